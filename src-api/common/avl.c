@@ -222,9 +222,37 @@ _avl_find_last(struct avl_tree *tree, struct avl_node* last)
 int
 avl_insert(struct avl_tree *tree, struct avl_node *new)
 {
-  struct avl_node *node, *last;
+  struct avl_node *node;
   int diff;
 
+  if (tree->root == NULL) {
+    return avl_insert_at(tree, new, NULL, 0);
+  }
+
+  node = _avl_find_rec(tree->root, new->key, tree->comp, &diff);
+  return avl_insert_at(tree, new, node, diff);
+}
+
+/**
+ * Inserts an avl_node into a tree at a position found by a search
+ * of the caller. This allows specialized search functions to reuse
+ * the linking and rebalancing code of the tree.
+ * @param tree pointer to tree
+ * @param new pointer to node
+ * @param node pointer to the node the search for the key of the new
+ *   node ended at (a node with the same key or a node with at most one
+ *   child), NULL if the tree is empty
+ * @param diff result of the comparator for the key of the new node
+ *   and the key of 'node'
+ * @return 0 if node was inserted successfully, -1 if it was not inserted
+ *   because of a key collision
+ */
+int
+avl_insert_at(struct avl_tree *tree, struct avl_node *new,
+    struct avl_node *node, int diff)
+{
+  struct avl_node *last;
+
   new->parent = NULL;
 
   new->left = NULL;
@@ -233,17 +261,13 @@ avl_insert(struct avl_tree *tree, struct avl_node *new)
   new->balance = 0;
   new->follower = false;
 
-  if (tree->root == NULL) {
+  if (node == NULL) {
     list_add_head(&tree->list_head, &new->list);
     tree->root = new;
     tree->count = 1;
     return 0;
   }
 
-  node = _avl_find_rec(tree->root, new->key, tree->comp, &diff);
-
-  diff = (*tree->comp) (new->key, node->key);
-
   if (diff == 0) {
     if (!tree->allow_dups)
       return -1;
@@ -140,6 +140,8 @@ EXPORT struct avl_node *avl_find(const struct avl_tree *, const void *);
 EXPORT struct avl_node *avl_find_greaterequal(const struct avl_tree *tree, const void *key);
 EXPORT struct avl_node *avl_find_lessequal(const struct avl_tree *tree, const void *key);
 EXPORT int avl_insert(struct avl_tree *, struct avl_node *);
+EXPORT int avl_insert_at(struct avl_tree *, struct avl_node *,
+    struct avl_node *, int);
 EXPORT void avl_remove(struct avl_tree *, struct avl_node *);
 
 /**
@@ -139,7 +139,7 @@ int
 avl_comp_netaddr(const void *k1, const void *k2) {
   const struct netaddr *n1 = k1;
   const struct netaddr *n2 = k2;
-  return memcmp(n1, n2, sizeof(struct netaddr));
+  return netaddr_cmp(n1, n2);
 }
 
 /**
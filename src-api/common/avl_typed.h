@@ -0,0 +1,180 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Generators for avl tree operations specialized on one key type.
+ *
+ * avl_find() and avl_insert() call the comparator of the tree through
+ * a function pointer on each level of the tree and read every key
+ * through the key pointer of the node. The functions generated by the
+ * macros of this file descend the tree with an inlined comparator
+ * instead and share the linking and rebalancing code with avl_insert().
+ *
+ * AVL_DEFINE_TYPED() reads the keys through the key pointer of the
+ * nodes. AVL_DEFINE_TYPED_MEMBER() is for trees which only contain
+ * one type of element that stores its key by value: it reads the key
+ * at a fixed offset from the node, without loading the key pointer.
+ * The key pointer must still be set for the generic functions.
+ *
+ * The comparator of a generator must order the keys exactly like the
+ * comparator the tree was initialized with, so specialized and generic
+ * functions can be mixed on the same tree.
+ */
+
+#ifndef AVL_TYPED_H_
+#define AVL_TYPED_H_
+
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+/**
+ * Generate specialized avl functions for a key type, keys are read
+ * through the key pointer of the avl nodes.
+ *
+ * Generates the functions avl_<name>_find() and avl_<name>_insert()
+ * with the same semantics as avl_find() and avl_insert().
+ * @param name suffix for the names of the generated functions
+ * @param key_type type of the key
+ * @param comp comparator with two 'const key_type *' parameters,
+ *    returns <0, 0 or >0 like the avl tree comparators.
+ */
+#define AVL_DEFINE_TYPED(name, key_type, comp) \
+  static INLINE const key_type * \
+  _avl_key_##name(const struct avl_node *node) { \
+    return node->key; \
+  } \
+  _AVL_DEFINE_TYPED_OPS(name, key_type, comp)
+
+/**
+ * Generate specialized avl functions for a tree that only contains
+ * one type of element, keys are read directly from the element.
+ *
+ * Generates the functions avl_<name>_find() and avl_<name>_insert()
+ * with the same semantics as avl_find() and avl_insert().
+ * @param name suffix for the names of the generated functions
+ * @param key_type type of the key
+ * @param type type of the elements of the tree
+ * @param node_member name of the avl_node inside the element
+ * @param key_member name of the key inside the element
+ * @param comp comparator with two 'const key_type *' parameters,
+ *    returns <0, 0 or >0 like the avl tree comparators.
+ */
+#define AVL_DEFINE_TYPED_MEMBER(name, key_type, type, node_member, key_member, comp) \
+  static INLINE const key_type * \
+  _avl_key_##name(const struct avl_node *node) { \
+    return &((const type *)((const uint8_t *)node - offsetof(type, node_member)))->key_member; \
+  } \
+  _AVL_DEFINE_TYPED_OPS(name, key_type, comp)
+
+/**
+ * Internal part of the generators, needs the key accessor
+ * _avl_key_<name>()
+ */
+#define _AVL_DEFINE_TYPED_OPS(name, key_type, comp) \
+  static INLINE struct avl_node * \
+  avl_##name##_find(const struct avl_tree *tree, const key_type *key) { \
+    struct avl_node *node; \
+    int diff; \
+    \
+    node = tree->root; \
+    while (node != NULL) { \
+      diff = comp(key, _avl_key_##name(node)); \
+      if (diff == 0) { \
+        return node; \
+      } \
+      node = diff < 0 ? node->left : node->right; \
+    } \
+    return NULL; \
+  } \
+  \
+  static INLINE int \
+  avl_##name##_insert(struct avl_tree *tree, struct avl_node *new_node) { \
+    const key_type *key; \
+    struct avl_node *node, *next; \
+    int diff; \
+    \
+    key = _avl_key_##name(new_node); \
+    node = NULL; \
+    next = tree->root; \
+    diff = 0; \
+    while (next != NULL) { \
+      node = next; \
+      diff = comp(key, _avl_key_##name(node)); \
+      if (diff == 0) { \
+        break; \
+      } \
+      next = diff < 0 ? node->left : node->right; \
+    } \
+    return avl_insert_at(tree, new_node, node, diff); \
+  }
+
+/**
+ * @param name suffix of the specialized avl functions
+ * @param tree pointer to avl-tree
+ * @param key pointer to key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the avl_node element inside the
+ *    larger struct
+ * @return pointer to tree element with the specified key,
+ *    NULL if no element was found
+ */
+#define avl_typed_find_element(name, tree, key, element, node_element) \
+  container_of_if_notnull(avl_##name##_find(tree, key), typeof(*(element)), node_element)
+
+/**
+ * Comparator for uint32 keys, same order as avl_comp_uint32()
+ * @param k1 pointer to key 1
+ * @param k2 pointer to key 2
+ * @return +1 if k1>k2, -1 if k1<k2, 0 if k1==k2
+ */
+static INLINE int
+avl_typed_cmp_uint32(const uint32_t *k1, const uint32_t *k2) {
+  return (*k1 > *k2) - (*k1 < *k2);
+}
+
+AVL_DEFINE_TYPED(uint32, uint32_t, avl_typed_cmp_uint32)
+AVL_DEFINE_TYPED(netaddr, struct netaddr, netaddr_cmp)
+
+#endif /* AVL_TYPED_H_ */
@@ -0,0 +1,817 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/bptree.h"
+
+enum {
+  /*! maximum tree height, BPTREE_INNER_SIZE/2 ^ 16 is far beyond 2^32 */
+  BPTREE_MAX_HEIGHT = 16,
+};
+
+static struct bptree_leaf *_find_leaf(const struct bptree *tree,
+    const void *key, bool upper);
+static uint32_t _leaf_search(const struct bptree *tree,
+    const struct bptree_leaf *leaf, const void *key, bool upper);
+static void _leaf_shift(struct bptree_leaf *leaf, uint32_t from, int delta);
+static void _leaf_copy(struct bptree_leaf *dst, uint32_t dst_idx,
+    const struct bptree_leaf *src, uint32_t src_idx, uint32_t n);
+static void _leaf_unlink(struct bptree *tree, struct bptree_leaf *leaf);
+static int _split_leaf(struct bptree *tree, struct bptree_leaf *leaf,
+    uint32_t idx, struct bptree_node *node);
+static void _insert_child(struct bptree *tree, struct bptree_block *left,
+    const void *key, struct bptree_block *right,
+    struct bptree_inner **pool);
+static struct bptree_inner *_take_inner(struct bptree_inner **pool);
+static uint32_t _get_child_pos(const struct bptree_inner *parent,
+    const struct bptree_block *child);
+static void _remove_child(struct bptree_inner *inner, uint32_t pos);
+static void _set_children_parent(struct bptree_inner *inner,
+    uint32_t from, uint32_t to);
+static void _update_separator(struct bptree_leaf *leaf);
+static void _rebalance_leaf(struct bptree *tree, struct bptree_leaf *leaf);
+static void _rebalance_inner(struct bptree *tree, struct bptree_inner *inner);
+
+/**
+ * Initialize a new B+-tree struct
+ * @param tree pointer to B+-tree
+ * @param comp pointer to comparator for the tree
+ * @param allow_dups true if the tree allows multiple
+ *   elements with the same key
+ */
+void
+bptree_init(struct bptree *tree,
+    int (*comp) (const void *k1, const void *k2), bool allow_dups) {
+  memset(tree, 0, sizeof(*tree));
+  tree->comp = comp;
+  tree->allow_dups = allow_dups;
+}
+
+/**
+ * Finds a node in a B+-tree with a certain key. If the tree
+ * contains multiple nodes with the key, the first one is returned.
+ * @param tree pointer to B+-tree
+ * @param key pointer to key
+ * @return pointer to B+-tree node with key, NULL if no node with
+ *    this key exists.
+ */
+struct bptree_node *
+bptree_find(const struct bptree *tree, const void *key) {
+  struct bptree_node *node;
+
+  node = bptree_find_greaterequal(tree, key);
+  if (node != NULL && tree->comp(node->key, key) != 0) {
+    return NULL;
+  }
+  return node;
+}
+
+/**
+ * Finds the first node in a B+-tree with a key greater
+ * or equal to the specified key.
+ * @param tree pointer to B+-tree
+ * @param key pointer to specified key
+ * @return pointer to B+-tree node, NULL if no node
+ *    was found
+ */
+struct bptree_node *
+bptree_find_greaterequal(const struct bptree *tree, const void *key) {
+  struct bptree_leaf *leaf;
+  uint32_t idx;
+
+  if (tree->root == NULL) {
+    return NULL;
+  }
+
+  leaf = _find_leaf(tree, key, false);
+  idx = _leaf_search(tree, leaf, key, false);
+  if (idx < leaf->block.count) {
+    return leaf->nodes[idx];
+  }
+
+  /* all keys of the leaf are smaller, first key of next leaf is larger */
+  return leaf->next == NULL ? NULL : leaf->next->nodes[0];
+}
+
+/**
+ * Finds the last node in a B+-tree with a key less
+ * or equal to the specified key.
+ * @param tree pointer to B+-tree
+ * @param key pointer to specified key
+ * @return pointer to B+-tree node, NULL if no node
+ *    was found
+ */
+struct bptree_node *
+bptree_find_lessequal(const struct bptree *tree, const void *key) {
+  struct bptree_leaf *leaf;
+  uint32_t idx;
+
+  if (tree->root == NULL) {
+    return NULL;
+  }
+
+  leaf = _find_leaf(tree, key, true);
+  idx = _leaf_search(tree, leaf, key, true);
+  if (idx > 0) {
+    return leaf->nodes[idx - 1];
+  }
+
+  /* all keys of the leaf are larger, last key of previous leaf is smaller */
+  return leaf->prev == NULL ? NULL : leaf->prev->nodes[leaf->prev->block.count - 1];
+}
+
+/**
+ * Inserts a B+-tree node into a tree. Nodes with the same
+ * key are inserted behind the existing ones.
+ * @param tree pointer to tree
+ * @param node pointer to node
+ * @return 0 if node was inserted successfully, -1 if it could not
+ *   be inserted because of a key duplicate or missing memory
+ */
+int
+bptree_insert(struct bptree *tree, struct bptree_node *node) {
+  struct bptree_leaf *leaf;
+  uint32_t idx;
+
+  if (tree->root == NULL) {
+    leaf = calloc(1, sizeof(*leaf));
+    if (leaf == NULL) {
+      return -1;
+    }
+    leaf->block.is_leaf = true;
+
+    tree->root = &leaf->block;
+    tree->first = leaf;
+    tree->last = leaf;
+  }
+
+  leaf = _find_leaf(tree, node->key, true);
+  idx = _leaf_search(tree, leaf, node->key, true);
+
+  if (!tree->allow_dups && idx > 0
+      && tree->comp(leaf->keys[idx - 1], node->key) == 0) {
+    return -1;
+  }
+
+  if (leaf->block.count < BPTREE_LEAF_SIZE) {
+    _leaf_shift(leaf, idx, 1);
+    leaf->keys[idx] = node->key;
+    leaf->nodes[idx] = node;
+    node->_leaf = leaf;
+    node->_idx = idx;
+    leaf->block.count++;
+  }
+  else if (_split_leaf(tree, leaf, idx, node)) {
+    return -1;
+  }
+
+  if (node->_idx == 0) {
+    _update_separator(node->_leaf);
+  }
+
+  tree->count++;
+  return 0;
+}
+
+/**
+ * Removes a B+-tree node from a tree
+ * @param tree pointer to tree
+ * @param node pointer to node
+ */
+void
+bptree_remove(struct bptree *tree, struct bptree_node *node) {
+  struct bptree_leaf *leaf;
+  uint32_t idx;
+
+  leaf = node->_leaf;
+  idx = node->_idx;
+  if (leaf == NULL) {
+    return;
+  }
+
+  _leaf_shift(leaf, idx + 1, -1);
+  leaf->block.count--;
+
+  node->_leaf = NULL;
+  node->_idx = 0;
+  tree->count--;
+
+  if (&leaf->block == tree->root) {
+    if (leaf->block.count == 0) {
+      free(leaf);
+      tree->root = NULL;
+      tree->first = NULL;
+      tree->last = NULL;
+    }
+    return;
+  }
+
+  if (idx == 0 && leaf->block.count > 0) {
+    _update_separator(leaf);
+  }
+  if (leaf->block.count < BPTREE_LEAF_SIZE / 2) {
+    _rebalance_leaf(tree, leaf);
+  }
+}
+
+/**
+ * Walk from the root to the leaf which contains a key
+ * @param tree pointer to tree, must not be empty
+ * @param key pointer to key
+ * @param upper true to find the leaf of the last node with the key,
+ *   false to find the leaf of the first node with the key (or the
+ *   leaf before it)
+ * @return pointer to leaf
+ */
+static struct bptree_leaf *
+_find_leaf(const struct bptree *tree, const void *key, bool upper) {
+  const struct bptree_inner *inner;
+  struct bptree_block *block;
+  uint32_t low, high, mid;
+  int diff;
+
+  block = tree->root;
+  while (!block->is_leaf) {
+    inner = (const struct bptree_inner *)block;
+
+    /* binary search for the number of separators below (or equal) key */
+    low = 0;
+    high = inner->block.count - 1;
+    while (low < high) {
+      mid = (low + high) / 2;
+      diff = tree->comp(inner->keys[mid], key);
+      if (diff < 0 || (upper && diff == 0)) {
+        low = mid + 1;
+      }
+      else {
+        high = mid;
+      }
+    }
+    block = inner->children[low];
+  }
+  return (struct bptree_leaf *)block;
+}
+
+/**
+ * Binary search inside a leaf
+ * @param tree pointer to tree
+ * @param leaf pointer to leaf
+ * @param key pointer to key
+ * @param upper true to find the index behind the last node with
+ *   the key, false to find the index of the first node with the key
+ * @return index inside leaf
+ */
+static uint32_t
+_leaf_search(const struct bptree *tree, const struct bptree_leaf *leaf,
+    const void *key, bool upper) {
+  uint32_t low, high, mid;
+  int diff;
+
+  low = 0;
+  high = leaf->block.count;
+  while (low < high) {
+    mid = (low + high) / 2;
+    diff = tree->comp(leaf->keys[mid], key);
+    if (diff < 0 || (upper && diff == 0)) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * Move the entries of a leaf starting at an index and
+ * update the position of the moved nodes. The element
+ * count of the leaf is not changed.
+ * @param leaf pointer to leaf
+ * @param from index of first moved entry
+ * @param delta distance to move the entries
+ */
+static void
+_leaf_shift(struct bptree_leaf *leaf, uint32_t from, int delta) {
+  uint32_t i, n;
+
+  if (from >= leaf->block.count) {
+    return;
+  }
+
+  n = leaf->block.count - from;
+  memmove(&leaf->keys[from + delta], &leaf->keys[from], n * sizeof(leaf->keys[0]));
+  memmove(&leaf->nodes[from + delta], &leaf->nodes[from], n * sizeof(leaf->nodes[0]));
+
+  for (i = from + delta; i < from + delta + n; i++) {
+    leaf->nodes[i]->_idx = i;
+  }
+}
+
+/**
+ * Copy entries from one leaf to another one and update the
+ * position of the copied nodes. The element counts of the
+ * leaves are not changed.
+ * @param dst target leaf
+ * @param dst_idx first target index
+ * @param src source leaf
+ * @param src_idx first source index
+ * @param n number of entries
+ */
+static void
+_leaf_copy(struct bptree_leaf *dst, uint32_t dst_idx,
+    const struct bptree_leaf *src, uint32_t src_idx, uint32_t n) {
+  uint32_t i;
+
+  memcpy(&dst->keys[dst_idx], &src->keys[src_idx], n * sizeof(dst->keys[0]));
+  memcpy(&dst->nodes[dst_idx], &src->nodes[src_idx], n * sizeof(dst->nodes[0]));
+
+  for (i = dst_idx; i < dst_idx + n; i++) {
+    dst->nodes[i]->_leaf = dst;
+    dst->nodes[i]->_idx = i;
+  }
+}
+
+/**
+ * Remove a leaf from the linked list of leaves
+ * @param tree pointer to tree
+ * @param leaf pointer to leaf
+ */
+static void
+_leaf_unlink(struct bptree *tree, struct bptree_leaf *leaf) {
+  if (leaf->prev) {
+    leaf->prev->next = leaf->next;
+  }
+  else {
+    tree->first = leaf->next;
+  }
+  if (leaf->next) {
+    leaf->next->prev = leaf->prev;
+  }
+  else {
+    tree->last = leaf->prev;
+  }
+}
+
+/**
+ * Split a full leaf and insert a node
+ * @param tree pointer to tree
+ * @param leaf pointer to full leaf
+ * @param idx insertion index of node
+ * @param node pointer to node
+ * @return -1 if not enough memory was available, 0 otherwise
+ */
+static int
+_split_leaf(struct bptree *tree, struct bptree_leaf *leaf,
+    uint32_t idx, struct bptree_node *node) {
+  struct bptree_inner *pool[BPTREE_MAX_HEIGHT];
+  struct bptree_inner *parent;
+  struct bptree_leaf *right;
+  uint32_t i, needed, left_count;
+
+  /* allocate everything before modifying the tree */
+  needed = 1;
+  for (parent = leaf->block.parent;
+      parent != NULL && parent->block.count == BPTREE_INNER_SIZE;
+      parent = parent->block.parent) {
+    needed++;
+  }
+
+  right = calloc(1, sizeof(*right));
+  for (i = 0; i < needed; i++) {
+    pool[i] = right == NULL ? NULL : calloc(1, sizeof(*pool[i]));
+    if (pool[i] == NULL) {
+      while (i > 0) {
+        free(pool[--i]);
+      }
+      free(right);
+      return -1;
+    }
+  }
+  pool[needed] = NULL;
+
+  right->block.is_leaf = true;
+
+  /* move upper half into new leaf */
+  left_count = (BPTREE_LEAF_SIZE + 1) / 2;
+  if (idx < left_count) {
+    /* new node goes into the left leaf */
+    _leaf_copy(right, 0, leaf, left_count - 1, BPTREE_LEAF_SIZE - left_count + 1);
+    right->block.count = BPTREE_LEAF_SIZE - left_count + 1;
+    leaf->block.count = left_count - 1;
+    _leaf_shift(leaf, idx, 1);
+    leaf->block.count++;
+    leaf->keys[idx] = node->key;
+    leaf->nodes[idx] = node;
+    node->_leaf = leaf;
+    node->_idx = idx;
+  }
+  else {
+    /* new node goes into the right leaf */
+    _leaf_copy(right, 0, leaf, left_count, BPTREE_LEAF_SIZE - left_count);
+    right->block.count = BPTREE_LEAF_SIZE - left_count;
+    leaf->block.count = left_count;
+    idx -= left_count;
+    _leaf_shift(right, idx, 1);
+    right->block.count++;
+    right->keys[idx] = node->key;
+    right->nodes[idx] = node;
+    node->_leaf = right;
+    node->_idx = idx;
+  }
+
+  /* link new leaf behind the old one */
+  right->prev = leaf;
+  right->next = leaf->next;
+  if (leaf->next) {
+    leaf->next->prev = right;
+  }
+  else {
+    tree->last = right;
+  }
+  leaf->next = right;
+
+  _insert_child(tree, &leaf->block, right->keys[0], &right->block, pool);
+
+  /* free unused preallocated inner nodes */
+  for (i = 0; pool[i] != NULL; i++) {
+    free(pool[i]);
+  }
+  return 0;
+}
+
+/**
+ * Insert a new block into the parent of its left neighbor
+ * @param tree pointer to tree
+ * @param left block left of the new one
+ * @param key smallest key of the new block
+ * @param right new block
+ * @param pool array of preallocated inner nodes, used nodes
+ *   are removed from the end of the array
+ */
+static void
+_insert_child(struct bptree *tree, struct bptree_block *left,
+    const void *key, struct bptree_block *right,
+    struct bptree_inner **pool) {
+  const void *keys[BPTREE_INNER_SIZE];
+  struct bptree_block *children[BPTREE_INNER_SIZE + 1];
+  struct bptree_inner *parent, *sibling, *root;
+  uint32_t pos, left_count;
+
+  parent = left->parent;
+  if (parent == NULL) {
+    /* split of the root, tree grows */
+    root = _take_inner(pool);
+
+    root->children[0] = left;
+    root->children[1] = right;
+    root->keys[0] = key;
+    root->block.count = 2;
+
+    left->parent = root;
+    right->parent = root;
+    tree->root = &root->block;
+    return;
+  }
+
+  pos = _get_child_pos(parent, left) + 1;
+  if (parent->block.count < BPTREE_INNER_SIZE) {
+    memmove(&parent->keys[pos], &parent->keys[pos - 1],
+        (parent->block.count - pos) * sizeof(parent->keys[0]));
+    memmove(&parent->children[pos + 1], &parent->children[pos],
+        (parent->block.count - pos) * sizeof(parent->children[0]));
+    parent->keys[pos - 1] = key;
+    parent->children[pos] = right;
+    parent->block.count++;
+
+    right->parent = parent;
+    return;
+  }
+
+  /* split full parent, merge everything into temporary arrays first */
+  memcpy(keys, parent->keys, (pos - 1) * sizeof(keys[0]));
+  keys[pos - 1] = key;
+  memcpy(&keys[pos], &parent->keys[pos - 1],
+      (BPTREE_INNER_SIZE - pos) * sizeof(keys[0]));
+
+  memcpy(children, parent->children, pos * sizeof(children[0]));
+  children[pos] = right;
+  memcpy(&children[pos + 1], &parent->children[pos],
+      (BPTREE_INNER_SIZE - pos) * sizeof(children[0]));
+
+  sibling = _take_inner(pool);
+
+  left_count = (BPTREE_INNER_SIZE + 1) / 2;
+
+  memcpy(parent->keys, keys, (left_count - 1) * sizeof(keys[0]));
+  memcpy(parent->children, children, left_count * sizeof(children[0]));
+  parent->block.count = left_count;
+
+  memcpy(sibling->keys, &keys[left_count],
+      (BPTREE_INNER_SIZE - left_count) * sizeof(keys[0]));
+  memcpy(sibling->children, &children[left_count],
+      (BPTREE_INNER_SIZE + 1 - left_count) * sizeof(children[0]));
+  sibling->block.count = BPTREE_INNER_SIZE + 1 - left_count;
+
+  _set_children_parent(parent, 0, parent->block.count);
+  _set_children_parent(sibling, 0, sibling->block.count);
+
+  /* keys[left_count - 1] is the smallest key of the new sibling */
+  _insert_child(tree, &parent->block, keys[left_count - 1], &sibling->block, pool);
+}
+
+/**
+ * Take the last inner node from an array of preallocated ones
+ * @param pool NULL terminated array of inner nodes, must not be empty
+ * @return pointer to inner node
+ */
+static struct bptree_inner *
+_take_inner(struct bptree_inner **pool) {
+  struct bptree_inner *inner;
+  uint32_t i;
+
+  for (i = 0; pool[i + 1] != NULL; i++);
+
+  inner = pool[i];
+  pool[i] = NULL;
+  return inner;
+}
+
+/**
+ * @param parent pointer to inner node
+ * @param child pointer to child block of inner node
+ * @return index of child inside parent
+ */
+static uint32_t
+_get_child_pos(const struct bptree_inner *parent,
+    const struct bptree_block *child) {
+  uint32_t i;
+
+  for (i = 0; parent->children[i] != child; i++);
+  return i;
+}
+
+/**
+ * Remove a child (and the separator key in front of it)
+ * from an inner node
+ * @param inner pointer to inner node
+ * @param pos index of child, must not be zero
+ */
+static void
+_remove_child(struct bptree_inner *inner, uint32_t pos) {
+  memmove(&inner->keys[pos - 1], &inner->keys[pos],
+      (inner->block.count - pos - 1) * sizeof(inner->keys[0]));
+  memmove(&inner->children[pos], &inner->children[pos + 1],
+      (inner->block.count - pos - 1) * sizeof(inner->children[0]));
+  inner->block.count--;
+}
+
+/**
+ * Set the parent pointer of a range of children
+ * @param inner pointer to inner node
+ * @param from first child index
+ * @param to index behind last child
+ */
+static void
+_set_children_parent(struct bptree_inner *inner, uint32_t from, uint32_t to) {
+  uint32_t i;
+
+  for (i = from; i < to; i++) {
+    inner->children[i]->parent = inner;
+  }
+}
+
+/**
+ * Update the separator key which references the first key of a leaf.
+ * Must be called every time the first node of a leaf changes.
+ * @param leaf pointer to leaf, must not be empty
+ */
+static void
+_update_separator(struct bptree_leaf *leaf) {
+  struct bptree_block *block;
+  struct bptree_inner *parent;
+  uint32_t pos;
+
+  /* the separator is in the first ancestor the leaf is not the leftmost descendant of */
+  for (block = &leaf->block; block->parent != NULL; block = &parent->block) {
+    parent = block->parent;
+    pos = _get_child_pos(parent, block);
+    if (pos > 0) {
+      parent->keys[pos - 1] = leaf->keys[0];
+      return;
+    }
+  }
+}
+
+/**
+ * Merge an underfull leaf with a neighbor or move nodes from a
+ * neighbor into it.
+ * @param tree pointer to tree
+ * @param leaf pointer to leaf, must not be the root
+ */
+static void
+_rebalance_leaf(struct bptree *tree, struct bptree_leaf *leaf) {
+  struct bptree_inner *parent;
+  struct bptree_leaf *sibling;
+  uint32_t pos, n, old_count;
+
+  parent = leaf->block.parent;
+  pos = _get_child_pos(parent, &leaf->block);
+  old_count = leaf->block.count;
+
+  if (pos > 0) {
+    sibling = (struct bptree_leaf *)parent->children[pos - 1];
+
+    if (sibling->block.count + leaf->block.count <= BPTREE_LEAF_SIZE) {
+      /* merge into left neighbor */
+      _leaf_copy(sibling, sibling->block.count, leaf, 0, leaf->block.count);
+      sibling->block.count += leaf->block.count;
+
+      _leaf_unlink(tree, leaf);
+      _remove_child(parent, pos);
+      free(leaf);
+
+      _rebalance_inner(tree, parent);
+      return;
+    }
+
+    /* move the last nodes of the left neighbor */
+    n = (sibling->block.count - leaf->block.count) / 2;
+    _leaf_shift(leaf, 0, n);
+    _leaf_copy(leaf, 0, sibling, sibling->block.count - n, n);
+    sibling->block.count -= n;
+    leaf->block.count += n;
+
+    _update_separator(leaf);
+    return;
+  }
+
+  sibling = (struct bptree_leaf *)parent->children[1];
+
+  if (sibling->block.count + leaf->block.count <= BPTREE_LEAF_SIZE) {
+    /* merge right neighbor into leaf */
+    _leaf_copy(leaf, leaf->block.count, sibling, 0, sibling->block.count);
+    leaf->block.count += sibling->block.count;
+
+    _leaf_unlink(tree, sibling);
+    _remove_child(parent, 1);
+    free(sibling);
+  }
+  else {
+    /* move the first nodes of the right neighbor */
+    n = (sibling->block.count - leaf->block.count) / 2;
+    _leaf_copy(leaf, leaf->block.count, sibling, 0, n);
+    leaf->block.count += n;
+    _leaf_shift(sibling, n, -(int)n);
+    sibling->block.count -= n;
+
+    _update_separator(sibling);
+  }
+
+  if (old_count == 0) {
+    _update_separator(leaf);
+  }
+  _rebalance_inner(tree, parent);
+}
+
+/**
+ * Merge an underfull inner node with a neighbor or move a child from
+ * a neighbor into it. Removes the root if it has a single child.
+ * @param tree pointer to tree
+ * @param inner pointer to inner node
+ */
+static void
+_rebalance_inner(struct bptree *tree, struct bptree_inner *inner) {
+  struct bptree_inner *parent, *sibling;
+  uint32_t pos, count;
+
+  if (&inner->block == tree->root) {
+    if (inner->block.count == 1) {
+      /* tree shrinks */
+      tree->root = inner->children[0];
+      tree->root->parent = NULL;
+      free(inner);
+    }
+    return;
+  }
+
+  if (inner->block.count >= BPTREE_INNER_SIZE / 2) {
+    return;
+  }
+
+  parent = inner->block.parent;
+  pos = _get_child_pos(parent, &inner->block);
+
+  if (pos > 0) {
+    sibling = (struct bptree_inner *)parent->children[pos - 1];
+    count = sibling->block.count;
+
+    if (count + inner->block.count <= BPTREE_INNER_SIZE) {
+      /* merge into left neighbor, separator moves down */
+      sibling->keys[count - 1] = parent->keys[pos - 1];
+      memcpy(&sibling->keys[count], inner->keys,
+          (inner->block.count - 1) * sizeof(inner->keys[0]));
+      memcpy(&sibling->children[count], inner->children,
+          inner->block.count * sizeof(inner->children[0]));
+      sibling->block.count += inner->block.count;
+      _set_children_parent(sibling, count, sibling->block.count);
+
+      _remove_child(parent, pos);
+      free(inner);
+
+      _rebalance_inner(tree, parent);
+      return;
+    }
+
+    /* move the last child of the left neighbor */
+    memmove(&inner->keys[1], &inner->keys[0],
+        (inner->block.count - 1) * sizeof(inner->keys[0]));
+    memmove(&inner->children[1], &inner->children[0],
+        inner->block.count * sizeof(inner->children[0]));
+    inner->keys[0] = parent->keys[pos - 1];
+    inner->children[0] = sibling->children[count - 1];
+    inner->children[0]->parent = inner;
+    inner->block.count++;
+
+    parent->keys[pos - 1] = sibling->keys[count - 2];
+    sibling->block.count--;
+    return;
+  }
+
+  sibling = (struct bptree_inner *)parent->children[1];
+  count = inner->block.count;
+
+  if (count + sibling->block.count <= BPTREE_INNER_SIZE) {
+    /* merge right neighbor, separator moves down */
+    inner->keys[count - 1] = parent->keys[0];
+    memcpy(&inner->keys[count], sibling->keys,
+        (sibling->block.count - 1) * sizeof(inner->keys[0]));
+    memcpy(&inner->children[count], sibling->children,
+        sibling->block.count * sizeof(inner->children[0]));
+    inner->block.count += sibling->block.count;
+    _set_children_parent(inner, count, inner->block.count);
+
+    _remove_child(parent, 1);
+    free(sibling);
+
+    _rebalance_inner(tree, parent);
+    return;
+  }
+
+  /* move the first child of the right neighbor */
+  inner->keys[count - 1] = parent->keys[0];
+  inner->children[count] = sibling->children[0];
+  inner->children[count]->parent = inner;
+  inner->block.count++;
+
+  parent->keys[0] = sibling->keys[0];
+  memmove(&sibling->keys[0], &sibling->keys[1],
+      (sibling->block.count - 2) * sizeof(sibling->keys[0]));
+  memmove(&sibling->children[0], &sibling->children[1],
+      (sibling->block.count - 1) * sizeof(sibling->children[0]));
+  sibling->block.count--;
+}
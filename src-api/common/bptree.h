@@ -0,0 +1,507 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Ordered B+-tree container for iteration-heavy users.
+ *
+ * Each leaf stores the key pointers and node pointers of up to
+ * BPTREE_LEAF_SIZE elements in sorted order and all leaves are linked,
+ * so a full iteration walks a few packed arrays instead of following
+ * a linked list through all elements like the avl tree does.
+ *
+ * The embedded bptree_node is much smaller than an avl_node. It
+ * remembers the position of the element inside its leaf, which allows
+ * the iteration macros to have the same parameters as the avl ones,
+ * so an avl tree can be replaced with minimal code change. Positions
+ * are kept up to date on every modification of the tree.
+ *
+ * The non-safe loops walk the leaves with a hidden cursor, so the
+ * address of the next element never depends on loading the current
+ * one and cache misses on scattered elements can overlap.
+ *
+ * Leaves and inner nodes are allocated by the tree, bptree_insert()
+ * fails if no memory is available.
+ */
+
+#ifndef BPTREE_H_
+#define BPTREE_H_
+
+#include <stddef.h>
+
+#include "common/common_types.h"
+#include "common/container_of.h"
+
+enum {
+  /*! maximum number of elements per leaf */
+  BPTREE_LEAF_SIZE = 30,
+
+  /*! maximum number of children per inner node */
+  BPTREE_INNER_SIZE = 32,
+};
+
+struct bptree_inner;
+struct bptree_leaf;
+
+/**
+ * This element is a member of a B+-tree. It must be contained in all
+ * larger structs that should be put into a tree.
+ */
+struct bptree_node {
+  /**
+   * pointer to key of node
+   */
+  const void *key;
+
+  /**
+   * leaf the node is stored in, NULL if node is not in a tree
+   */
+  struct bptree_leaf *_leaf;
+
+  /**
+   * index of the node inside its leaf
+   */
+  uint32_t _idx;
+};
+
+/**
+ * Common header of leaves and inner nodes
+ */
+struct bptree_block {
+  /*! parent inner node, NULL for the root */
+  struct bptree_inner *parent;
+
+  /*! number of elements (leaf) or children (inner node) */
+  uint16_t count;
+
+  /*! true if this block is a leaf */
+  bool is_leaf;
+};
+
+/**
+ * Leaf of a B+-tree
+ */
+struct bptree_leaf {
+  /*! common block header, must be first element */
+  struct bptree_block block;
+
+  /*! previous leaf in key order, NULL for first leaf */
+  struct bptree_leaf *prev;
+
+  /*! next leaf in key order, NULL for last leaf */
+  struct bptree_leaf *next;
+
+  /*! sorted key pointers of the elements */
+  const void *keys[BPTREE_LEAF_SIZE];
+
+  /*! nodes of the elements, same order as keys */
+  struct bptree_node *nodes[BPTREE_LEAF_SIZE];
+};
+
+/**
+ * Inner node of a B+-tree
+ */
+struct bptree_inner {
+  /*! common block header, must be first element */
+  struct bptree_block block;
+
+  /*! keys[i] is the smallest key of the subtree children[i+1] */
+  const void *keys[BPTREE_INNER_SIZE - 1];
+
+  /*! child blocks */
+  struct bptree_block *children[BPTREE_INNER_SIZE];
+};
+
+/**
+ * Position of an iteration loop inside the leaves of a tree
+ */
+struct bptree_cursor {
+  /*! current leaf, NULL at the end of the iteration */
+  struct bptree_leaf *leaf;
+
+  /*! index of current node inside the leaf */
+  uint32_t idx;
+};
+
+/**
+ * This struct is the central management part of a B+-tree.
+ * One of them is necessary for each tree.
+ */
+struct bptree {
+  /**
+   * root block of tree, NULL if tree is empty
+   */
+  struct bptree_block *root;
+
+  /**
+   * first leaf of tree, NULL if tree is empty
+   */
+  struct bptree_leaf *first;
+
+  /**
+   * last leaf of tree, NULL if tree is empty
+   */
+  struct bptree_leaf *last;
+
+  /**
+   * number of nodes in the tree
+   */
+  uint32_t count;
+
+  /**
+   * true if multiple nodes with the same key are
+   * allowed in the tree, false otherwise
+   */
+  bool allow_dups;
+
+  /**
+   * Prototype for comparators, same as for avl trees
+   * @param k1 first key
+   * @param k2 second key
+   * @return +1 if k1>k2, -1 if k1<k2, 0 if k1==k2
+   */
+  int (*comp)(const void *k1, const void *k2);
+};
+
+EXPORT void bptree_init(struct bptree *,
+    int (*comp) (const void *k1, const void *k2), bool allow_dups);
+EXPORT struct bptree_node *bptree_find(const struct bptree *, const void *key);
+EXPORT struct bptree_node *bptree_find_greaterequal(const struct bptree *tree, const void *key);
+EXPORT struct bptree_node *bptree_find_lessequal(const struct bptree *tree, const void *key);
+EXPORT int bptree_insert(struct bptree *, struct bptree_node *);
+EXPORT void bptree_remove(struct bptree *, struct bptree_node *);
+
+/**
+ * @param tree pointer to B+-tree
+ * @return true if the tree is empty, false otherwise
+ */
+static INLINE bool
+bptree_is_empty(const struct bptree *tree) {
+  return tree->count == 0;
+}
+
+/**
+ * @param node pointer to B+-tree node
+ * @return true if node is currently in a tree, false otherwise
+ */
+static INLINE bool
+bptree_is_node_added(const struct bptree_node *node) {
+  return node->_leaf != NULL;
+}
+
+/**
+ * @param node pointer to node of a tree
+ * @return node after 'node', NULL if 'node' is the last one
+ */
+static INLINE struct bptree_node *
+bptree_next_node(const struct bptree_node *node) {
+  const struct bptree_leaf *leaf = node->_leaf;
+
+  if (node->_idx + 1 < leaf->block.count) {
+    return leaf->nodes[node->_idx + 1];
+  }
+  return leaf->next == NULL ? NULL : leaf->next->nodes[0];
+}
+
+/**
+ * @param node pointer to node of a tree
+ * @return node before 'node', NULL if 'node' is the first one
+ */
+static INLINE struct bptree_node *
+bptree_prev_node(const struct bptree_node *node) {
+  const struct bptree_leaf *leaf = node->_leaf;
+
+  if (node->_idx > 0) {
+    return leaf->nodes[node->_idx - 1];
+  }
+  return leaf->prev == NULL ? NULL : leaf->prev->nodes[leaf->prev->block.count - 1];
+}
+
+/**
+ * @param tree pointer to B+-tree
+ * @param node pointer to node of the tree
+ * @return true if node is the first one of the tree, false otherwise
+ */
+static INLINE bool
+bptree_is_first(const struct bptree *tree, const struct bptree_node *node) {
+  return node->_leaf == tree->first && node->_idx == 0;
+}
+
+/**
+ * @param tree pointer to B+-tree
+ * @param node pointer to node of the tree
+ * @return true if node is the last one of the tree, false otherwise
+ */
+static INLINE bool
+bptree_is_last(const struct bptree *tree, const struct bptree_node *node) {
+  return node->_leaf == tree->last && node->_idx + 1 == tree->last->block.count;
+}
+
+/**
+ * @param cursor pointer to iteration cursor
+ * @return node at the cursor position, NULL if cursor is at the end
+ */
+static INLINE struct bptree_node *
+bptree_cursor_get(const struct bptree_cursor *cursor) {
+  return cursor->leaf == NULL ? NULL : cursor->leaf->nodes[cursor->idx];
+}
+
+/**
+ * Move an iteration cursor to the next node
+ * @param cursor pointer to iteration cursor
+ */
+static INLINE void
+bptree_cursor_next(struct bptree_cursor *cursor) {
+  if (++cursor->idx >= cursor->leaf->block.count) {
+    cursor->leaf = cursor->leaf->next;
+    cursor->idx = 0;
+  }
+}
+
+/**
+ * Move an iteration cursor to the previous node
+ * @param cursor pointer to iteration cursor
+ */
+static INLINE void
+bptree_cursor_prev(struct bptree_cursor *cursor) {
+  if (cursor->idx-- == 0) {
+    cursor->leaf = cursor->leaf->prev;
+    cursor->idx = cursor->leaf == NULL ? 0 : cursor->leaf->block.count - 1;
+  }
+}
+
+/*! unique name for the hidden cursor of the iteration loops */
+#define _BPTREE_CONCAT2(a, b) a##b
+#define _BPTREE_CONCAT(a, b) _BPTREE_CONCAT2(a, b)
+#define _BPTREE_CURSOR _BPTREE_CONCAT(_bptree_cursor_, __LINE__)
+
+/**
+ * @param tree pointer to B+-tree
+ * @param key pointer to key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to tree element with the specified key,
+ *    NULL if no element was found
+ */
+#define bptree_find_element(tree, key, element, node_element) \
+  container_of_if_notnull(bptree_find(tree, key), typeof(*(element)), node_element)
+
+/**
+ * @param tree pointer to B+-tree
+ * @param key pointer to specified key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the bptree_node element inside the
+ *    larger struct
+ * return pointer to last tree element with less or equal key than specified key,
+ *    NULL if no element was found
+ */
+#define bptree_find_le_element(tree, key, element, node_element) \
+  container_of_if_notnull(bptree_find_lessequal(tree, key), typeof(*(element)), node_element)
+
+/**
+ * @param tree pointer to B+-tree
+ * @param key pointer to specified key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the bptree_node element inside the
+ *    larger struct
+ * return pointer to first tree element with greater or equal key than specified key,
+ *    NULL if no element was found
+ */
+#define bptree_find_ge_element(tree, key, element, node_element) \
+  container_of_if_notnull(bptree_find_greaterequal(tree, key), typeof(*(element)), node_element)
+
+/**
+ * This function must not be called for an empty tree
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the first element of the tree
+ *    (automatically converted to type 'element')
+ */
+#define bptree_first_element(tree, element, node_member) \
+  container_of((tree)->first->nodes[0], typeof(*(element)), node_member)
+
+/**
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the first element of the tree
+ *    (automatically converted to type 'element'),
+ *    NULL if tree is empty
+ */
+#define bptree_first_element_safe(tree, element, node_member) \
+  (bptree_is_empty(tree) ? NULL : bptree_first_element(tree, element, node_member))
+
+/**
+ * This function must not be called for an empty tree
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the last element of the tree
+ *    (automatically converted to type 'element')
+ */
+#define bptree_last_element(tree, element, node_member) \
+  container_of((tree)->last->nodes[(tree)->last->block.count - 1], typeof(*(element)), node_member)
+
+/**
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the last element of the tree
+ *    (automatically converted to type 'element'),
+ *    NULL if tree is empty
+ */
+#define bptree_last_element_safe(tree, element, node_member) \
+  (bptree_is_empty(tree) ? NULL : bptree_last_element(tree, element, node_member))
+
+/**
+ * @param element pointer to a node of the tree
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the node after 'element'
+ *    (automatically converted to type 'element'),
+ *    NULL if 'element' is the last one
+ */
+#define bptree_next_element(element, node_member) \
+  container_of_if_notnull(bptree_next_node(&(element)->node_member), typeof(*(element)), node_member)
+
+/**
+ * @param element pointer to a node of the tree
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @return pointer to the node before 'element'
+ *    (automatically converted to type 'element'),
+ *    NULL if 'element' is the first one
+ */
+#define bptree_prev_element(element, node_member) \
+  container_of_if_notnull(bptree_prev_node(&(element)->node_member), typeof(*(element)), node_member)
+
+/**
+ * Loop over all elements of a B+-tree, used similar to a for() command.
+ * This loop should not be used if elements are removed from the tree during
+ * the loop.
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node of the tree, this element will
+ *    contain the current node of the tree during the loop
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ */
+#define bptree_for_each_element(tree, element, node_member) \
+  for (struct bptree_cursor _BPTREE_CURSOR = { (tree)->first, 0 }; \
+       (element = container_of_if_notnull( \
+           bptree_cursor_get(&_BPTREE_CURSOR), typeof(*(element)), node_member)) != NULL; \
+       bptree_cursor_next(&_BPTREE_CURSOR))
+
+/**
+ * Loop over all elements of a B+-tree backwards, used similar to a for() command.
+ * This loop should not be used if elements are removed from the tree during
+ * the loop.
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node of the tree, this element will
+ *    contain the current node of the tree during the loop
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ */
+#define bptree_for_each_element_reverse(tree, element, node_member) \
+  for (struct bptree_cursor _BPTREE_CURSOR = \
+           { (tree)->last, bptree_is_empty(tree) ? 0u : (tree)->last->block.count - 1u }; \
+       (element = container_of_if_notnull( \
+           bptree_cursor_get(&_BPTREE_CURSOR), typeof(*(element)), node_member)) != NULL; \
+       bptree_cursor_prev(&_BPTREE_CURSOR))
+
+/**
+ * Loop over all elements of a B+-tree, used similar to a for() command.
+ * This loop can be used if the current element might be removed from
+ * the tree during the loop. Other elements should not be removed during
+ * the loop.
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node of the tree, this element will
+ *    contain the current node of the tree during the loop
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @param ptr pointer to a tree element which is used to store
+ *    the next node during the loop
+ */
+#define bptree_for_each_element_safe(tree, element, node_member, ptr) \
+  for (element = bptree_first_element_safe(tree, element, node_member), \
+       ptr = element == NULL ? NULL : bptree_next_element(element, node_member); \
+       element != NULL; \
+       element = ptr, ptr = element == NULL ? NULL : bptree_next_element(element, node_member))
+
+/**
+ * Loop over all elements of a B+-tree backwards, used similar to a for() command.
+ * This loop can be used if the current element might be removed from
+ * the tree during the loop. Other elements should not be removed during
+ * the loop.
+ *
+ * @param tree pointer to B+-tree
+ * @param element pointer to a node of the tree, this element will
+ *    contain the current node of the tree during the loop
+ * @param node_member name of the bptree_node element inside the
+ *    larger struct
+ * @param ptr pointer to a tree element which is used to store
+ *    the previous node during the loop
+ */
+#define bptree_for_each_element_reverse_safe(tree, element, node_member, ptr) \
+  for (element = bptree_last_element_safe(tree, element, node_member), \
+       ptr = element == NULL ? NULL : bptree_prev_element(element, node_member); \
+       element != NULL; \
+       element = ptr, ptr = element == NULL ? NULL : bptree_prev_element(element, node_member))
+
+#endif /* BPTREE_H_ */
@@ -0,0 +1,391 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/hash.h"
+
+enum {
+  /*! minimal number of slots of an allocated table */
+  HASH_MIN_SIZE = 8,
+
+  /*! number of old slots migrated by every insert/remove during a resize */
+  HASH_MIGRATE_STEP = 8,
+};
+
+static int _start_resize(struct hash_table *table, uint32_t new_size);
+static void _migrate(struct hash_table *table, uint32_t steps);
+static void _finish_migration(struct hash_table *table);
+static struct hash_slot *_find_slot(struct hash_slot *slots, uint32_t size,
+    uint32_t hash, const void *key, int (*comp)(const void *, const void *));
+static struct hash_slot *_find_node_slot(struct hash_slot *slots, uint32_t size,
+    const struct hash_node *node);
+static void _add_slot(struct hash_table *table, struct hash_node *node, uint32_t hash);
+static uint32_t _get_size(uint32_t count);
+static bool _is_overloaded(const struct hash_table *table);
+
+/* marker for deleted slots, keeps probe sequences intact */
+static struct hash_node _deleted_node;
+
+/**
+ * Initialize a new hash table struct. No memory is allocated
+ * until the first node is inserted.
+ * @param table pointer to hash table
+ * @param hash pointer to hash function for the keys
+ * @param comp pointer to comparator for the keys, only
+ *   equality is evaluated
+ */
+void
+hash_init(struct hash_table *table,
+    uint32_t (*hash)(const void *key),
+    int (*comp)(const void *k1, const void *k2)) {
+  memset(table, 0, sizeof(*table));
+  list_init_head(&table->list_head);
+  table->hash = hash;
+  table->comp = comp;
+}
+
+/**
+ * Release the memory allocated by a hash table and reset it
+ * to an empty table. The nodes of the table are not touched,
+ * so they should be removed (or freed) before.
+ * @param table pointer to hash table
+ */
+void
+hash_free(struct hash_table *table) {
+  free(table->_slots);
+  free(table->_old_slots);
+
+  hash_init(table, table->hash, table->comp);
+}
+
+/**
+ * Finds a node in a hash table with a certain key
+ * @param table pointer to hash table
+ * @param key pointer to key
+ * @return pointer to hash node with key, NULL if no node with
+ *    this key exists.
+ */
+struct hash_node *
+hash_find(const struct hash_table *table, const void *key) {
+  struct hash_slot *slot;
+  uint32_t hash;
+
+  if (table->count == 0) {
+    return NULL;
+  }
+
+  hash = table->hash(key);
+
+  slot = _find_slot(table->_slots, table->_size, hash, key, table->comp);
+  if (slot == NULL && table->_old_slots != NULL) {
+    slot = _find_slot(table->_old_slots, table->_old_size, hash, key, table->comp);
+  }
+  return slot == NULL ? NULL : slot->node;
+}
+
+/**
+ * Inserts a hash node into a hash table. The key pointer
+ * of the node must be set before.
+ * @param table pointer to hash table
+ * @param node pointer to node
+ * @return 0 if node was inserted, -1 if a node with the same key
+ *   is already in the table or no memory was available
+ */
+int
+hash_insert(struct hash_table *table, struct hash_node *node) {
+  uint32_t hash;
+
+  hash = table->hash(node->key);
+  if (table->count > 0
+      && (_find_slot(table->_slots, table->_size, hash, node->key, table->comp) != NULL
+          || (table->_old_slots != NULL
+              && _find_slot(table->_old_slots, table->_old_size,
+                  hash, node->key, table->comp) != NULL))) {
+    return -1;
+  }
+
+  _migrate(table, HASH_MIGRATE_STEP);
+
+  if (_is_overloaded(table)
+      && _start_resize(table, _get_size(table->count + 1))
+      && table->_used + table->_deleted + 1 >= table->_size) {
+    /* no memory for a larger table and no free slot left */
+    return -1;
+  }
+
+  node->_hash = hash;
+  _add_slot(table, node, hash);
+
+  list_add_tail(&table->list_head, &node->list);
+  table->count++;
+  return 0;
+}
+
+/**
+ * Removes a hash node from a hash table
+ * @param table pointer to hash table
+ * @param node pointer to node
+ */
+void
+hash_remove(struct hash_table *table, struct hash_node *node) {
+  struct hash_slot *slot;
+
+  slot = _find_node_slot(table->_slots, table->_size, node);
+  if (slot != NULL) {
+    table->_used--;
+    table->_deleted++;
+  }
+  else if (table->_old_slots != NULL) {
+    slot = _find_node_slot(table->_old_slots, table->_old_size, node);
+    if (slot != NULL) {
+      table->_old_used--;
+    }
+  }
+  if (slot == NULL) {
+    /* node is not part of this table */
+    return;
+  }
+
+  slot->node = &_deleted_node;
+
+  list_remove(&node->list);
+  table->count--;
+
+  _migrate(table, HASH_MIGRATE_STEP);
+
+  /* shrink table if it gets too empty */
+  if (table->_old_slots == NULL && table->_size > HASH_MIN_SIZE
+      && table->count * 8 < table->_size) {
+    _start_resize(table, _get_size(table->count));
+  }
+}
+
+/**
+ * Start to migrate the content of a hash table into a new slot array.
+ * A running migration will be finished first.
+ * @param table pointer to hash table
+ * @param new_size number of slots of the new array
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_start_resize(struct hash_table *table, uint32_t new_size) {
+  struct hash_slot *slots;
+
+  _finish_migration(table);
+
+  slots = calloc(new_size, sizeof(*slots));
+  if (slots == NULL) {
+    return -1;
+  }
+
+  if (table->_used > 0) {
+    table->_old_slots = table->_slots;
+    table->_old_size = table->_size;
+    table->_old_used = table->_used;
+    table->_migrate_idx = 0;
+  }
+  else {
+    free(table->_slots);
+  }
+
+  table->_slots = slots;
+  table->_size = new_size;
+  table->_used = 0;
+  table->_deleted = 0;
+  return 0;
+}
+
+/**
+ * Migrate a number of slots from the old slot array into the new one
+ * @param table pointer to hash table
+ * @param steps number of old slots to migrate
+ */
+static void
+_migrate(struct hash_table *table, uint32_t steps) {
+  struct hash_slot *slot;
+
+  if (table->_old_slots == NULL) {
+    return;
+  }
+
+  while (steps-- > 0 && table->_migrate_idx < table->_old_size) {
+    slot = &table->_old_slots[table->_migrate_idx++];
+
+    if (slot->node != NULL && slot->node != &_deleted_node) {
+      _add_slot(table, slot->node, slot->hash);
+      table->_old_used--;
+
+      /* keep the probe sequence of the old array intact */
+      slot->node = &_deleted_node;
+    }
+  }
+
+  if (table->_migrate_idx == table->_old_size || table->_old_used == 0) {
+    free(table->_old_slots);
+    table->_old_slots = NULL;
+    table->_old_size = 0;
+    table->_old_used = 0;
+    table->_migrate_idx = 0;
+  }
+}
+
+/**
+ * Migrate all remaining slots of the old slot array
+ * @param table pointer to hash table
+ */
+static void
+_finish_migration(struct hash_table *table) {
+  if (table->_old_slots != NULL) {
+    _migrate(table, table->_old_size - table->_migrate_idx);
+  }
+}
+
+/**
+ * Find the slot of a key in a slot array
+ * @param slots pointer to slot array
+ * @param size number of slots
+ * @param hash hash value of key
+ * @param key pointer to key
+ * @param comp key comparator
+ * @return pointer to slot, NULL if not found
+ */
+static struct hash_slot *
+_find_slot(struct hash_slot *slots, uint32_t size,
+    uint32_t hash, const void *key, int (*comp)(const void *, const void *)) {
+  uint32_t idx, mask;
+
+  if (size == 0) {
+    return NULL;
+  }
+
+  mask = size - 1;
+  for (idx = hash & mask; slots[idx].node != NULL; idx = (idx + 1) & mask) {
+    if (slots[idx].hash == hash && slots[idx].node != &_deleted_node
+        && comp(key, slots[idx].node->key) == 0) {
+      return &slots[idx];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Find the slot of a node in a slot array
+ * @param slots pointer to slot array
+ * @param size number of slots
+ * @param node pointer to hash node
+ * @return pointer to slot, NULL if not found
+ */
+static struct hash_slot *
+_find_node_slot(struct hash_slot *slots, uint32_t size,
+    const struct hash_node *node) {
+  uint32_t idx, mask;
+
+  if (size == 0) {
+    return NULL;
+  }
+
+  mask = size - 1;
+  for (idx = node->_hash & mask; slots[idx].node != NULL; idx = (idx + 1) & mask) {
+    if (slots[idx].node == node) {
+      return &slots[idx];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Put a node into the first free or deleted slot of its probe
+ * sequence in the current slot array. The array must not be full.
+ * @param table pointer to hash table
+ * @param node pointer to hash node
+ * @param hash hash value of the nodes key
+ */
+static void
+_add_slot(struct hash_table *table, struct hash_node *node, uint32_t hash) {
+  uint32_t idx, mask;
+
+  mask = table->_size - 1;
+  for (idx = hash & mask; table->_slots[idx].node != NULL; idx = (idx + 1) & mask) {
+    if (table->_slots[idx].node == &_deleted_node) {
+      table->_deleted--;
+      break;
+    }
+  }
+
+  table->_slots[idx].node = node;
+  table->_slots[idx].hash = hash;
+  table->_used++;
+}
+
+/**
+ * @param count number of nodes
+ * @return number of slots for a freshly resized table
+ */
+static uint32_t
+_get_size(uint32_t count) {
+  uint32_t size = HASH_MIN_SIZE;
+
+  /* fill new tables to less than 50 percent */
+  while (size < count * 2 + 1) {
+    size *= 2;
+  }
+  return size;
+}
+
+/**
+ * Nodes which still have to be migrated are counted too, so a
+ * running migration can always be finished into the current array.
+ * @param table pointer to hash table
+ * @return true if the current slot array cannot take another
+ *   node without exceeding its maximum load of 75 percent
+ */
+static bool
+_is_overloaded(const struct hash_table *table) {
+  return (table->_used + table->_deleted + table->_old_used + 1) * 4 > table->_size * 3;
+}
@@ -0,0 +1,345 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Intrusive hash table for exact-match lookups.
+ *
+ * The table is an open addressing (linear probing) array of pointers
+ * to hash_nodes embedded into the stored objects, together with the
+ * cached hash value of each key. All nodes are also kept in a linked
+ * list (in insertion order) to allow iteration with the same kind of
+ * macros as the avl tree.
+ *
+ * Resizing is done incrementally: when the table has to grow (or
+ * shrink) a new array is allocated and each following insert or remove
+ * moves a few nodes from the old array to the new one, so no single
+ * operation has to rehash the whole table.
+ *
+ * The table can use the avl comparators from avl_comp.h, only the
+ * equality (return value 0) of keys is evaluated.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <stddef.h>
+
+#include "common/common_types.h"
+#include "common/container_of.h"
+#include "common/list.h"
+
+/**
+ * This element is a member of a hash table. It must be contained in all
+ * larger structs that should be put into a hash table.
+ */
+struct hash_node {
+  /**
+   * Linked list node for supporting iteration over all elements.
+   *
+   * this must be the first element of a hash_node to
+   * make casting for lists easier
+   */
+  struct list_entity list;
+
+  /**
+   * pointer to key of node
+   */
+  const void *key;
+
+  /**
+   * hash value of key, set by hash_insert()
+   */
+  uint32_t _hash;
+};
+
+/**
+ * One slot of the open addressing array of a hash table
+ */
+struct hash_slot {
+  /*! pointer to hash node, NULL if slot is empty */
+  struct hash_node *node;
+
+  /*! cached hash value of the nodes key */
+  uint32_t hash;
+};
+
+/**
+ * This struct is the central management part of a hash table.
+ * One of them is necessary for each hash table.
+ */
+struct hash_table {
+  /**
+   * Head of linked list node for supporting easy iteration
+   */
+  struct list_entity list_head;
+
+  /**
+   * number of nodes in the hash table
+   */
+  uint32_t count;
+
+  /**
+   * Prototype for hash functions
+   * @param key pointer to key
+   * @return hash value of key
+   */
+  uint32_t (*hash)(const void *key);
+
+  /**
+   * Prototype for key comparators
+   * @param k1 first key
+   * @param k2 second key
+   * @return 0 if k1 and k2 are equal, non-zero otherwise
+   */
+  int (*comp)(const void *k1, const void *k2);
+
+  /*! slot array, NULL if no memory has been allocated yet */
+  struct hash_slot *_slots;
+
+  /*! number of slots, always zero or a power of two */
+  uint32_t _size;
+
+  /*! number of slots used by nodes */
+  uint32_t _used;
+
+  /*! number of slots marked as deleted */
+  uint32_t _deleted;
+
+  /*! slot array which is migrated into _slots, NULL if no resize is running */
+  struct hash_slot *_old_slots;
+
+  /*! number of slots of the old array */
+  uint32_t _old_size;
+
+  /*! number of nodes in the old array which still have to be migrated */
+  uint32_t _old_used;
+
+  /*! index of the next slot of the old array to be migrated */
+  uint32_t _migrate_idx;
+};
+
+EXPORT void hash_init(struct hash_table *,
+    uint32_t (*hash)(const void *key),
+    int (*comp)(const void *k1, const void *k2));
+EXPORT void hash_free(struct hash_table *);
+EXPORT struct hash_node *hash_find(const struct hash_table *, const void *key);
+EXPORT int hash_insert(struct hash_table *, struct hash_node *);
+EXPORT void hash_remove(struct hash_table *, struct hash_node *);
+
+/**
+ * @param table pointer to hash table
+ * @return true if the table is empty, false otherwise
+ */
+static INLINE bool
+hash_is_empty(const struct hash_table *table) {
+  return table->count == 0;
+}
+
+/**
+ * @param node pointer to hash node
+ * @return true if node is currently in a hash table, false otherwise
+ */
+static INLINE bool
+hash_is_node_added(struct hash_node *node) {
+  return list_is_node_added(&node->list);
+}
+
+/**
+ * @param table pointer to hash table
+ * @param key pointer to key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_element name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to table element with the specified key,
+ *    NULL if no element was found
+ */
+#define hash_find_element(table, key, element, node_element) \
+  container_of_if_notnull(hash_find(table, key), typeof(*(element)), node_element)
+
+/**
+ * This function must not be called for an empty table
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the first element of the hash table
+ *    (automatically converted to type 'element')
+ */
+#define hash_first_element(table, element, node_member) \
+  list_first_element(&(table)->list_head, element, node_member.list)
+
+/**
+ * @param table pointer to hash table
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the first element of the hash table
+ *    (automatically converted to type 'element'),
+ *    NULL if table is empty
+ */
+#define hash_first_element_safe(table, element, node_member) \
+  (hash_is_empty(table) ? NULL : hash_first_element(table, element, node_member))
+
+/**
+ * This function must not be called for an empty table
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the last element of the hash table
+ *    (automatically converted to type 'element')
+ */
+#define hash_last_element(table, element, node_member) \
+  list_last_element(&(table)->list_head, element, node_member.list)
+
+/**
+ * @param table pointer to hash table
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the last element of the hash table
+ *    (automatically converted to type 'element'),
+ *    NULL if table is empty
+ */
+#define hash_last_element_safe(table, element, node_member) \
+  (hash_is_empty(table) ? NULL : hash_last_element(table, element, node_member))
+
+/**
+ * This function must not be called for the last element of
+ * a hash table
+ *
+ * @param element pointer to a node of the table
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the node after 'element'
+ *    (automatically converted to type 'element')
+ */
+#define hash_next_element(element, node_member) \
+  list_next_element(element, node_member.list)
+
+/**
+ * This function must not be called for the first element of
+ * a hash table
+ *
+ * @param element pointer to a node of the table
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @return pointer to the node before 'element'
+ *    (automatically converted to type 'element')
+ */
+#define hash_prev_element(element, node_member) \
+  list_prev_element(element, node_member.list)
+
+/**
+ * Loop over all elements of a hash table in insertion order, used
+ * similar to a for() command.
+ * This loop should not be used if elements are removed from the table
+ * during the loop.
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node of the table, this element will
+ *    contain the current node of the table during the loop
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ */
+#define hash_for_each_element(table, element, node_member) \
+  list_for_each_element(&(table)->list_head, element, node_member.list)
+
+/**
+ * Loop over all elements of a hash table backwards, used similar
+ * to a for() command.
+ * This loop should not be used if elements are removed from the table
+ * during the loop.
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node of the table, this element will
+ *    contain the current node of the table during the loop
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ */
+#define hash_for_each_element_reverse(table, element, node_member) \
+  list_for_each_element_reverse(&(table)->list_head, element, node_member.list)
+
+/**
+ * Loop over all elements of a hash table, used similar to a for() command.
+ * This loop can be used if the current element might be removed from
+ * the table during the loop. Other elements should not be removed during
+ * the loop.
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node of the table, this element will
+ *    contain the current node of the table during the loop
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @param ptr pointer to a table element which is used to store
+ *    the next node during the loop
+ */
+#define hash_for_each_element_safe(table, element, node_member, ptr) \
+  list_for_each_element_safe(&(table)->list_head, element, node_member.list, ptr)
+
+/**
+ * Loop over all elements of a hash table backwards, used similar
+ * to a for() command.
+ * This loop can be used if the current element might be removed from
+ * the table during the loop. Other elements should not be removed during
+ * the loop.
+ *
+ * @param table pointer to hash table
+ * @param element pointer to a node of the table, this element will
+ *    contain the current node of the table during the loop
+ * @param node_member name of the hash_node element inside the
+ *    larger struct
+ * @param ptr pointer to a table element which is used to store
+ *    the previous node during the loop
+ */
+#define hash_for_each_element_reverse_safe(table, element, node_member, ptr) \
+  list_for_each_element_reverse_safe(&(table)->list_head, element, node_member.list, ptr)
+
+#endif /* HASH_H_ */
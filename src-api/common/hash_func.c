@@ -0,0 +1,134 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <ctype.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/hash_func.h"
+#include "common/netaddr.h"
+
+/* FNV-1a parameters for 32 bit */
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME        16777619u
+
+/**
+ * 64 bit finalizer of MurmurHash3, distributes every input bit
+ * over the whole result
+ * @param value input value
+ * @return mixed value, truncated to 32 bit
+ */
+static INLINE uint32_t
+_mix64(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return (uint32_t)value;
+}
+
+/**
+ * Hash function for unsigned 32 bit integers,
+ * fits to avl_comp_uint32()
+ * @param key pointer to key
+ * @return hash value
+ */
+uint32_t
+hash_func_uint32(const void *key) {
+  const uint32_t *u = key;
+
+  return _mix64(*u);
+}
+
+/**
+ * Hash function for netaddr objects, fits to avl_comp_netaddr()
+ * @param key pointer to key
+ * @return hash value
+ */
+uint32_t
+hash_func_netaddr(const void *key) {
+  const struct netaddr *addr = key;
+  uint64_t w1, w2;
+
+  memcpy(&w1, &addr->_addr[0], sizeof(w1));
+  memcpy(&w2, &addr->_addr[8], sizeof(w2));
+
+  w2 ^= ((uint64_t)addr->_type << 8) | addr->_prefix_len;
+  return _mix64(w1 * 0x9e3779b97f4a7c15ull ^ w2);
+}
+
+/**
+ * Hash function for zero terminated strings, fits to strcmp()
+ * @param key pointer to key
+ * @return hash value
+ */
+uint32_t
+hash_func_string(const void *key) {
+  const unsigned char *ptr;
+  uint32_t hash = FNV_OFFSET_BASIS;
+
+  for (ptr = key; *ptr; ptr++) {
+    hash = (hash ^ *ptr) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * Case insensitive hash function for zero terminated strings,
+ * fits to avl_comp_strcasecmp()
+ * @param key pointer to key
+ * @return hash value
+ */
+uint32_t
+hash_func_strcase(const void *key) {
+  const unsigned char *ptr;
+  uint32_t hash = FNV_OFFSET_BASIS;
+
+  for (ptr = key; *ptr; ptr++) {
+    hash = (hash ^ (unsigned char)tolower(*ptr)) * FNV_PRIME;
+  }
+  return hash;
+}
@@ -789,7 +789,7 @@ netaddr_cmp_to_socket(const struct netaddr *a1, const union netaddr_socket *a2)
   }
   else if (a1->_type == AF_INET6) {
     /* ipv6 */
-    result = memcmp(a1->_addr, &a2->v6.sin6_addr, 16);
+    result = netaddr_kernel_cmp(a1->_addr, &a2->v6.sin6_addr);
   }
 
   if (result) {
@@ -822,6 +822,9 @@ netaddr_isequal_binary(const struct netaddr *addr,
     return false;
   }
 
+  if (addr_len == NETADDR_KERNEL_LENGTH) {
+    return netaddr_kernel_isequal(addr->_addr, bin);
+  }
   return memcmp(addr->_addr, bin, addr_len) == 0;
 }
 
@@ -836,10 +839,18 @@ netaddr_isequal_binary(const struct netaddr *addr,
 bool
 netaddr_binary_is_in_subnet(const struct netaddr *subnet,
     const void *bin, size_t len, uint8_t af_family) {
+  uint8_t padded[NETADDR_KERNEL_LENGTH];
+
   if (subnet->_type != af_family
       || netaddr_get_maxprefix(subnet) != len * 8) {
     return false;
   }
+  if (len < sizeof(padded)) {
+    /* kernels always read 16 bytes */
+    memcpy(padded, bin, len);
+    memset(&padded[len], 0, sizeof(padded) - len);
+    bin = padded;
+  }
   return _binary_is_in_subnet(subnet, bin);
 }
 
@@ -1104,29 +1115,10 @@ _subnetmask_to_prefixlen(const char *src) {
  * It will assume that the length of the binary address and its
  * address family makes sense.
  * @param addr netaddr prefix
- * @param bin pointer to binary address
+ * @param bin pointer to binary address, padded to 16 bytes
  * @return true if part of the prefix, false otherwise
  */
 static bool
 _binary_is_in_subnet(const struct netaddr *subnet, const void *bin) {
-  size_t byte_length, bit_length;
-  const uint8_t *_bin;
-
-  _bin = bin;
-
-  /* split prefix length into whole bytes and bit rest */
-  byte_length = subnet->_prefix_len / 8;
-  bit_length = subnet->_prefix_len % 8;
-
-  /* compare whole bytes */
-  if (memcmp(subnet->_addr, bin, byte_length) != 0) {
-    return false;
-  }
-
-  /* compare bits if necessary */
-  if (bit_length != 0) {
-    return (subnet->_addr[byte_length] >> (8 - bit_length))
-        == (_bin[byte_length] >> (8 - bit_length));
-  }
-  return true;
+  return netaddr_kernel_is_in_prefix(subnet->_addr, bin, subnet->_prefix_len);
 }
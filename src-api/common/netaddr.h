@@ -64,6 +64,7 @@
 
 #include "common/common_types.h"
 #include "common/autobuf.h"
+#include "common/netaddr_kernel.h"
 
 enum {
   /*! address family for 48-bit mac address */
@@ -333,7 +334,28 @@ netaddr_from_binary(struct netaddr *dst, const void *binary,
  */
 static INLINE int
 netaddr_cmp(const struct netaddr *a1, const struct netaddr *a2) {
-  return memcmp(a1, a2, sizeof(*a1));
+  int result;
+
+  result = netaddr_kernel_cmp(a1->_addr, a2->_addr);
+  if (result) {
+    return result;
+  }
+  if (a1->_type != a2->_type) {
+    return (int)a1->_type - (int)a2->_type;
+  }
+  return (int)a1->_prefix_len - (int)a2->_prefix_len;
+}
+
+/**
+ * Calculates the number of leading bits two addresses have in common.
+ * Address type and prefix length are ignored.
+ * @param a1 address 1
+ * @param a2 address 2
+ * @return common prefix length in bits
+ */
+static INLINE int
+netaddr_get_common_prefix(const struct netaddr *a1, const struct netaddr *a2) {
+  return netaddr_kernel_common_prefix(a1->_addr, a2->_addr);
 }
 
 /**
@@ -0,0 +1,329 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Kernels for comparing the 16 byte binary part of netaddr objects.
+ *
+ * Each kernel exists as a portable scalar variant working on two
+ * 64 bit words and (if the compiler targets it) as a SSE2 or NEON
+ * variant. The netaddr_kernel_*() functions dispatch to the fastest
+ * variant available at compile time, SSE2 and NEON are part of the
+ * baseline of x86-64 and AArch64 so no runtime detection is necessary.
+ * Use tests/common/benchmark_common_netaddr to compare the variants.
+ *
+ * All kernels read exactly NETADDR_KERNEL_LENGTH bytes from both
+ * pointers, callers with shorter addresses must pad them.
+ */
+
+#ifndef NETADDR_KERNEL_H_
+#define NETADDR_KERNEL_H_
+
+#include <string.h>
+
+#include "common/common_types.h"
+
+#if !defined(NETADDR_KERNEL_FORCE_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+/*! netaddr kernels use SSE2 */
+#define NETADDR_KERNEL_SSE2
+#elif !defined(NETADDR_KERNEL_FORCE_SCALAR) \
+    && (defined(__ARM_NEON) || defined(__ARM_NEON__)) \
+    && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_neon.h>
+/*! netaddr kernels use NEON */
+#define NETADDR_KERNEL_NEON
+#endif
+
+enum {
+  /*! number of bytes processed by a netaddr kernel */
+  NETADDR_KERNEL_LENGTH = 16,
+};
+
+#if defined(NETADDR_KERNEL_SSE2)
+/*! name of the kernel variant selected at compile time */
+#define NETADDR_KERNEL_NAME "sse2"
+#elif defined(NETADDR_KERNEL_NEON)
+#define NETADDR_KERNEL_NAME "neon"
+#else
+#define NETADDR_KERNEL_NAME "scalar"
+#endif
+
+/**
+ * Load 8 bytes as a big endian 64 bit integer
+ * @param ptr pointer to 8 bytes of memory, no alignment necessary
+ * @return integer in host byte order
+ */
+static INLINE uint64_t
+_netaddr_kernel_load_be64(const void *ptr) {
+  uint64_t value;
+
+  memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+/**
+ * Compare two binary addresses for equality (scalar variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return true if both addresses are equal
+ */
+static INLINE bool
+netaddr_kernel_scalar_isequal(const void *a1, const void *a2) {
+  const uint8_t *p1 = a1, *p2 = a2;
+
+  return ((_netaddr_kernel_load_be64(p1) ^ _netaddr_kernel_load_be64(p2))
+      | (_netaddr_kernel_load_be64(p1 + 8) ^ _netaddr_kernel_load_be64(p2 + 8))) == 0;
+}
+
+/**
+ * Compare two binary addresses in network byte order (scalar variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return >0 if a1>a2, <0 if a1<a2, 0 otherwise
+ */
+static INLINE int
+netaddr_kernel_scalar_cmp(const void *a1, const void *a2) {
+  const uint8_t *p1 = a1, *p2 = a2;
+  uint64_t w1, w2;
+
+  w1 = _netaddr_kernel_load_be64(p1);
+  w2 = _netaddr_kernel_load_be64(p2);
+  if (w1 == w2) {
+    w1 = _netaddr_kernel_load_be64(p1 + 8);
+    w2 = _netaddr_kernel_load_be64(p2 + 8);
+  }
+  if (w1 < w2) {
+    return -1;
+  }
+  return w1 > w2 ? 1 : 0;
+}
+
+/**
+ * Calculate the number of leading bits two binary addresses
+ * have in common (scalar variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return common prefix length in bits (0-128)
+ */
+static INLINE int
+netaddr_kernel_scalar_common_prefix(const void *a1, const void *a2) {
+  const uint8_t *p1 = a1, *p2 = a2;
+  uint64_t diff;
+
+  diff = _netaddr_kernel_load_be64(p1) ^ _netaddr_kernel_load_be64(p2);
+  if (diff) {
+    return __builtin_clzll(diff);
+  }
+  diff = _netaddr_kernel_load_be64(p1 + 8) ^ _netaddr_kernel_load_be64(p2 + 8);
+  if (diff) {
+    return 64 + __builtin_clzll(diff);
+  }
+  return 128;
+}
+
+#if defined(NETADDR_KERNEL_SSE2) || defined(NETADDR_KERNEL_NEON)
+/**
+ * Calculate a bitmask of the bytes which differ between two
+ * binary addresses.
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return mask with one bit (SSE2) or four bits (NEON) per
+ *   differing byte, lowest bits belong to the first byte
+ */
+static INLINE uint64_t
+_netaddr_kernel_diffmask(const void *a1, const void *a2) {
+#if defined(NETADDR_KERNEL_SSE2)
+  __m128i eq;
+
+  eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a1),
+      _mm_loadu_si128((const __m128i *)a2));
+  return (~(unsigned)_mm_movemask_epi8(eq)) & 0xffff;
+#else
+  uint8x16_t eq;
+  uint8x8_t nibbles;
+
+  eq = vceqq_u8(vld1q_u8(a1), vld1q_u8(a2));
+
+  /* narrow every byte of the compare result into four bits */
+  nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+  return ~vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+#endif
+}
+
+/**
+ * @param mask result of _netaddr_kernel_diffmask(), must not be zero
+ * @return index of the first differing byte
+ */
+static INLINE int
+_netaddr_kernel_first_diff(uint64_t mask) {
+#if defined(NETADDR_KERNEL_SSE2)
+  return __builtin_ctzll(mask);
+#else
+  return __builtin_ctzll(mask) >> 2;
+#endif
+}
+
+/**
+ * Compare two binary addresses for equality (vector variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return true if both addresses are equal
+ */
+static INLINE bool
+netaddr_kernel_vector_isequal(const void *a1, const void *a2) {
+  return _netaddr_kernel_diffmask(a1, a2) == 0;
+}
+
+/**
+ * Compare two binary addresses in network byte order (vector variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return >0 if a1>a2, <0 if a1<a2, 0 otherwise
+ */
+static INLINE int
+netaddr_kernel_vector_cmp(const void *a1, const void *a2) {
+  const uint8_t *p1 = a1, *p2 = a2;
+  uint64_t mask;
+  int idx;
+
+  mask = _netaddr_kernel_diffmask(a1, a2);
+  if (!mask) {
+    return 0;
+  }
+  idx = _netaddr_kernel_first_diff(mask);
+  return (int)p1[idx] - (int)p2[idx];
+}
+
+/**
+ * Calculate the number of leading bits two binary addresses
+ * have in common (vector variant)
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return common prefix length in bits (0-128)
+ */
+static INLINE int
+netaddr_kernel_vector_common_prefix(const void *a1, const void *a2) {
+  const uint8_t *p1 = a1, *p2 = a2;
+  uint64_t mask;
+  int idx;
+
+  mask = _netaddr_kernel_diffmask(a1, a2);
+  if (!mask) {
+    return 128;
+  }
+  idx = _netaddr_kernel_first_diff(mask);
+
+  /* leading zeros of the xor-ed byte inside a 32 bit word */
+  return idx * 8 + __builtin_clz((unsigned)(p1[idx] ^ p2[idx])) - 24;
+}
+#endif
+
+/**
+ * Compare two binary addresses for equality
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return true if both addresses are equal
+ */
+static INLINE bool
+netaddr_kernel_isequal(const void *a1, const void *a2) {
+#if defined(NETADDR_KERNEL_SSE2) || defined(NETADDR_KERNEL_NEON)
+  return netaddr_kernel_vector_isequal(a1, a2);
+#else
+  return netaddr_kernel_scalar_isequal(a1, a2);
+#endif
+}
+
+/**
+ * Compare two binary addresses in network byte order, the
+ * sign of the result is the same as the one of memcmp().
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return >0 if a1>a2, <0 if a1<a2, 0 otherwise
+ */
+static INLINE int
+netaddr_kernel_cmp(const void *a1, const void *a2) {
+#if defined(NETADDR_KERNEL_SSE2) || defined(NETADDR_KERNEL_NEON)
+  return netaddr_kernel_vector_cmp(a1, a2);
+#else
+  return netaddr_kernel_scalar_cmp(a1, a2);
+#endif
+}
+
+/**
+ * Calculate the number of leading bits two binary addresses
+ * have in common.
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return common prefix length in bits (0-128)
+ */
+static INLINE int
+netaddr_kernel_common_prefix(const void *a1, const void *a2) {
+  /*
+   * with native 64 bit registers byteswap and count-leading-zeros
+   * are cheaper than searching the first differing byte of the
+   * vector compare result
+   */
+#if (defined(NETADDR_KERNEL_SSE2) || defined(NETADDR_KERNEL_NEON)) && __SIZEOF_POINTER__ < 8
+  return netaddr_kernel_vector_common_prefix(a1, a2);
+#else
+  return netaddr_kernel_scalar_common_prefix(a1, a2);
+#endif
+}
+
+/**
+ * Check if the first prefix_len bits of two binary addresses
+ * are the same.
+ * @param prefix pointer to 16 byte address
+ * @param addr pointer to 16 byte address
+ * @param prefix_len number of bits to compare
+ * @return true if addr is inside the prefix, false otherwise
+ */
+static INLINE bool
+netaddr_kernel_is_in_prefix(const void *prefix, const void *addr, unsigned prefix_len) {
+  return (unsigned)netaddr_kernel_common_prefix(prefix, addr) >= prefix_len;
+}
+
+#endif /* NETADDR_KERNEL_H_ */
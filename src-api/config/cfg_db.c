@@ -90,12 +90,106 @@ void
 cfg_db_remove(struct cfg_db *db) {
   struct cfg_section_type *section, *section_it;
 
+  /* no need to record anything during removal */
+  db->_track_changes = false;
+
   CFG_FOR_ALL_SECTION_TYPES(db, section, section_it) {
     _free_sectiontype(section);
   }
+  strarray_free(&db->_changed_types);
   free(db);
 }
 
+/**
+ * (Re)start recording the section types modified in a database.
+ * The record of earlier changes is cleared.
+ * @param db pointer to configuration database
+ */
+void
+cfg_db_track_changes(struct cfg_db *db) {
+  strarray_free(&db->_changed_types);
+  db->_track_changes = true;
+  db->_all_changed = false;
+}
+
+/**
+ * Record that a section type of a database has been modified.
+ * Nothing happens if the database does not track changes.
+ * @param db pointer to configuration database
+ * @param section_type type of modified section
+ */
+void
+cfg_db_mark_changed(struct cfg_db *db, const char *section_type) {
+  if (!db->_track_changes || db->_all_changed
+      || cfg_db_is_changed(db, section_type)) {
+    return;
+  }
+
+  if (strarray_append(&db->_changed_types, section_type)) {
+    /* we lost track of the modifications */
+    db->_all_changed = true;
+  }
+}
+
+/**
+ * @param db pointer to configuration database
+ * @param section_type type of section
+ * @return true if the section type might have been modified since
+ *   the change tracking was started. Always true if the database
+ *   has no complete change record.
+ */
+bool
+cfg_db_is_changed(const struct cfg_db *db, const char *section_type) {
+  char *type;
+
+  if (!cfg_db_has_change_record(db)) {
+    return true;
+  }
+
+  CFG_FOR_ALL_CHANGED_TYPES(db, type) {
+    if (cfg_cmp_keys(type, section_type) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Move a section type including all named sections and entries
+ * from one database to another one without copying the data.
+ * An existing section type of the same name in the target database
+ * will be removed. The move is not recorded as a change in either
+ * database.
+ * @param dst pointer to target database
+ * @param src pointer to source database
+ * @param section_type type of section
+ * @return -1 if the section type did not exist in the source, 0 otherwise
+ */
+int
+cfg_db_move_sectiontype(struct cfg_db *dst, struct cfg_db *src,
+    const char *section_type) {
+  struct cfg_section_type *section, *old;
+  bool track;
+
+  section = cfg_db_find_sectiontype(src, section_type);
+  if (section == NULL) {
+    return -1;
+  }
+
+  old = cfg_db_find_sectiontype(dst, section_type);
+  if (old) {
+    track = dst->_track_changes;
+    dst->_track_changes = false;
+    _free_sectiontype(old);
+    dst->_track_changes = track;
+  }
+
+  avl_remove(&src->sectiontypes, &section->node);
+  avl_insert(&dst->sectiontypes, &section->node);
+  section->db = dst;
+  return 0;
+}
+
 /**
  * Copy parts of a configuration database into a new db
  * @param dst pointer to target db
@@ -292,6 +386,8 @@ cfg_db_set_entry_ext(struct cfg_db *db, const char *section_type,
     new_entry = true;
   }
 
+  cfg_db_mark_changed(db, section_type);
+
   if (!append) {
     strarray_free(&entry->val);
   }
@@ -461,6 +557,7 @@ cfg_db_remove_element(struct cfg_db *db, const char *section_type,
 
   strarray_for_each_element(&entry->val, ptr) {
     if (strcmp(ptr, value) == 0) {
+      cfg_db_mark_changed(db, section_type);
       strarray_remove(&entry->val, ptr);
       return 0;
     }
@@ -499,6 +596,8 @@ _alloc_section(struct cfg_db *db, const char *type) {
   section->db = db;
 
   avl_init(&section->names, cfg_avlcmp_keys, false);
+
+  cfg_db_mark_changed(db, type);
   return section;
 }
 
@@ -516,6 +615,7 @@ _free_sectiontype(struct cfg_section_type *section) {
     _free_namedsection(named);
   }
 
+  cfg_db_mark_changed(section->db, section->type);
   avl_remove(&section->db->sectiontypes, &section->node);
   free((void *)section->type);
   free(section);
@@ -548,6 +648,8 @@ _alloc_namedsection(struct cfg_section_type *section,
 
   named->section_type = section;
   avl_init(&named->entries, cfg_avlcmp_keys, false);
+
+  cfg_db_mark_changed(section->db, section->type);
   return named;
 }
 
@@ -564,6 +666,7 @@ _free_namedsection(struct cfg_named_section *named) {
     _free_entry(entry);
   }
 
+  cfg_db_mark_changed(named->section_type->db, named->section_type->type);
   avl_remove(&named->section_type->names, &named->node);
   free ((void *)named->name);
   free (named);
@@ -598,6 +701,8 @@ _alloc_entry(struct cfg_named_section *named,
   avl_insert(&named->entries, &entry->node);
 
   entry->named_section = named;
+
+  cfg_db_mark_changed(named->section_type->db, named->section_type->type);
   return entry;
 }
 
@@ -607,6 +712,8 @@ _alloc_entry(struct cfg_named_section *named,
  */
 static void
 _free_entry(struct cfg_entry *entry) {
+  cfg_db_mark_changed(entry->named_section->section_type->db,
+      entry->named_section->section_type->type);
   avl_remove(&entry->named_section->entries, &entry->node);
 
   strarray_free(&entry->val);
@@ -67,6 +67,15 @@ struct cfg_db {
 
   /*! linked schema of db */
   struct cfg_schema *schema;
+
+  /*! true if modified section types are recorded */
+  bool _track_changes;
+
+  /*! true if the change record is incomplete (out of memory) */
+  bool _all_changed;
+
+  /*! types of all sections modified since tracking was (re)started */
+  struct strarray _changed_types;
 };
 
 /**
@@ -182,6 +191,12 @@ EXPORT const struct const_strarray *cfg_db_get_schema_entry_value(
 EXPORT int cfg_db_remove_element(struct cfg_db *, const char *section_type,
     const char *section_name, const char *entry_name, const char *value);
 
+EXPORT void cfg_db_track_changes(struct cfg_db *db);
+EXPORT void cfg_db_mark_changed(struct cfg_db *db, const char *section_type);
+EXPORT bool cfg_db_is_changed(const struct cfg_db *db, const char *section_type);
+EXPORT int cfg_db_move_sectiontype(struct cfg_db *dst, struct cfg_db *src,
+    const char *section_type);
+
 /**
  * Link a configuration schema to a database
  * @param db pointer to database
@@ -192,6 +207,24 @@ cfg_db_link_schema(struct cfg_db *db, struct cfg_schema *schema) {
   db->schema = schema;
 }
 
+/**
+ * @param db pointer to database
+ * @return true if all modifications of the database since the
+ *   last call of cfg_db_track_changes() are known
+ */
+static INLINE bool
+cfg_db_has_change_record(const struct cfg_db *db) {
+  return db->_track_changes && !db->_all_changed;
+}
+
+/**
+ * Iterate over the types of all modified sections of a database.
+ * Only valid if cfg_db_has_change_record() is true.
+ * @param db configuration database
+ * @param type char pointer used as iterator variable
+ */
+#define CFG_FOR_ALL_CHANGED_TYPES(db, type) strarray_for_each_element(&(db)->_changed_types, type)
+
 /**
  * Creates a copy of a configuration database
  * @param src original database
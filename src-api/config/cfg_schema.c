@@ -100,6 +100,7 @@ cfg_schema_add(struct cfg_schema *schema) {
   avl_init(&schema->sections, cfg_avlcmp_keys, true);
   avl_init(&schema->entries, cfg_avlcmp_schemaentries, true);
   list_init_head(&schema->handlers);
+  schema->generation = 0;
 }
 
 /**
@@ -121,6 +122,7 @@ cfg_schema_add_section(struct cfg_schema *schema,
   /* hook section into global section tree */
   section->_section_node.key = section->type;
   avl_insert(&schema->sections, &section->_section_node);
+  schema->generation++;
 
   if (section->cb_delta_handler) {
     /* hook callback into global callback handler list */
@@ -175,6 +177,7 @@ cfg_schema_remove_section(struct cfg_schema *schema, struct cfg_schema_section *
   if (section->_section_node.key) {
     avl_remove(&schema->sections, &section->_section_node);
     section->_section_node.key = NULL;
+    schema->generation++;
 
     for (i=0; i<section->entry_count; i++) {
       avl_remove(&schema->entries, &section->entries[i]._node);
@@ -400,7 +403,9 @@ cfg_schema_tobin(void *target, struct cfg_named_section *named,
 }
 
 /**
- * Compare two databases with the same schema and call their change listeners
+ * Compare two databases with the same schema and call their change listeners.
+ * If the post_change database has a change record, only the section types
+ * recorded as modified are compared.
  * @param pre_change database before change
  * @param post_change database after change
  * @return -1 if databases have different schema, 0 otherwise
@@ -978,6 +983,11 @@ _handle_db_changes(struct cfg_db *pre_change, struct cfg_db *post_change, bool s
   default_section_type[1].db = post_change;
 
   list_for_each_element(&pre_change->schema->handlers, s_section, _delta_node) {
+    if (!cfg_db_is_changed(post_change, s_section->type)) {
+      /* section type is identical in both databases */
+      continue;
+    }
+
     /* get section types in both databases */
     pre_type = cfg_db_find_sectiontype(pre_change, s_section->type);
     post_type = cfg_db_find_sectiontype(post_change, s_section->type);
@@ -1096,6 +1106,7 @@ _validate_cfg_entry(struct cfg_db *db, struct cfg_section_type *section,
 
       if ((warning || do_remove) && cleanup) {
         /* illegal entry found, remove it */
+        cfg_db_mark_changed(db, section->type);
         strarray_remove_ext(&entry->val, ptr1, false);
       }
       else {
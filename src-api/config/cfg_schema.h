@@ -854,6 +854,9 @@ struct cfg_schema {
 
   /*! list of delta handlers of this schema */
   struct list_entity handlers;
+
+  /*! incremented every time a section is added or removed */
+  uint32_t generation;
 };
 
 /**
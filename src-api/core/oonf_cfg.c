@@ -73,6 +73,9 @@ static struct cfg_db *_oonf_work_db = NULL;
 static struct cfg_schema _oonf_schema;
 static bool _first_apply;
 
+/* schema generation used for the last successful apply */
+static uint32_t _applied_schema_generation;
+
 /* remember to trigger reload/commit and the running state */
 static bool _trigger_reload, _trigger_commit;
 static bool _running = true;
@@ -103,6 +106,10 @@ static struct cfg_schema_section _global_section = {
   .entry_count = ARRAYSIZE(_global_entries),
 };
 
+/* prototypes */
+static struct cfg_db *_create_incremental_workdb(struct cfg_db *old_db);
+static int _sync_rawdb(void);
+
 
 /**
  * Initializes the olsrd configuration subsystem
@@ -344,6 +351,7 @@ int
 oonf_cfg_apply(void) {
   struct cfg_db *old_db;
   struct autobuf log;
+  bool incremental;
   int result;
 
   if (abuf_init(&log)) {
@@ -377,20 +385,38 @@ oonf_cfg_apply(void) {
   /* backup old db */
   old_db = _oonf_work_db;
 
-  /* create new configuration database with correct values */
-  _oonf_work_db = cfg_db_duplicate(_oonf_raw_db);
-  if (_oonf_work_db == NULL) {
-    OONF_WARN(LOG_CONFIG, "Not enough memory for duplicating work db");
-    _oonf_work_db = old_db;
-    old_db = NULL;
-    goto apply_failed;
+  /*
+   * only the section types modified in the raw db have to be copied
+   * and compared as long as the schema stays the same
+   */
+  incremental = !_first_apply
+      && cfg_db_has_change_record(_oonf_raw_db)
+      && _applied_schema_generation == _oonf_schema.generation;
+
+  if (incremental) {
+    _oonf_work_db = _create_incremental_workdb(old_db);
+    if (_oonf_work_db == NULL) {
+      OONF_INFO(LOG_CONFIG, "Fall back to full copy of work db");
+      incremental = false;
+    }
   }
 
-  /* bind schema */
-  cfg_db_link_schema(_oonf_work_db, &_oonf_schema);
+  if (!incremental) {
+    /* create new configuration database with correct values */
+    _oonf_work_db = cfg_db_duplicate(_oonf_raw_db);
+    if (_oonf_work_db == NULL) {
+      OONF_WARN(LOG_CONFIG, "Not enough memory for duplicating work db");
+      _oonf_work_db = old_db;
+      old_db = NULL;
+      goto apply_failed;
+    }
 
-  /* remove everything not valid */
-  cfg_schema_validate(_oonf_work_db, true, false, NULL);
+    /* bind schema */
+    cfg_db_link_schema(_oonf_work_db, &_oonf_schema);
+
+    /* remove everything not valid */
+    cfg_schema_validate(_oonf_work_db, true, false, NULL);
+  }
 
   if (oonf_cfg_update_globalcfg(false)) {
     /* this should not happen at all */
@@ -417,9 +443,15 @@ oonf_cfg_apply(void) {
   _trigger_commit = false;
 
   /* now get a new working copy of the committed settings */
-  cfg_db_remove(_oonf_raw_db);
-  _oonf_raw_db = cfg_db_duplicate(_oonf_work_db);
-  cfg_db_link_schema(_oonf_raw_db, &_oonf_schema);
+  if (!incremental || _sync_rawdb()) {
+    cfg_db_remove(_oonf_raw_db);
+    _oonf_raw_db = cfg_db_duplicate(_oonf_work_db);
+    cfg_db_link_schema(_oonf_raw_db, &_oonf_schema);
+  }
+
+  /* raw db is identical to work db now, start recording changes */
+  cfg_db_track_changes(_oonf_raw_db);
+  _applied_schema_generation = _oonf_schema.generation;
 
 apply_failed:
   if (old_db) {
@@ -449,6 +481,7 @@ oonf_cfg_rollback(void) {
     _oonf_raw_db = db;
     return -1;
   }
+  cfg_db_track_changes(_oonf_raw_db);
 
   /* free old db */
   cfg_db_remove(db);
@@ -550,3 +583,69 @@ char **
 oonf_cfg_get_argv(void) {
   return _argv;
 }
+
+/**
+ * Create a new work database by copying and validating only the
+ * section types modified in the raw database. All other section
+ * types are moved over from the old work database.
+ * @param old_db current work database
+ * @return new work database, NULL if the change record was lost
+ *   or an error happened
+ */
+static struct cfg_db *
+_create_incremental_workdb(struct cfg_db *old_db) {
+  struct cfg_section_type *s_type, *s_type_it;
+  struct cfg_db *db;
+  char *type;
+
+  db = cfg_db_add();
+  if (db == NULL) {
+    return NULL;
+  }
+  cfg_db_link_schema(db, &_oonf_schema);
+  cfg_db_track_changes(db);
+
+  CFG_FOR_ALL_CHANGED_TYPES(_oonf_raw_db, type) {
+    if (cfg_db_copy_sectiontype(db, _oonf_raw_db, type)) {
+      cfg_db_remove(db);
+      return NULL;
+    }
+
+    /* section type might have been removed completely */
+    cfg_db_mark_changed(db, type);
+  }
+
+  /* remove everything not valid */
+  cfg_schema_validate(db, true, false, NULL);
+
+  if (!cfg_db_has_change_record(db)) {
+    cfg_db_remove(db);
+    return NULL;
+  }
+
+  /* unchanged section types are already validated */
+  CFG_FOR_ALL_SECTION_TYPES(old_db, s_type, s_type_it) {
+    if (!cfg_db_is_changed(db, s_type->type)) {
+      cfg_db_move_sectiontype(db, old_db, s_type->type);
+    }
+  }
+  return db;
+}
+
+/**
+ * Copy the modified section types of the work database back
+ * into the raw database.
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_sync_rawdb(void) {
+  char *type;
+
+  CFG_FOR_ALL_CHANGED_TYPES(_oonf_work_db, type) {
+    cfg_db_remove_sectiontype(_oonf_raw_db, type);
+    if (cfg_db_copy_sectiontype(_oonf_raw_db, _oonf_work_db, type)) {
+      return -1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,356 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/common_types.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_logging_async.h"
+
+/*! time in milliseconds the writer thread sleeps if it gets no wakeup */
+#define WRITER_IDLE_TIMEOUT 100
+
+static void *_writer_thread(void *);
+static void _cb_atfork_child(void);
+static int _start_writer(void);
+static void _ring_write(size_t pos, const void *data, size_t len);
+static void _ring_read(size_t pos, void *data, size_t len);
+static void _ring_fwrite(size_t pos, size_t len);
+
+/* ring buffer, positions are running counters masked by the ring size */
+static char *_ring;
+static size_t _ring_head;
+static size_t _ring_tail;
+
+/* number of logging events that did not fit into the ring */
+static uint64_t _dropped;
+
+/* state of the writer thread */
+static FILE *_file;
+static pthread_t _writer;
+static bool _active, _stop, _atfork_registered;
+
+/* used to wake up the idle writer thread */
+static pthread_mutex_t _wakeup_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _wakeup_cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * Start a background thread that writes all logging events
+ * given to the oonf_log_file_async() handler into a file
+ * @param f file for logging output
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+oonf_log_async_start(FILE *f) {
+  if (_active) {
+    return -1;
+  }
+
+  _ring = malloc(OONF_LOG_ASYNC_RING_SIZE);
+  if (!_ring) {
+    return -1;
+  }
+
+  if (!_atfork_registered) {
+    /* the writer thread does not survive a fork into background */
+    if (pthread_atfork(NULL, NULL, _cb_atfork_child)) {
+      free(_ring);
+      _ring = NULL;
+      return -1;
+    }
+    _atfork_registered = true;
+  }
+
+  _file = f;
+  _ring_head = 0;
+  _ring_tail = 0;
+  _dropped = 0;
+
+  if (_start_writer()) {
+    free(_ring);
+    _ring = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Write all remaining logging events and stop the writer thread
+ */
+void
+oonf_log_async_stop(void) {
+  if (!_active) {
+    return;
+  }
+
+  pthread_mutex_lock(&_wakeup_mutex);
+  __atomic_store_n(&_stop, true, __ATOMIC_RELEASE);
+  pthread_cond_signal(&_wakeup_cond);
+  pthread_mutex_unlock(&_wakeup_mutex);
+
+  pthread_join(_writer, NULL);
+  _active = false;
+
+  free(_ring);
+  _ring = NULL;
+  _file = NULL;
+}
+
+/**
+ * @return true if the asynchronous writer is running
+ */
+bool
+oonf_log_async_is_active(void) {
+  return _active;
+}
+
+/**
+ * @return number of logging events dropped because the ring buffer
+ *   was full
+ */
+uint64_t
+oonf_log_async_get_dropped(void) {
+  return __atomic_load_n(&_dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * Logger for file output through the asynchronous writer thread.
+ * Falls back to synchronous output if the writer is not running.
+ * @param entry logging handler
+ * @param param logging parameter set
+ */
+void
+oonf_log_file_async(struct oonf_log_handler_entry *entry,
+    struct oonf_log_parameters *param) {
+  size_t head, tail, len, total;
+  uint32_t record_len;
+
+  if (!_active) {
+    oonf_log_file(entry, param);
+    return;
+  }
+
+  len = strlen(param->buffer);
+  record_len = len + 1;
+  total = sizeof(record_len) + record_len;
+
+  head = _ring_head;
+  tail = __atomic_load_n(&_ring_tail, __ATOMIC_ACQUIRE);
+  if (total > OONF_LOG_ASYNC_RING_SIZE - (head - tail)) {
+    /* writer is too slow, do not block the caller */
+    __atomic_fetch_add(&_dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  _ring_write(head, &record_len, sizeof(record_len));
+  _ring_write(head + sizeof(record_len), param->buffer, len);
+  _ring_write(head + sizeof(record_len) + len, "\n", 1);
+
+  /* publish record to writer thread */
+  __atomic_store_n(&_ring_head, head + total, __ATOMIC_RELEASE);
+  pthread_cond_signal(&_wakeup_cond);
+}
+
+/**
+ * Create the writer thread
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_start_writer(void) {
+  _stop = false;
+  if (pthread_create(&_writer, NULL, _writer_thread, NULL)) {
+    _active = false;
+    return -1;
+  }
+  _active = true;
+  return 0;
+}
+
+/**
+ * Restart the writer thread in the child process after a fork
+ */
+static void
+_cb_atfork_child(void) {
+  if (!_active) {
+    return;
+  }
+
+  pthread_mutex_init(&_wakeup_mutex, NULL);
+  pthread_cond_init(&_wakeup_cond, NULL);
+
+  if (_start_writer()) {
+    fputs("Could not restart logging thread\n", stderr);
+  }
+}
+
+/**
+ * Background thread that writes the logging events of the ring
+ * buffer into the logging file and flushes it when the ring is empty
+ * @param ptr unused
+ * @return always NULL
+ */
+static void *
+_writer_thread(void *ptr __attribute__((unused))) {
+  struct timespec timeout;
+  uint64_t dropped, reported, nsec;
+  uint32_t record_len;
+  size_t head, tail;
+  bool written;
+
+  reported = 0;
+  written = false;
+  tail = _ring_tail;
+
+  while (true) {
+    head = __atomic_load_n(&_ring_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+      _ring_read(tail, &record_len, sizeof(record_len));
+      _ring_fwrite(tail + sizeof(record_len), record_len);
+
+      tail += sizeof(record_len) + record_len;
+      __atomic_store_n(&_ring_tail, tail, __ATOMIC_RELEASE);
+      written = true;
+    }
+
+    dropped = __atomic_load_n(&_dropped, __ATOMIC_RELAXED);
+    if (dropped != reported) {
+      fprintf(_file, "%" PRIu64 " logging events dropped\n",
+          dropped - reported);
+      reported = dropped;
+      written = true;
+    }
+
+    if (written) {
+      /* one flush for the whole batch */
+      fflush(_file);
+      written = false;
+    }
+
+    pthread_mutex_lock(&_wakeup_mutex);
+    if (__atomic_load_n(&_stop, __ATOMIC_ACQUIRE)
+        && tail == __atomic_load_n(&_ring_head, __ATOMIC_ACQUIRE)) {
+      pthread_mutex_unlock(&_wakeup_mutex);
+      break;
+    }
+
+    if (tail == __atomic_load_n(&_ring_head, __ATOMIC_ACQUIRE)) {
+      /* the logging thread does not lock, so do not sleep forever */
+      clock_gettime(CLOCK_REALTIME, &timeout);
+      nsec = (uint64_t)timeout.tv_nsec + WRITER_IDLE_TIMEOUT * 1000000ull;
+      timeout.tv_sec += nsec / 1000000000ull;
+      timeout.tv_nsec = nsec % 1000000000ull;
+      pthread_cond_timedwait(&_wakeup_cond, &_wakeup_mutex, &timeout);
+    }
+    pthread_mutex_unlock(&_wakeup_mutex);
+  }
+  return NULL;
+}
+
+/**
+ * Copy data into the ring buffer
+ * @param pos ring position
+ * @param data pointer to data
+ * @param len length of data
+ */
+static void
+_ring_write(size_t pos, const void *data, size_t len) {
+  size_t idx, first;
+
+  idx = pos & (OONF_LOG_ASYNC_RING_SIZE - 1);
+  first = OONF_LOG_ASYNC_RING_SIZE - idx;
+  if (first > len) {
+    first = len;
+  }
+
+  memcpy(&_ring[idx], data, first);
+  memcpy(_ring, (const char *)data + first, len - first);
+}
+
+/**
+ * Copy data out of the ring buffer
+ * @param pos ring position
+ * @param data pointer to target buffer
+ * @param len length of data
+ */
+static void
+_ring_read(size_t pos, void *data, size_t len) {
+  size_t idx, first;
+
+  idx = pos & (OONF_LOG_ASYNC_RING_SIZE - 1);
+  first = OONF_LOG_ASYNC_RING_SIZE - idx;
+  if (first > len) {
+    first = len;
+  }
+
+  memcpy(data, &_ring[idx], first);
+  memcpy((char *)data + first, _ring, len - first);
+}
+
+/**
+ * Write data of the ring buffer into the logging file
+ * @param pos ring position
+ * @param len length of data
+ */
+static void
+_ring_fwrite(size_t pos, size_t len) {
+  size_t idx, first;
+
+  idx = pos & (OONF_LOG_ASYNC_RING_SIZE - 1);
+  first = OONF_LOG_ASYNC_RING_SIZE - idx;
+  if (first > len) {
+    first = len;
+  }
+
+  fwrite(&_ring[idx], 1, first, _file);
+  if (len > first) {
+    fwrite(_ring, 1, len - first, _file);
+  }
+}
@@ -55,6 +55,7 @@
 
 #include "core/oonf_cfg.h"
 #include "core/oonf_logging.h"
+#include "core/oonf_logging_async.h"
 #include "core/oonf_logging_cfg.h"
 
 /*! configuration section for logging definition */
@@ -75,10 +76,14 @@
 /*! configuration entry for activating file logging */
 #define LOG_FILE_ENTRY   "file"
 
+/*! configuration entry for writing the logging file in the background */
+#define LOG_FILE_ASYNC_ENTRY "file_async"
+
 /* prototype for configuration change handler */
 static void _cb_logcfg_apply(void);
 static void _apply_log_setting(struct cfg_named_section *named,
     const char *entry_name, enum oonf_log_severity severity);
+static void _close_logfile(void);
 
 /* define logging configuration template */
 static struct cfg_schema_entry _logging_entries[] = {
@@ -93,6 +98,8 @@ static struct cfg_schema_entry _logging_entries[] = {
   CFG_VALIDATE_BOOL(LOG_STDERR_ENTRY, "false", "Set to true to activate logging to stderr"),
   CFG_VALIDATE_BOOL(LOG_SYSLOG_ENTRY, "false", "Set to true to activate logging to syslog"),
   CFG_VALIDATE_STRING(LOG_FILE_ENTRY, "", "Set a filename to log to a file"),
+  CFG_VALIDATE_BOOL(LOG_FILE_ASYNC_ENTRY, "false",
+      "Set to true to write the logging file from a background thread"),
 };
 
 static struct cfg_schema_section _logging_section = {
@@ -136,13 +143,7 @@ oonf_logcfg_cleanup(void) {
     oonf_log_removehandler(&_syslog_handler);
   }
   if (list_is_node_added(&_file_handler._node)) {
-    FILE *f;
-
-    f = _file_handler.custom;
-    fflush(f);
-    fclose(f);
-
-    oonf_log_removehandler(&_file_handler);
+    _close_logfile();
   }
 }
 
@@ -156,7 +157,7 @@ oonf_logcfg_apply(struct cfg_db *db) {
   struct cfg_named_section *named;
   const char *ptr, *file_name;
   int file_errno = 0;
-  bool activate_syslog, activate_file, activate_stderr;
+  bool activate_syslog, activate_file, activate_stderr, activate_async;
 
   /* clean up logging mask */
   oonf_log_mask_clear(_logging_cfg);
@@ -179,6 +180,9 @@ oonf_logcfg_apply(struct cfg_db *db) {
   file_name = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_FILE_ENTRY)->value;
   activate_file = file_name != NULL && *file_name != 0;
 
+  ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_FILE_ASYNC_ENTRY)->value;
+  activate_async = cfg_get_bool(ptr);
+
   ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_STDERR_ENTRY)->value;
   activate_stderr = cfg_get_bool(ptr);
 
@@ -198,11 +202,19 @@ oonf_logcfg_apply(struct cfg_db *db) {
     }
   }
   else if (!activate_file && list_is_node_added(&_file_handler._node)) {
-    FILE *f = _file_handler.custom;
-    oonf_log_removehandler(&_file_handler);
+    _close_logfile();
+  }
 
-    fflush(f);
-    fclose(f);
+  /* log.file_async */
+  if (list_is_node_added(&_file_handler._node)
+      && activate_async != oonf_log_async_is_active()) {
+    if (!activate_async) {
+      oonf_log_async_stop();
+      _file_handler.handler = oonf_log_file;
+    }
+    else if (!oonf_log_async_start(_file_handler.custom)) {
+      _file_handler.handler = oonf_log_file_async;
+    }
   }
 
   /* log.stderr (activate if syslog and file are offline) */
@@ -314,6 +326,24 @@ _apply_log_setting(struct cfg_named_section *named,
   }
 }
 
+/**
+ * Stop the file logger and close the logging file
+ */
+static void
+_close_logfile(void) {
+  FILE *f;
+
+  /* write remaining logging events of the background writer */
+  oonf_log_async_stop();
+  _file_handler.handler = oonf_log_file;
+
+  f = _file_handler.custom;
+  oonf_log_removehandler(&_file_handler);
+
+  fflush(f);
+  fclose(f);
+}
+
 /**
  * Wrapper for configuration delta handling
  */
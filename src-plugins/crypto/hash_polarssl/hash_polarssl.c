@@ -62,6 +62,25 @@
 
 #define LOG_HASH_POLARSSL _hash_polarssl_subsystem.logging
 
+/**
+ * Precalculated HMAC state of a key, polarssl contexts store
+ * both padded keys and the hash state after the inner padded key
+ */
+union polarssl_hmac_context {
+#ifdef POLARSSL_SHA1_C
+  /*! SHA1 HMAC context */
+  sha1_context sha1;
+#endif
+#ifdef POLARSSL_SHA256_C
+  /*! SHA224/256 HMAC context */
+  sha256_context sha256;
+#endif
+#ifdef POLARSSL_SHA512_C
+  /*! SHA384/512 HMAC context */
+  sha512_context sha512;
+#endif
+};
+
 /* function prototypes */
 static int _init(void);
 static void _cleanup(void);
@@ -88,6 +107,13 @@ static int _cb_hmac_sign(
     void *dst, size_t *dst_len,
     const void *src, size_t src_len,
     const void *key, size_t key_len);
+static int _cb_hmac_init_key_context(
+    struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    void *ctx, const void *key, size_t key_len);
+static int _cb_hmac_sign_iov(
+    struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    const void *ctx, void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count);
 
 /* hash tomcrypt subsystem definition */
 static const char *_dependencies[] = {
@@ -145,6 +171,10 @@ static struct rfc7182_crypt _hmac = {
   .type = RFC7182_ICV_CRYPT_HMAC,
   .sign = _cb_hmac_sign,
   .getSignSize = _cb_get_signsize,
+
+  .key_context_size = sizeof(union polarssl_hmac_context),
+  .init_key_context = _cb_hmac_init_key_context,
+  .sign_iov = _cb_hmac_sign_iov,
 };
 
 /**
@@ -306,3 +336,110 @@ _cb_hmac_sign(struct rfc7182_crypt *crypt __attribute__((unused)),
   *dst_len = hash->hash_length;
   return 0;
 }
+
+/**
+ * Precalculate the HMAC pads and the inner hash state of a key
+ * @param crypt rfc7182 crypt
+ * @param hash rfc7182 hash
+ * @param ctx pointer to polarssl HMAC context
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_init_key_context(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash, void *ctx,
+    const void *key, size_t key_len) {
+  union polarssl_hmac_context *hmac = ctx;
+
+  switch (hash->type) {
+#ifdef POLARSSL_SHA1_C
+    case RFC7182_ICV_HASH_SHA_1:
+      sha1_hmac_starts(&hmac->sha1, key, key_len);
+      break;
+#endif
+#ifdef POLARSSL_SHA256_C
+    case RFC7182_ICV_HASH_SHA_224:
+      sha256_hmac_starts(&hmac->sha256, key, key_len, 1);
+      break;
+    case RFC7182_ICV_HASH_SHA_256:
+      sha256_hmac_starts(&hmac->sha256, key, key_len, 0);
+      break;
+#endif
+#ifdef POLARSSL_SHA512_C
+    case RFC7182_ICV_HASH_SHA_384:
+      sha512_hmac_starts(&hmac->sha512, key, key_len, 1);
+      break;
+    case RFC7182_ICV_HASH_SHA_512:
+      sha512_hmac_starts(&hmac->sha512, key, key_len, 0);
+      break;
+#endif
+    default:
+      return -1;
+  }
+  return 0;
+}
+
+/**
+ * HMAC function for scattered data based on a precalculated
+ * polarssl HMAC context
+ * @param crypt rfc7182 crypt
+ * @param hash rfc7182 hash
+ * @param ctx pointer to polarssl HMAC context
+ * @param dst output buffer for signature
+ * @param dst_len pointer to length of output buffer,
+ *   will be set to signature length afterwards
+ * @param src array of fragments of unsigned original data
+ * @param src_count number of fragments
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_sign_iov(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash, const void *ctx,
+    void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count) {
+  union polarssl_hmac_context hmac;
+  size_t i;
+
+  if (*dst_len < hash->hash_length) {
+    return -1;
+  }
+
+  /* work on a copy, the cached context stays at the inner key state */
+  memcpy(&hmac, ctx, sizeof(hmac));
+
+  switch (hash->type) {
+#ifdef POLARSSL_SHA1_C
+    case RFC7182_ICV_HASH_SHA_1:
+      for (i=0; i<src_count; i++) {
+        sha1_hmac_update(&hmac.sha1, src[i].data, src[i].length);
+      }
+      sha1_hmac_finish(&hmac.sha1, dst);
+      break;
+#endif
+#ifdef POLARSSL_SHA256_C
+    case RFC7182_ICV_HASH_SHA_224:
+    case RFC7182_ICV_HASH_SHA_256:
+      for (i=0; i<src_count; i++) {
+        sha256_hmac_update(&hmac.sha256, src[i].data, src[i].length);
+      }
+      sha256_hmac_finish(&hmac.sha256, dst);
+      break;
+#endif
+#ifdef POLARSSL_SHA512_C
+    case RFC7182_ICV_HASH_SHA_384:
+    case RFC7182_ICV_HASH_SHA_512:
+      for (i=0; i<src_count; i++) {
+        sha512_hmac_update(&hmac.sha512, src[i].data, src[i].length);
+      }
+      sha512_hmac_finish(&hmac.sha512, dst);
+      break;
+#endif
+    default:
+      return -1;
+  }
+
+  memset(&hmac, 0, sizeof(hmac));
+  *dst_len = hash->hash_length;
+  return 0;
+}
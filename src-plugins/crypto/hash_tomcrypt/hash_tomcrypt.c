@@ -68,6 +68,20 @@ struct tomcrypt_hash {
   int idx;
 };
 
+/**
+ * Precalculated HMAC state of a key
+ */
+struct tomcrypt_hmac_context {
+  /*! tomcrypt index of hash */
+  int idx;
+
+  /*! hash state after processing the inner padded key */
+  hash_state inner;
+
+  /*! hash state after processing the outer padded key */
+  hash_state outer;
+};
+
 /* function prototypes */
 static int _init(void);
 static void _cleanup(void);
@@ -79,6 +93,12 @@ static size_t _cb_get_cryptsize(struct rfc7182_crypt *, struct rfc7182_hash *);
 static int _cb_hmac_sign(struct rfc7182_crypt *, struct rfc7182_hash *,
     void *dst, size_t *dst_len, const void *src, size_t src_len,
     const void *key, size_t key_len);
+static int _cb_hmac_init_key_context(struct rfc7182_crypt *,
+    struct rfc7182_hash *, void *ctx, const void *key, size_t key_len);
+static int _cb_hmac_sign_iov(struct rfc7182_crypt *, struct rfc7182_hash *,
+    const void *ctx, void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count);
+static int _get_hash_idx(struct rfc7182_hash *hash);
 
 /* hash tomcrypt subsystem definition */
 static const char *_dependencies[] = {
@@ -145,6 +165,10 @@ static struct rfc7182_crypt _hmac = {
   .type = RFC7182_ICV_CRYPT_HMAC,
   .sign = _cb_hmac_sign,
   .getSignSize = _cb_get_cryptsize,
+
+  .key_context_size = sizeof(struct tomcrypt_hmac_context),
+  .init_key_context = _cb_hmac_init_key_context,
+  .sign_iov = _cb_hmac_sign_iov,
 };
 
 /**
@@ -252,22 +276,160 @@ _cb_hmac_sign(struct rfc7182_crypt *crypt __attribute__((unused)),
     struct rfc7182_hash *hash,
     void *dst, size_t *dst_len, const void *src, size_t src_len,
     const void *key, size_t key_len) {
+  int idx, result;
+
+  OONF_DEBUG_HEX(LOG_HASH_TOMCRYPT, src, src_len, "Calculate hash:");
+
+  idx = _get_hash_idx(hash);
+  if (idx == -1) {
+    return -1;
+  }
+
+  result = hmac_memory(idx,
+      key, (unsigned long)key_len,
+      src, (unsigned long)src_len,
+      dst, (unsigned long *)dst_len);
+  if (result) {
+    OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Precalculate the hash states of the inner and outer padded
+ * HMAC key (RFC 2104)
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param ctx pointer to tomcrypt HMAC context
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_init_key_context(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash, void *ctx,
+    const void *key, size_t key_len) {
+  struct tomcrypt_hmac_context *hmac = ctx;
+  uint8_t padded_key[MAXBLOCKSIZE];
+  unsigned long blocksize, len;
   size_t i;
   int result;
 
-  OONF_DEBUG_HEX(LOG_HASH_TOMCRYPT, src, src_len, "Calculate hash:");
+  hmac->idx = _get_hash_idx(hash);
+  if (hmac->idx == -1) {
+    return -1;
+  }
+  blocksize = hash_descriptor[hmac->idx].blocksize;
+
+  /* keys longer than the blocksize are hashed first */
+  memset(padded_key, 0, sizeof(padded_key));
+  if (key_len > blocksize) {
+    len = sizeof(padded_key);
+    result = hash_memory(hmac->idx, key, (unsigned long)key_len,
+        padded_key, &len);
+    if (result) {
+      OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+      return -1;
+    }
+  }
+  else {
+    memcpy(padded_key, key, key_len);
+  }
+
+  /* inner state */
+  for (i=0; i<blocksize; i++) {
+    padded_key[i] ^= 0x36;
+  }
+  if ((result = hash_descriptor[hmac->idx].init(&hmac->inner)) != CRYPT_OK
+      || (result = hash_descriptor[hmac->idx].process(
+          &hmac->inner, padded_key, blocksize)) != CRYPT_OK) {
+    OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+    return -1;
+  }
+
+  /* outer state */
+  for (i=0; i<blocksize; i++) {
+    padded_key[i] ^= 0x36 ^ 0x5c;
+  }
+  if ((result = hash_descriptor[hmac->idx].init(&hmac->outer)) != CRYPT_OK
+      || (result = hash_descriptor[hmac->idx].process(
+          &hmac->outer, padded_key, blocksize)) != CRYPT_OK) {
+    OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+    return -1;
+  }
+
+  memset(padded_key, 0, sizeof(padded_key));
+  return 0;
+}
+
+/**
+ * HMAC function for scattered data based on a precalculated
+ * tomcrypt HMAC context
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param ctx pointer to tomcrypt HMAC context
+ * @param dst output buffer for cryptographic signature
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @param src array of fragments of unsigned original data
+ * @param src_count number of fragments
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_hmac_sign_iov(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash __attribute__((unused)),
+    const void *ctx, void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count) {
+  const struct tomcrypt_hmac_context *hmac = ctx;
+  const struct ltc_hash_descriptor *desc;
+  uint8_t inner_hash[MAXBLOCKSIZE];
+  hash_state md;
+  size_t i;
+  int result;
+
+  desc = &hash_descriptor[hmac->idx];
+  if (*dst_len < desc->hashsize) {
+    return -1;
+  }
+
+  /* inner hash */
+  memcpy(&md, &hmac->inner, sizeof(md));
+  for (i=0; i<src_count; i++) {
+    OONF_DEBUG_HEX(LOG_HASH_TOMCRYPT, src[i].data, src[i].length, "Calculate hash:");
+    if ((result = desc->process(&md, src[i].data, (unsigned long)src[i].length)) != CRYPT_OK) {
+      OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+      return -1;
+    }
+  }
+  if ((result = desc->done(&md, inner_hash)) != CRYPT_OK) {
+    OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+    return -1;
+  }
+
+  /* outer hash */
+  memcpy(&md, &hmac->outer, sizeof(md));
+  if ((result = desc->process(&md, inner_hash, desc->hashsize)) != CRYPT_OK
+      || (result = desc->done(&md, dst)) != CRYPT_OK) {
+    OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
+    return -1;
+  }
+
+  *dst_len = desc->hashsize;
+  return 0;
+}
+
+/**
+ * @param hash rfc7182 hash
+ * @return tomcrypt index of hash, -1 if not supported
+ */
+static int
+_get_hash_idx(struct rfc7182_hash *hash) {
+  size_t i;
 
   for (i=0; i<ARRAYSIZE(_hashes); i++) {
     if (&_hashes[i].h == hash) {
-      result = hmac_memory(_hashes[i].idx,
-          key, (unsigned long)key_len,
-          src, (unsigned long)src_len,
-          dst, (unsigned long *)dst_len);
-      if (result) {
-        OONF_WARN(LOG_HASH_TOMCRYPT, "tomcrypt error: %s", error_to_string(result));
-        return -1;
-      }
-      return 0;
+      return _hashes[i].idx;
     }
   }
   OONF_WARN(LOG_HASH_TOMCRYPT, "Unsupported Hash for Tomcrypt HMAC: %u", hash->type);
@@ -67,6 +67,8 @@ static int _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
 
 static size_t _remove_signature_data(uint8_t *dst,
     const struct rfc5444_reader_tlvblock_context *context);
+static size_t _get_unsigned_iov(struct rfc7182_iov *iov, size_t iov_max,
+    const struct rfc5444_reader_tlvblock_context *context);
 
 static void _cb_hash_added(void *ptr);
 static void _cb_hash_removed(void *ptr);
@@ -131,6 +133,15 @@ static struct avl_tree _sig_tree;
 static uint8_t _static_message_buffer[RFC5444_MAX_PACKET_SIZE];
 static uint8_t _crypt_buffer[RFC5444_MAX_PACKET_SIZE];
 
+/* fragments of signed data, first two are used for source IP and ICV header */
+static struct rfc7182_iov _iov[RFC5444_SIG_MAX_FRAGMENTS];
+
+/* buffer for source IP and ICV header of signed data */
+static uint8_t _prefix_buffer[16 + 3];
+
+/* buffer for modified packet/message header of signed data */
+static uint8_t _unsigned_header[32];
+
 /* listeners for crypto and hash algorithms */
 static struct oonf_class_extension _hash_listener = {
   .ext_name = "rfc5444 signatures",
@@ -243,8 +254,8 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
   enum rfc5444_result drop_value;
   int msg_type;
   uint8_t key_id_len;
-  uint8_t *static_data;
-  size_t static_length, key_length;
+  const struct rfc7182_iov *src;
+  size_t iov_count, src_count, key_length;
   const void *key;
   bool sig_to_verify;
 #ifdef OONF_LOG_DEBUG_INFO
@@ -281,6 +292,15 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
   OONF_DEBUG(LOG_RFC5444_SIG,
       "Start checking signature for message type %d", msg_type);
 
+  /* reference unsigned data directly in the incoming buffer */
+  iov_count = _get_unsigned_iov(&_iov[2], ARRAYSIZE(_iov) - 2, context);
+  if (iov_count == 0) {
+    /* too many fragments, fall back to copying the unsigned data */
+    _iov[2].data = _static_message_buffer;
+    _iov[2].length = _remove_signature_data(_static_message_buffer, context);
+    iov_count = 1;
+  }
+
   for (tlv = sig_tlv->tlv; tlv; tlv = tlv->next_entry) {
     if (tlv->type_ext != RFC7182_ICV_EXT_CRYPTHASH
         && tlv->type_ext != RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
@@ -308,25 +328,26 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
       continue;
     }
 
-    /* assemble static message buffer */
+    /* add ICV header in front of the unsigned data */
+    _iov[1].data = tlv->single_value;
+    _iov[1].length = 3 + key_id_len;
+
     if (tlv->type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
       OONF_DEBUG(LOG_RFC5444_SIG, "incoming src IP: %s",
           netaddr_to_string(&nbuf, _protocol->input_address));
 
-      /* copy source address into buffer */
-      netaddr_to_binary(_static_message_buffer, _protocol->input_address,
-          sizeof(_static_message_buffer));
-      static_length = netaddr_get_binlength(_protocol->input_address);
+      /* add source address in front of ICV header */
+      netaddr_to_binary(_prefix_buffer, _protocol->input_address,
+          sizeof(_prefix_buffer));
+      _iov[0].data = _prefix_buffer;
+      _iov[0].length = netaddr_get_binlength(_protocol->input_address);
+      src = &_iov[0];
+      src_count = iov_count + 2;
     }
     else {
-      static_length = 0;
+      src = &_iov[1];
+      src_count = iov_count + 1;
     }
-    memcpy(&_static_message_buffer[static_length], tlv->single_value,
-        3 + key_id_len);
-    static_length += 3 + key_id_len;
-
-    static_data = &_static_message_buffer[static_length];
-    static_length += _remove_signature_data(static_data, context);
 
     /* loop over all possible signatures */
     avl_for_each_elements_with_key(&_sig_tree, sig, _node, sigstart, &sigkey) {
@@ -357,10 +378,9 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
 
       /* check signature */
       key = sig->getCryptoKey(sig, &key_length);
-      sig->verified = sig->crypt->validate(sig->crypt, sig->hash,
+      sig->verified = rfc7182_validate_iov(sig->crypt, sig->hash,
           &tlv->single_value[3+key_id_len], tlv->length - 3 - key_id_len,
-          _static_message_buffer, static_length,
-          key, key_length);
+          src, src_count, key, key_length);
 
       OONF_DEBUG(LOG_RFC5444_SIG, "Checked signature hash=%d/crypt=%d: %s",
           sig->key.hash_function, sig->key.crypt_function, sig->verified ? "check" : "bad");
@@ -401,7 +421,8 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
   const union netaddr_socket *local_socket;
   struct netaddr srcaddr;
 
-  size_t hash_buffer_size, sig_size, sig_tlv_size, tlvblock_size, key_size;
+  size_t sig_size, sig_tlv_size, tlvblock_size, key_size, iov_count;
+  size_t header_len, hoplimit, hopcount;
   uint8_t *tlvblock;
   int idx;
 
@@ -426,8 +447,8 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
   oonf_target = oonf_rfc5444_get_target_from_rfc5444_target(target);
 
   /*
-   * copy data into static buffer, leave space in front
-   * for source address and signature data
+   * collect fragments of signed data, the prefix buffer contains
+   * source address and signature header
    */
   if (sig->source_specific) {
     local_socket = oonf_rfc5444_target_get_local_socket(oonf_target);
@@ -437,7 +458,7 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
     OONF_DEBUG(LOG_RFC5444_SIG, "outgoing src IP: %s",
         netaddr_to_string(&nbuf, &srcaddr));
 
-    netaddr_to_binary(_static_message_buffer, &srcaddr, sizeof(_static_message_buffer));
+    netaddr_to_binary(_prefix_buffer, &srcaddr, sizeof(_prefix_buffer));
     idx = netaddr_get_binlength(&srcaddr);
   }
   else {
@@ -447,43 +468,58 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
   key_id_length = 0;
   key_id = sig->getKeyId(sig, &key_id_length);
 
-  _static_message_buffer[idx++] = sig->key.hash_function;
-  _static_message_buffer[idx++] = sig->key.crypt_function;
-  _static_message_buffer[idx++] = key_id_length;
-  memcpy(&_static_message_buffer[idx], key_id, key_id_length);
-  idx += key_id_length;
-  hash_buffer_size = idx + *data_size;
+  _prefix_buffer[idx++] = sig->key.hash_function;
+  _prefix_buffer[idx++] = sig->key.crypt_function;
+  _prefix_buffer[idx++] = key_id_length;
 
-  if (msg) {
-    /* just copy message data, it always has a TLV block */
-    memcpy(&_static_message_buffer[idx], data, *data_size);
+  _iov[0].data = _prefix_buffer;
+  _iov[0].length = idx;
+  _iov[1].data = key_id;
+  _iov[1].length = key_id_length;
 
+  if (msg) {
     /*
-     * get pointer to message tlvblock
-     * zero hoplimit/hopcount in static buffer
+     * calculate message header length and copy header,
+     * hoplimit/hopcount are zero for signature
      */
-    idx += 4;
-    tlvblock = &data[4];
+    hoplimit = 0;
+    hopcount = 0;
+    header_len = 4;
     if (msg->has_origaddr) {
-      idx += _protocol->writer.msg_addr_len;
-      tlvblock += _protocol->writer.msg_addr_len;
+      header_len += _protocol->writer.msg_addr_len;
     }
     if (msg->has_hoplimit) {
-      _static_message_buffer[idx++] = 0;
-      tlvblock++;
+      hoplimit = header_len++;
     }
     if (msg->has_hopcount) {
-      _static_message_buffer[idx++] = 0;
-      tlvblock++;
+      hopcount = header_len++;
     }
     if (msg->has_seqno) {
-      idx+=2;
-      tlvblock+=2;
+      header_len += 2;
+    }
+
+    memcpy(_unsigned_header, data, header_len);
+    if (hoplimit) {
+      _unsigned_header[hoplimit] = 0;
     }
+    if (hopcount) {
+      _unsigned_header[hopcount] = 0;
+    }
+
+    /* get pointer to message tlvblock, it always has a TLV block */
+    tlvblock = &data[header_len];
+
+    _iov[2].data = _unsigned_header;
+    _iov[2].length = header_len;
+    _iov[3].data = tlvblock;
+    _iov[3].length = *data_size - header_len;
+    iov_count = 4;
   }
   else {
-    /* just copy packet for hashing */
-    memcpy(&_static_message_buffer[idx], data, *data_size);
+    /* hash packet without modification */
+    _iov[2].data = data;
+    _iov[2].length = *data_size;
+    iov_count = 3;
 
     if (data[0] & RFC5444_PKT_FLAG_SEQNO) {
       tlvblock = &data[3];
@@ -496,9 +532,8 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
   /* calculate encrypted hash value */
   crypt_len = sizeof(_crypt_buffer);
   key = sig->getCryptoKey(sig, &key_size);
-  if (sig->crypt->sign(sig->crypt, sig->hash, _crypt_buffer, &crypt_len,
-      _static_message_buffer, hash_buffer_size,
-      key, key_size)) {
+  if (rfc7182_sign_iov(sig->crypt, sig->hash, _crypt_buffer, &crypt_len,
+      _iov, iov_count, key, key_size)) {
     OONF_WARN(LOG_RFC5444_SIG, "Signature generation failed");
     return -1;
   }
@@ -592,6 +627,156 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor,
   return 0;
 }
 
+/**
+ * Collect the fragments of a message/packet without signature TLVs
+ * without copying the data. Modified header fields are stored in a
+ * static buffer.
+ * @param iov pointer to array for fragments
+ * @param iov_max maximum number of fragments
+ * @param context rfc5444 context
+ * @return number of fragments, 0 if array was too small
+ */
+static size_t
+_get_unsigned_iov(struct rfc7182_iov *iov, size_t iov_max,
+    const struct rfc5444_reader_tlvblock_context *context) {
+  const uint8_t *src_ptr, *src_end, *fragment;
+  uint16_t len, hoplimit, hopcount;
+  uint16_t blocklen, tlvlen;
+  size_t count, total;
+
+  hoplimit = 0;
+  hopcount = 0;
+
+  /* initialize pointers to src */
+  if (context->type == RFC5444_CONTEXT_PACKET) {
+    src_ptr = context->pkt_buffer;
+    src_end = context->pkt_buffer + context->pkt_size;
+
+    /* calculate message header length */
+    if (context->has_pktseqno) {
+      len = 3;
+    }
+    else {
+      len = 1;
+    }
+  }
+  else {
+    src_ptr = context->msg_buffer;
+    src_end = context->msg_buffer + context->msg_size;
+
+    /* calculate message header length */
+    len = 4;
+    if (context->has_origaddr) {
+      len += context->addr_len;
+    }
+    if (context->has_hoplimit) {
+      hoplimit = len;
+      len++;
+    }
+    if (context->has_hopcount) {
+      hopcount = len;
+      len++;
+    }
+    if (context->has_seqno) {
+      len += 2;
+    }
+  }
+
+  /* copy packet/message header, tlvblock length is written later */
+  memcpy(_unsigned_header, src_ptr, len);
+
+  /* clear hoplimit/hopcount */
+  if (hoplimit) {
+    _unsigned_header[hoplimit] = 0;
+  }
+  if (hopcount) {
+    _unsigned_header[hopcount] = 0;
+  }
+
+  iov[0].data = _unsigned_header;
+  iov[0].length = len + 2;
+  count = 1;
+  total = len + 2;
+
+  /* advance to start of tlvs */
+  src_ptr += len;
+  blocklen = 256 * src_ptr[0] + src_ptr[1];
+  src_ptr += 2;
+
+  /* loop over tlvs, skip signature tlvs */
+  fragment = src_ptr;
+  len = blocklen;
+  while (len > 0) {
+    /* calculate length of TLV */
+    tlvlen = 2;
+    if (src_ptr[1] & RFC5444_TLV_FLAG_TYPEEXT) {
+      /* extended type, one extra byte */
+      tlvlen++;
+    }
+    if (src_ptr[1] & RFC5444_TLV_FLAG_VALUE) {
+      /* TLV has a value field */
+      if (src_ptr[1] & RFC5444_TLV_FLAG_EXTVALUE) {
+        /* 2-byte value */
+        tlvlen += (256 * src_ptr[tlvlen]) + src_ptr[tlvlen+1] + 2;
+      }
+      else {
+        /* 1-byte value */
+        tlvlen += src_ptr[tlvlen] + 1;
+      }
+    }
+
+    if (src_ptr[0] == RFC7182_MSGTLV_ICV) {
+      /* end current fragment before signature TLV */
+      if (src_ptr > fragment) {
+        if (count == iov_max) {
+          return 0;
+        }
+        iov[count].data = fragment;
+        iov[count].length = src_ptr - fragment;
+        total += iov[count].length;
+        count++;
+      }
+      fragment = src_ptr + tlvlen;
+
+      /* reduce blocklength */
+      blocklen -= tlvlen;
+    }
+    len -= tlvlen;
+    src_ptr += tlvlen;
+  }
+
+  /* add rest of data */
+  if (src_end > fragment) {
+    if (count == iov_max) {
+      return 0;
+    }
+    iov[count].data = fragment;
+    iov[count].length = src_end - fragment;
+    total += iov[count].length;
+    count++;
+  }
+
+  len = iov[0].length - 2;
+  if (blocklen > 0 || context->type == RFC5444_CONTEXT_MESSAGE) {
+    /* overwrite tlvblock length */
+    _unsigned_header[len] = blocklen / 256;
+    _unsigned_header[len + 1] = blocklen & 255;
+  }
+  else {
+    /* remove empty packet tlvblock and fix flags */
+    iov[0].length = len;
+    total -= 2;
+    _unsigned_header[0] &= ~ RFC5444_PKT_FLAG_TLV;
+  }
+
+  if (context->type == RFC5444_CONTEXT_MESSAGE) {
+    /* overwrite message length */
+    _unsigned_header[2] = total / 256;
+    _unsigned_header[3] = total & 255;
+  }
+  return count;
+}
+
 /**
  * Remove signature TLVs from a message/packet
  * @param dst pointer to destination buffer for unsigned message/packet
@@ -55,6 +55,7 @@
 enum {
   RFC5444_SIG_MAX_HASHSIZE = RFC5444_MAX_PACKET_SIZE,
   RFC5444_SIG_MAX_CRYPTSIZE = RFC5444_MAX_PACKET_SIZE,
+  RFC5444_SIG_MAX_FRAGMENTS = 32,
 };
 
 /**
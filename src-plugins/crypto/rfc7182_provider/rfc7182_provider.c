@@ -43,9 +43,12 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include "common/common_types.h"
 #include "common/avl.h"
 #include "common/avl_comp.h"
+#include "common/list.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_class.h"
 #include "subsystems/rfc5444/rfc5444_iana.h"
@@ -54,6 +57,29 @@
 
 #define LOG_RFC7182_PROVIDER _rfc7182_provider_subsystem.logging
 
+/**
+ * Cached key dependant state of a crypto function
+ */
+struct _key_context {
+  /*! crypto function of context */
+  struct rfc7182_crypt *crypt;
+
+  /*! hash function of context */
+  struct rfc7182_hash *hash;
+
+  /*! key material used to initialize context */
+  uint8_t key[RFC7182_MAX_CACHED_KEY_LENGTH];
+
+  /*! length of key material */
+  size_t key_len;
+
+  /*! provider specific precalculated state */
+  void *ctx;
+
+  /*! hook into LRU list of key contexts */
+  struct list_entity _node;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
@@ -74,6 +100,12 @@ static int _cb_sign_by_crypthash(
       const void *src, size_t src_len,
       const void *key, size_t key_len);
 
+static struct _key_context *_get_key_context(
+    struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    const void *key, size_t key_len);
+static void _remove_key_context(struct _key_context *kctx);
+static size_t _gather(const struct rfc7182_iov *src, size_t src_count);
+
 /* plugin declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
@@ -117,6 +149,13 @@ static struct oonf_class _crypt_class = {
 /* static buffer for crypto calculation */
 static uint8_t _crypt_buffer[1500];
 
+/* static buffer to assemble scattered data */
+static uint8_t _gather_buffer[1500];
+
+/* LRU list of precalculated key contexts */
+static struct list_entity _key_contexts;
+static size_t _key_context_count;
+
 /**
  * Constructor of subsystem
  * @return -1 if rfc5444 protocol was not available, 0 otherwise
@@ -125,6 +164,7 @@ static int
 _init(void) {
   avl_init(&_crypt_functions, avl_comp_uint8, false);
   avl_init(&_hash_functions, avl_comp_uint8, false);
+  list_init_head(&_key_contexts);
 
   oonf_class_add(&_hash_class);
   oonf_class_add(&_crypt_class);
@@ -142,6 +182,11 @@ static void
 _cleanup(void) {
   struct rfc7182_hash *hash, *hash_it;
   struct rfc7182_crypt *crypt, *crypt_it;
+  struct _key_context *kctx, *kctx_it;
+
+  list_for_each_element_safe(&_key_contexts, kctx, _node, kctx_it) {
+    _remove_key_context(kctx);
+  }
 
   avl_for_each_element_safe(&_hash_functions, hash, _node, hash_it) {
     rfc7182_remove_hash(hash);
@@ -175,6 +220,14 @@ rfc7182_add_hash(struct rfc7182_hash *hash) {
  */
 void
 rfc7182_remove_hash(struct rfc7182_hash *hash) {
+  struct _key_context *kctx, *kctx_it;
+
+  list_for_each_element_safe(&_key_contexts, kctx, _node, kctx_it) {
+    if (kctx->hash == hash) {
+      _remove_key_context(kctx);
+    }
+  }
+
   oonf_class_event(&_hash_class, hash, OONF_OBJECT_REMOVED);
   avl_remove(&_hash_functions, &hash->_node);
 }
@@ -218,6 +271,14 @@ rfc7182_add_crypt(struct rfc7182_crypt *crypt) {
  */
 void
 rfc7182_remove_crypt(struct rfc7182_crypt *crypt) {
+  struct _key_context *kctx, *kctx_it;
+
+  list_for_each_element_safe(&_key_contexts, kctx, _node, kctx_it) {
+    if (kctx->crypt == crypt) {
+      _remove_key_context(kctx);
+    }
+  }
+
   oonf_class_event(&_crypt_class, crypt, OONF_OBJECT_REMOVED);
   avl_remove(&_crypt_functions, &crypt->_node);
 }
@@ -231,6 +292,183 @@ rfc7182_get_crypt_tree(void){
   return &_crypt_functions;
 }
 
+/**
+ * Creates a cryptographic signature for a scattered data block.
+ * Uses a cached key context if the crypto function supports it,
+ * otherwise the data is assembled and signed with the 'sign' callback.
+ * @param crypt crypto definition
+ * @param hash the definition of the hash
+ * @param dst output buffer for cryptographic signature
+ * @param dst_len pointer to length of output buffer, will be set to
+ *   length of signature afterwards
+ * @param src array of fragments of unsigned original data
+ * @param src_count number of fragments
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+rfc7182_sign_iov(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count,
+    const void *key, size_t key_len) {
+  struct _key_context *kctx;
+  size_t len;
+
+  kctx = _get_key_context(crypt, hash, key, key_len);
+  if (kctx) {
+    return crypt->sign_iov(crypt, hash, kctx->ctx, dst, dst_len, src, src_count);
+  }
+
+  len = _gather(src, src_count);
+  if (len == 0 && src_count > 0) {
+    return -1;
+  }
+  return crypt->sign(crypt, hash, dst, dst_len, _gather_buffer, len, key, key_len);
+}
+
+/**
+ * Checks if an encrypted signature of a scattered data block is valid.
+ * Uses a cached key context if the crypto function supports it,
+ * otherwise the data is assembled and checked with the 'validate'
+ * callback.
+ * @param crypt crypto definition
+ * @param hash the definition of the hash
+ * @param encrypted pointer to encrypted signature
+ * @param encrypted_length length of encrypted signature
+ * @param src array of fragments of unsigned original data
+ * @param src_count number of fragments
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return true if signature matches, false otherwise
+ */
+bool
+rfc7182_validate_iov(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    const void *encrypted, size_t encrypted_length,
+    const struct rfc7182_iov *src, size_t src_count,
+    const void *key, size_t key_len) {
+  struct _key_context *kctx;
+  size_t len;
+
+  kctx = _get_key_context(crypt, hash, key, key_len);
+  if (kctx) {
+    len = sizeof(_crypt_buffer);
+    if (crypt->sign_iov(crypt, hash, kctx->ctx, _crypt_buffer, &len, src, src_count)) {
+      OONF_INFO(LOG_RFC7182_PROVIDER, "Crypto-error when checking signature");
+      return false;
+    }
+    return len == encrypted_length
+        && memcmp(encrypted, _crypt_buffer, len) == 0;
+  }
+
+  len = _gather(src, src_count);
+  if (len == 0 && src_count > 0) {
+    return false;
+  }
+  return crypt->validate(crypt, hash, encrypted, encrypted_length,
+      _gather_buffer, len, key, key_len);
+}
+
+/**
+ * Lookup a precalculated key context, create a new one if necessary
+ * @param crypt crypto definition
+ * @param hash hash definition
+ * @param key key material
+ * @param key_len length of key material
+ * @return key context, NULL if crypto function does not support
+ *   key contexts or an error happened
+ */
+static struct _key_context *
+_get_key_context(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+    const void *key, size_t key_len) {
+  struct _key_context *kctx;
+
+  if (crypt->key_context_size == 0 || crypt->init_key_context == NULL
+      || crypt->sign_iov == NULL || key_len > RFC7182_MAX_CACHED_KEY_LENGTH) {
+    return NULL;
+  }
+
+  list_for_each_element(&_key_contexts, kctx, _node) {
+    if (kctx->crypt == crypt && kctx->hash == hash && kctx->key_len == key_len
+        && memcmp(kctx->key, key, key_len) == 0) {
+      /* move to front of LRU list */
+      list_remove(&kctx->_node);
+      list_add_head(&_key_contexts, &kctx->_node);
+      return kctx;
+    }
+  }
+
+  if (_key_context_count >= RFC7182_KEY_CONTEXT_CACHE_SIZE) {
+    /* drop least recently used context */
+    kctx = list_last_element(&_key_contexts, kctx, _node);
+    _remove_key_context(kctx);
+  }
+
+  kctx = calloc(1, sizeof(*kctx));
+  if (!kctx) {
+    return NULL;
+  }
+  kctx->ctx = calloc(1, crypt->key_context_size);
+  if (!kctx->ctx) {
+    free(kctx);
+    return NULL;
+  }
+
+  if (crypt->init_key_context(crypt, hash, kctx->ctx, key, key_len)) {
+    OONF_WARN(LOG_RFC7182_PROVIDER, "Could not initialize key context for crypt %u/hash %u",
+        crypt->type, hash->type);
+    free(kctx->ctx);
+    free(kctx);
+    return NULL;
+  }
+
+  kctx->crypt = crypt;
+  kctx->hash = hash;
+  memcpy(kctx->key, key, key_len);
+  kctx->key_len = key_len;
+
+  list_add_head(&_key_contexts, &kctx->_node);
+  _key_context_count++;
+  return kctx;
+}
+
+/**
+ * Remove a key context from the cache and clear its key material
+ * @param kctx key context
+ */
+static void
+_remove_key_context(struct _key_context *kctx) {
+  list_remove(&kctx->_node);
+  _key_context_count--;
+
+  memset(kctx->ctx, 0, kctx->crypt->key_context_size);
+  memset(kctx->key, 0, sizeof(kctx->key));
+  free(kctx->ctx);
+  free(kctx);
+}
+
+/**
+ * Assemble scattered data in the gather buffer
+ * @param src array of fragments
+ * @param src_count number of fragments
+ * @return length of assembled data, 0 if data was too long
+ */
+static size_t
+_gather(const struct rfc7182_iov *src, size_t src_count) {
+  size_t i, len;
+
+  len = 0;
+  for (i=0; i<src_count; i++) {
+    if (len + src[i].length > sizeof(_gather_buffer)) {
+      OONF_WARN(LOG_RFC7182_PROVIDER, "Signed data too long for gather buffer");
+      return 0;
+    }
+    memcpy(&_gather_buffer[len], src[i].data, src[i].length);
+    len += src[i].length;
+  }
+  return len;
+}
+
 /**
  * 'Identity' hash function as defined in RFC7182
  * @param sig rfc5444 signature
@@ -77,6 +77,17 @@ struct rfc7182_hash {
   struct avl_node _node;
 };
 
+/**
+ * One fragment of scattered data for a signature
+ */
+struct rfc7182_iov {
+  /*! pointer to data */
+  const void *data;
+
+  /*! length of data */
+  size_t length;
+};
+
 /**
  * representation of a crypto function for signatures
  */
@@ -129,6 +140,41 @@ struct rfc7182_crypt {
       const void *src, size_t src_len,
       const void *key, size_t key_len);
 
+  /*! size of provider specific key context, 0 if not supported */
+  size_t key_context_size;
+
+  /**
+   * Precalculates the key dependant state of the crypto function
+   * (e.g. the HMAC inner/outer pad state) so it can be reused for
+   * multiple signatures.
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param ctx pointer to key context of 'key_context_size' bytes
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*init_key_context)(struct rfc7182_crypt *crypt,
+      struct rfc7182_hash *hash, void *ctx,
+      const void *key, size_t key_len);
+
+  /**
+   * Creates a cryptographic signature for a scattered data block
+   * based on a precalculated key context.
+   * @param crypt this crypto definition
+   * @param hash the definition of the hash
+   * @param ctx pointer to initialized key context
+   * @param dst output buffer for cryptographic signature
+   * @param dst_len pointer to length of output buffer, will be set to
+   *   length of signature afterwards
+   * @param src array of fragments of unsigned original data
+   * @param src_count number of fragments
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign_iov)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash,
+      const void *ctx, void *dst, size_t *dst_len,
+      const struct rfc7182_iov *src, size_t src_count);
+
   /**
    * Encrypts a data block.
    * @param crypt this crypto definition
@@ -167,6 +213,14 @@ struct rfc7182_crypt {
   struct avl_node _node;
 };
 
+enum {
+  /*! maximum length of a key stored in the key context cache */
+  RFC7182_MAX_CACHED_KEY_LENGTH = 256,
+
+  /*! maximum number of cached key contexts */
+  RFC7182_KEY_CONTEXT_CACHE_SIZE = 16,
+};
+
 /*! subsystem identifier */
 #define OONF_RFC7182_PROVIDER_SUBSYSTEM "rfc7182_provider"
 
@@ -184,6 +238,16 @@ EXPORT void rfc7182_add_crypt(struct rfc7182_crypt *);
 EXPORT void rfc7182_remove_crypt(struct rfc7182_crypt *);
 EXPORT struct avl_tree *rfc7182_get_crypt_tree(void);
 
+EXPORT int rfc7182_sign_iov(struct rfc7182_crypt *crypt,
+    struct rfc7182_hash *hash, void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count,
+    const void *key, size_t key_len);
+EXPORT bool rfc7182_validate_iov(struct rfc7182_crypt *crypt,
+    struct rfc7182_hash *hash,
+    const void *encrypted, size_t encrypted_length,
+    const struct rfc7182_iov *src, size_t src_count,
+    const void *key, size_t key_len);
+
 /**
  * @param id RFC7182 hash id
  * @return hash provider, NULL if unregistered id
@@ -229,6 +229,7 @@ dlep_extension_router_process_destination(
         ext->id, result);
     return result;
   }
+  dlep_session_mark_l2neigh_changed(session, &mac);
   return 0;
 }
 
@@ -399,5 +400,9 @@ _process_interface_specific_update(
         ext->id, result);
     return result;
   }
+
+  if (!session->radio) {
+    dlep_session_mark_l2net_changed(session);
+  }
   return 0;
 }
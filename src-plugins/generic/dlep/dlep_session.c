@@ -48,6 +48,7 @@
 #include "common/avl_comp.h"
 #include "core/oonf_logging.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_stream_socket.h"
 #include "subsystems/oonf_timer.h"
 
@@ -58,9 +59,20 @@
 /**
  * internal constants of DLEP session
  */
+/**
+ * Layer2 neighbor with changes not yet committed to the database
+ */
+struct _l2_changed_neighbor {
+  /*! MAC address of layer2 neighbor */
+  struct netaddr mac;
+
+  /*! hook into the sessions tree of changed neighbors */
+  struct avl_node _node;
+};
+
 enum {
-  /*! size increase step for DLEP value storage */
-  SESSION_VALUE_STEP = 128,
+  /*! maximum number of TLVs in a single signal (4 byte TLV header) */
+  SESSION_VALUE_MAX_COUNT = UINT16_MAX / 4,
 };
 
 static int _update_allowed_tlvs(struct dlep_session *session);
@@ -80,6 +92,7 @@ static enum dlep_parser_error _process_tlvs(struct dlep_session *,
     uint16_t signal_type, uint16_t signal_length, const uint8_t *tlvs);
 static void _send_terminate(struct dlep_session *session);
 static void _cb_destination_timeout(struct oonf_timer_instance *);
+static void _cb_destination_update(struct oonf_timer_instance *);
 
 static struct oonf_class _tlv_class = {
     .name = "dlep reader tlv",
@@ -91,11 +104,21 @@ static struct oonf_class _local_neighbor_class = {
     .size = sizeof(struct dlep_local_neighbor),
 };
 
+static struct oonf_class _l2_changed_class = {
+    .name = "dlep changed l2 neighbor",
+    .size = sizeof(struct _l2_changed_neighbor),
+};
+
 static struct oonf_timer_class _destination_ack_class = {
     .name = "dlep destination ack",
     .callback = _cb_destination_timeout,
 };
 
+static struct oonf_timer_class _destination_update_class = {
+    .name = "dlep destination update",
+    .callback = _cb_destination_update,
+};
+
 /**
  * Initialize DLEP session system
  */
@@ -103,7 +126,9 @@ void
 dlep_session_init(void) {
   oonf_class_add(&_tlv_class);
   oonf_class_add(&_local_neighbor_class);
+  oonf_class_add(&_l2_changed_class);
   oonf_timer_add(&_destination_ack_class);
+  oonf_timer_add(&_destination_update_class);
 }
 
 /**
@@ -129,6 +154,9 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname,
 
   avl_init(&parser->allowed_tlvs, avl_comp_uint16, false);
   avl_init(&session->local_neighbor_tree, avl_comp_netaddr, false);
+  list_init_head(&session->_pending_updates);
+  session->_update_timer.class = &_destination_update_class;
+  avl_init(&session->_l2_changed_neighbors, avl_comp_netaddr, false);
 
   session->log_source = log_source;
   session->l2_origin = l2_origin;
@@ -159,7 +187,8 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname,
   /* remember the sessions */
   parser->extension_count =  dlep_extension_get_tree()->count;
 
-  parser->values = calloc(SESSION_VALUE_STEP,
+  /* a signal cannot contain more TLVs, so parsing never reallocates */
+  parser->values = calloc(SESSION_VALUE_MAX_COUNT,
       sizeof(struct dlep_parser_value));
   if (!parser->values) {
     OONF_WARN(session->log_source,
@@ -167,6 +196,7 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname,
     dlep_session_remove(session);
     return -1;
   }
+  parser->value_max_count = SESSION_VALUE_MAX_COUNT;
 
   i = 0;
   avl_for_each_element( dlep_extension_get_tree(), ext, _node) {
@@ -193,6 +223,7 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname,
 void
 dlep_session_remove(struct dlep_session *session) {
   struct dlep_parser_tlv *tlv, *tlv_it;
+  struct _l2_changed_neighbor *changed, *changed_it;
   struct dlep_session_parser *parser;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
@@ -202,6 +233,13 @@ dlep_session_remove(struct dlep_session *session) {
       session->l2_listener.name,
       netaddr_socket_to_string(&nbuf, &session->remote_socket));
 
+  if (session->update_stats.batches > 0) {
+    OONF_INFO(session->log_source, "Destination updates on %s: %"PRIu64" sent"
+        " in %"PRIu64" batches, %"PRIu64" suppressed",
+        session->l2_listener.name, session->update_stats.sent,
+        session->update_stats.batches, session->update_stats.suppressed);
+  }
+
   os_interface_remove(&session->l2_listener);
 
   parser = &session->parser;
@@ -212,12 +250,25 @@ dlep_session_remove(struct dlep_session *session) {
 
   oonf_timer_stop(&session->local_event_timer);
   oonf_timer_stop(&session->remote_heartbeat_timeout);
+  oonf_timer_stop(&session->_update_timer);
+
+  avl_for_each_element_safe(&session->_l2_changed_neighbors,
+      changed, _node, changed_it) {
+    avl_remove(&session->_l2_changed_neighbors, &changed->_node);
+    oonf_class_free(&_l2_changed_class, changed);
+  }
+  session->_l2_net_changed = false;
 
   free (parser->extensions);
   parser->extensions = NULL;
 
   free (parser->values);
   parser->values = NULL;
+  parser->value_max_count = 0;
+
+  free (parser->tlv_table);
+  parser->tlv_table = NULL;
+  parser->tlv_table_size = 0;
 }
 
 /**
@@ -305,6 +356,9 @@ dlep_session_process_tcp(struct oonf_stream_session *tcp_session,
       abuf_getptr(&tcp_session->in),
       abuf_getlen(&tcp_session->in));
 
+  /* notify layer2 listeners once for all signals of this read */
+  dlep_session_commit_l2_changes(session);
+
   OONF_DEBUG(session->log_source,
       "Processed %" PRINTF_SSIZE_T_SPECIFIER " bytes", processed);
   if (processed < 0) {
@@ -485,6 +539,9 @@ void
 dlep_session_remove_local_neighbor(struct dlep_session *session,
     struct dlep_local_neighbor *local) {
   avl_remove(&session->local_neighbor_tree, &local->_node);
+  if (list_is_node_added(&local->_update_node)) {
+    list_remove(&local->_update_node);
+  }
   oonf_timer_stop(&local->_ack_timeout);
   oonf_class_free(&_local_neighbor_class, local);
 }
@@ -529,6 +586,170 @@ dlep_session_get_local_l2_neighbor(struct dlep_session *session,
   return l2neigh;
 }
 
+/**
+ * Mark a local neighbor for a destination update. If batching is
+ * configured, all pending updates are sent in batches and multiple
+ * changes of a neighbor between two batches are merged into a single
+ * destination update. Otherwise the update is sent immediately.
+ * @param session dlep session
+ * @param local DLEP neighbor
+ */
+void
+dlep_session_queue_destination_update(struct dlep_session *session,
+    struct dlep_local_neighbor *local) {
+  int64_t due;
+
+  if (list_is_node_added(&local->_update_node)) {
+    /* update already pending */
+    session->update_stats.suppressed++;
+    return;
+  }
+
+  if (session->cfg.update_interval == 0 && session->cfg.update_batch_size <= 0) {
+    /* batching is disabled */
+    dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &local->addr);
+    local->changed = false;
+    return;
+  }
+
+  list_add_tail(&session->_pending_updates, &local->_update_node);
+
+  if (oonf_timer_is_active(&session->_update_timer)) {
+    return;
+  }
+
+  /* keep minimal interval between two batches */
+  due = oonf_clock_get_relative(
+      session->_last_update_batch + session->cfg.update_interval);
+  if (due < 1) {
+    due = 1;
+  }
+  oonf_timer_start(&session->_update_timer, due);
+}
+
+/**
+ * Send the next batch of pending destination updates of a session
+ * @param session dlep session
+ */
+void
+dlep_session_flush_destination_updates(struct dlep_session *session) {
+  struct dlep_local_neighbor *local;
+  int32_t count;
+
+  count = 0;
+  while (!list_is_empty(&session->_pending_updates)
+      && (session->cfg.update_batch_size <= 0
+          || count < session->cfg.update_batch_size)) {
+    local = list_first_element(&session->_pending_updates, local, _update_node);
+    list_remove(&local->_update_node);
+
+    if (local->state != DLEP_NEIGHBOR_UP_ACKED) {
+      /* update will be handled by destination up ack */
+      continue;
+    }
+
+    if (!dlep_session_generate_signal(session,
+        DLEP_DESTINATION_UPDATE, &local->addr)) {
+      session->update_stats.sent++;
+      count++;
+    }
+    local->changed = false;
+  }
+
+  session->_last_update_batch = oonf_clock_getNow();
+
+  if (count > 0) {
+    /* send all updates with a single write */
+    session->update_stats.batches++;
+    session->cb_send_buffer(session, 0);
+
+    OONF_DEBUG(session->log_source, "Sent batch of %d destination updates"
+        " (total: %"PRIu64" sent, %"PRIu64" batches, %"PRIu64" suppressed)",
+        count, session->update_stats.sent, session->update_stats.batches,
+        session->update_stats.suppressed);
+  }
+
+  if (!list_is_empty(&session->_pending_updates)) {
+    oonf_timer_start(&session->_update_timer,
+        session->cfg.update_interval > 0 ? session->cfg.update_interval : 1);
+  }
+}
+
+/**
+ * Remember that the layer2 data of a neighbor has been changed by
+ * an incoming signal. The layer2 database will be notified by
+ * dlep_session_commit_l2_changes().
+ * @param session dlep session
+ * @param mac MAC address of layer2 neighbor
+ */
+void
+dlep_session_mark_l2neigh_changed(
+    struct dlep_session *session, const struct netaddr *mac) {
+  struct _l2_changed_neighbor *changed;
+
+  if (avl_find(&session->_l2_changed_neighbors, mac)) {
+    return;
+  }
+
+  changed = oonf_class_malloc(&_l2_changed_class);
+  if (!changed) {
+    return;
+  }
+
+  memcpy(&changed->mac, mac, sizeof(changed->mac));
+  changed->_node.key = &changed->mac;
+  avl_insert(&session->_l2_changed_neighbors, &changed->_node);
+}
+
+/**
+ * Remember that the layer2 network data has been changed by an
+ * incoming signal. The layer2 database will be notified by
+ * dlep_session_commit_l2_changes().
+ * @param session dlep session
+ */
+void
+dlep_session_mark_l2net_changed(struct dlep_session *session) {
+  session->_l2_net_changed = true;
+}
+
+/**
+ * Commit all layer2 changes of a session collected since the last
+ * call. Each changed neighbor and the network trigger a single
+ * layer2 database event.
+ * @param session dlep session
+ */
+void
+dlep_session_commit_l2_changes(struct dlep_session *session) {
+  struct _l2_changed_neighbor *changed, *changed_it;
+  struct oonf_layer2_net *l2net;
+  struct oonf_layer2_neigh *l2neigh;
+
+  if (avl_is_empty(&session->_l2_changed_neighbors)
+      && !session->_l2_net_changed) {
+    return;
+  }
+
+  l2net = oonf_layer2_net_get(session->l2_listener.name);
+
+  avl_for_each_element_safe(&session->_l2_changed_neighbors,
+      changed, _node, changed_it) {
+    if (l2net) {
+      l2neigh = oonf_layer2_neigh_get(l2net, &changed->mac);
+      if (l2neigh) {
+        oonf_layer2_neigh_commit(l2neigh);
+      }
+    }
+
+    avl_remove(&session->_l2_changed_neighbors, &changed->_node);
+    oonf_class_free(&_l2_changed_class, changed);
+  }
+
+  if (l2net && session->_l2_net_changed) {
+    oonf_layer2_net_commit(l2net);
+  }
+  session->_l2_net_changed = false;
+}
+
 /**
  * Generate a DLEP signal/message
  * @param session dlep session
@@ -673,8 +894,9 @@ static int
 _update_allowed_tlvs(struct dlep_session *session) {
   struct dlep_session_parser *parser;
   struct dlep_parser_tlv *tlv, *tlv_it;
+  struct dlep_parser_tlv **table;
   struct dlep_extension *ext;
-  size_t e, t;
+  size_t e, t, table_size;
   uint16_t id;
 
   parser = &session->parser;
@@ -692,7 +914,7 @@ _update_allowed_tlvs(struct dlep_session *session) {
     for (t = 0; t < ext->tlv_count; t++) {
       /* for all tlvs */
       id = ext->tlvs[t].id;
-      tlv = dlep_parser_get_tlv(parser, id);
+      tlv = avl_find_element(&parser->allowed_tlvs, &id, tlv, _node);
       if (!tlv) {
         /* new tlv found! */
         if (!(tlv = _add_session_tlv(parser, id))) {
@@ -721,6 +943,29 @@ _update_allowed_tlvs(struct dlep_session *session) {
     }
   }
 
+  /* compile allowed tlvs into a lookup table indexed by tlv id */
+  table_size = 0;
+  if (!avl_is_empty(&parser->allowed_tlvs)) {
+    tlv = avl_last_element(&parser->allowed_tlvs, tlv, _node);
+    table_size = tlv->id + 1;
+  }
+
+  table = calloc(table_size > 0 ? table_size : 1, sizeof(*table));
+  if (!table) {
+    OONF_WARN(session->log_source, "Cannot allocate TLV lookup table");
+    free(parser->tlv_table);
+    parser->tlv_table = NULL;
+    parser->tlv_table_size = 0;
+    return -1;
+  }
+
+  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+    table[tlv->id] = tlv;
+  }
+
+  free(parser->tlv_table);
+  parser->tlv_table = table;
+  parser->tlv_table_size = table_size;
   return 0;
 }
 
@@ -828,6 +1073,18 @@ _cb_destination_timeout(struct oonf_timer_instance *ptr) {
   }
 }
 
+/**
+ * Callback to send the next batch of destination updates
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_destination_update(struct oonf_timer_instance *ptr) {
+  struct dlep_session *session;
+
+  session = container_of(ptr, struct dlep_session, _update_timer);
+  dlep_session_flush_destination_updates(session);
+}
+
 /**
  * parse a stream of DLEP tlvs
  * @param session dlep session
@@ -850,9 +1107,14 @@ _parse_tlvstream(struct dlep_session *session,
   tlv_count = 0;
   idx = 0;
 
-  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
-    tlv->tlv_first = -1;
-    tlv->tlv_last = -1;
+  /* invalidate the values of the last signal */
+  parser->generation++;
+  if (parser->generation == 0) {
+    /* wrap around, make sure no stale generation matches */
+    avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+      tlv->generation = 0;
+    }
+    parser->generation = 1;
   }
 
   while (idx < length) {
@@ -893,16 +1155,9 @@ _parse_tlvstream(struct dlep_session *session,
       return DLEP_NEW_PARSER_ILLEGAL_TLV_LENGTH;
     }
 
-    /* check if we need to allocate more space for value pointers */
-    if (parser->value_max_count == tlv_count) {
-      /* allocate more */
-      value = realloc(parser->values,
-          sizeof(*value) * (tlv_count + SESSION_VALUE_STEP));
-      if (!value) {
-        return DLEP_NEW_PARSER_OUT_OF_MEMORY;
-      }
-      parser->value_max_count += SESSION_VALUE_STEP;
-      parser->values = value;
+    if (tlv_count == parser->value_max_count) {
+      /* cannot happen, value array is sized for the largest signal */
+      return DLEP_NEW_PARSER_INTERNAL_ERROR;
     }
 
     OONF_DEBUG_HEX(session->log_source, &buffer[idx], tlv_length, "Received TLV %u", tlv_type);
@@ -913,8 +1168,9 @@ _parse_tlvstream(struct dlep_session *session,
     value->index = idx;
     value->length = tlv_length;
 
-    if (tlv->tlv_last == -1) {
+    if (tlv->generation != parser->generation) {
       /* first tlv */
+      tlv->generation = parser->generation;
       tlv->tlv_first = tlv_count;
     }
     else {
@@ -969,7 +1225,7 @@ _check_mandatory(struct dlep_session *session,
       return DLEP_NEW_PARSER_INTERNAL_ERROR;
     }
 
-    if (tlv->tlv_first == -1) {
+    if (!dlep_session_get_tlv_first_value(session, tlv)) {
       OONF_WARN(session->log_source, "Missing mandatory TLV"
           " %u in extension %d",
           extsig->mandatory_tlvs[t], ext->id);
@@ -1011,8 +1267,9 @@ _check_duplicate(struct dlep_session *session,
   }
 
   for (t = 0; t < extsig->supported_tlv_count; t++) {
-    tlv = avl_find_element(&parser->allowed_tlvs, &extsig->supported_tlvs[t], tlv, _node);
-    if (tlv == NULL || tlv->tlv_first == tlv->tlv_last) {
+    tlv = dlep_parser_get_tlv(parser, extsig->supported_tlvs[t]);
+    if (tlv == NULL || tlv->generation != parser->generation
+        || tlv->tlv_first == tlv->tlv_last) {
       continue;
     }
 
@@ -52,6 +52,7 @@ struct dlep_writer;
 #include "common/common_types.h"
 #include "common/avl.h"
 #include "common/autobuf.h"
+#include "common/list.h"
 #include "common/netaddr.h"
 #include "subsystems/oonf_layer2.h"
 #include "subsystems/oonf_stream_socket.h"
@@ -106,6 +107,9 @@ struct dlep_parser_tlv {
   /*! index of last session value for tlv, -1 if none */
   int32_t tlv_last;
 
+  /*! parser generation tlv_first/tlv_last are valid for */
+  uint32_t generation;
+
   /*! minimal length of tlv */
   uint16_t length_min;
 
@@ -140,6 +144,15 @@ struct dlep_session_parser {
   /*! tree of allowed TLVs for this session */
   struct avl_tree allowed_tlvs;
 
+  /*! lookup table of allowed TLVs indexed by TLV id */
+  struct dlep_parser_tlv **tlv_table;
+
+  /*! number of entries in TLV lookup table */
+  size_t tlv_table_size;
+
+  /*! generation of the currently parsed signal */
+  uint32_t generation;
+
   /*! array of TLV values */
   struct dlep_parser_value *values;
 
@@ -220,6 +233,9 @@ struct dlep_local_neighbor {
 
   /*! hook into the sessions treee of neighbors */
   struct avl_node _node;
+
+  /*! hook into the sessions list of pending destination updates */
+  struct list_entity _update_node;
 };
 
 /**
@@ -240,6 +256,26 @@ struct dlep_session_config {
 
   /*! true if proxied neighbors should be sent with DLEP */
   bool send_proxied;
+
+  /*! minimal interval between two batches of destination updates */
+  uint64_t update_interval;
+
+  /*! maximum number of destination updates sent in one batch */
+  int32_t update_batch_size;
+};
+
+/**
+ * Statistics of the destination update batching of a session
+ */
+struct dlep_session_update_stats {
+  /*! number of destination update signals sent */
+  uint64_t sent;
+
+  /*! number of updates merged into an already pending update */
+  uint64_t suppressed;
+
+  /*! number of update batches sent */
+  uint64_t batches;
 };
 
 /**
@@ -298,6 +334,24 @@ struct dlep_session {
   /*! remote endpoint of current communication */
   union netaddr_socket remote_socket;
 
+  /*! statistics of destination update batching */
+  struct dlep_session_update_stats update_stats;
+
+  /*! list of local neighbors with pending destination update */
+  struct list_entity _pending_updates;
+
+  /*! timer to send the next batch of destination updates */
+  struct oonf_timer_instance _update_timer;
+
+  /*! absolute timestamp of the last batch of destination updates */
+  uint64_t _last_update_batch;
+
+  /*! MACs of layer2 neighbors with uncommitted changes */
+  struct avl_tree _l2_changed_neighbors;
+
+  /*! true if layer2 network has uncommitted changes */
+  bool _l2_net_changed;
+
   /*! tree of all dlep sessions of an interface */
   struct avl_node _node;
 };
@@ -333,6 +387,13 @@ void dlep_session_remove_local_neighbor(
     struct dlep_session *session, struct dlep_local_neighbor *local);
 struct oonf_layer2_neigh *dlep_session_get_local_l2_neighbor(
     struct dlep_session *session, const struct netaddr *neigh);
+void dlep_session_queue_destination_update(
+    struct dlep_session *session, struct dlep_local_neighbor *local);
+void dlep_session_flush_destination_updates(struct dlep_session *session);
+void dlep_session_mark_l2neigh_changed(
+    struct dlep_session *session, const struct netaddr *mac);
+void dlep_session_mark_l2net_changed(struct dlep_session *session);
+void dlep_session_commit_l2_changes(struct dlep_session *session);
 
 /**
  * get the dlep session tlv
@@ -342,8 +403,10 @@ struct oonf_layer2_neigh *dlep_session_get_local_l2_neighbor(
  */
 static INLINE struct dlep_parser_tlv *
 dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
-    struct dlep_parser_tlv *tlv;
-  return avl_find_element(&parser->allowed_tlvs, &tlvtype, tlv, _node);
+  if (tlvtype >= parser->tlv_table_size) {
+    return NULL;
+  }
+  return parser->tlv_table[tlvtype];
 }
 
 /**
@@ -355,7 +418,8 @@ dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
 static INLINE struct dlep_parser_value *
 dlep_session_get_tlv_first_value(struct dlep_session *session,
     struct dlep_parser_tlv *tlv) {
-  if (tlv->tlv_first == -1) {
+  if (tlv->generation != session->parser.generation
+      || tlv->tlv_first == -1) {
     return NULL;
   }
   return &session->parser.values[tlv->tlv_first];
@@ -640,9 +640,9 @@ _l2_neigh_changed(struct oonf_layer2_neigh *l2neigh,
           local->changed = true;
           break;
         case DLEP_NEIGHBOR_UP_ACKED:
-          dlep_session_generate_signal(&radio_session->session,
-              DLEP_DESTINATION_UPDATE, mac);
-          local->changed = false;
+          local->changed = true;
+          dlep_session_queue_destination_update(
+              &radio_session->session, local);
           break;
         case DLEP_NEIGHBOR_IDLE:
         case DLEP_NEIGHBOR_DOWN_SENT:
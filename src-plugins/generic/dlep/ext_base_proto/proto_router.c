@@ -396,6 +396,7 @@ _router_process_peer_init_ack(
         ext->id, result);
     return result;
   }
+  dlep_session_mark_l2net_changed(session);
 
   OONF_DEBUG(session->log_source, "Remote heartbeat interval %"PRIu64,
       session->remote_heartbeat_interval);
@@ -434,6 +435,7 @@ _router_process_peer_update(
         ext->id, result);
     return -1;
   }
+  dlep_session_mark_l2net_changed(session);
 
   /* we don't support IP address exchange at the moment */
 
@@ -495,6 +497,7 @@ _router_process_destination_up(
         ext->id, result);
     return result;
   }
+  dlep_session_mark_l2neigh_changed(session, &mac);
 
   /* generate ACK */
   return dlep_session_generate_signal(
@@ -601,6 +604,7 @@ _router_process_destination_update(
         ext->id, result);
     return result;
   }
+  dlep_session_mark_l2neigh_changed(session, &mac);
 
   return 0;
 }
@@ -102,6 +102,16 @@ static struct cfg_schema_entry _radio_entries[] = {
       "Report 802.11s proxied mac address for neighbors"),
   CFG_MAP_BOOL(dlep_radio_if, interf.session.cfg.send_neighbors, "not_proxied", "false",
       "Report direct neighbors"),
+
+  CFG_MAP_CLOCK_MINMAX(dlep_radio_if, interf.session.cfg.update_interval,
+      "update_interval", "0.000",
+      "Minimal interval in seconds between two batches of destination updates."
+      " Updates are sent immediately if this and update_batch_size are 0",
+      0, 65535 * 1000),
+  CFG_MAP_INT32_MINMAX(dlep_radio_if, interf.session.cfg.update_batch_size,
+      "update_batch_size", "0",
+      "Maximum number of destination updates sent in one batch, 0 for unlimited",
+      0, false, 0, 65535),
 };
 
 static struct cfg_schema_section _radio_section = {
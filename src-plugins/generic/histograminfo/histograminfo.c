@@ -0,0 +1,377 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/autobuf.h"
+#include "common/avl.h"
+#include "common/isonumber.h"
+#include "common/string.h"
+#include "common/template.h"
+
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_histogram.h"
+#include "subsystems/oonf_telnet.h"
+#include "subsystems/oonf_viewer.h"
+
+#include "histograminfo/histograminfo.h"
+
+/* definitions */
+#define LOG_HISTOGRAMINFO _oonf_histograminfo_subsystem.logging
+
+/*! name of telnet command to reset histograms */
+#define TELNET_CMD_RESET OONF_HISTOGRAMINFO_SUBSYSTEM "_reset"
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static enum oonf_telnet_result _cb_histograminfo(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_histograminfo_help(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_histogram_reset(struct oonf_telnet_data *con);
+
+static void _initialize_probe_values(struct oonf_viewer_template *template,
+    struct oonf_histogram *h);
+static void _initialize_bucket_values(struct oonf_viewer_template *template,
+    unsigned idx, uint64_t count);
+
+static int _cb_create_text_probe(struct oonf_viewer_template *);
+static int _cb_create_text_bucket(struct oonf_viewer_template *);
+
+/*
+ * list of template keys and corresponding buffers for values.
+ *
+ * The keys are API, so they should not be changed after published
+ */
+
+/*! template key for name of probe */
+#define KEY_PROBE                       "probe"
+
+/*! template key for unit of probe values */
+#define KEY_PROBE_UNIT                  "probe_unit"
+
+/*! template key for number of recorded values */
+#define KEY_PROBE_COUNT                 "probe_count"
+
+/*! template key for smallest recorded value */
+#define KEY_PROBE_MIN                   "probe_min"
+
+/*! template key for largest recorded value */
+#define KEY_PROBE_MAX                   "probe_max"
+
+/*! template key for average of recorded values */
+#define KEY_PROBE_AVG                   "probe_avg"
+
+/*! template key for 50th percentile of recorded values */
+#define KEY_PROBE_P50                   "probe_p50"
+
+/*! template key for 90th percentile of recorded values */
+#define KEY_PROBE_P90                   "probe_p90"
+
+/*! template key for 99th percentile of recorded values */
+#define KEY_PROBE_P99                   "probe_p99"
+
+/*! template key for lower boundary of histogram bucket */
+#define KEY_BUCKET_MIN                  "bucket_min"
+
+/*! template key for upper boundary of histogram bucket */
+#define KEY_BUCKET_MAX                  "bucket_max"
+
+/*! template key for number of values in histogram bucket */
+#define KEY_BUCKET_COUNT                "bucket_count"
+
+/*
+ * buffer space for values that will be assembled
+ * into the output of the plugin
+ */
+static char                             _value_probe[64];
+static char                             _value_probe_unit[16];
+static struct isonumber_str             _value_probe_count;
+static struct isonumber_str             _value_probe_min;
+static struct isonumber_str             _value_probe_max;
+static struct isonumber_str             _value_probe_avg;
+static struct isonumber_str             _value_probe_p50;
+static struct isonumber_str             _value_probe_p90;
+static struct isonumber_str             _value_probe_p99;
+
+static struct isonumber_str             _value_bucket_min;
+static struct isonumber_str             _value_bucket_max;
+static struct isonumber_str             _value_bucket_count;
+
+/* definition of the template data entries for JSON and table output */
+static struct abuf_template_data_entry _tde_probe_key[] = {
+    { KEY_PROBE, _value_probe, true },
+    { KEY_PROBE_UNIT, _value_probe_unit, true },
+};
+static struct abuf_template_data_entry _tde_probe[] = {
+    { KEY_PROBE_COUNT, _value_probe_count.buf, false },
+    { KEY_PROBE_MIN, _value_probe_min.buf, false },
+    { KEY_PROBE_MAX, _value_probe_max.buf, false },
+    { KEY_PROBE_AVG, _value_probe_avg.buf, false },
+    { KEY_PROBE_P50, _value_probe_p50.buf, false },
+    { KEY_PROBE_P90, _value_probe_p90.buf, false },
+    { KEY_PROBE_P99, _value_probe_p99.buf, false },
+};
+static struct abuf_template_data_entry _tde_bucket[] = {
+    { KEY_BUCKET_MIN, _value_bucket_min.buf, false },
+    { KEY_BUCKET_MAX, _value_bucket_max.buf, false },
+    { KEY_BUCKET_COUNT, _value_bucket_count.buf, false },
+};
+
+static struct abuf_template_storage _template_storage;
+
+/* Template Data objects (contain one or more Template Data Entries) */
+static struct abuf_template_data _td_probe[] = {
+    { _tde_probe_key, ARRAYSIZE(_tde_probe_key) },
+    { _tde_probe, ARRAYSIZE(_tde_probe) },
+};
+static struct abuf_template_data _td_bucket[] = {
+    { _tde_probe_key, ARRAYSIZE(_tde_probe_key) },
+    { _tde_bucket, ARRAYSIZE(_tde_bucket) },
+};
+
+/* OONF viewer templates (based on Template Data arrays) */
+static struct oonf_viewer_template _templates[] = {
+    {
+        .data = _td_probe,
+        .data_size = ARRAYSIZE(_td_probe),
+        .json_name = "probe",
+        .cb_function = _cb_create_text_probe,
+    },
+    {
+        .data = _td_bucket,
+        .data_size = ARRAYSIZE(_td_bucket),
+        .json_name = "bucket",
+        .cb_function = _cb_create_text_bucket,
+    },
+};
+
+/* telnet commands of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+    TELNET_CMD(OONF_HISTOGRAMINFO_SUBSYSTEM, _cb_histograminfo,
+        "", .help_handler = _cb_histograminfo_help),
+    TELNET_CMD(TELNET_CMD_RESET, _cb_histogram_reset,
+        "\"" TELNET_CMD_RESET "\": resets all histograms\n"
+        "\"" TELNET_CMD_RESET " <probe>\": resets a single histogram\n"),
+};
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_HISTOGRAM_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+  OONF_VIEWER_SUBSYSTEM,
+};
+
+static struct oonf_subsystem _oonf_histograminfo_subsystem = {
+  .name = OONF_HISTOGRAMINFO_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "Histogram viewer for instrumentation probes",
+  .author = "Henning Rogge",
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_oonf_histograminfo_subsystem);
+
+/**
+ * Initialize plugin
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init(void) {
+  oonf_telnet_add(&_telnet_commands[0]);
+  oonf_telnet_add(&_telnet_commands[1]);
+  return 0;
+}
+
+/**
+ * Cleanup plugin
+ */
+static void
+_cleanup(void) {
+  oonf_telnet_remove(&_telnet_commands[1]);
+  oonf_telnet_remove(&_telnet_commands[0]);
+}
+
+/**
+ * Callback for the telnet command of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_histograminfo(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_handler(con->out, &_template_storage,
+      OONF_HISTOGRAMINFO_SUBSYSTEM, con->parameter,
+      _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback for the help output of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_histograminfo_help(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_help(con->out, OONF_HISTOGRAMINFO_SUBSYSTEM,
+      con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback for the reset telnet command of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_histogram_reset(struct oonf_telnet_data *con) {
+  struct oonf_histogram *h;
+
+  if (con->parameter == NULL || *con->parameter == 0) {
+    avl_for_each_element(oonf_histogram_get_tree(), h, _node) {
+      oonf_histogram_reset(h);
+    }
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  h = avl_find_element(oonf_histogram_get_tree(), con->parameter, h, _node);
+  if (h == NULL) {
+    abuf_appendf(con->out, "Unknown probe: %s\n", con->parameter);
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  oonf_histogram_reset(h);
+  return TELNET_RESULT_ACTIVE;
+}
+
+/**
+ * Initialize the value buffers for a histogram probe
+ * @param template viewer template
+ * @param h histogram
+ */
+static void
+_initialize_probe_values(struct oonf_viewer_template *template,
+    struct oonf_histogram *h) {
+  bool raw = template->create_raw;
+
+  strscpy(_value_probe, h->name, sizeof(_value_probe));
+  strscpy(_value_probe_unit, h->unit, sizeof(_value_probe_unit));
+
+  isonumber_from_u64(&_value_probe_count, h->count, "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_min, h->min, "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_max, h->max, "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_avg,
+      h->count > 0 ? h->sum / h->count : 0, "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_p50,
+      oonf_histogram_get_percentile(h, 50), "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_p90,
+      oonf_histogram_get_percentile(h, 90), "", 0, false, raw);
+  isonumber_from_u64(&_value_probe_p99,
+      oonf_histogram_get_percentile(h, 99), "", 0, false, raw);
+}
+
+/**
+ * Initialize the value buffers for a histogram bucket
+ * @param template viewer template
+ * @param idx bucket index
+ * @param count number of values in bucket
+ */
+static void
+_initialize_bucket_values(struct oonf_viewer_template *template,
+    unsigned idx, uint64_t count) {
+  bool raw = template->create_raw;
+
+  isonumber_from_u64(&_value_bucket_min,
+      oonf_histogram_get_bucket_min(idx), "", 0, false, raw);
+  isonumber_from_u64(&_value_bucket_max,
+      oonf_histogram_get_bucket_max(idx), "", 0, false, raw);
+  isonumber_from_u64(&_value_bucket_count, count, "", 0, false, raw);
+}
+
+/**
+ * Callback to generate text/json description of all histogram probes
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_probe(struct oonf_viewer_template *template) {
+  struct oonf_histogram *h;
+
+  avl_for_each_element(oonf_histogram_get_tree(), h, _node) {
+    _initialize_probe_values(template, h);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+  return 0;
+}
+
+/**
+ * Callback to generate text/json description of all non-empty
+ * histogram buckets
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_bucket(struct oonf_viewer_template *template) {
+  struct oonf_histogram *h;
+  unsigned i;
+
+  avl_for_each_element(oonf_histogram_get_tree(), h, _node) {
+    _initialize_probe_values(template, h);
+
+    for (i=0; i<OONF_HISTOGRAM_BUCKETS; i++) {
+      if (h->_buckets[i] == 0) {
+        continue;
+      }
+
+      _initialize_bucket_values(template, i, h->_buckets[i]);
+
+      /* generate template output */
+      oonf_viewer_output_print_line(template);
+    }
+  }
+  return 0;
+}
@@ -68,6 +68,8 @@ static int _init(void);
 static void _cleanup(void);
 
 static void _cb_l2gen_event(struct oonf_timer_instance *);
+static void _generate_neighbor(struct oonf_layer2_net *net,
+    int32_t idx, uint64_t value);
 
 static void _cb_config_changed(void);
 
@@ -89,6 +91,9 @@ struct _l2_generator_config {
 
   /*! proxied MAC behind neighbor for event generation */
   struct netaddr destination;
+
+  /*! number of neighbors generated, starting with the neighbor mac */
+  int32_t neighbor_count;
 };
 
 static struct oonf_timer_class _l2gen_timer_info = {
@@ -107,13 +112,16 @@ static struct _l2_generator_config _l2gen_config;
 static struct cfg_schema_entry _l2gen_entries[] = {
   CFG_MAP_CLOCK_MIN(_l2_generator_config, interval, "interval", "3.000",
       "Interval between L2 generator events",
-      500),
+      100),
   CFG_MAP_STRING_ARRAY(_l2_generator_config, interface, "interface", "eth0",
       "Interface of example radio", IF_NAMESIZE),
   CFG_MAP_NETADDR_MAC48(_l2_generator_config, neighbor, "neighbor", "02:00:00:00:00:01",
       "Mac address of example radio", false, false),
   CFG_MAP_NETADDR_MAC48(_l2_generator_config, destination, "destination", "02:00:00:00:00:02",
       "Mac address of example radio destination", false, true),
+  CFG_MAP_INT32_MINMAX(_l2_generator_config, neighbor_count, "neighbor_count", "1",
+      "Number of generated neighbors, mac addresses are counted up from"
+      " the neighbor mac address", 0, false, 1, 65535),
   CFG_MAP_BOOL(_l2_generator_config, active, "active", "false",
       "Activates artificially generated layer2 data"),
 };
@@ -186,7 +194,7 @@ _cb_l2gen_event(struct oonf_timer_instance *ptr __attribute((unused))) {
   enum oonf_layer2_network_index net_idx;
   enum oonf_layer2_neighbor_index neigh_idx;
   struct oonf_layer2_net *net;
-  struct oonf_layer2_neigh *neigh;
+  int32_t i;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str buf1;
 #endif
@@ -225,20 +233,48 @@ _cb_l2gen_event(struct oonf_timer_instance *ptr __attribute((unused))) {
     return;
   }
 
-  neigh = oonf_layer2_neigh_add(net, &_l2gen_config.neighbor);
+  for (i = 0; i < _l2gen_config.neighbor_count; i++) {
+    _generate_neighbor(net, i, event_counter);
+  }
+}
+
+/**
+ * Generate the layer2 data of a single neighbor
+ * @param net layer2 network of neighbor
+ * @param idx index of neighbor, added to the configured neighbor mac
+ * @param value value for all layer2 data of neighbor
+ */
+static void
+_generate_neighbor(struct oonf_layer2_net *net,
+    int32_t idx, uint64_t value) {
+  enum oonf_layer2_neighbor_index neigh_idx;
+  struct oonf_layer2_neigh *neigh;
+  struct netaddr mac;
+  uint8_t binmac[6];
+  uint32_t low;
+
+  /* count up the lower three bytes of the configured mac */
+  netaddr_to_binary(binmac, &_l2gen_config.neighbor, sizeof(binmac));
+  low = (binmac[3] << 16) + (binmac[4] << 8) + binmac[5] + idx;
+  binmac[3] = (low >> 16) & 0xff;
+  binmac[4] = (low >> 8) & 0xff;
+  binmac[5] = low & 0xff;
+  netaddr_from_binary(&mac, binmac, sizeof(binmac), AF_MAC48);
+
+  neigh = oonf_layer2_neigh_add(net, &mac);
   if (neigh == NULL) {
     OONF_WARN(LOG_L2GEN, "Cannot allocate layer2_neighbor");
     return;
   }
 
-  if (netaddr_get_address_family(&_l2gen_config.destination) == AF_MAC48) {
+  if (idx == 0
+      && netaddr_get_address_family(&_l2gen_config.destination) == AF_MAC48) {
     oonf_layer2_destination_add(neigh, &_l2gen_config.destination, _origin);
   }
-  memcpy(&neigh->addr, &_l2gen_config.neighbor, sizeof(neigh->addr));
   neigh->last_seen = oonf_clock_getNow();
 
   for (neigh_idx = 0; neigh_idx < OONF_LAYER2_NEIGH_COUNT; neigh_idx++) {
-    oonf_layer2_set_value(&neigh->data[neigh_idx], _origin, event_counter);
+    oonf_layer2_set_value(&neigh->data[neigh_idx], _origin, value);
   }
   oonf_layer2_neigh_commit(neigh);
 }
@@ -251,6 +251,42 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf,
   oonf_layer2_neigh_commit(l2neigh);
 }
 
+/**
+ * Process NL80211_CMD_DEL_STATION multicast event
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ */
+void
+nl80211_process_del_station_event(struct nl80211_if *interf,
+    struct nlmsghdr *hdr) {
+  struct oonf_layer2_neigh *l2neigh;
+  struct netaddr l2neigh_mac;
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct genlmsghdr *gnlh;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  gnlh = nlmsg_data(hdr);
+
+  nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+      genlmsg_attrlen(gnlh, 0), NULL);
+
+  if (!tb[NL80211_ATTR_MAC]) {
+    return;
+  }
+
+  netaddr_from_binary(&l2neigh_mac, nla_data(tb[NL80211_ATTR_MAC]), 6, AF_MAC48);
+
+  OONF_DEBUG(LOG_NL80211, "Station %s left",
+      netaddr_to_string(&nbuf, &l2neigh_mac));
+
+  l2neigh = oonf_layer2_neigh_get(interf->l2net, &l2neigh_mac);
+  if (l2neigh) {
+    nl80211_remove_l2neigh(l2neigh);
+  }
+}
+
 static bool
 _handle_traffic(struct oonf_layer2_neigh *l2neigh,
     enum oonf_layer2_neighbor_index idx, uint32_t new_32bit) {
@@ -185,8 +185,11 @@ static void _nl80211_if_remove(struct nl80211_if *);
 static void _cb_config_changed(void);
 static void _cb_if_config_changed(void);
 
+static struct nl80211_if *_nl80211_if_get_by_index(unsigned if_index);
+
 static void _cb_transmission_event(struct oonf_timer_instance *);
 static void _trigger_next_netlink_query(void);
+static void _process_station_event(struct nlmsghdr *hdr);
 
 static void _cb_nl_message(struct nlmsghdr *hdr);
 static void _cb_nl_error(uint32_t seq, int error);
@@ -264,6 +267,7 @@ static struct nlmsghdr *_nl_msg = (void *)_nl_msgbuffer;
 /* netlink nl80211 identification */
 static uint32_t _nl80211_id = 0;
 static uint32_t _nl80211_multicast_group = 0;
+static bool _nl80211_multicast_joined = false;
 
 /* layer2 metadata */
 static uint32_t _layer2_origin, _layer2_old_origin;
@@ -272,6 +276,7 @@ static uint32_t _layer2_origin, _layer2_old_origin;
 static struct nl80211_if *_current_query_if = NULL;
 static enum _if_query _current_query_number = QUERY_START;
 static bool _current_query_in_progress = false;
+static uint32_t _current_query_seq = 0;
 
 /* timer for generating netlink requests */
 static struct oonf_timer_class _transmission_timer_info = {
@@ -333,6 +338,8 @@ _cleanup(void) {
   oonf_timer_stop(&_transmission_timer);
   oonf_timer_remove(&_transmission_timer_info);
   os_system_linux_netlink_remove(&_netlink_handler);
+
+  _nl80211_multicast_joined = false;
 }
 
 /**
@@ -388,6 +395,27 @@ nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh) {
   oonf_layer2_neigh_cleanup(l2neigh, _layer2_old_origin);
 }
 
+/**
+ * Remove all data generated by this listener from a layer2 neighbor
+ * and commit the change. This might remove the neighbor.
+ * @param l2neigh pointer to layer2 neighbor
+ */
+void
+nl80211_remove_l2neigh(struct oonf_layer2_neigh *l2neigh) {
+  struct oonf_layer2_destination *l2dst, *l2dst_it;
+
+  avl_for_each_element_safe(&l2neigh->destinations, l2dst, _node, l2dst_it) {
+    if (l2dst->origin == _layer2_origin
+        || l2dst->origin == _layer2_old_origin) {
+      oonf_layer2_destination_remove(l2dst);
+    }
+  }
+
+  oonf_layer2_neigh_cleanup(l2neigh, _layer2_origin);
+  oonf_layer2_neigh_cleanup(l2neigh, _layer2_old_origin);
+  oonf_layer2_neigh_commit(l2neigh);
+}
+
 /**
  * Change a layer2 neighbor setting
  * @param l2neigh pointer to layer2 neighbor
@@ -413,6 +441,23 @@ _nl80211_if_get(const char *name) {
   return avl_find_element(&_nl80211_if_tree, name, interf, _node);
 }
 
+/**
+ * Get a nl80211 interface by its interface index
+ * @param if_index interface index
+ * @return nl80211 interface, NULL if not found
+ */
+static struct nl80211_if *
+_nl80211_if_get_by_index(unsigned if_index) {
+  struct nl80211_if *interf;
+
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (nl80211_get_if_baseindex(interf) == if_index) {
+      return interf;
+    }
+  }
+  return NULL;
+}
+
 /**
  * Add a nl80211 interface to the tree
  * @param name interface name
@@ -550,7 +595,8 @@ _send_netlink_message(struct nl80211_if *interf, enum _if_query query) {
     _if_query_ops[query].send(&_netlink_handler, _nl_msg, hdr, interf);
   }
 
-  os_system_linux_netlink_send(&_netlink_handler, _nl_msg);
+  /* remember sequence number to match the answers to the query */
+  _current_query_seq = os_system_linux_netlink_send(&_netlink_handler, _nl_msg);
 }
 
 /**
@@ -641,6 +687,18 @@ _cb_nl_message(struct nlmsghdr *hdr) {
   if (hdr->nlmsg_type == GENL_ID_CTRL && gen_hdr->cmd == CTRL_CMD_NEWFAMILY) {
     genl_process_get_family_result(hdr,
         &_nl80211_id, &_nl80211_multicast_group);
+
+    if (_nl80211_multicast_group && !_nl80211_multicast_joined) {
+      /* subscribe to station events */
+      if (os_system_linux_netlink_add_mc(&_netlink_handler,
+          &_nl80211_multicast_group, 1)) {
+        OONF_WARN(LOG_NL80211, "Could not join nl80211 multicast group %u",
+            _nl80211_multicast_group);
+      }
+      else {
+        _nl80211_multicast_joined = true;
+      }
+    }
     return;
   }
 
@@ -649,6 +707,18 @@ _cb_nl_message(struct nlmsghdr *hdr) {
     return;
   }
 
+  if (hdr->nlmsg_seq == 0) {
+    /* multicast event of the kernel */
+    _process_station_event(hdr);
+    return;
+  }
+
+  if (hdr->nlmsg_seq != _current_query_seq) {
+    OONF_INFO(LOG_NL80211, "Received Nl80211 command %u for old query (seq %u)",
+        gen_hdr->cmd, hdr->nlmsg_seq);
+    return;
+  }
+
   if (gen_hdr->cmd != _if_query_ops[_current_query_number].cmd) {
     OONF_INFO(LOG_NL80211, "Received Nl80211 command %u for query %u (should be %u)",
         gen_hdr->cmd, _current_query_number,
@@ -661,14 +731,63 @@ _cb_nl_message(struct nlmsghdr *hdr) {
   }
 }
 
+/**
+ * Handle a nl80211 station multicast event to update the layer2
+ * database without waiting for the next station dump
+ * @param hdr pointer to netlink message
+ */
+static void
+_process_station_event(struct nlmsghdr *hdr) {
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct genlmsghdr *gen_hdr;
+  struct nl80211_if *interf;
+
+  gen_hdr = NLMSG_DATA(hdr);
+  if (gen_hdr->cmd != NL80211_CMD_NEW_STATION
+      && gen_hdr->cmd != NL80211_CMD_DEL_STATION) {
+    /* not interested in other mlme events */
+    return;
+  }
+
+  if (nlmsg_parse(hdr, sizeof(struct genlmsghdr),
+      tb, NL80211_ATTR_MAX, NULL) < 0) {
+    OONF_WARN(LOG_NL80211, "Cannot parse nl80211 station event");
+    return;
+  }
+
+  if (!tb[NL80211_ATTR_IFINDEX] || !tb[NL80211_ATTR_MAC]) {
+    return;
+  }
+
+  interf = _nl80211_if_get_by_index(nla_get_u32(tb[NL80211_ATTR_IFINDEX]));
+  if (!interf) {
+    /* not one of our interfaces */
+    return;
+  }
+
+  OONF_DEBUG(LOG_NL80211, "Received station event %u for interface %s",
+      gen_hdr->cmd, interf->name);
+
+  if (gen_hdr->cmd == NL80211_CMD_NEW_STATION) {
+    nl80211_process_get_station_dump_result(interf, hdr);
+  }
+  else {
+    nl80211_process_del_station_event(interf, hdr);
+  }
+}
+
 /**
  * Callback triggered when a netlink message failes
  * @param seq sequence number
  * @param error error code
  */
 static void
-_cb_nl_error(uint32_t seq __attribute((unused)), int error __attribute((unused))) {
+_cb_nl_error(uint32_t seq, int error __attribute((unused))) {
   OONF_DEBUG(LOG_NL80211, "seq %u: Received error %d", seq, error);
+  if (seq != _current_query_seq) {
+    /* error of an old query */
+    return;
+  }
   if (_nl80211_id && _nl80211_multicast_group) {
     _trigger_next_netlink_query();
   }
@@ -693,8 +812,12 @@ _cb_nl_timeout(void) {
  * @param seq sequence number
  */
 static void
-_cb_nl_done(uint32_t seq __attribute((unused))) {
+_cb_nl_done(uint32_t seq) {
   OONF_DEBUG(LOG_NL80211, "%u: Received done", seq);
+  if (seq != _current_query_seq) {
+    /* end of an old query */
+    return;
+  }
   if (_nl80211_id && _nl80211_multicast_group) {
     if (_if_query_ops[_current_query_number].finalize) {
       _if_query_ops[_current_query_number].finalize(_current_query_if);
@@ -59,6 +59,8 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
+#include "subsystems/oonf_socket.h"
 #include "subsystems/oonf_timer.h"
 #include "subsystems/oonf_telnet.h"
 #include "subsystems/os_routing.h"
@@ -74,6 +76,12 @@
 struct _remotecontrol_cfg {
   /*! access control list for telnet plugin */
   struct netaddr_acl acl;
+
+  /*! true if scheduler callbacks should be charged with CPU time */
+  bool cpu_profiling;
+
+  /*! callbacks with longer runtime (in milliseconds) trigger a warning */
+  uint64_t slow_callback;
 };
 
 /**
@@ -106,6 +114,9 @@ static enum oonf_telnet_result _update_logfilter(struct oonf_telnet_data *data,
 
 static void _print_memory(struct autobuf *buf);
 static void _print_timer(struct autobuf *buf);
+static void _print_socket(struct autobuf *buf);
+static void _print_profile(struct autobuf *buf,
+    struct oonf_timer_profile *profile);
 
 static enum oonf_telnet_result _start_logging(struct oonf_telnet_data *data,
     struct _remotecontrol_session *rc_session);
@@ -125,6 +136,11 @@ static void _cb_handle_session_cleanup(struct oonf_telnet_cleanup *cleanup);
 /* configuration */
 static struct cfg_schema_entry _remotecontrol_entries[] = {
   CFG_MAP_ACL(_remotecontrol_cfg, acl, "acl", ACL_LOCALHOST_ONLY, "acl for remote control commands"),
+  CFG_MAP_BOOL(_remotecontrol_cfg, cpu_profiling, "cpu_profiling", "false",
+      "Charge socket and timer callbacks with their CPU time"
+      " (costs an additional system call per callback)"),
+  CFG_MAP_CLOCK_MIN(_remotecontrol_cfg, slow_callback, "slow_callback", "0.1",
+      "Socket and timer callbacks running longer than this trigger a warning", 1),
 };
 
 static struct cfg_schema_section _remotecontrol_section = {
@@ -139,6 +155,8 @@ static struct _remotecontrol_cfg _remotecontrol_config;
 /* plugin declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
+  OONF_SOCKET_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_OS_ROUTING_SUBSYSTEM,
@@ -162,7 +180,8 @@ DECLARE_OONF_PLUGIN(_oonf_remotecontrol_subsystem);
 static struct oonf_telnet_command _telnet_cmds[] = {
   TELNET_CMD("resources", _cb_handle_resource,
       "\"resources memory\": display information about memory usage\n"
-      "\"resources timer\": display information about active timers\n",
+      "\"resources timer\": display information about active timers\n"
+      "\"resources socket\": display information about active sockets\n",
       .acl = &_remotecontrol_config.acl),
   TELNET_CMD("log", _cb_handle_log,
       "\"log\":      continuous output of logging to this console\n"
@@ -244,6 +263,9 @@ _cleanup(void)
     oonf_telnet_remove(&_telnet_cmds[i]);
   }
 
+  /* restore default callback accounting */
+  oonf_timer_set_profiling(false, OONF_TIMER_SLICE);
+
   netaddr_acl_remove(&_remotecontrol_config.acl);
 }
 
@@ -275,11 +297,43 @@ _print_timer(struct autobuf *buf) {
   struct oonf_timer_class *t;
 
   list_for_each_element(oonf_timer_get_list(), t, _node) {
-    abuf_appendf(buf, "%-25s (TIMER) usage: %u changes: %u\n",
+    abuf_appendf(buf, "%-25s (TIMER) usage: %u changes: %u",
         t->name, t->usage, t->changes);
+    _print_profile(buf, &t->profile);
+  }
+}
+
+/**
+ * Print current resources known to socket scheduler
+ * @param buf output buffer
+ */
+static void
+_print_socket(struct autobuf *buf) {
+  struct oonf_socket_entry *s;
+
+  list_for_each_element(oonf_socket_get_list(), s, _node) {
+    abuf_appendf(buf, "%-25s (SOCKET) fd: %d",
+        s->name ? s->name : "-", os_fd_get_fd(&s->fd));
+    _print_profile(buf, &s->profile);
   }
 }
 
+/**
+ * Print the callback accounting of a timer class or socket
+ * @param buf output buffer
+ * @param profile callback accounting
+ */
+static void
+_print_profile(struct autobuf *buf, struct oonf_timer_profile *profile) {
+  abuf_appendf(buf, " calls: %"PRIu64" wall: %"PRIu64"/%"PRIu64" us",
+      profile->calls, profile->wall_total / 1000, profile->wall_max / 1000);
+  if (oonf_timer_is_cpu_profiling()) {
+    abuf_appendf(buf, " cpu: %"PRIu64"/%"PRIu64" us",
+        profile->cpu_total / 1000, profile->cpu_max / 1000);
+  }
+  abuf_appendf(buf, " slow: %u\n", profile->slow);
+}
+
 /**
  * Handle resource command
  * @param data pointer to telnet data
@@ -296,6 +350,11 @@ _cb_handle_resource(struct oonf_telnet_data *data) {
     abuf_puts(data->out, "\nTimer cookies:\n");
     _print_timer(data->out);
   }
+
+  if (data->parameter == NULL || strcasecmp(data->parameter, "socket") == 0) {
+    abuf_puts(data->out, "\nSockets:\n");
+    _print_socket(data->out);
+  }
   return TELNET_RESULT_ACTIVE;
 }
 
@@ -762,6 +821,9 @@ _cb_config_changed(void) {
     OONF_WARN(LOG_REMOTECONTROL, "Could not convert remotecontrol config to bin");
     return;
   }
+
+  oonf_timer_set_profiling(
+      _remotecontrol_config.cpu_profiling, _remotecontrol_config.slow_callback);
 }
 
 /**
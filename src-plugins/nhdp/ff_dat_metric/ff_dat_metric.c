@@ -524,8 +524,8 @@ _get_scaled_rx_linkspeed(struct nhdp_link *lnk) {
   /* get local interface data  */
   os_if = nhdp_interface_get_if_listener(lnk->local_if)->data;
 
-  l2data = oonf_layer2_neigh_query(
-      os_if->name, &lnk->remote_mac, OONF_LAYER2_NEIGH_RX_BITRATE);
+  l2data = oonf_layer2_neigh_query_if(
+      os_if, &lnk->remote_mac, OONF_LAYER2_NEIGH_RX_BITRATE);
   if (!l2data) {
     return 1;
   }
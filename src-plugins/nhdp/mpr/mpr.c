@@ -55,6 +55,7 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/oonf_rfc5444.h"
 #include "subsystems/oonf_timer.h"
 
@@ -81,6 +82,7 @@ static void _cb_update_mpr(void);
 
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_NHDP_SUBSYSTEM,
 };
@@ -101,6 +103,12 @@ static struct nhdp_domain_mpr _mpr_handler = {
   .update_mpr = _cb_update_mpr,
 };
 
+/* runtime of a complete MPR recalculation */
+static struct oonf_histogram _mpr_histogram = {
+  .name = "mpr_update",
+  .unit = "ns",
+};
+
 /**
  * Initialize plugin
  * @return -1 if an error happened, 0 otherwise
@@ -110,6 +118,7 @@ _init(void) {
   if (nhdp_domain_mpr_add(&_mpr_handler)) {
     return -1;
   }
+  oonf_histogram_add(&_mpr_histogram);
   return 0;
 }
 
@@ -118,6 +127,7 @@ _init(void) {
  */
 static void
 _cleanup(void) {
+  oonf_histogram_remove(&_mpr_histogram);
 }
 
 /**
@@ -248,7 +258,10 @@ _update_routing_mpr(void) {
  */
 static void
 _cb_update_mpr(void) {
+  uint64_t start;
+
   OONF_DEBUG(LOG_MPR, "Recalculating MPRs");
+  start = oonf_histogram_start(&_mpr_histogram);
 
   /* calculate flooding MPRs */
   _update_flooding_mpr();
@@ -256,6 +269,7 @@ _cb_update_mpr(void) {
   /* calculate routing MPRs */
   _update_routing_mpr();
 
+  oonf_histogram_stop(&_mpr_histogram, start);
   OONF_DEBUG(LOG_MPR, "Finished recalculating MPRs");
 }
 
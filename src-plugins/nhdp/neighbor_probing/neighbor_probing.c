@@ -282,7 +282,7 @@ _cb_probe_link(struct oonf_timer_instance *ptr __attribute__((unused))) {
   avl_for_each_element(nhdp_interface_get_tree(), nhdp_if, _node) {
     if_listener = nhdp_interface_get_if_listener(nhdp_if);
 
-    l2net = oonf_layer2_net_get(if_listener->data->name);
+    l2net = oonf_layer2_net_get_by_interface(if_listener->data);
     if (!l2net) {
       continue;
     }
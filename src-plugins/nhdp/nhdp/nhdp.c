@@ -48,8 +48,10 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_rfc5444.h"
 #include "subsystems/os_interface.h"
+#include "nhdp/nhdp_db.h"
 #include "nhdp/nhdp_hysteresis.h"
 #include "nhdp/nhdp_interfaces.h"
 #include "nhdp/nhdp_domain.h"
@@ -82,6 +84,9 @@ struct _generic_parameters {
 
   /*! routing willingness */
   int32_t mpr_willingness;
+
+  /*! granularity of link and two-hop expiry in milliseconds */
+  uint64_t expiry_granularity;
 };
 
 /* prototypes */
@@ -109,6 +114,11 @@ static struct cfg_schema_entry _nhdp_entries[] = {
       RFC7181_WILLINGNESS_DEFAULT_STRING,
       "Flooding willingness for MPR calculation", 0, false,
       RFC7181_WILLINGNESS_MIN, RFC7181_WILLINGNESS_MAX),
+  CFG_MAP_CLOCK_MINMAX(_generic_parameters, expiry_granularity, "expiry_granularity", "0.100",
+      "Granularity in seconds of link and two-hop neighbor expiry. Entries can be removed"
+      " up to this time after their validity ended, but each interface is checked at most"
+      " once per granularity.",
+      NHDP_DB_EXPIRY_GRANULARITY_MIN, NHDP_DB_EXPIRY_GRANULARITY_MAX),
 };
 
 static struct cfg_schema_section _nhdp_section = {
@@ -261,6 +271,7 @@ nhdp_set_originator(const struct netaddr *addr) {
   else if (netaddr_get_address_family(addr) == AF_INET6) {
     memcpy(&_originator_v6, addr, sizeof(*addr));
   }
+  nhdp_writer_invalidate_hello_cache();
 }
 
 /**
@@ -276,6 +287,7 @@ nhdp_reset_originator(int af_type) {
   else if (af_type == AF_INET6) {
     netaddr_invalidate(&_originator_v6);
   }
+  nhdp_writer_invalidate_hello_cache();
 }
 
 /**
@@ -449,6 +461,7 @@ _cb_cfg_nhdp_changed(void) {
   }
 
   nhdp_domain_set_flooding_mpr(param.flooding_mpr_name, param.mpr_willingness);
+  nhdp_db_set_expiry_granularity(param.expiry_granularity);
 }
 
 /**
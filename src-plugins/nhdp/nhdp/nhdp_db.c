@@ -51,11 +51,13 @@
 
 #include "core/oonf_logging.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_timer.h"
 
 #include "nhdp/nhdp_internal.h"
 #include "nhdp/nhdp_hysteresis.h"
 #include "nhdp/nhdp_interfaces.h"
+#include "nhdp/nhdp_writer.h"
 #include "nhdp/nhdp_domain.h"
 #include "nhdp/nhdp_db.h"
 
@@ -64,11 +66,12 @@ static void _link_status_now_symmetric(struct nhdp_link *lnk);
 static void _link_status_not_symmetric_anymore(struct nhdp_link *lnk);
 int _nhdp_db_link_calculate_status(struct nhdp_link *lnk);
 
-static void _cb_link_vtime(struct oonf_timer_instance *);
-static void _cb_link_heard(struct oonf_timer_instance *);
-static void _cb_link_symtime(struct oonf_timer_instance *);
-static void _cb_l2hop_vtime(struct oonf_timer_instance *);
-static void _cb_naddr_vtime(struct oonf_timer_instance *);
+static void _link_expired(struct nhdp_link *lnk);
+static uint64_t _get_expiry(uint64_t rel_time);
+static bool _is_expired(uint64_t timestamp);
+static void _schedule_expiry(struct oonf_timer_instance *timer, uint64_t timestamp);
+static void _cb_interface_expiry(struct oonf_timer_instance *);
+static void _cb_naddr_expiry(struct oonf_timer_instance *);
 
 /* Link status names */
 static const char *_LINK_PENDING   = "pending";
@@ -102,29 +105,19 @@ static struct oonf_class _naddr_info = {
   .size = sizeof(struct nhdp_naddr),
 };
 
-static struct oonf_timer_class _link_vtime_info = {
-  .name = "NHDP link vtime",
-  .callback = _cb_link_vtime,
+static struct oonf_timer_class _interface_expiry_info = {
+  .name = "NHDP link and 2hop expiry",
+  .callback = _cb_interface_expiry,
 };
 
-static struct oonf_timer_class _link_heard_info = {
-  .name = "NHDP link heard-time",
-  .callback = _cb_link_heard,
+static struct oonf_timer_class _naddr_expiry_info = {
+  .name = "NHDP lost neighbor address expiry",
+  .callback = _cb_naddr_expiry,
 };
 
-static struct oonf_timer_class _link_symtime_info = {
-  .name = "NHDP link symtime",
-  .callback = _cb_link_symtime,
-};
-
-static struct oonf_timer_class _naddr_vtime_info = {
-  .name = "NHDP neighbor address vtime",
-  .callback = _cb_naddr_vtime,
-};
-
-static struct oonf_timer_class _l2hop_vtime_info = {
-  .name = "NHDP 2hop vtime",
-  .callback = _cb_l2hop_vtime,
+/* timer to remove lost neighbor addresses */
+static struct oonf_timer_instance _naddr_expiry_timer = {
+  .class = &_naddr_expiry_info,
 };
 
 /* global tree of neighbor addresses */
@@ -139,6 +132,12 @@ static struct avl_tree _neigh_originator_tree;
 /* list of links (to neighbors) */
 static struct list_entity _link_list;
 
+/* list of lost neighbor addresses */
+static struct list_entity _lost_naddr_list;
+
+/* granularity of expiry sweeps in milliseconds */
+static uint64_t _expiry_granularity = NHDP_DB_EXPIRY_GRANULARITY;
+
 /**
  * Initialize NHDP databases
  */
@@ -148,6 +147,7 @@ nhdp_db_init(void) {
   list_init_head(&_neigh_list);
   avl_init(&_neigh_originator_tree, avl_comp_netaddr, false);
   list_init_head(&_link_list);
+  list_init_head(&_lost_naddr_list);
 
   oonf_class_add(&_neigh_info);
   oonf_class_add(&_naddr_info);
@@ -155,11 +155,8 @@ nhdp_db_init(void) {
   oonf_class_add(&_laddr_info);
   oonf_class_add(&_l2hop_info);
 
-  oonf_timer_add(&_naddr_vtime_info);
-  oonf_timer_add(&_link_vtime_info);
-  oonf_timer_add(&_link_heard_info);
-  oonf_timer_add(&_link_symtime_info);
-  oonf_timer_add(&_l2hop_vtime_info);
+  oonf_timer_add(&_naddr_expiry_info);
+  oonf_timer_add(&_interface_expiry_info);
 }
 
 /**
@@ -175,11 +172,8 @@ nhdp_db_cleanup(void) {
   }
 
   /* cleanup all timers */
-  oonf_timer_remove(&_l2hop_vtime_info);
-  oonf_timer_remove(&_link_symtime_info);
-  oonf_timer_remove(&_link_heard_info);
-  oonf_timer_remove(&_link_vtime_info);
-  oonf_timer_remove(&_naddr_vtime_info);
+  oonf_timer_remove(&_interface_expiry_info);
+  oonf_timer_remove(&_naddr_expiry_info);
 
   /* cleanup all memory cookies */
   oonf_class_remove(&_l2hop_info);
@@ -189,6 +183,42 @@ nhdp_db_cleanup(void) {
   oonf_class_remove(&_neigh_info);
 }
 
+/**
+ * Set the granularity of the expiry sweeps. Tuples might be
+ * removed up to one granularity after their validity ended,
+ * but each interface is swept at most once per granularity.
+ * @param granularity granularity in milliseconds
+ */
+void
+nhdp_db_set_expiry_granularity(uint64_t granularity) {
+  _expiry_granularity = granularity > 0 ? granularity : 1;
+}
+
+/**
+ * Initialize the NHDP database part of a new interface
+ * @param interf nhdp interface
+ */
+void
+nhdp_db_init_interface(struct nhdp_interface *interf) {
+  interf->_expiry_timer.class = &_interface_expiry_info;
+}
+
+/**
+ * Remove all links of an interface from the database. The links
+ * cannot outlive the interface because it drives their expiry.
+ * @param interf nhdp interface
+ */
+void
+nhdp_db_cleanup_interface(struct nhdp_interface *interf) {
+  struct nhdp_link *lnk, *l_it;
+
+  list_for_each_element_safe(&interf->_links, lnk, _if_node, l_it) {
+    _link_expired(lnk);
+  }
+
+  oonf_timer_stop(&interf->_expiry_timer);
+}
+
 /**
  * @return new NHDP neighbor without links and addresses,
  *  NULL if out of memory
@@ -356,13 +386,13 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh,
   /* initialize backward link */
   naddr->neigh = neigh;
 
-  /* initialize timer for lost addresses */
-  naddr->_lost_vtime.class = &_naddr_vtime_info;
-
   /* add to trees */
   avl_insert(&_naddr_tree, &naddr->_global_node);
   avl_insert(&neigh->_neigh_addresses, &naddr->_neigh_node);
 
+  /* new address will be part of the next HELLO */
+  nhdp_writer_invalidate_hello_cache();
+
   /* trigger event */
   oonf_class_event(&_naddr_info, naddr, OONF_OBJECT_ADDED);
 
@@ -382,8 +412,12 @@ nhdp_db_neighbor_addr_remove(struct nhdp_naddr *naddr) {
   avl_remove(&_naddr_tree, &naddr->_global_node);
   avl_remove(&naddr->neigh->_neigh_addresses, &naddr->_neigh_node);
 
-  /* stop timer */
-  oonf_timer_stop(&naddr->_lost_vtime);
+  /* remove from list of lost addresses */
+  if (list_is_node_added(&naddr->_lost_node)) {
+    list_remove(&naddr->_lost_node);
+  }
+
+  nhdp_writer_invalidate_hello_cache();
 
   /* free memory */
   oonf_class_free(&_naddr_info, naddr);
@@ -404,6 +438,41 @@ nhdp_db_neighbor_addr_move(struct nhdp_neighbor *neigh, struct nhdp_naddr *naddr
 
   /* set new backlink */
   naddr->neigh = neigh;
+
+  nhdp_writer_invalidate_hello_cache();
+}
+
+/**
+ * Define a neighbor address as lost
+ * @param naddr nhdp neighbor address
+ * @param vtime time until lost address gets purged from the database
+ */
+void
+nhdp_db_neighbor_addr_set_lost(struct nhdp_naddr *naddr, uint64_t vtime) {
+  if (vtime == 0) {
+    nhdp_db_neighbor_addr_not_lost(naddr);
+    return;
+  }
+
+  naddr->_lost_vtime = _get_expiry(vtime);
+  if (!list_is_node_added(&naddr->_lost_node)) {
+    list_add_tail(&_lost_naddr_list, &naddr->_lost_node);
+    nhdp_writer_invalidate_hello_cache();
+  }
+  _schedule_expiry(&_naddr_expiry_timer, naddr->_lost_vtime);
+}
+
+/**
+ * Define a neighbor address as not lost anymore
+ * @param naddr nhdp neighbor address
+ */
+void
+nhdp_db_neighbor_addr_not_lost(struct nhdp_naddr *naddr) {
+  naddr->_lost_vtime = 0;
+  if (list_is_node_added(&naddr->_lost_node)) {
+    list_remove(&naddr->_lost_node);
+    nhdp_writer_invalidate_hello_cache();
+  }
 }
 
 /**
@@ -520,11 +589,6 @@ nhdp_db_link_add(struct nhdp_neighbor *neigh, struct nhdp_interface *local_if) {
   avl_init(&lnk->_addresses, avl_comp_netaddr, false);
   avl_init(&lnk->_2hop, avl_comp_netaddr, false);
 
-  /* init timers */
-  lnk->sym_time.class = &_link_symtime_info;
-  lnk->heard_time.class = &_link_heard_info;
-  lnk->vtime.class = &_link_vtime_info;
-
   /* add to originator tree if set */
   lnk->_originator_node.key = &neigh->originator;
   if (netaddr_get_address_family(&neigh->originator) != AF_UNSPEC) {
@@ -534,6 +598,8 @@ nhdp_db_link_add(struct nhdp_neighbor *neigh, struct nhdp_interface *local_if) {
   /* initialize link domain data */
   nhdp_domain_init_link(lnk);
 
+  nhdp_writer_invalidate_hello_cache();
+
   /* trigger event */
   oonf_class_event(&_link_info, lnk, OONF_OBJECT_ADDED);
 
@@ -552,8 +618,8 @@ nhdp_db_link_set_unsymmetric(struct nhdp_link *lnk) {
     _link_status_not_symmetric_anymore(lnk);
   }
 
-  /* stop link timers */
-  oonf_timer_stop(&lnk->sym_time);
+  /* reset symmetric time */
+  lnk->sym_time = 0;
 
   /* remove all 2hop addresses */
   avl_for_each_element_safe(&lnk->_2hop, twohop, _link_node, th_it) {
@@ -576,10 +642,6 @@ nhdp_db_link_remove(struct nhdp_link *lnk) {
   /* trigger event */
   oonf_class_event(&_link_info, lnk, OONF_OBJECT_REMOVED);
 
-  oonf_timer_stop(&lnk->sym_time);
-  oonf_timer_stop(&lnk->heard_time);
-  oonf_timer_stop(&lnk->vtime);
-
   /* disconnect dualstack */
   if (nhdp_db_link_is_dualstack(lnk)) {
     nhdp_db_link_disconnect_dualstack(lnk);
@@ -606,10 +668,46 @@ nhdp_db_link_remove(struct nhdp_link *lnk) {
   /* remove from global list */
   list_remove(&lnk->_global_node);
 
+  nhdp_writer_invalidate_hello_cache();
+
   /* free memory */
   oonf_class_free(&_link_info, lnk);
 }
 
+/**
+ * Sets the validity time of a nhdp link
+ * @param lnk pointer to nhdp link
+ * @param vtime validity time in milliseconds
+ */
+void
+nhdp_db_link_set_vtime(struct nhdp_link *lnk, uint64_t vtime) {
+  lnk->vtime = _get_expiry(vtime);
+  _schedule_expiry(&lnk->local_if->_expiry_timer, lnk->vtime);
+}
+
+/**
+ * Sets the time until a NHDP link is not considered heard anymore
+ * @param lnk pointer to nhdp link
+ * @param htime heard time in milliseconds
+ */
+void
+nhdp_db_link_set_heardtime(struct nhdp_link *lnk, uint64_t htime) {
+  lnk->heard_time = _get_expiry(htime);
+  _schedule_expiry(&lnk->local_if->_expiry_timer, lnk->heard_time);
+}
+
+/**
+ * Sets the time until a NHDP link is not considered symmetric anymore
+ * @param lnk pointer to nhdp link
+ * @param stime symmetric time in milliseconds
+ */
+void
+nhdp_db_link_set_symtime(struct nhdp_link *lnk, uint64_t stime) {
+  lnk->sym_time = _get_expiry(stime);
+  _schedule_expiry(&lnk->local_if->_expiry_timer, lnk->sym_time);
+  nhdp_db_link_update_status(lnk);
+}
+
 /**
  * Add a network address as a link address to a nhdp link
  * @param lnk nhpd link
@@ -639,6 +737,8 @@ nhdp_db_link_addr_add(struct nhdp_link *lnk, const struct netaddr *addr) {
   avl_insert(&lnk->neigh->_link_addresses, &laddr->_neigh_node);
   nhdp_interface_add_laddr(laddr);
 
+  nhdp_writer_invalidate_hello_cache();
+
   /* trigger event */
   oonf_class_event(&_laddr_info, laddr, OONF_OBJECT_ADDED);
 
@@ -659,6 +759,8 @@ nhdp_db_link_addr_remove(struct nhdp_laddr *laddr) {
   avl_remove(&laddr->link->_addresses, &laddr->_link_node);
   avl_remove(&laddr->link->neigh->_link_addresses, &laddr->_neigh_node);
 
+  nhdp_writer_invalidate_hello_cache();
+
   /* free memory */
   oonf_class_free(&_laddr_info, laddr);
 }
@@ -685,6 +787,8 @@ nhdp_db_link_addr_move(struct nhdp_link *lnk, struct nhdp_laddr *laddr) {
   }
   /* set new backlink */
   laddr->link = lnk;
+
+  nhdp_writer_invalidate_hello_cache();
 }
 
 /**
@@ -709,9 +813,6 @@ nhdp_db_link_2hop_add(struct nhdp_link *lnk, const struct netaddr *addr) {
   /* initialize back link */
   l2hop->link = lnk;
 
-  /* initialize validity timer */
-  l2hop->_vtime.class = &_l2hop_vtime_info;
-
   /* add to link tree */
   avl_insert(&lnk->_2hop, &l2hop->_link_node);
 
@@ -742,13 +843,21 @@ nhdp_db_link_2hop_remove(struct nhdp_l2hop *l2hop) {
   /* remove from interface tree */
   nhdp_interface_remove_l2hop(l2hop);
 
-  /* stop validity timer */
-  oonf_timer_stop(&l2hop->_vtime);
-
   /* free memory */
   oonf_class_free(&_l2hop_info, l2hop);
 }
 
+/**
+ * Set the validity time of a two-hop neighbor
+ * @param l2hop nhdp link two-hop neighbor
+ * @param vtime new validity time
+ */
+void
+nhdp_db_link_2hop_set_vtime(struct nhdp_l2hop *l2hop, uint64_t vtime) {
+  l2hop->_vtime = _get_expiry(vtime);
+  _schedule_expiry(&l2hop->link->local_if->_expiry_timer, l2hop->_vtime);
+}
+
 /**
  * Connect two links as representations of the same node,
  * @param l_ipv4 ipv4 link
@@ -788,12 +897,17 @@ nhdp_db_link_disconnect_dualstack(struct nhdp_link *lnk) {
  */
 void
 nhdp_db_link_update_status(struct nhdp_link *lnk) {
+  enum nhdp_link_status old_status;
   bool was_symmetric;
 
+  old_status = lnk->status;
   was_symmetric = lnk->status == NHDP_LINK_SYMMETRIC;
 
   /* update link status */
   lnk->status = _nhdp_db_link_calculate_status(lnk);
+  if (lnk->status != old_status) {
+    nhdp_writer_invalidate_hello_cache();
+  }
 
   /* handle database changes */
   if (was_symmetric && lnk->status != NHDP_LINK_SYMMETRIC) {
@@ -877,9 +991,9 @@ _nhdp_db_link_calculate_status(struct nhdp_link *lnk) {
     return NHDP_LINK_PENDING;
   if (nhdp_hysteresis_is_lost(lnk))
     return RFC6130_LINKSTATUS_LOST;
-  if (oonf_timer_is_active(&lnk->sym_time))
+  if (nhdp_db_timestamp_is_valid(lnk->sym_time))
     return RFC6130_LINKSTATUS_SYMMETRIC;
-  if (oonf_timer_is_active(&lnk->heard_time))
+  if (nhdp_db_timestamp_is_valid(lnk->heard_time))
     return RFC6130_LINKSTATUS_HEARD;
   return RFC6130_LINKSTATUS_LOST;
 }
@@ -893,6 +1007,7 @@ _link_status_now_symmetric(struct nhdp_link *lnk) {
   struct nhdp_naddr *naddr;
 
   lnk->neigh->symmetric++;
+  nhdp_writer_invalidate_hello_cache();
 
   if (lnk->neigh->symmetric == 1) {
     avl_for_each_element(&lnk->neigh->_neigh_addresses, naddr, _neigh_node) {
@@ -916,6 +1031,7 @@ _link_status_not_symmetric_anymore(struct nhdp_link *lnk) {
   }
 
   lnk->neigh->symmetric--;
+  nhdp_writer_invalidate_hello_cache();
   if (lnk->neigh->symmetric == 0) {
     /* mark all neighbor addresses as lost */
     avl_for_each_element_safe(&lnk->neigh->_neigh_addresses, naddr, _neigh_node, na_it) {
@@ -925,16 +1041,14 @@ _link_status_not_symmetric_anymore(struct nhdp_link *lnk) {
 }
 
 /**
- * Callback triggered when link validity timer fires
- * @param ptr timer instance that fired
+ * Remove a link whose validity time is over from the database
+ * @param lnk nhdp link
  */
 static void
-_cb_link_vtime(struct oonf_timer_instance *ptr) {
-  struct nhdp_link *lnk;
+_link_expired(struct nhdp_link *lnk) {
   struct nhdp_neighbor *neigh;
 
-  lnk = container_of(ptr, struct nhdp_link, vtime);
-  OONF_DEBUG(LOG_NHDP, "Link vtime fired: 0x%0zx", (size_t)ptr);
+  OONF_DEBUG(LOG_NHDP, "Link expired: 0x%0zx", (size_t)lnk);
 
   neigh = lnk->neigh;
 
@@ -956,59 +1070,148 @@ _cb_link_vtime(struct oonf_timer_instance *ptr) {
 }
 
 /**
- * Callback triggered when link heard timer fires
- * @param ptr timer instance that fired
+ * @param rel_time relative time in milliseconds, 0 to reset a timestamp
+ * @return absolute timestamp, 0 if relative time was 0
  */
-static void
-_cb_link_heard(struct oonf_timer_instance *ptr) {
-  struct nhdp_link *lnk;
+static uint64_t
+_get_expiry(uint64_t rel_time) {
+  if (rel_time == 0) {
+    return 0;
+  }
+  return oonf_clock_get_absolute(rel_time);
+}
 
-  lnk = container_of(ptr, struct nhdp_link, heard_time);
-  OONF_DEBUG(LOG_NHDP, "Link heard fired: 0x%0zx", (size_t)lnk);
-  nhdp_db_link_update_status(lnk);
+/**
+ * @param timestamp absolute timestamp, 0 if not set
+ * @return true if timestamp is set and has been reached
+ */
+static bool
+_is_expired(uint64_t timestamp) {
+  return timestamp != 0 && !nhdp_db_timestamp_is_valid(timestamp);
 }
 
 /**
- * Callback triggered when link symmetric timer fires
- * @param ptr timer instance that fired
+ * Make sure an expiry timer fires not later than one granularity
+ * after a timestamp. The timestamp is snapped to the granularity,
+ * so most tuples share an already scheduled sweep and the timer
+ * is only moved if the sweep would be too late. A sweep is never
+ * scheduled less than one granularity ahead.
+ * @param timer expiry timer
+ * @param timestamp absolute timestamp, 0 if not set
  */
 static void
-_cb_link_symtime(struct oonf_timer_instance *ptr) {
-  struct nhdp_link *lnk;
+_schedule_expiry(struct oonf_timer_instance *timer, uint64_t timestamp) {
+  int64_t rel_time;
 
-  lnk = container_of(ptr, struct nhdp_link, sym_time);
-  OONF_DEBUG(LOG_NHDP, "Link Symtime fired: 0x%0zx", (size_t)lnk);
-  nhdp_db_link_update_status(lnk);
-  nhdp_domain_neighbor_changed(lnk->neigh);
+  if (timestamp == 0) {
+    return;
+  }
+
+  timestamp += _expiry_granularity - 1;
+  timestamp -= timestamp % _expiry_granularity;
+
+  rel_time = oonf_clock_get_relative(timestamp);
+  if (rel_time < (int64_t)_expiry_granularity) {
+    rel_time = _expiry_granularity;
+  }
+
+  if (!oonf_timer_is_active(timer) || rel_time < oonf_timer_get_due(timer)) {
+    oonf_timer_set(timer, rel_time);
+  }
 }
 
 /**
- * Callback triggered when nhdp address validity timer fires
+ * Callback triggered when the links or two-hop neighbors of an interface
+ * might have expired. Removes all due entries and reschedules itself
+ * for the next one.
  * @param ptr timer instance that fired
  */
 static void
-_cb_naddr_vtime(struct oonf_timer_instance *ptr) {
-  struct nhdp_naddr *naddr;
+_cb_interface_expiry(struct oonf_timer_instance *ptr) {
+  struct nhdp_interface *interf;
+  struct nhdp_link *lnk, *l_it;
+  struct nhdp_l2hop *l2hop, *l2_it;
+  uint64_t next;
+  bool changed;
+
+  interf = container_of(ptr, struct nhdp_interface, _expiry_timer);
+  OONF_DEBUG(LOG_NHDP, "Expiry sweep for interface %s",
+      nhdp_interface_get_name(interf));
+
+  next = ~0ull;
+  list_for_each_element_safe(&interf->_links, lnk, _if_node, l_it) {
+    if (_is_expired(lnk->vtime)) {
+      _link_expired(lnk);
+      continue;
+    }
 
-  naddr = container_of(ptr, struct nhdp_naddr, _lost_vtime);
-  OONF_DEBUG(LOG_NHDP, "Neighbor Address Lost fired: 0x%0zx", (size_t)ptr);
+    changed = false;
+
+    /* remove outdated two-hop neighbors */
+    avl_for_each_element_safe(&lnk->_2hop, l2hop, _link_node, l2_it) {
+      if (_is_expired(l2hop->_vtime)) {
+        OONF_DEBUG(LOG_NHDP, "2Hop expired: 0x%0zx", (size_t)l2hop);
+        nhdp_db_link_2hop_remove(l2hop);
+        changed = true;
+      }
+      else if (l2hop->_vtime != 0 && l2hop->_vtime < next) {
+        next = l2hop->_vtime;
+      }
+    }
 
-  nhdp_db_neighbor_addr_remove(naddr);
+    if (_is_expired(lnk->sym_time)) {
+      OONF_DEBUG(LOG_NHDP, "Link symtime expired: 0x%0zx", (size_t)lnk);
+      lnk->sym_time = 0;
+      nhdp_db_link_update_status(lnk);
+      changed = true;
+    }
+    if (_is_expired(lnk->heard_time)) {
+      OONF_DEBUG(LOG_NHDP, "Link heard-time expired: 0x%0zx", (size_t)lnk);
+      lnk->heard_time = 0;
+      nhdp_db_link_update_status(lnk);
+    }
+
+    if (changed) {
+      nhdp_domain_neighbor_changed(lnk->neigh);
+    }
+
+    if (lnk->sym_time != 0 && lnk->sym_time < next) {
+      next = lnk->sym_time;
+    }
+    if (lnk->heard_time != 0 && lnk->heard_time < next) {
+      next = lnk->heard_time;
+    }
+    if (lnk->vtime != 0 && lnk->vtime < next) {
+      next = lnk->vtime;
+    }
+  }
+
+  if (next != ~0ull) {
+    _schedule_expiry(&interf->_expiry_timer, next);
+  }
 }
 
 /**
- * Callback triggered when 2hop valitidy timer fires
+ * Callback triggered when lost neighbor addresses might have expired
  * @param ptr timer instance that fired
  */
 static void
-_cb_l2hop_vtime(struct oonf_timer_instance *ptr) {
-  struct nhdp_l2hop *l2hop;
-  struct nhdp_neighbor *neigh;
+_cb_naddr_expiry(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct nhdp_naddr *naddr, *na_it;
+  uint64_t next;
 
-  l2hop = container_of(ptr, struct nhdp_l2hop, _vtime);
-  neigh = l2hop->link->neigh;
+  next = ~0ull;
+  list_for_each_element_safe(&_lost_naddr_list, naddr, _lost_node, na_it) {
+    if (_is_expired(naddr->_lost_vtime)) {
+      OONF_DEBUG(LOG_NHDP, "Neighbor Address Lost expired: 0x%0zx", (size_t)naddr);
+      nhdp_db_neighbor_addr_remove(naddr);
+    }
+    else if (naddr->_lost_vtime < next) {
+      next = naddr->_lost_vtime;
+    }
+  }
 
-  OONF_DEBUG(LOG_NHDP, "2Hop vtime fired: 0x%0zx", (size_t)ptr);
-  nhdp_db_link_2hop_remove(l2hop);
-  nhdp_domain_neighbor_changed(neigh);
+  if (next != ~0ull) {
+    _schedule_expiry(&_naddr_expiry_timer, next);
+  }
 }
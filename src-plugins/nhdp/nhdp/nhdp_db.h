@@ -55,6 +55,7 @@ struct nhdp_laddr;
 #include "common/avl.h"
 #include "common/list.h"
 #include "common/netaddr.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_rfc5444.h"
 #include "subsystems/oonf_timer.h"
 
@@ -97,7 +98,16 @@ enum nhdp_link_status {
  */
 enum {
   /*! maximum text length of link status */
-  NHDP_LINK_STATUS_TXTLENGTH = 10
+  NHDP_LINK_STATUS_TXTLENGTH = 10,
+
+  /*! default granularity of expiry sweeps in milliseconds */
+  NHDP_DB_EXPIRY_GRANULARITY = 100,
+
+  /*! minimal granularity of expiry sweeps in milliseconds */
+  NHDP_DB_EXPIRY_GRANULARITY_MIN = 100,
+
+  /*! maximal granularity of expiry sweeps in milliseconds */
+  NHDP_DB_EXPIRY_GRANULARITY_MAX = 1000,
 };
 
 /**
@@ -117,6 +127,9 @@ struct nhdp_metric {
 struct nhdp_link_domaindata {
   /*! incoming and outgoing metric cost */
   struct nhdp_metric metric;
+
+  /*! metric cost used for the cached HELLO messages */
+  struct nhdp_metric _hello_metric;
 };
 
 /**
@@ -140,6 +153,12 @@ struct nhdp_neighbor_domaindata {
 
   /*! Routing willingness of neighbor */
   uint8_t willingness;
+
+  /*! metric cost used for the cached HELLO messages */
+  struct nhdp_metric _hello_metric;
+
+  /*! MPR selection used for the cached HELLO messages */
+  bool _hello_neigh_is_mpr;
 };
 
 /**
@@ -161,14 +180,14 @@ struct nhdp_link {
   /*! last received interval time */
   uint64_t itime_value;
 
-  /*! timer that fires if this link is not symmetric anymore */
-  struct oonf_timer_instance sym_time;
+  /*! absolute time when this link is not symmetric anymore, 0 if not set */
+  uint64_t sym_time;
 
-  /*! timer that fires if the last received neighbor HELLO timed out */
-  struct oonf_timer_instance heard_time;
+  /*! absolute time when the last received neighbor HELLO times out, 0 if not set */
+  uint64_t heard_time;
 
-  /*! timer that fires when the link has to be removed from the database */
-  struct oonf_timer_instance vtime;
+  /*! absolute time when the link has to be removed from the database, 0 if not set */
+  uint64_t vtime;
 
   /*! cached status of the linked */
   enum nhdp_link_status status;
@@ -249,8 +268,8 @@ struct nhdp_l2hop {
   /*! link entry for two-hop address */
   struct nhdp_link *link;
 
-  /*! validity time for this address */
-  struct oonf_timer_instance _vtime;
+  /*! absolute validity time for this address */
+  uint64_t _vtime;
 
   /*! member entry for two-hop addresses of neighbor link */
   struct avl_node _link_node;
@@ -284,6 +303,9 @@ struct nhdp_neighbor {
   /*! Willingness of neighbor for flooding data */
   uint8_t flooding_willingness;
 
+  /*! flooding MPR selection used for the cached HELLO messages */
+  bool _hello_neigh_is_flooding_mpr;
+
   /*! internal field for NHDP processing */
   int _process_count;
 
@@ -320,8 +342,11 @@ struct nhdp_naddr {
   /*! link address usage counter */
   int laddr_count;
 
-  /*! validity time for this address when its lost */
-  struct oonf_timer_instance _lost_vtime;
+  /*! absolute validity time for this address when its lost, 0 if not lost */
+  uint64_t _lost_vtime;
+
+  /*! member entry for global list of lost neighbor addresses */
+  struct list_entity _lost_node;
 
   /*! member entry for neighbor address tree */
   struct avl_node _neigh_node;
@@ -344,6 +369,9 @@ struct nhdp_naddr {
 
 void nhdp_db_init(void);
 void nhdp_db_cleanup(void);
+void nhdp_db_set_expiry_granularity(uint64_t granularity);
+void nhdp_db_init_interface(struct nhdp_interface *);
+void nhdp_db_cleanup_interface(struct nhdp_interface *);
 
 EXPORT struct nhdp_neighbor *nhdp_db_neighbor_add(void);
 EXPORT void nhdp_db_neighbor_remove(struct nhdp_neighbor *);
@@ -355,16 +383,22 @@ EXPORT void nhdp_db_neighbor_addr_move(struct nhdp_neighbor *, struct nhdp_naddr
 EXPORT void nhdp_db_neighbor_set_originator(struct nhdp_neighbor *, const struct netaddr *);
 EXPORT void nhdp_db_neighbor_connect_dualstack(struct nhdp_neighbor *, struct nhdp_neighbor *);
 EXPORT void nhdp_db_neigbor_disconnect_dualstack(struct nhdp_neighbor *neigh);
+EXPORT void nhdp_db_neighbor_addr_set_lost(struct nhdp_naddr *, uint64_t vtime);
+EXPORT void nhdp_db_neighbor_addr_not_lost(struct nhdp_naddr *);
 
 EXPORT struct nhdp_link *nhdp_db_link_add(struct nhdp_neighbor *ipv4, struct nhdp_interface *ipv6);
 EXPORT void nhdp_db_link_remove(struct nhdp_link *);
 EXPORT void nhdp_db_link_set_unsymmetric(struct nhdp_link *lnk);
+EXPORT void nhdp_db_link_set_vtime(struct nhdp_link *, uint64_t vtime);
+EXPORT void nhdp_db_link_set_heardtime(struct nhdp_link *, uint64_t htime);
+EXPORT void nhdp_db_link_set_symtime(struct nhdp_link *, uint64_t stime);
 EXPORT struct nhdp_laddr *nhdp_db_link_addr_add(struct nhdp_link *, const struct netaddr*);
 EXPORT void nhdp_db_link_addr_remove(struct nhdp_laddr *);
 EXPORT void nhdp_db_link_addr_move(struct nhdp_link *, struct nhdp_laddr *);
 EXPORT struct nhdp_l2hop *nhdp_db_link_2hop_add(
     struct nhdp_link *, const struct netaddr *);
 EXPORT void nhdp_db_link_2hop_remove(struct nhdp_l2hop *);
+EXPORT void nhdp_db_link_2hop_set_vtime(struct nhdp_l2hop *, uint64_t vtime);
 EXPORT void nhdp_db_link_connect_dualstack(struct nhdp_link *ipv4, struct nhdp_link *ipv6);
 EXPORT void nhdp_db_link_disconnect_dualstack(struct nhdp_link *lnk);
 
@@ -421,67 +455,15 @@ ndhp_db_link_2hop_get(const struct nhdp_link *lnk, const struct netaddr *addr) {
 }
 
 /**
- * Sets the validity time of a nhdp link
- * @param lnk pointer to nhdp link
- * @param vtime validity time in milliseconds
- */
-static INLINE void
-nhdp_db_link_set_vtime(
-    struct nhdp_link *lnk, uint64_t vtime) {
-  oonf_timer_set(&lnk->vtime, vtime);
-}
-
-/**
- * Sets the time until a NHDP link is not considered heard anymore
- * @param lnk pointer to nhdp link
- * @param htime heard time in milliseconds
- */
-static INLINE void
-nhdp_db_link_set_heardtime(
-    struct nhdp_link *lnk, uint64_t htime) {
-  oonf_timer_set(&lnk->heard_time, htime);
-}
-
-/**
- * Sets the time until a NHDP link is not considered symmetric anymore
- * @param lnk pointer to nhdp link
- * @param stime symmetric time in milliseconds
+ * NHDP tuples store absolute timestamps instead of running their own
+ * timers. An expired timestamp is treated as invalid immediately, the
+ * database removes the tuple during the next sweep.
+ * @param timestamp absolute timestamp of a NHDP tuple, 0 if not set
+ * @return true if timestamp is set and not yet reached
  */
-static INLINE void
-nhdp_db_link_set_symtime(
-    struct nhdp_link *lnk, uint64_t stime) {
-  oonf_timer_set(&lnk->sym_time, stime);
-  nhdp_db_link_update_status(lnk);
-}
-
-/**
- * Set the validity time of a two-hop neighbor
- * @param l2hop nhdp link two-hop neighbor
- * @param vtime new validity time
- */
-static INLINE void
-nhdp_db_link_2hop_set_vtime(
-    struct nhdp_l2hop *l2hop, uint64_t vtime) {
-  oonf_timer_set(&l2hop->_vtime, vtime);
-}
-
-/**
- * Define a neighbor address as lost
- * @param naddr nhdp neighbor address
- * @param vtime time until lost address gets purged from the database
- */
-static INLINE void
-nhdp_db_neighbor_addr_set_lost(struct nhdp_naddr *naddr, uint64_t vtime) {
-  oonf_timer_set(&naddr->_lost_vtime, vtime);
-}
-
-/**
- * Define a neighbor address as not lost anymore
- * @param naddr nhdp neighbor address
- */
-static INLINE void
-nhdp_db_neighbor_addr_not_lost(struct nhdp_naddr *naddr) {
-  oonf_timer_stop(&naddr->_lost_vtime);
+static INLINE bool
+nhdp_db_timestamp_is_valid(uint64_t timestamp) {
+  return timestamp > oonf_clock_getNow();
 }
 
 /**
@@ -490,7 +472,7 @@ nhdp_db_neighbor_addr_not_lost(struct nhdp_naddr *naddr) {
  */
 static INLINE bool
 nhdp_db_neighbor_addr_is_lost(const struct nhdp_naddr *naddr) {
-  return oonf_timer_is_active(&naddr->_lost_vtime);
+  return naddr->_lost_vtime != 0;
 }
 
 /**
@@ -564,6 +546,6 @@ nhdp_db_neighbor_is_ipv6_dualstack(const struct nhdp_neighbor *neigh) {
 
 static INLINE bool
 nhdp_db_2hop_is_lost(const struct nhdp_l2hop *l2hop) {
-  return oonf_timer_is_active(&l2hop->_vtime);
+  return nhdp_db_timestamp_is_valid(l2hop->_vtime);
 }
 #endif /* NHDP_DB_H_ */
@@ -60,6 +60,7 @@
 #include "nhdp/nhdp_domain.h"
 #include "nhdp/nhdp_interfaces.h"
 #include "nhdp/nhdp_internal.h"
+#include "nhdp/nhdp_writer.h"
 
 static void _apply_metric(struct nhdp_domain *domain, const char *metric_name);
 static void _remove_metric(struct nhdp_domain *);
@@ -71,6 +72,9 @@ static void _cb_update_everyone_mpr(void);
 
 static void _recalculate_neighbor_metric(struct nhdp_domain *domain,
         struct nhdp_neighbor *neigh);
+static void _check_hello_content(void);
+static bool _check_neighbor_hello_mpr(struct nhdp_neighbor *neigh);
+static bool _check_neighbor_hello_metric(struct nhdp_neighbor *neigh);
 static const char *_link_to_string(struct nhdp_metric_str *, uint32_t);
 static const char *_path_to_string(struct nhdp_metric_str *, uint32_t, uint8_t);
 static const char *_int_to_string(struct nhdp_metric_str *, struct nhdp_link *);
@@ -482,6 +486,9 @@ nhdp_domain_neighborhood_changed(void) {
   // TODO: flooding mpr ?
   // (Why do we need to consider flooding MPRs here?)
 
+  /* check if metrics or MPR selection modified the HELLO content */
+  _check_hello_content();
+
   list_for_each_element(&_domain_listener_list, listener, _node) {
     if (listener->update) {
       listener->update(NULL);
@@ -511,7 +518,8 @@ void
 nhdp_domain_neighbor_changed(struct nhdp_neighbor *neigh) {
   struct nhdp_domain_listener *listener;
   struct nhdp_domain *domain;
-  
+  struct nhdp_neighbor *other;
+  bool changed;
 
   list_for_each_element(&_domain_list, domain, _node) {
     _recalculate_neighbor_metric(domain, neigh);
@@ -524,6 +532,19 @@ nhdp_domain_neighbor_changed(struct nhdp_neighbor *neigh) {
   // TODO: flooding mpr ?
   // (Why do we need to consider flooding MPRs here?)
 
+  /*
+   * check if metrics or MPR selection modified the HELLO content,
+   * only the metrics of this neighbor have been recalculated but
+   * the MPR selection might have changed for every neighbor
+   */
+  changed = _check_neighbor_hello_metric(neigh);
+  list_for_each_element(nhdp_db_get_neigh_list(), other, _global_node) {
+    changed |= _check_neighbor_hello_mpr(other);
+  }
+  if (changed) {
+    nhdp_writer_invalidate_hello_cache();
+  }
+
   list_for_each_element(&_domain_listener_list, listener, _node) {
     if (listener->update) {
       listener->update(neigh);
@@ -862,6 +883,11 @@ nhdp_domain_set_incoming_metric(struct nhdp_domain_metric *metric,
       linkdata->metric.in = metric_in;
     }
   }
+
+  if (changed) {
+    /* link metrics are only part of the HELLOs of the link interface */
+    nhdp_writer_invalidate_interface_hello_cache(lnk->local_if);
+  }
   return changed;
 }
 
@@ -957,6 +983,93 @@ _recalculate_neighbor_metric(
   }
 }
 
+/**
+ * Compare the metrics and MPR selection of all neighbors and links
+ * with the values used for the cached HELLO messages and invalidate
+ * the cache if one of them changed.
+ */
+static void
+_check_hello_content(void) {
+  struct nhdp_neighbor *neigh;
+  bool changed;
+
+  changed = false;
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    changed |= _check_neighbor_hello_mpr(neigh);
+    changed |= _check_neighbor_hello_metric(neigh);
+  }
+
+  if (changed) {
+    nhdp_writer_invalidate_hello_cache();
+  }
+}
+
+/**
+ * Compare the MPR selection of a neighbor with the values used
+ * for the cached HELLO messages.
+ * @param neigh nhdp neighbor
+ * @return true if the MPR selection changed
+ */
+static bool
+_check_neighbor_hello_mpr(struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_domain *domain;
+  bool changed;
+
+  changed = false;
+  if (neigh->_hello_neigh_is_flooding_mpr != neigh->neigh_is_flooding_mpr) {
+    neigh->_hello_neigh_is_flooding_mpr = neigh->neigh_is_flooding_mpr;
+    changed = true;
+  }
+
+  list_for_each_element(&_domain_list, domain, _node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+    if (neighdata->_hello_neigh_is_mpr != neighdata->neigh_is_mpr) {
+      neighdata->_hello_neigh_is_mpr = neighdata->neigh_is_mpr;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+/**
+ * Compare the metrics of a neighbor and its links with the values
+ * used for the cached HELLO messages. A changed link metric only
+ * invalidates the HELLOs of the link interface.
+ * @param neigh nhdp neighbor
+ * @return true if the neighbor metric changed
+ */
+static bool
+_check_neighbor_hello_metric(struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_link_domaindata *linkdata;
+  struct nhdp_domain *domain;
+  struct nhdp_link *lnk;
+  bool changed;
+
+  changed = false;
+  list_for_each_element(&_domain_list, domain, _node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+    if (memcmp(&neighdata->_hello_metric, &neighdata->metric,
+        sizeof(neighdata->metric)) != 0) {
+      memcpy(&neighdata->_hello_metric, &neighdata->metric,
+          sizeof(neighdata->metric));
+      changed = true;
+    }
+
+    list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+      linkdata = nhdp_domain_get_linkdata(domain, lnk);
+      if (memcmp(&linkdata->_hello_metric, &linkdata->metric,
+          sizeof(linkdata->metric)) != 0) {
+        memcpy(&linkdata->_hello_metric, &linkdata->metric,
+            sizeof(linkdata->metric));
+        nhdp_writer_invalidate_interface_hello_cache(lnk->local_if);
+      }
+    }
+  }
+  return changed;
+}
+
 /**
  * Add a new domain to the NHDP system
  * @param ext TLV extension type used for new domain
@@ -1005,6 +1118,9 @@ nhdp_domain_add(uint8_t ext) {
   /* add to domain list */
   list_add_tail(&_domain_list, &domain->_node);
 
+  /* new domain changes the MPR types and willingness TLVs */
+  nhdp_writer_invalidate_hello_cache();
+
   oonf_class_event(&_domain_class, domain,OONF_OBJECT_ADDED);
   return domain;
 }
@@ -1123,7 +1239,10 @@ static void
 _apply_mpr(struct nhdp_domain *domain, const char *mpr_name, uint8_t willingness) {
   struct nhdp_domain_mpr *mpr;
 
-  domain->local_willingness = willingness;
+  if (domain->local_willingness != willingness) {
+    domain->local_willingness = willingness;
+    nhdp_writer_invalidate_hello_cache();
+  }
 
   /* check if we have to remove the old mpr first */
   if (strcasecmp(domain->mpr_name, mpr_name) == 0) {
@@ -231,6 +231,7 @@ nhdp_interface_add(const char *name) {
 
     /* initialize timers */
     interf->_hello_timer.class = &_interface_hello_timer;
+    nhdp_db_init_interface(interf);
 
     /* hook into global interface tree */
     interf->_node.key = interf->rfc5444_if.interface->name;
@@ -278,7 +279,6 @@ nhdp_interface_add(const char *name) {
 void
 nhdp_interface_remove(struct nhdp_interface *interf) {
   struct nhdp_interface_addr *addr, *a_it;
-  struct nhdp_link *lnk, *l_it;
 
   OONF_INFO(LOG_NHDP, "Remove interface to NHDP_interface tree: %s (refcount was %d)",
       nhdp_interface_get_name(interf), interf->_refcount);
@@ -302,9 +302,8 @@ nhdp_interface_remove(struct nhdp_interface *interf) {
     _remove_addr(addr);
   }
 
-  list_for_each_element_safe(&interf->_links, lnk, _if_node, l_it) {
-    nhdp_db_link_set_unsymmetric(lnk);
-  }
+  /* remove links, they cannot expire without the interface */
+  nhdp_db_cleanup_interface(interf);
 
   /* remove first from tree because we use the interface name as a key */
   avl_remove(&_interface_tree, &interf->_node);
@@ -331,6 +330,9 @@ nhdp_interface_apply_settings(struct nhdp_interface *interf) {
   interf->l_hold_time = interf->h_hold_time;
   interf->n_hold_time = interf->l_hold_time;
   interf->i_hold_time = interf->n_hold_time;
+
+  /* interval and validity time TLVs might have changed */
+  nhdp_writer_invalidate_hello_cache();
 }
 
 /**
@@ -430,6 +432,8 @@ _remove_addr(struct nhdp_interface_addr *addr) {
   avl_remove(&_ifaddr_tree, &addr->_global_node);
   avl_remove(&addr->interf->_if_addresses, &addr->_if_node);
   oonf_class_free(&_addr_info, addr);
+
+  nhdp_writer_invalidate_hello_cache();
 }
 
 /**
@@ -550,4 +554,7 @@ _cb_interface_event(struct oonf_rfc5444_interface_listener *ifl,
       nhdp_db_link_set_unsymmetric(nhdp_link);
     }
   }
+
+  /* local addresses or MAC of the interface might have changed */
+  nhdp_writer_invalidate_hello_cache();
 }
@@ -67,6 +67,21 @@ struct nhdp_interface_domaindata;
 /*! memory class for NHDP interface address */
 #define NHDP_CLASS_INTERFACE_ADDRESS "nhdp_iaddr"
 
+/**
+ * Binary copy of the last HELLO generated for one
+ * address family of a NHDP interface
+ */
+struct nhdp_interface_hello_cache {
+  /*! HELLO content generation this copy belongs to, 0 if invalid */
+  uint64_t generation;
+
+  /*! length of cached message */
+  size_t length;
+
+  /*! binary HELLO message before postprocessing */
+  uint8_t data[RFC5444_MAX_MESSAGE_SIZE];
+};
+
 /**
  * nhdp_interface represents a local interface
  * participating in the mesh network
@@ -114,6 +129,12 @@ struct nhdp_interface {
   /*! timer for hello generation */
   struct oonf_timer_instance _hello_timer;
 
+  /*! timer to remove expired links and two-hop neighbors */
+  struct oonf_timer_instance _expiry_timer;
+
+  /*! last generated IPv4 and IPv6 HELLO of this interface */
+  struct nhdp_interface_hello_cache _hello_cache[2];
+
   /*! member entry for global interface tree */
   struct avl_node _node;
 
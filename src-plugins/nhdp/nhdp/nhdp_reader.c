@@ -47,6 +47,7 @@
 #include "common/netaddr.h"
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_rfc5444.h"
 
 #include "nhdp/nhdp.h"
@@ -930,15 +931,15 @@ _cb_msg_pass2_end(struct rfc5444_reader_tlvblock_context *context, bool dropped)
   }
   else if (_current.link_lost) {
     /* Section 12.5.4.1.2 */
-    if (oonf_timer_is_active(&_current.link->sym_time)) {
+    if (nhdp_db_timestamp_is_valid(_current.link->sym_time)) {
       OONF_DEBUG(LOG_NHDP_R, "Stop link timer for link to %s",
           netaddr_to_string(&nbuf, &_current.link->if_addr));
 
-      oonf_timer_stop(&_current.link->sym_time);
+      _current.link->sym_time = 0;
 
       /*
-       * the stop timer might have modified to link status, but do not trigger
-       * cleanup until this processing is over
+       * resetting the symmetric time might have modified to link status,
+       * but do not trigger cleanup until this processing is over
        */
       if (_nhdp_db_link_calculate_status(_current.link)== RFC6130_LINKSTATUS_HEARD) {
         nhdp_db_link_set_vtime(_current.link, _current.localif->l_hold_time);
@@ -947,11 +948,12 @@ _cb_msg_pass2_end(struct rfc5444_reader_tlvblock_context *context, bool dropped)
   }
 
   /* Section 12.5.4.3 */
-  t = oonf_timer_get_due(&_current.link->sym_time);
-  if (!oonf_timer_is_active(&_current.link->sym_time) || t < _current.vtime) {
-    t = _current.vtime;
+  t = _current.vtime;
+  if (nhdp_db_timestamp_is_valid(_current.link->sym_time)
+      && oonf_clock_get_relative(_current.link->sym_time) > (int64_t)t) {
+    t = oonf_clock_get_relative(_current.link->sym_time);
   }
-  oonf_timer_set(&_current.link->heard_time, t);
+  nhdp_db_link_set_heardtime(_current.link, t);
 
   /* Section 12.5.4.4: link status pending is not influenced by the code above */
   if (_current.link->status != NHDP_LINK_PENDING) {
@@ -959,9 +961,9 @@ _cb_msg_pass2_end(struct rfc5444_reader_tlvblock_context *context, bool dropped)
   }
 
   /* Section 12.5.4.5 */
-  if (!oonf_timer_is_active(&_current.link->vtime)
-      || (int64_t)t > oonf_timer_get_due(&_current.link->vtime)) {
-    oonf_timer_set(&_current.link->vtime, t);
+  if (!nhdp_db_timestamp_is_valid(_current.link->vtime)
+      || (int64_t)t > oonf_clock_get_relative(_current.link->vtime)) {
+    nhdp_db_link_set_vtime(_current.link, t);
   }
 
   /* overwrite originator of neighbor entry */
@@ -68,6 +68,11 @@ static int _cb_addMessageHeader(
     struct rfc5444_writer *, struct rfc5444_writer_message *);
 static void _cb_addMessageTLVs(struct rfc5444_writer *);
 static void _cb_addAddresses(struct rfc5444_writer *);
+static void _cb_cacheMessage(struct rfc5444_writer *,
+    struct rfc5444_writer_message *, const uint8_t *, size_t);
+
+static void _send_hello(struct oonf_rfc5444_target *target,
+    struct nhdp_interface_hello_cache *cache);
 
 static void _add_link_address(struct rfc5444_writer *writer,
     struct rfc5444_writer_content_provider *prv,
@@ -103,6 +108,12 @@ static bool _cleanedup = false;
 static bool _add_mac_tlv = true;
 static struct nhdp_interface *_nhdp_if = NULL;
 
+/* current generation of HELLO content, incremented by every change */
+static uint64_t _hello_generation = 1;
+
+/* cache entry for the HELLO that is currently generated */
+static struct nhdp_interface_hello_cache *_current_cache = NULL;
+
 /**
  * Initialize nhdp writer
  * @param p rfc5444 protocol
@@ -120,6 +131,7 @@ nhdp_writer_init(struct oonf_rfc5444_protocol *p) {
   }
 
   _nhdp_message->addMessageHeader = _cb_addMessageHeader;
+  _nhdp_message->cacheMessage = _cb_cacheMessage;
 
   if (rfc5444_writer_register_msgcontentprovider(
       &_protocol->writer, &_nhdp_msgcontent_provider,
@@ -154,9 +166,7 @@ nhdp_writer_cleanup(void) {
  */
 void
 nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
-  enum rfc5444_result result;
   struct os_interface_listener *interf;
-  struct netaddr_str buf;
 
   if (_cleanedup) {
     /* do not send more Hellos during shutdown */
@@ -176,20 +186,32 @@ nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
   _nhdp_if = ninterf;
 
   /* send IPv4 (if socket is active) */
-  result = oonf_rfc5444_send_if(ninterf->rfc5444_if.interface->multicast4, RFC6130_MSGTYPE_HELLO);
-  if (result < 0) {
-    OONF_WARN(LOG_NHDP_W, "Could not send NHDP message to %s: %s (%d)",
-        netaddr_to_string(&buf, &ninterf->rfc5444_if.interface->multicast4->dst), rfc5444_strerror(result), result);
-  }
+  _send_hello(ninterf->rfc5444_if.interface->multicast4, &ninterf->_hello_cache[0]);
 
   /* send IPV6 (if socket is active) */
-  result = oonf_rfc5444_send_if(ninterf->rfc5444_if.interface->multicast6, RFC6130_MSGTYPE_HELLO);
-  if (result < 0) {
-    OONF_WARN(LOG_NHDP_W, "Could not send NHDP message to %s: %s (%d)",
-        netaddr_to_string(&buf, &ninterf->rfc5444_if.interface->multicast6->dst), rfc5444_strerror(result), result);
-  }
+  _send_hello(ninterf->rfc5444_if.interface->multicast6, &ninterf->_hello_cache[1]);
+}
+
+/**
+ * Mark all cached HELLO messages as outdated. This must be called
+ * for every change of the database content that ends up in a HELLO.
+ */
+void
+nhdp_writer_invalidate_hello_cache(void) {
+  _hello_generation++;
 }
 
+/**
+ * Mark the cached HELLO messages of a single interface as outdated.
+ * This is enough for changes that only end up in the HELLOs of
+ * this interface, like link metrics.
+ * @param ninterf NHDP interface
+ */
+void
+nhdp_writer_invalidate_interface_hello_cache(struct nhdp_interface *ninterf) {
+  ninterf->_hello_cache[0].generation = 0;
+  ninterf->_hello_cache[1].generation = 0;
+}
 
 /**
  * activates or deactivates the MAC_TLV in the NHDP Hello messages
@@ -197,7 +219,46 @@ nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
  */
 void
 nhdp_writer_set_mac_TLV_state(bool active) {
-  _add_mac_tlv = active;
+  if (_add_mac_tlv != active) {
+    _add_mac_tlv = active;
+    nhdp_writer_invalidate_hello_cache();
+  }
+}
+
+/**
+ * Send a HELLO through a multicast target, either by reusing
+ * the cached binary message or by generating a new one.
+ * @param target rfc5444 multicast target
+ * @param cache HELLO cache for the address family of the target
+ */
+static void
+_send_hello(struct oonf_rfc5444_target *target,
+    struct nhdp_interface_hello_cache *cache) {
+  enum rfc5444_result result;
+  struct netaddr_str buf;
+
+  if (cache->generation == _hello_generation) {
+    OONF_DEBUG(LOG_NHDP_W, "Reuse cached Hello for %s",
+        netaddr_to_string(&buf, &target->dst));
+
+    result = oonf_rfc5444_send_if_cached(target, RFC6130_MSGTYPE_HELLO,
+        cache->data, cache->length);
+    if (result == RFC5444_OKAY) {
+      return;
+    }
+
+    /* cached message cannot be used anymore, generate a new one */
+    cache->generation = 0;
+  }
+
+  _current_cache = cache;
+  result = oonf_rfc5444_send_if(target, RFC6130_MSGTYPE_HELLO);
+  _current_cache = NULL;
+
+  if (result < 0) {
+    OONF_WARN(LOG_NHDP_W, "Could not send NHDP message to %s: %s (%d)",
+        netaddr_to_string(&buf, &target->dst), rfc5444_strerror(result), result);
+  }
 }
 
 /**
@@ -248,6 +309,30 @@ _cb_addMessageHeader(struct rfc5444_writer *writer,
   return RFC5444_OKAY;
 }
 
+/**
+ * Callback to store the binary form of a generated HELLO message
+ * @param writer rfc5444 writer
+ * @param msg rfc5444 message
+ * @param data pointer to binary message
+ * @param len length of binary message
+ */
+static void
+_cb_cacheMessage(struct rfc5444_writer *writer __attribute__((unused)),
+    struct rfc5444_writer_message *msg, const uint8_t *data, size_t len) {
+  if (_current_cache == NULL || len > sizeof(_current_cache->data)) {
+    return;
+  }
+
+  if (msg->_provider_tree.count != 1) {
+    /* other plugins add content to the HELLO we cannot track */
+    return;
+  }
+
+  memcpy(_current_cache->data, data, len);
+  _current_cache->length = len;
+  _current_cache->generation = _hello_generation;
+}
+
 /**
  * Callback to add the message TLVs to a HELLO message
  * @param writer
@@ -53,6 +53,9 @@ int nhdp_writer_init(struct oonf_rfc5444_protocol *)
   __attribute__((warn_unused_result));
 void nhdp_writer_cleanup(void);
 
+void nhdp_writer_invalidate_hello_cache(void);
+void nhdp_writer_invalidate_interface_hello_cache(struct nhdp_interface *ninterf);
+
 EXPORT void nhdp_writer_send_hello(struct nhdp_interface *interf);
 
 EXPORT void nhdp_writer_set_mac_TLV_state(bool active);
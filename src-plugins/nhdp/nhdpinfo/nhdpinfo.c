@@ -599,11 +599,11 @@ _initialize_nhdp_link_values(struct nhdp_link *lnk) {
   oonf_clock_toIntervalString(&_value_link_itime_value, lnk->itime_value);
 
   oonf_clock_toIntervalString(&_value_link_symtime,
-      oonf_timer_get_due(&lnk->sym_time));
+      oonf_clock_get_relative(lnk->sym_time));
   oonf_clock_toIntervalString(&_value_link_heardtime,
-      oonf_timer_get_due(&lnk->heard_time));
+      oonf_clock_get_relative(lnk->heard_time));
   oonf_clock_toIntervalString(&_value_link_vtime,
-      oonf_timer_get_due(&lnk->vtime));
+      oonf_clock_get_relative(lnk->vtime));
 
   strscpy(_value_link_status, nhdp_db_link_status_to_string(lnk),
       sizeof(_value_link_status));
@@ -691,7 +691,7 @@ _initialize_nhdp_link_twohop_values(struct nhdp_l2hop *twohop) {
       sizeof(_value_twohop_sameif));
 
   oonf_clock_toIntervalString(&_value_twohop_vtime,
-      oonf_timer_get_due(&twohop->_vtime));
+      oonf_clock_get_relative(twohop->_vtime));
 }
 
 /**
@@ -734,11 +734,11 @@ _initialize_nhdp_neighbor_address_values(struct nhdp_naddr *naddr) {
   netaddr_to_string(&_value_neighbor_address, &naddr->neigh_addr);
 
   strscpy(_value_neighbor_address_lost,
-      json_getbool(oonf_timer_is_active(&naddr->_lost_vtime)),
+      json_getbool(nhdp_db_neighbor_addr_is_lost(naddr)),
       sizeof(_value_neighbor_address_lost));
 
   oonf_clock_toIntervalString(&_value_neighbor_address_lost_vtime,
-      oonf_timer_get_due(&naddr->_lost_vtime));
+      oonf_clock_get_relative(naddr->_lost_vtime));
 }
 
 /**
@@ -54,6 +54,7 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "core/os_core.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/oonf_rfc5444.h"
 #include "subsystems/oonf_telnet.h"
 #include "subsystems/oonf_timer.h"
@@ -219,6 +220,7 @@ static struct cfg_schema_section _olsrv2_section = {
 
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_RFC5444_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
@@ -526,6 +528,16 @@ olsrv2_get_ansn(void) {
   return _ansn;
 }
 
+/**
+ * Overwrite the answer set number of the local topology database,
+ * used to continue the ANSN sequence of an earlier run of the router.
+ * @param ansn new answer set number
+ */
+void
+olsrv2_set_ansn(uint16_t ansn) {
+  _ansn = ansn;
+}
+
 /**
  * Update answer set number if metric of a neighbor changed since last update.
  * @return new answer set number, might be the same if no metric changed.
@@ -91,6 +91,7 @@ EXPORT bool olsrv2_mpr_shall_forwarding(
     struct netaddr *source_address, uint64_t vtime);
 EXPORT uint16_t olsrv2_get_ansn(void);
 EXPORT uint16_t olsrv2_update_ansn(void);
+EXPORT void olsrv2_set_ansn(uint16_t ansn);
 EXPORT int olsrv2_validate_lan(const struct cfg_schema_entry *entry,
     const char *section_name, const char *value, struct autobuf *out);
 
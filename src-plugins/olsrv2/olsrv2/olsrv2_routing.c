@@ -47,11 +47,13 @@
 
 #include "common/avl.h"
 #include "common/avl_comp.h"
+#include "common/avl_typed.h"
 #include "common/common_types.h"
 #include "common/list.h"
 #include "common/netaddr.h"
 #include "core/oonf_logging.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/oonf_rfc5444.h"
 #include "subsystems/oonf_timer.h"
 #include "subsystems/os_routing.h"
@@ -110,6 +112,12 @@ static struct oonf_timer_instance _rate_limit_timer = {
   .class = &_dijkstra_timer_info
 };
 
+/* runtime of a single dijkstra run */
+static struct oonf_histogram _dijkstra_histogram = {
+  .name = "olsrv2_dijkstra",
+  .unit = "ns",
+};
+
 /* callback for NHDP domain events */
 static struct nhdp_domain_listener _nhdp_listener = {
   .update = _cb_nhdp_update,
@@ -124,6 +132,12 @@ static struct list_entity _routing_filter_list;
 static struct avl_tree _dijkstra_working_tree;
 static struct list_entity _kernel_queue;
 
+/* specialized avl functions for routing entries and the dijkstra queue */
+AVL_DEFINE_TYPED_MEMBER(routing_entry, struct os_route_key,
+    struct olsrv2_routing_entry, _node, route.p.key, os_routing_cmp_route_key)
+AVL_DEFINE_TYPED_MEMBER(dijkstra, uint32_t,
+    struct olsrv2_dijkstra_node, _node, path_cost, avl_typed_cmp_uint32)
+
 static bool _initiate_shutdown = false;
 
 /**
@@ -135,6 +149,7 @@ olsrv2_routing_init(void) {
 
   oonf_class_add(&_rtset_entry);
   oonf_timer_add(&_dijkstra_timer_info);
+  oonf_histogram_add(&_dijkstra_histogram);
 
   for (i=0; i<NHDP_MAXIMUM_DOMAINS; i++) {
     avl_init(&_routing_tree[i], os_routing_avl_cmp_route_key, false);
@@ -199,6 +214,7 @@ olsrv2_routing_cleanup(void) {
     olsrv2_routing_filter_remove(filter);
   }
 
+  oonf_histogram_remove(&_dijkstra_histogram);
   oonf_timer_remove(&_dijkstra_timer_info);
   oonf_class_remove(&_rtset_entry);
 }
@@ -379,10 +395,14 @@ olsrv2_routing_get_filter_list(void) {
 static void
 _run_dijkstra(struct nhdp_domain *domain, int af_family,
     bool use_non_ss, bool use_ss) {
+  uint64_t start;
+
   OONF_INFO(LOG_OLSRV2_ROUTING, "Run %s dijkstra on domain %d: %s/%s",
       af_family == AF_INET ? "ipv4" : "ipv6", domain->index,
       use_non_ss ? "true" : "false", use_ss ? "true" : "false");
 
+  start = oonf_histogram_start(&_dijkstra_histogram);
+
   /* add direct neighbors to working queue */
   _add_one_hop_nodes(domain, af_family, use_non_ss, use_ss);
 
@@ -390,6 +410,8 @@ _run_dijkstra(struct nhdp_domain *domain, int af_family,
   while (!avl_is_empty(&_dijkstra_working_tree)) {
     _handle_working_queue(domain, use_non_ss, use_ss);
   }
+
+  oonf_histogram_stop(&_dijkstra_histogram, start);
 }
 
 /**
@@ -402,8 +424,8 @@ static struct olsrv2_routing_entry *
 _add_entry(struct nhdp_domain *domain, struct os_route_key *prefix) {
   struct olsrv2_routing_entry *rtentry;
 
-  rtentry = avl_find_element(
-      &_routing_tree[domain->index], prefix, rtentry, _node);
+  rtentry = avl_typed_find_element(
+      routing_entry, &_routing_tree[domain->index], prefix, rtentry, _node);
   if (rtentry) {
     return rtentry;
   }
@@ -428,7 +450,7 @@ _add_entry(struct nhdp_domain *domain, struct os_route_key *prefix) {
 
   rtentry->route.p.type = OS_ROUTE_UNICAST;
 
-  avl_insert(&_routing_tree[domain->index], &rtentry->_node);
+  avl_routing_entry_insert(&_routing_tree[domain->index], &rtentry->_node);
   return rtentry;
 }
 
@@ -510,7 +532,7 @@ _insert_into_working_tree(struct olsrv2_tc_target *target,
   node->single_hop = single_hop;
   node->last_originator = last_originator;
 
-  avl_insert(&_dijkstra_working_tree, &node->_node);
+  avl_dijkstra_insert(&_dijkstra_working_tree, &node->_node);
   return;
 }
 
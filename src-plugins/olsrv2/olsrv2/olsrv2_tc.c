@@ -45,6 +45,7 @@
 
 #include "common/avl.h"
 #include "common/avl_comp.h"
+#include "common/avl_typed.h"
 #include "common/common_types.h"
 #include "common/netaddr.h"
 #include "subsystems/oonf_class.h"
@@ -148,8 +149,8 @@ olsrv2_tc_node_add(struct netaddr *originator,
     uint64_t vtime, uint16_t ansn) {
   struct olsrv2_tc_node *node;
 
-  node = avl_find_element(
-      &_tc_tree, originator, node, _originator_node);
+  node = avl_typed_find_element(
+      tc_node, &_tc_tree, originator, node, _originator_node);
   if (!node) {
     node = oonf_class_malloc(&_tc_node_class);
     if (node == NULL) {
@@ -173,7 +174,7 @@ olsrv2_tc_node_add(struct netaddr *originator,
     olsrv2_routing_dijkstra_node_init(&node->target._dijkstra);
 
     /* hook into global tree */
-    avl_insert(&_tc_tree, &node->_originator_node);
+    avl_tc_node_insert(&_tc_tree, &node->_originator_node);
 
     /* fire event */
     oonf_class_event(&_tc_node_class, node, OONF_OBJECT_ADDED);
@@ -234,7 +235,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
   struct olsrv2_tc_node *dst = NULL;
   int i;
 
-  edge = avl_find_element(&src->_edges, addr, edge, _node);
+  edge = avl_typed_find_element(netaddr, &src->_edges, addr, edge, _node);
   if (edge != NULL) {
     edge->virtual = false;
 
@@ -262,7 +263,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
   }
 
   /* find or allocate destination node */
-  dst = avl_find_element(&_tc_tree, addr, dst, _originator_node);
+  dst = avl_typed_find_element(tc_node, &_tc_tree, addr, dst, _originator_node);
   if (dst == NULL) {
     /* create virtual node */
     dst = olsrv2_tc_node_add(addr, 0, 0);
@@ -283,7 +284,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
 
   /* hook edge into src node */
   edge->_node.key = &dst->target.prefix.dst;
-  avl_insert(&src->_edges, &edge->_node);
+  avl_netaddr_insert(&src->_edges, &edge->_node);
 
   /* initialize inverse (virtual) edge */
   inverse->src = dst;
@@ -296,7 +297,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
 
   /* hook inverse edge into dst node */
   inverse->_node.key = &src->target.prefix.dst;
-  avl_insert(&dst->_edges, &inverse->_node);
+  avl_netaddr_insert(&dst->_edges, &inverse->_node);
 
   /* fire event */
   oonf_class_event(&_tc_edge_class, edge, OONF_OBJECT_ADDED);
@@ -328,7 +329,7 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node,
   struct olsrv2_tc_endpoint *end;
   int i;
 
-  net = avl_find_element(&node->_attached_networks, prefix, net, _src_node);
+  net = avl_typed_find_element(route_key, &node->_attached_networks, prefix, net, _src_node);
   if (net != NULL) {
     return net;
   }
@@ -338,7 +339,7 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node,
     return NULL;
   }
 
-  end = avl_find_element(&_tc_endpoint_tree, prefix, end, _node);
+  end = avl_typed_find_element(route_key, &_tc_endpoint_tree, prefix, end, _node);
   if (end == NULL) {
     /* create new endpoint */
     end = oonf_class_malloc(&_tc_endpoint_class);
@@ -354,7 +355,7 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node,
     /* attach to global tree */
     memcpy(&end->target.prefix, prefix, sizeof(*prefix));
     end->_node.key = &end->target.prefix;
-    avl_insert(&_tc_endpoint_tree, &end->_node);
+    avl_route_key_insert(&_tc_endpoint_tree, &end->_node);
 
     oonf_class_event(&_tc_endpoint_class, end, OONF_OBJECT_ADDED);
   }
@@ -368,11 +369,11 @@ olsrv2_tc_endpoint_add(struct olsrv2_tc_node *node,
 
   /* hook into src node */
   net->_src_node.key = &end->target.prefix;
-  avl_insert(&node->_attached_networks, &net->_src_node);
+  avl_route_key_insert(&node->_attached_networks, &net->_src_node);
 
   /* hook into endpoint */
   net->_endpoint_node.key = &node->target.prefix;
-  avl_insert(&end->_attached_networks, &net->_endpoint_node);
+  avl_route_key_insert(&end->_attached_networks, &net->_endpoint_node);
 
   /* initialize dijkstra data */
   olsrv2_routing_dijkstra_node_init(&end->target._dijkstra);
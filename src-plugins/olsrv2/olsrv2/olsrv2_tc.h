@@ -47,6 +47,7 @@
 #define OLSRV2_TC_H_
 
 #include "common/avl.h"
+#include "common/avl_typed.h"
 #include "common/common_types.h"
 #include "common/netaddr.h"
 
@@ -136,6 +137,10 @@ struct olsrv2_tc_node {
   struct avl_node _originator_node;
 };
 
+/* avl_tc_node_find() and avl_tc_node_insert() for the tree of tc_nodes */
+AVL_DEFINE_TYPED_MEMBER(tc_node, struct netaddr,
+    struct olsrv2_tc_node, _originator_node, target.prefix.dst, netaddr_cmp)
+
 /**
  * represents an edge between two tc nodes
  */
@@ -225,7 +230,7 @@ EXPORT struct olsrv2_tc_attachment *olsrv2_tc_endpoint_add(
 EXPORT void olsrv2_tc_endpoint_remove(
     struct olsrv2_tc_attachment *);
 
-void olsrv2_tc_trigger_change(struct olsrv2_tc_node *);
+EXPORT void olsrv2_tc_trigger_change(struct olsrv2_tc_node *);
 
 EXPORT struct avl_tree *olsrv2_tc_get_tree(void);
 EXPORT struct avl_tree *olsrv2_tc_get_endpoint_tree(void);
@@ -238,7 +243,7 @@ static INLINE struct olsrv2_tc_node *
 olsrv2_tc_node_get(struct netaddr *originator) {
   struct olsrv2_tc_node *node;
 
-  return avl_find_element(olsrv2_tc_get_tree(), originator, node, _originator_node);
+  return avl_typed_find_element(tc_node, olsrv2_tc_get_tree(), originator, node, _originator_node);
 }
 
 /**
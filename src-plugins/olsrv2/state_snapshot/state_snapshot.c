@@ -0,0 +1,1296 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/autobuf.h"
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/string.h"
+
+#include "config/cfg_schema.h"
+#include "core/oonf_cfg.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
+#include "subsystems/oonf_duplicate_set.h"
+#include "subsystems/oonf_rfc5444.h"
+#include "subsystems/oonf_telnet.h"
+#include "subsystems/oonf_timer.h"
+
+#include "nhdp/nhdp_db.h"
+#include "nhdp/nhdp_domain.h"
+#include "nhdp/nhdp_interfaces.h"
+
+#include "olsrv2/olsrv2.h"
+#include "olsrv2/olsrv2_originator.h"
+#include "olsrv2/olsrv2_routing.h"
+#include "olsrv2/olsrv2_tc.h"
+
+#include "state_snapshot/state_snapshot.h"
+
+/* definitions */
+#define LOG_STATE_SNAPSHOT _snapshot_subsystem.logging
+
+/*! magic bytes at the start of a snapshot file */
+#define SNAPSHOT_MAGIC "OONFSNAP"
+
+/*! version of snapshot file format, 2 added the duplicate set history */
+#define SNAPSHOT_VERSION 2
+
+/**
+ * Record types of a snapshot file
+ */
+enum _snapshot_record {
+  /*! NHDP neighbor including its links */
+  SNAPSHOT_NEIGHBOR = 1,
+
+  /*! OLSRv2 topology node including edges and attached networks */
+  SNAPSHOT_TC_NODE  = 2,
+
+  /*! entry of a RFC5444 duplicate set */
+  SNAPSHOT_DUPLICATE = 3,
+
+  /*! packet sequence number of a RFC5444 multicast target */
+  SNAPSHOT_PKTSEQNO  = 4,
+};
+
+/**
+ * Duplicate sets stored in a snapshot file
+ */
+enum _snapshot_dupset {
+  /*! duplicate set for processed messages */
+  SNAPSHOT_DUPSET_PROCESSED = 0,
+
+  /*! duplicate set for forwarded messages */
+  SNAPSHOT_DUPSET_FORWARDED = 1,
+};
+
+/**
+ * Configuration of state snapshot plugin
+ */
+struct _snapshot_config {
+  /*! name of snapshot file */
+  char *file;
+
+  /*! validity time of restored state */
+  uint64_t validity;
+
+  /*! maximum age of a snapshot that will be restored */
+  uint64_t max_age;
+};
+
+/**
+ * Read cursor for snapshot data
+ */
+struct _snapshot_reader {
+  /*! pointer to next unread byte */
+  const uint8_t *ptr;
+
+  /*! number of bytes left */
+  size_t len;
+};
+
+/* prototypes */
+static int _init(void);
+static void _initiate_shutdown(void);
+static void _cleanup(void);
+
+static int _save_snapshot(const char *filename);
+static void _write_neighbor(struct autobuf *out, struct nhdp_neighbor *neigh);
+static void _write_link(struct autobuf *out, struct nhdp_link *lnk);
+static void _write_tc_node(struct autobuf *out, struct olsrv2_tc_node *node);
+static void _write_dupset(struct autobuf *out,
+    enum _snapshot_dupset type, struct oonf_duplicate_set *set);
+static void _write_pktseqno(struct autobuf *out, struct oonf_rfc5444_target *target);
+static size_t _start_record(struct autobuf *out, enum _snapshot_record type);
+static void _end_record(struct autobuf *out, size_t start);
+
+static int _restore_snapshot(const char *filename);
+static int _parse_snapshot(struct _snapshot_reader *reader);
+static int _read_neighbor(struct _snapshot_reader *reader);
+static int _read_link(struct _snapshot_reader *reader, struct nhdp_neighbor *neigh);
+static int _read_tc_node(struct _snapshot_reader *reader);
+static int _read_duplicate(struct _snapshot_reader *reader);
+static int _read_pktseqno(struct _snapshot_reader *reader);
+static int _read_addresses(struct _snapshot_reader *reader,
+    struct nhdp_neighbor *neigh, bool *known);
+static int _read_metrics(struct _snapshot_reader *reader,
+    struct nhdp_metric *metrics);
+static int _get(struct _snapshot_reader *reader, void *dst, size_t len);
+
+static void _save_on_shutdown(void);
+
+static void _cb_nhdp_interface_removed(void *);
+static void _cb_restore(struct oonf_timer_instance *);
+static enum oonf_telnet_result _cb_snapshot_cmd(struct oonf_telnet_data *con);
+static void _cb_cfg_changed(void);
+
+/* configuration */
+static struct _snapshot_config _config;
+
+static struct cfg_schema_entry _snapshot_entries[] = {
+  CFG_MAP_STRING(_snapshot_config, file, "file", "/var/run/olsrd2.state",
+      "File the protocol state is written to on shutdown and restored from"
+      " during startup, empty to disable the snapshot"),
+  CFG_MAP_CLOCK_MIN(_snapshot_config, validity, "validity", "6.0",
+      "Validity time of the restored state, it should be long enough to"
+      " receive a HELLO of every neighbor", 100),
+  CFG_MAP_CLOCK(_snapshot_config, max_age, "max_age", "60.0",
+      "Maximum age of a snapshot file, older snapshots will be ignored"),
+};
+
+static struct cfg_schema_section _snapshot_section = {
+  .type = OONF_STATE_SNAPSHOT_SUBSYSTEM,
+  .cb_delta_handler = _cb_cfg_changed,
+  .entries = _snapshot_entries,
+  .entry_count = ARRAYSIZE(_snapshot_entries),
+};
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_DUPSET_SUBSYSTEM,
+  OONF_RFC5444_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+};
+static struct oonf_subsystem _snapshot_subsystem = {
+  .name = OONF_STATE_SNAPSHOT_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "OLSRv2 protocol state snapshot plugin",
+  .author = "Henning Rogge",
+
+  .cfg_section = &_snapshot_section,
+
+  .init = _init,
+  .initiate_shutdown = _initiate_shutdown,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_snapshot_subsystem);
+
+/* telnet command of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD(OONF_STATE_SNAPSHOT_SUBSYSTEM, _cb_snapshot_cmd,
+      "\"" OONF_STATE_SNAPSHOT_SUBSYSTEM " save\": write protocol state into snapshot file\n"
+      "\"" OONF_STATE_SNAPSHOT_SUBSYSTEM " restore\": restore protocol state from snapshot file\n"),
+};
+
+/* timer for restoring the snapshot after the first configuration */
+static struct oonf_timer_class _restore_timer_class = {
+  .name = "state snapshot restore",
+  .callback = _cb_restore,
+};
+
+static struct oonf_timer_instance _restore_timer = {
+  .class = &_restore_timer_class,
+};
+
+/* listener for NHDP interfaces removed during shutdown */
+static struct oonf_class_extension _nhdp_interface_listener = {
+  .ext_name = "state snapshot",
+  .class_name = NHDP_CLASS_INTERFACE,
+  .cb_remove = _cb_nhdp_interface_removed,
+};
+
+/* true if the snapshot has been restored after startup */
+static bool _restored = false;
+
+/* true if the snapshot has been written during shutdown */
+static bool _saved = false;
+
+/* mapping of domain indices of the restored snapshot to local domains */
+static struct nhdp_domain *_restore_domains[NHDP_MAXIMUM_DOMAINS];
+static uint8_t _restore_domain_count;
+
+/**
+ * Initialize plugin
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init(void) {
+  if (oonf_class_extension_add(&_nhdp_interface_listener)) {
+    return -1;
+  }
+  oonf_timer_add(&_restore_timer_class);
+  oonf_telnet_add(&_telnet_commands[0]);
+  return 0;
+}
+
+/**
+ * Write snapshot before the protocol state is torn down
+ */
+static void
+_initiate_shutdown(void) {
+  _save_on_shutdown();
+}
+
+/**
+ * Cleanup plugin
+ */
+static void
+_cleanup(void) {
+  oonf_telnet_remove(&_telnet_commands[0]);
+  oonf_timer_stop(&_restore_timer);
+  oonf_timer_remove(&_restore_timer_class);
+  oonf_class_extension_remove(&_nhdp_interface_listener);
+
+  free(_config.file);
+  _config.file = NULL;
+}
+
+/**
+ * Write the snapshot file once during shutdown
+ */
+static void
+_save_on_shutdown(void) {
+  if (_saved || _config.file == NULL || *_config.file == 0) {
+    return;
+  }
+
+  _saved = true;
+  _save_snapshot(_config.file);
+}
+
+/**
+ * Serialize NHDP neighbors, OLSRv2 topology and duplicate sets
+ * into a snapshot file
+ * @param filename name of snapshot file
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_save_snapshot(const char *filename) {
+  struct oonf_rfc5444_protocol *protocol;
+  struct oonf_rfc5444_interface *rfc5444_if;
+  struct nhdp_neighbor *neigh;
+  struct olsrv2_tc_node *node;
+  struct nhdp_domain *domain;
+  char tmpname[256];
+  struct autobuf out;
+  int64_t timestamp;
+  FILE *f;
+  int result;
+
+  if (abuf_init(&out)) {
+    return -1;
+  }
+
+  protocol = oonf_rfc5444_get_default_protocol();
+
+  /* file header */
+  timestamp = time(NULL);
+  abuf_memcpy(&out, SNAPSHOT_MAGIC, strlen(SNAPSHOT_MAGIC));
+  abuf_append_uint32(&out, SNAPSHOT_VERSION);
+  abuf_memcpy(&out, &timestamp, sizeof(timestamp));
+  abuf_append_uint16(&out, olsrv2_get_ansn());
+  abuf_append_uint16(&out, oonf_rfc5444_get_last_message_seqno(protocol));
+
+  abuf_append_uint8(&out, nhdp_domain_get_count());
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    abuf_append_uint8(&out, domain->ext);
+  }
+
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    _write_neighbor(&out, neigh);
+  }
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    if (!olsrv2_tc_is_node_virtual(node)) {
+      _write_tc_node(&out, node);
+    }
+  }
+
+  _write_dupset(&out, SNAPSHOT_DUPSET_PROCESSED, &protocol->processed_set);
+  _write_dupset(&out, SNAPSHOT_DUPSET_FORWARDED, &protocol->forwarded_set);
+
+  avl_for_each_element(&protocol->_interface_tree, rfc5444_if, _node) {
+    _write_pktseqno(&out, rfc5444_if->multicast4);
+    _write_pktseqno(&out, rfc5444_if->multicast6);
+  }
+
+  if (abuf_has_failed(&out)) {
+    OONF_WARN(LOG_STATE_SNAPSHOT, "Not enough memory for state snapshot");
+    abuf_free(&out);
+    return -1;
+  }
+
+  /* write into temporary file first so a crash never leaves a partial snapshot */
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+
+  result = -1;
+  f = fopen(tmpname, "w");
+  if (f == NULL) {
+    OONF_WARN(LOG_STATE_SNAPSHOT, "Cannot open snapshot file '%s': %s (%d)",
+        tmpname, strerror(errno), errno);
+  }
+  else {
+    if (fwrite(abuf_getptr(&out), abuf_getlen(&out), 1, f) == 1) {
+      result = 0;
+    }
+    if (fclose(f)) {
+      result = -1;
+    }
+
+    if (result == 0 && rename(tmpname, filename) == 0) {
+      OONF_INFO(LOG_STATE_SNAPSHOT, "Wrote %" PRINTF_SIZE_T_SPECIFIER
+          " bytes of protocol state to '%s'", abuf_getlen(&out), filename);
+    }
+    else {
+      OONF_WARN(LOG_STATE_SNAPSHOT, "Cannot write snapshot file '%s': %s (%d)",
+          filename, strerror(errno), errno);
+      remove(tmpname);
+      result = -1;
+    }
+  }
+
+  abuf_free(&out);
+  return result;
+}
+
+/**
+ * Append a NHDP neighbor record to a snapshot
+ * @param out output buffer
+ * @param neigh nhdp neighbor
+ */
+static void
+_write_neighbor(struct autobuf *out, struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_domain *domain;
+  struct nhdp_naddr *naddr;
+  struct nhdp_link *lnk;
+  uint16_t count;
+  size_t start;
+
+  start = _start_record(out, SNAPSHOT_NEIGHBOR);
+
+  abuf_memcpy(out, &neigh->originator, sizeof(neigh->originator));
+  abuf_append_uint8(out, neigh->flooding_willingness);
+  abuf_append_uint8(out, neigh->local_is_flooding_mpr ? 1 : 0);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+    abuf_append_uint8(out, neighdata->willingness);
+    abuf_append_uint8(out, neighdata->local_is_mpr ? 1 : 0);
+  }
+
+  /* addresses of neighbor, lost ones will be learned again if necessary */
+  count = 0;
+  avl_for_each_element(&neigh->_neigh_addresses, naddr, _neigh_node) {
+    if (!nhdp_db_neighbor_addr_is_lost(naddr)) {
+      count++;
+    }
+  }
+  abuf_append_uint16(out, count);
+  avl_for_each_element(&neigh->_neigh_addresses, naddr, _neigh_node) {
+    if (!nhdp_db_neighbor_addr_is_lost(naddr)) {
+      abuf_memcpy(out, &naddr->neigh_addr, sizeof(naddr->neigh_addr));
+    }
+  }
+
+  /* links of neighbor which have been heard at least */
+  count = 0;
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    if (lnk->status == NHDP_LINK_HEARD || lnk->status == NHDP_LINK_SYMMETRIC) {
+      count++;
+    }
+  }
+  abuf_append_uint16(out, count);
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    if (lnk->status == NHDP_LINK_HEARD || lnk->status == NHDP_LINK_SYMMETRIC) {
+      _write_link(out, lnk);
+    }
+  }
+
+  _end_record(out, start);
+}
+
+/**
+ * Append a NHDP link to a snapshot
+ * @param out output buffer
+ * @param lnk nhdp link
+ */
+static void
+_write_link(struct autobuf *out, struct nhdp_link *lnk) {
+  char ifname[IF_NAMESIZE];
+  struct nhdp_domain *domain;
+  struct nhdp_metric *metric;
+  struct nhdp_laddr *laddr;
+  struct nhdp_l2hop *l2hop;
+
+  memset(ifname, 0, sizeof(ifname));
+  strscpy(ifname, nhdp_interface_get_name(lnk->local_if), sizeof(ifname));
+
+  abuf_memcpy(out, ifname, sizeof(ifname));
+  abuf_memcpy(out, &lnk->if_addr, sizeof(lnk->if_addr));
+  abuf_memcpy(out, &lnk->remote_mac, sizeof(lnk->remote_mac));
+  abuf_append_uint8(out, lnk->status == NHDP_LINK_SYMMETRIC ? 1 : 0);
+  abuf_memcpy(out, &lnk->vtime_value, sizeof(lnk->vtime_value));
+  abuf_memcpy(out, &lnk->itime_value, sizeof(lnk->itime_value));
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    metric = &nhdp_domain_get_linkdata(domain, lnk)->metric;
+    abuf_append_uint32(out, metric->in);
+    abuf_append_uint32(out, metric->out);
+  }
+
+  abuf_append_uint16(out, lnk->_addresses.count);
+  avl_for_each_element(&lnk->_addresses, laddr, _link_node) {
+    abuf_memcpy(out, &laddr->link_addr, sizeof(laddr->link_addr));
+  }
+
+  abuf_append_uint16(out, lnk->_2hop.count);
+  avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
+    abuf_memcpy(out, &l2hop->twohop_addr, sizeof(l2hop->twohop_addr));
+    abuf_append_uint8(out, l2hop->same_interface ? 1 : 0);
+
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      metric = &nhdp_domain_get_l2hopdata(domain, l2hop)->metric;
+      abuf_append_uint32(out, metric->in);
+      abuf_append_uint32(out, metric->out);
+    }
+  }
+}
+
+/**
+ * Append an OLSRv2 topology node record to a snapshot
+ * @param out output buffer
+ * @param node tc node
+ */
+static void
+_write_tc_node(struct autobuf *out, struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_edge *edge;
+  struct nhdp_domain *domain;
+  uint16_t count;
+  size_t start;
+
+  start = _start_record(out, SNAPSHOT_TC_NODE);
+
+  abuf_memcpy(out, &node->target.prefix.dst, sizeof(node->target.prefix.dst));
+  abuf_append_uint16(out, node->ansn);
+  abuf_memcpy(out, &node->interval_time, sizeof(node->interval_time));
+  abuf_append_uint8(out, node->source_specific ? 1 : 0);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    abuf_append_uint8(out, node->ss_attached_networks[domain->index] ? 1 : 0);
+  }
+
+  /* virtual edges will be created again by their inverse edges */
+  count = 0;
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (!edge->virtual) {
+      count++;
+    }
+  }
+  abuf_append_uint16(out, count);
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (edge->virtual) {
+      continue;
+    }
+
+    abuf_memcpy(out, &edge->dst->target.prefix.dst, sizeof(edge->dst->target.prefix.dst));
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      abuf_append_uint32(out, edge->cost[domain->index]);
+    }
+  }
+
+  abuf_append_uint16(out, node->_attached_networks.count);
+  avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+    abuf_memcpy(out, &attached->dst->target.prefix, sizeof(attached->dst->target.prefix));
+    abuf_append_uint8(out,
+        attached->dst->target.type == OLSRV2_ADDRESS_TARGET ? 1 : 0);
+
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      abuf_append_uint32(out, attached->cost[domain->index]);
+      abuf_append_uint8(out, attached->distance[domain->index]);
+    }
+  }
+
+  _end_record(out, start);
+}
+
+/**
+ * Append all entries of a duplicate set to a snapshot
+ * @param out output buffer
+ * @param type type of duplicate set
+ * @param set duplicate set
+ */
+static void
+_write_dupset(struct autobuf *out,
+    enum _snapshot_dupset type, struct oonf_duplicate_set *set) {
+  struct oonf_duplicate_entry *entry;
+  size_t start;
+
+  oonf_duplicate_for_each_entry(set, entry) {
+    start = _start_record(out, SNAPSHOT_DUPLICATE);
+
+    abuf_append_uint8(out, type);
+    abuf_append_uint8(out, entry->key.msg_type);
+    abuf_memcpy(out, &entry->key.addr, sizeof(entry->key.addr));
+    abuf_memcpy(out, &entry->current, sizeof(entry->current));
+    abuf_memcpy(out, &entry->history, sizeof(entry->history));
+
+    _end_record(out, start);
+  }
+}
+
+/**
+ * Append the packet sequence number of a multicast target to a snapshot
+ * @param out output buffer
+ * @param target rfc5444 target, might be NULL
+ */
+static void
+_write_pktseqno(struct autobuf *out, struct oonf_rfc5444_target *target) {
+  char ifname[IF_NAMESIZE];
+  size_t start;
+
+  if (target == NULL) {
+    return;
+  }
+
+  memset(ifname, 0, sizeof(ifname));
+  strscpy(ifname, target->interface->name, sizeof(ifname));
+
+  start = _start_record(out, SNAPSHOT_PKTSEQNO);
+
+  abuf_memcpy(out, ifname, sizeof(ifname));
+  abuf_memcpy(out, &target->dst, sizeof(target->dst));
+  abuf_append_uint16(out, oonf_rfc5444_get_last_packet_seqno(target));
+
+  _end_record(out, start);
+}
+
+/**
+ * Start a new record in a snapshot
+ * @param out output buffer
+ * @param type record type
+ * @return position of record data for _end_record()
+ */
+static size_t
+_start_record(struct autobuf *out, enum _snapshot_record type) {
+  abuf_append_uint8(out, type);
+
+  /* placeholder for record length */
+  abuf_append_uint32(out, 0);
+  return abuf_getlen(out);
+}
+
+/**
+ * Finish a record and write its length into the record header
+ * @param out output buffer
+ * @param start position of record data returned by _start_record()
+ */
+static void
+_end_record(struct autobuf *out, size_t start) {
+  uint32_t len;
+
+  if (abuf_has_failed(out)) {
+    return;
+  }
+
+  len = abuf_getlen(out) - start;
+  memcpy(abuf_getptr(out) + start - sizeof(len), &len, sizeof(len));
+}
+
+/**
+ * Restore protocol state from a snapshot file
+ * @param filename name of snapshot file
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_restore_snapshot(const char *filename) {
+  struct _snapshot_reader reader;
+  uint8_t *buffer;
+  long size;
+  FILE *f;
+  int result;
+
+  f = fopen(filename, "r");
+  if (f == NULL) {
+    OONF_INFO(LOG_STATE_SNAPSHOT, "No snapshot file '%s' found", filename);
+    return -1;
+  }
+
+  buffer = NULL;
+  result = -1;
+  if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) > 0
+      && fseek(f, 0, SEEK_SET) == 0) {
+    buffer = malloc(size);
+    if (buffer != NULL && fread(buffer, size, 1, f) == 1) {
+      reader.ptr = buffer;
+      reader.len = size;
+      result = _parse_snapshot(&reader);
+    }
+  }
+  fclose(f);
+  free(buffer);
+
+  if (result) {
+    OONF_WARN(LOG_STATE_SNAPSHOT, "Could not restore state from '%s'", filename);
+  }
+  return result;
+}
+
+/**
+ * Parse the content of a snapshot file and add it to the
+ * protocol databases
+ * @param reader cursor of snapshot data
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_parse_snapshot(struct _snapshot_reader *reader) {
+  struct _snapshot_reader record;
+  char magic[sizeof(SNAPSHOT_MAGIC) - 1];
+  uint32_t version, len;
+  int64_t timestamp;
+  uint16_t ansn, msg_seqno;
+  uint8_t ext, type;
+  size_t i;
+  int result;
+
+  if (_get(reader, magic, sizeof(magic))
+      || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0
+      || _get(reader, &version, sizeof(version))
+      || version != SNAPSHOT_VERSION
+      || _get(reader, &timestamp, sizeof(timestamp))
+      || _get(reader, &ansn, sizeof(ansn))
+      || _get(reader, &msg_seqno, sizeof(msg_seqno))
+      || _get(reader, &_restore_domain_count, sizeof(_restore_domain_count))
+      || _restore_domain_count > NHDP_MAXIMUM_DOMAINS) {
+    OONF_WARN(LOG_STATE_SNAPSHOT, "Unknown snapshot file format");
+    return -1;
+  }
+
+  if (timestamp > time(NULL)
+      || (uint64_t)(time(NULL) - timestamp) * 1000ull > _config.max_age) {
+    OONF_INFO(LOG_STATE_SNAPSHOT, "Snapshot is too old, ignore it");
+    return 0;
+  }
+
+  for (i=0; i<_restore_domain_count; i++) {
+    if (_get(reader, &ext, sizeof(ext))) {
+      return -1;
+    }
+    _restore_domains[i] = nhdp_domain_get_by_ext(ext);
+  }
+
+  /*
+   * continue the ANSN and sequence numbers so neighbors do not
+   * drop our messages as outdated
+   */
+  olsrv2_set_ansn(ansn + 1);
+  oonf_rfc5444_set_last_message_seqno(
+      oonf_rfc5444_get_default_protocol(), msg_seqno);
+
+  result = 0;
+  while (reader->len > 0) {
+    if (_get(reader, &type, sizeof(type))
+        || _get(reader, &len, sizeof(len))
+        || len > reader->len) {
+      return -1;
+    }
+
+    record.ptr = reader->ptr;
+    record.len = len;
+    reader->ptr += len;
+    reader->len -= len;
+
+    switch (type) {
+      case SNAPSHOT_NEIGHBOR:
+        result |= _read_neighbor(&record);
+        break;
+      case SNAPSHOT_TC_NODE:
+        result |= _read_tc_node(&record);
+        break;
+      case SNAPSHOT_DUPLICATE:
+        result |= _read_duplicate(&record);
+        break;
+      case SNAPSHOT_PKTSEQNO:
+        result |= _read_pktseqno(&record);
+        break;
+      default:
+        /* ignore unknown records */
+        break;
+    }
+  }
+
+  nhdp_domain_neighborhood_changed();
+  olsrv2_routing_force_update(false);
+  return result;
+}
+
+/**
+ * Restore a NHDP neighbor and its links as tentative state
+ * @param reader cursor of record data
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_neighbor(struct _snapshot_reader *reader) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct _snapshot_reader addresses;
+  struct nhdp_neighbor *neigh;
+  struct netaddr originator;
+  uint8_t willingness[NHDP_MAXIMUM_DOMAINS];
+  uint8_t local_is_mpr[NHDP_MAXIMUM_DOMAINS];
+  uint8_t flooding_willingness, local_is_flooding_mpr;
+  uint16_t count;
+  bool known;
+  size_t i;
+
+  if (_get(reader, &originator, sizeof(originator))
+      || _get(reader, &flooding_willingness, sizeof(flooding_willingness))
+      || _get(reader, &local_is_flooding_mpr, sizeof(local_is_flooding_mpr))) {
+    return -1;
+  }
+  for (i=0; i<_restore_domain_count; i++) {
+    if (_get(reader, &willingness[i], sizeof(willingness[i]))
+        || _get(reader, &local_is_mpr[i], sizeof(local_is_mpr[i]))) {
+      return -1;
+    }
+  }
+
+  /* never overwrite neighbors learned since startup */
+  if (netaddr_get_address_family(&originator) != AF_UNSPEC
+      && nhdp_db_neighbor_get_by_originator(&originator) != NULL) {
+    return 0;
+  }
+
+  addresses = *reader;
+  if (_read_addresses(reader, NULL, &known)) {
+    return -1;
+  }
+  if (known) {
+    return 0;
+  }
+
+  neigh = nhdp_db_neighbor_add();
+  if (neigh == NULL) {
+    return -1;
+  }
+
+  if (_read_addresses(&addresses, neigh, &known)
+      || _get(reader, &count, sizeof(count))) {
+    nhdp_db_neighbor_remove(neigh);
+    return -1;
+  }
+
+  for (i=0; i<count; i++) {
+    if (_read_link(reader, neigh)) {
+      nhdp_db_neighbor_remove(neigh);
+      return -1;
+    }
+  }
+
+  if (list_is_empty(&neigh->_links)) {
+    /* none of the interfaces is configured anymore */
+    nhdp_db_neighbor_remove(neigh);
+    return 0;
+  }
+
+  neigh->flooding_willingness = flooding_willingness;
+  neigh->local_is_flooding_mpr = local_is_flooding_mpr != 0;
+  for (i=0; i<_restore_domain_count; i++) {
+    if (_restore_domains[i] != NULL) {
+      neighdata = nhdp_domain_get_neighbordata(_restore_domains[i], neigh);
+      neighdata->willingness = willingness[i];
+      neighdata->local_is_mpr = local_is_mpr[i] != 0;
+    }
+  }
+
+  nhdp_db_neighbor_set_originator(neigh, &originator);
+  return 0;
+}
+
+/**
+ * Read the address list of a NHDP neighbor record
+ * @param reader cursor of record data
+ * @param neigh nhdp neighbor the addresses should be added to,
+ *   NULL to only check if one of the addresses is already known
+ * @param known will be set to true if one of the addresses
+ *   is already in use by the database or a local interface
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_addresses(struct _snapshot_reader *reader,
+    struct nhdp_neighbor *neigh, bool *known) {
+  struct netaddr addr;
+  uint16_t count;
+  size_t i;
+
+  *known = false;
+  if (_get(reader, &count, sizeof(count))) {
+    return -1;
+  }
+
+  for (i=0; i<count; i++) {
+    if (_get(reader, &addr, sizeof(addr))) {
+      return -1;
+    }
+
+    if (neigh) {
+      if (nhdp_db_neighbor_addr_add(neigh, &addr) == NULL) {
+        return -1;
+      }
+    }
+    else if (nhdp_db_neighbor_addr_get(&addr) != NULL
+        || nhdp_interface_addr_global_get(&addr) != NULL) {
+      *known = true;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Restore a NHDP link of a neighbor
+ * @param reader cursor of record data
+ * @param neigh nhdp neighbor of the link
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_link(struct _snapshot_reader *reader, struct nhdp_neighbor *neigh) {
+  struct nhdp_metric metrics[NHDP_MAXIMUM_DOMAINS];
+  struct nhdp_interface *interf;
+  struct nhdp_link *lnk;
+  struct nhdp_l2hop *l2hop;
+  char ifname[IF_NAMESIZE];
+  struct netaddr if_addr, remote_mac, addr;
+  uint64_t vtime_value, itime_value;
+  uint8_t symmetric, same_interface;
+  uint16_t count;
+  size_t i, j;
+
+  if (_get(reader, ifname, sizeof(ifname))
+      || _get(reader, &if_addr, sizeof(if_addr))
+      || _get(reader, &remote_mac, sizeof(remote_mac))
+      || _get(reader, &symmetric, sizeof(symmetric))
+      || _get(reader, &vtime_value, sizeof(vtime_value))
+      || _get(reader, &itime_value, sizeof(itime_value))
+      || _read_metrics(reader, metrics)) {
+    return -1;
+  }
+  ifname[IF_NAMESIZE-1] = 0;
+
+  interf = nhdp_interface_get(ifname);
+  lnk = NULL;
+  if (interf != NULL) {
+    lnk = nhdp_db_link_add(neigh, interf);
+    if (lnk == NULL) {
+      return -1;
+    }
+
+    memcpy(&lnk->if_addr, &if_addr, sizeof(if_addr));
+    memcpy(&lnk->remote_mac, &remote_mac, sizeof(remote_mac));
+    lnk->vtime_value = vtime_value;
+    lnk->itime_value = itime_value;
+
+    for (j=0; j<_restore_domain_count; j++) {
+      if (_restore_domains[j] != NULL) {
+        nhdp_domain_get_linkdata(_restore_domains[j], lnk)->metric = metrics[j];
+      }
+    }
+  }
+
+  /* link addresses */
+  if (_get(reader, &count, sizeof(count))) {
+    return -1;
+  }
+  for (i=0; i<count; i++) {
+    if (_get(reader, &addr, sizeof(addr))) {
+      return -1;
+    }
+    if (lnk != NULL && nhdp_db_link_addr_add(lnk, &addr) == NULL) {
+      return -1;
+    }
+  }
+
+  /* two-hop neighbors */
+  if (_get(reader, &count, sizeof(count))) {
+    return -1;
+  }
+  for (i=0; i<count; i++) {
+    if (_get(reader, &addr, sizeof(addr))
+        || _get(reader, &same_interface, sizeof(same_interface))
+        || _read_metrics(reader, metrics)) {
+      return -1;
+    }
+    if (lnk == NULL) {
+      continue;
+    }
+
+    l2hop = nhdp_db_link_2hop_add(lnk, &addr);
+    if (l2hop == NULL) {
+      return -1;
+    }
+    l2hop->same_interface = same_interface != 0;
+    nhdp_db_link_2hop_set_vtime(l2hop, _config.validity);
+
+    for (j=0; j<_restore_domain_count; j++) {
+      if (_restore_domains[j] != NULL) {
+        nhdp_domain_get_l2hopdata(_restore_domains[j], l2hop)->metric = metrics[j];
+      }
+    }
+  }
+
+  if (lnk != NULL) {
+    /* restore the link as tentative state with shortened validity */
+    nhdp_db_link_set_heardtime(lnk, _config.validity);
+    nhdp_db_link_set_vtime(lnk, _config.validity + interf->l_hold_time);
+    if (symmetric) {
+      nhdp_db_link_set_symtime(lnk, _config.validity);
+    }
+    nhdp_db_link_update_status(lnk);
+  }
+  return 0;
+}
+
+/**
+ * Restore an OLSRv2 topology node as tentative state
+ * @param reader cursor of record data
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_tc_node(struct _snapshot_reader *reader) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_node *node;
+  struct os_route_key prefix;
+  struct netaddr originator, dst;
+  uint32_t cost[NHDP_MAXIMUM_DOMAINS];
+  uint8_t distance[NHDP_MAXIMUM_DOMAINS];
+  uint8_t ss_attached[NHDP_MAXIMUM_DOMAINS];
+  uint64_t interval_time;
+  uint8_t source_specific, mesh;
+  uint16_t ansn, count;
+  size_t i, j;
+
+  if (_get(reader, &originator, sizeof(originator))
+      || _get(reader, &ansn, sizeof(ansn))
+      || _get(reader, &interval_time, sizeof(interval_time))
+      || _get(reader, &source_specific, sizeof(source_specific))
+      || _get(reader, ss_attached, _restore_domain_count)) {
+    return -1;
+  }
+
+  if (olsrv2_originator_is_local(&originator)) {
+    return 0;
+  }
+
+  /* never overwrite topology received since startup */
+  node = olsrv2_tc_node_get(&originator);
+  if (node != NULL && !olsrv2_tc_is_node_virtual(node)) {
+    return 0;
+  }
+
+  node = olsrv2_tc_node_add(&originator, _config.validity, ansn);
+  if (node == NULL) {
+    return -1;
+  }
+  node->ansn = ansn;
+  node->interval_time = interval_time;
+  node->source_specific = source_specific != 0;
+
+  for (i=0; i<_restore_domain_count; i++) {
+    if (_restore_domains[i] != NULL) {
+      node->ss_attached_networks[_restore_domains[i]->index] = ss_attached[i] != 0;
+    }
+  }
+
+  /* edges to other nodes */
+  if (_get(reader, &count, sizeof(count))) {
+    goto read_failed;
+  }
+  for (i=0; i<count; i++) {
+    if (_get(reader, &dst, sizeof(dst))
+        || _get(reader, cost, sizeof(cost[0]) * _restore_domain_count)) {
+      goto read_failed;
+    }
+
+    edge = olsrv2_tc_edge_add(node, &dst);
+    if (edge == NULL) {
+      goto read_failed;
+    }
+
+    edge->ansn = ansn;
+    for (j=0; j<_restore_domain_count; j++) {
+      if (_restore_domains[j] != NULL) {
+        edge->cost[_restore_domains[j]->index] = cost[j];
+      }
+    }
+  }
+
+  /* attached networks and routable neighbor addresses */
+  if (_get(reader, &count, sizeof(count))) {
+    goto read_failed;
+  }
+  for (i=0; i<count; i++) {
+    if (_get(reader, &prefix, sizeof(prefix))
+        || _get(reader, &mesh, sizeof(mesh))) {
+      goto read_failed;
+    }
+    for (j=0; j<_restore_domain_count; j++) {
+      if (_get(reader, &cost[j], sizeof(cost[j]))
+          || _get(reader, &distance[j], sizeof(distance[j]))) {
+        goto read_failed;
+      }
+    }
+
+    attached = olsrv2_tc_endpoint_add(node, &prefix, mesh != 0);
+    if (attached == NULL) {
+      goto read_failed;
+    }
+
+    attached->ansn = ansn;
+    for (j=0; j<_restore_domain_count; j++) {
+      if (_restore_domains[j] != NULL) {
+        attached->cost[_restore_domains[j]->index] = cost[j];
+        attached->distance[_restore_domains[j]->index] = distance[j];
+      }
+    }
+  }
+
+  olsrv2_tc_trigger_change(node);
+  return 0;
+
+read_failed:
+  olsrv2_tc_node_remove(node);
+  return -1;
+}
+
+/**
+ * Restore an entry of a duplicate set
+ * @param reader cursor of record data
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_duplicate(struct _snapshot_reader *reader) {
+  struct oonf_rfc5444_protocol *protocol;
+  struct oonf_duplicate_set *set;
+  struct netaddr addr;
+  uint8_t type, msg_type;
+  uint64_t seqno, history;
+
+  if (_get(reader, &type, sizeof(type))
+      || _get(reader, &msg_type, sizeof(msg_type))
+      || _get(reader, &addr, sizeof(addr))
+      || _get(reader, &seqno, sizeof(seqno))
+      || _get(reader, &history, sizeof(history))) {
+    return -1;
+  }
+
+  protocol = oonf_rfc5444_get_default_protocol();
+  switch (type) {
+    case SNAPSHOT_DUPSET_PROCESSED:
+      set = &protocol->processed_set;
+      break;
+    case SNAPSHOT_DUPSET_FORWARDED:
+      set = &protocol->forwarded_set;
+      break;
+    default:
+      return 0;
+  }
+
+  /* the duplicate set does not override sequence numbers received since startup */
+  oonf_duplicate_entry_restore(set, msg_type, &addr, seqno, history, _config.validity);
+  return 0;
+}
+
+/**
+ * Restore the packet sequence number of a multicast target
+ * @param reader cursor of record data
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_pktseqno(struct _snapshot_reader *reader) {
+  struct oonf_rfc5444_interface *rfc5444_if;
+  struct oonf_rfc5444_target *target;
+  char ifname[IF_NAMESIZE];
+  struct netaddr dst;
+  uint16_t seqno;
+
+  if (_get(reader, ifname, sizeof(ifname))
+      || _get(reader, &dst, sizeof(dst))
+      || _get(reader, &seqno, sizeof(seqno))) {
+    return -1;
+  }
+  ifname[IF_NAMESIZE-1] = 0;
+
+  rfc5444_if = avl_find_element(&oonf_rfc5444_get_default_protocol()->_interface_tree,
+      ifname, rfc5444_if, _node);
+  if (rfc5444_if == NULL) {
+    return 0;
+  }
+
+  target = rfc5444_if->multicast4;
+  if (target == NULL || netaddr_cmp(&target->dst, &dst) != 0) {
+    target = rfc5444_if->multicast6;
+  }
+  if (target != NULL && netaddr_cmp(&target->dst, &dst) == 0) {
+    oonf_rfc5444_set_last_packet_seqno(target, seqno);
+  }
+  return 0;
+}
+
+/**
+ * Read the per-domain metrics of a link or two-hop neighbor
+ * @param reader cursor of record data
+ * @param metrics array for one metric per domain of the snapshot
+ * @return -1 if the record was malformed, 0 otherwise
+ */
+static int
+_read_metrics(struct _snapshot_reader *reader, struct nhdp_metric *metrics) {
+  size_t i;
+
+  for (i=0; i<_restore_domain_count; i++) {
+    if (_get(reader, &metrics[i].in, sizeof(metrics[i].in))
+        || _get(reader, &metrics[i].out, sizeof(metrics[i].out))) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Copy data from a snapshot and advance the cursor
+ * @param reader cursor of snapshot data
+ * @param dst pointer to destination buffer
+ * @param len number of bytes to read
+ * @return -1 if not enough data was left, 0 otherwise
+ */
+static int
+_get(struct _snapshot_reader *reader, void *dst, size_t len) {
+  if (reader->len < len) {
+    return -1;
+  }
+
+  memcpy(dst, reader->ptr, len);
+  reader->ptr += len;
+  reader->len -= len;
+  return 0;
+}
+
+/**
+ * Callback triggered when a NHDP interface is removed. Other plugins
+ * might already release the NHDP interfaces while the daemon shuts
+ * down, so the snapshot has to be written before the links are gone.
+ * @param ptr NHDP interface
+ */
+static void
+_cb_nhdp_interface_removed(void *ptr __attribute__((unused))) {
+  if (!oonf_cfg_is_running()) {
+    _save_on_shutdown();
+  }
+}
+
+/**
+ * Callback to restore the snapshot after the first configuration
+ * created the NHDP interfaces
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_restore(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  if (_config.file == NULL || *_config.file == 0) {
+    return;
+  }
+
+  if (_restore_snapshot(_config.file) == 0) {
+    OONF_INFO(LOG_STATE_SNAPSHOT, "Restored protocol state from '%s'", _config.file);
+  }
+}
+
+/**
+ * Handle telnet command to save or restore the protocol state
+ * @param con telnet connection
+ * @return active or internal error
+ */
+static enum oonf_telnet_result
+_cb_snapshot_cmd(struct oonf_telnet_data *con) {
+  if (_config.file == NULL || *_config.file == 0) {
+    abuf_puts(con->out, "No snapshot file configured\n");
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  if (con->parameter != NULL && strcasecmp(con->parameter, "save") == 0) {
+    if (_save_snapshot(_config.file)) {
+      abuf_appendf(con->out, "Could not write snapshot to '%s'\n", _config.file);
+    }
+    return TELNET_RESULT_ACTIVE;
+  }
+  if (con->parameter != NULL && strcasecmp(con->parameter, "restore") == 0) {
+    if (_restore_snapshot(_config.file)) {
+      abuf_appendf(con->out, "Could not restore snapshot from '%s'\n", _config.file);
+    }
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  abuf_appendf(con->out, "Unknown parameter for command '%s'\n", con->command);
+  return TELNET_RESULT_ACTIVE;
+}
+
+/**
+ * Configuration of plugin changed
+ */
+static void
+_cb_cfg_changed(void) {
+  if (cfg_schema_tobin(&_config, _snapshot_section.post,
+      _snapshot_entries, ARRAYSIZE(_snapshot_entries))) {
+    OONF_WARN(LOG_STATE_SNAPSHOT, "Could not convert "
+        OONF_STATE_SNAPSHOT_SUBSYSTEM " plugin configuration");
+    return;
+  }
+
+  if (!_restored) {
+    /* restore after all other subsystems applied the configuration */
+    _restored = true;
+    oonf_timer_set(&_restore_timer, 1);
+  }
+}
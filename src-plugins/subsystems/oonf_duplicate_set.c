@@ -43,13 +43,13 @@
  * @file
  */
 
-#include "common/avl.h"
-#include "common/avl_comp.h"
+#include <stdlib.h>
+
 #include "common/common_types.h"
+#include "common/list.h"
 #include "common/netaddr.h"
 #include "rfc5444/rfc5444.h"
 #include "core/oonf_subsystem.h"
-#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_timer.h"
 
 #include "subsystems/oonf_duplicate_set.h"
@@ -57,25 +57,45 @@
 /* Definitions */
 #define LOG_DUPLICATE_SET _oonf_duplicate_set_subsystem.logging
 
+/**
+ * state of a slot in the hash table of a duplicate set
+ */
+enum _dupset_slot_state {
+  /*! slot was never used */
+  _SLOT_EMPTY = 0,
+
+  /*! slot contains an entry */
+  _SLOT_USED,
+
+  /*! slot contained an entry that has been removed */
+  _SLOT_DELETED,
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
 static enum oonf_duplicate_result _test(struct oonf_duplicate_set *,
     struct oonf_duplicate_entry *, uint64_t seqno, bool set);
-static int _avl_cmp_dupkey(const void *, const void*);
+static uint32_t _hash_key(const struct oonf_duplicate_entry_key *key);
+static struct oonf_duplicate_entry *_find_slot(struct oonf_duplicate_set *set,
+    const struct oonf_duplicate_entry_key *key, uint32_t hash, bool insert);
+static int _resize(struct oonf_duplicate_set *set, uint32_t size);
+static uint32_t _get_expire(struct oonf_duplicate_set *set, uint64_t vtime);
 
-static void _cb_vtime(struct oonf_timer_instance *);
-static void _remove_duplicate_entry(struct oonf_duplicate_entry *entry);
+static void _cb_sweep(struct oonf_timer_instance *);
 
-static struct oonf_timer_class _vtime_info = {
-  .name = "Valdity time for duplicate set",
-  .callback = _cb_vtime,
+/* global list of duplicate sets */
+static struct list_entity _set_list = { &_set_list, &_set_list };
+
+static struct oonf_timer_class _sweep_info = {
+  .name = "Duplicate set sweep",
+  .callback = _cb_sweep,
+  .periodic = true,
 };
 
-static struct oonf_class _dupset_class = {
-  .name = "Duplicate set",
-  .size = sizeof(struct oonf_duplicate_entry),
+static struct oonf_timer_instance _sweep_timer = {
+  .class = &_sweep_info,
 };
 
 /* dupset result names */
@@ -90,7 +110,6 @@ static const char *OONF_DUPSET_RESULT_STR[] = {
 
 /* subsystem definition */
 static const char *_dependencies[] = {
-  OONF_CLASS_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
 };
 
@@ -116,8 +135,8 @@ static const int64_t _mask_values[] = {
  */
 static int
 _init(void) {
-  oonf_class_add(&_dupset_class);
-  oonf_timer_add(&_vtime_info);
+  oonf_timer_add(&_sweep_info);
+  oonf_timer_start(&_sweep_timer, OONF_DUPSET_SWEEP_INTERVAL);
   return 0;
 }
 
@@ -126,8 +145,8 @@ _init(void) {
  */
 static void
 _cleanup(void) {
-  oonf_timer_remove(&_vtime_info);
-  oonf_class_remove(&_dupset_class);
+  oonf_timer_stop(&_sweep_timer);
+  oonf_timer_remove(&_sweep_info);
 }
 
 /**
@@ -138,13 +157,14 @@ _cleanup(void) {
 void
 oonf_duplicate_set_add(struct oonf_duplicate_set *set, enum oonf_dupset_type type) {
   memset(set, 0, sizeof(*set));
-  avl_init(&set->_tree, _avl_cmp_dupkey, false);
 
   if (type != OONF_DUPSET_64BIT) {
     set->_mask   = _mask_values[type];
     set->_offset = set->_mask + 1;
     set->_limit  = set->_mask / 2;
   }
+
+  list_add_tail(&_set_list, &set->_node);
 }
 
 /**
@@ -153,11 +173,15 @@ oonf_duplicate_set_add(struct oonf_duplicate_set *set, enum oonf_dupset_type typ
  */
 void
 oonf_duplicate_set_remove(struct oonf_duplicate_set *set) {
-  struct oonf_duplicate_entry *entry, *it;
-
-  avl_for_each_element_safe(&set->_tree, entry, _node, it) {
-    _remove_duplicate_entry(entry);
+  if (list_is_node_added(&set->_node)) {
+    list_remove(&set->_node);
   }
+
+  free(set->_entries);
+  set->_entries = NULL;
+  set->_size = 0;
+  set->_used = 0;
+  set->_deleted = 0;
 }
 
 /**
@@ -168,7 +192,7 @@ oonf_duplicate_set_remove(struct oonf_duplicate_set *set) {
  * @param originator originator of sequence number
  * @param seqno sequence number
  * @param vtime validity time of sequence number
- * @return OONF_DUPSET_TOO_OLD if sequence number is more than 32 behind
+ * @return OONF_DUPSET_TOO_OLD if sequence number is more than 64 behind
  *   the current one, OONF_DUPSET_DUPLICATE if the number is in the set,
  *   OONF_DUPSET_NEW if the number was added to the set and OONF_DUPSET_NEWEST
  *   if the sequence number is newer than the newest in the set
@@ -179,38 +203,40 @@ oonf_duplicate_entry_add(struct oonf_duplicate_set *set, uint8_t msg_type,
   struct oonf_duplicate_entry *entry;
   struct oonf_duplicate_entry_key key;
   enum oonf_duplicate_result result;
+  uint32_t hash;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
 #endif
 
   /* generate combined key */
+  memset(&key, 0, sizeof(key));
   memcpy(&key.addr, originator, sizeof(*originator));
   key.msg_type = msg_type;
 
-  entry = avl_find_element(&set->_tree, &key, entry, _node);
-  if (!entry) {
-    entry = oonf_class_malloc(&_dupset_class);
-    if (entry == NULL) {
+  /* keep load factor (including tombstones) below 3/4 */
+  if ((set->_used + set->_deleted + 1) * 4 > set->_size * 3) {
+    if (_resize(set, set->_used * 2 + 2 > set->_size
+        ? set->_size * 2 : set->_size)) {
       return OONF_DUPSET_TOO_OLD;
     }
+  }
 
-    /* initialize history and current sequence number */
-    entry->current = seqno;
-    entry->history = 1;
-
-    /* initialize backpointer */
-    entry->set = set;
-
-    /* initialize vtime */
-    entry->_vtime.class = &_vtime_info;
-
-    oonf_timer_start(&entry->_vtime, vtime);
+  hash = _hash_key(&key);
+  entry = _find_slot(set, &key, hash, true);
+  if (entry->_state != _SLOT_USED) {
+    if (entry->_state == _SLOT_DELETED) {
+      set->_deleted--;
+    }
+    set->_used++;
 
-    /* set key and link entry to set */
+    /* set key and initialize history and current sequence number */
     memcpy(&entry->key, &key, sizeof(key));
-    entry->_node.key = &entry->key;
-    avl_insert(&set->_tree, &entry->_node);
+    entry->_state = _SLOT_USED;
+    entry->_hash = hash;
+    entry->current = seqno;
+    entry->history = 1;
+    entry->too_old_count = 0;
 
     result = OONF_DUPSET_FIRST;
   }
@@ -222,8 +248,48 @@ oonf_duplicate_entry_add(struct oonf_duplicate_set *set, uint8_t msg_type,
       OONF_DUPSET_RESULT_STR[result]);
 
   if (oonf_duplicate_is_new(result)) {
-    /* reset validity timer */
-    oonf_timer_set(&entry->_vtime, vtime);
+    /* reset validity time */
+    entry->_expire = _get_expire(set, vtime);
+  }
+  return result;
+}
+
+/**
+ * Restore a duplicate set entry including its history bitmap,
+ * e.g. from a saved state. Existing entries are not changed.
+ * @param set duplicate set
+ * @param msg_type message type of the sequence number
+ * @param originator originator of sequence number
+ * @param seqno newest sequence number of the entry
+ * @param history bit buffer of the entry, bit 0 represents seqno
+ * @param vtime validity time of the entry
+ * @return OONF_DUPSET_FIRST if the entry was restored, otherwise
+ *   the result of a test of the sequence number against the set
+ */
+enum oonf_duplicate_result
+oonf_duplicate_entry_restore(struct oonf_duplicate_set *set, uint8_t msg_type,
+    struct netaddr *originator, uint64_t seqno, uint64_t history, uint64_t vtime) {
+  struct oonf_duplicate_entry *entry;
+  struct oonf_duplicate_entry_key key;
+  enum oonf_duplicate_result result;
+
+  /* generate combined key */
+  memset(&key, 0, sizeof(key));
+  memcpy(&key.addr, originator, sizeof(*originator));
+  key.msg_type = msg_type;
+
+  if (set->_used > 0) {
+    entry = _find_slot(set, &key, _hash_key(&key), false);
+    if (entry) {
+      /* never override sequence numbers received since startup */
+      return _test(set, entry, seqno, false);
+    }
+  }
+
+  result = oonf_duplicate_entry_add(set, msg_type, originator, seqno, vtime);
+  if (result == OONF_DUPSET_FIRST) {
+    entry = _find_slot(set, &key, _hash_key(&key), false);
+    entry->history |= history;
   }
   return result;
 }
@@ -234,7 +300,7 @@ oonf_duplicate_entry_add(struct oonf_duplicate_set *set, uint8_t msg_type,
  * @param msg_type message type with incoming sequence number
  * @param originator originator of sequence number
  * @param seqno sequence number
- * @return OONF_DUPSET_TOO_OLD if sequence number is more than 32 behind
+ * @return OONF_DUPSET_TOO_OLD if sequence number is more than 64 behind
  *   the current one, OONF_DUPSET_DUPLICATE if the number is in the set,
  *   OONF_DUPSET_NEW if the number was added to the set and OONF_DUPSET_NEWEST
  *   if the sequence number is newer than the newest in the set
@@ -251,10 +317,14 @@ oonf_duplicate_test(struct oonf_duplicate_set *set, uint8_t msg_type,
 #endif
 
   /* generate combined key */
+  memset(&key, 0, sizeof(key));
   memcpy(&key.addr, originator, sizeof(*originator));
   key.msg_type = msg_type;
 
-  entry = avl_find_element(&set->_tree, &key, entry, _node);
+  entry = NULL;
+  if (set->_used > 0) {
+    entry = _find_slot(set, &key, _hash_key(&key), false);
+  }
   if (!entry) {
     result = OONF_DUPSET_FIRST;
   }
@@ -269,6 +339,60 @@ oonf_duplicate_test(struct oonf_duplicate_set *set, uint8_t msg_type,
   return result;
 }
 
+/**
+ * Get the next entry of a duplicate set
+ * @param set duplicate set
+ * @param entry current duplicate entry, NULL to get the first one
+ * @return next duplicate entry, NULL if there are no more entries
+ */
+struct oonf_duplicate_entry *
+oonf_duplicate_entry_next(struct oonf_duplicate_set *set,
+    struct oonf_duplicate_entry *entry) {
+  uint32_t i;
+
+  i = entry == NULL ? 0 : (uint32_t)(entry - set->_entries) + 1;
+  for (; i<set->_size; i++) {
+    if (set->_entries[i]._state == _SLOT_USED) {
+      return &set->_entries[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Advance the duplicate set by one generation and remove all
+ * entries whose validity time has run out. This is called
+ * automatically every OONF_DUPSET_SWEEP_INTERVAL milliseconds.
+ * @param set duplicate set
+ */
+void
+oonf_duplicate_set_sweep(struct oonf_duplicate_set *set) {
+  struct oonf_duplicate_entry *entry;
+  uint32_t i;
+
+  set->_generation++;
+
+  for (i=0; i<set->_size && set->_used > 0; i++) {
+    entry = &set->_entries[i];
+    if (entry->_state == _SLOT_USED
+        && (int32_t)(entry->_expire - set->_generation) <= 0) {
+      entry->_state = _SLOT_DELETED;
+      set->_used--;
+      set->_deleted++;
+    }
+  }
+
+  if (set->_used == 0 && set->_deleted > 0) {
+    /* all entries are gone, drop tombstones without reallocation */
+    memset(set->_entries, 0, sizeof(*set->_entries) * set->_size);
+    set->_deleted = 0;
+  }
+  else if (set->_size > OONF_DUPSET_INITIAL_SIZE && set->_used * 8 < set->_size) {
+    /* shrink mostly empty tables */
+    _resize(set, set->_size / 2);
+  }
+}
+
 static int64_t
 _seqno_difference(struct oonf_duplicate_set *set, uint64_t seqno1, uint64_t seqno2) {
   uint64_t diff;
@@ -292,7 +416,7 @@ _seqno_difference(struct oonf_duplicate_set *set, uint64_t seqno1, uint64_t seqn
  * @param seqno sequence number
  * @param set true to add the sequence number to the entry, false
  *   to leave the entry unchanged.
- * @return OONF_DUPSET_TOO_OLD if sequence number is more than 32 behind
+ * @return OONF_DUPSET_TOO_OLD if sequence number is more than 64 behind
  *   the current one, OONF_DUPSET_DUPLICATE if the number is in the set,
  *   OONF_DUPSET_CURRENT if the number is exactly the current sequence number,
  *   OONF_DUPSET_ if the number was added to the set and OONF_DUPSET_NEWEST
@@ -310,27 +434,34 @@ _test(struct oonf_duplicate_set *dupset,
 
   /* eliminate rollover */
   diff = _seqno_difference(dupset, seqno, entry->current);
-  if (diff < -31) {
-    entry->too_old_count++;
-    if (entry->too_old_count > OONF_DUPSET_MAXIMUM_TOO_OLD) {
+  if (diff <= -OONF_DUPSET_HISTORY_WINDOW) {
+    if (entry->too_old_count >= OONF_DUPSET_MAXIMUM_TOO_OLD) {
       /*
        * we got a long continuous series of too old messages,
-       * most likely the did reset and changed its sequence number
+       * most likely the did reset and changed its sequence number.
+       * The reset is decided before counting, so a pure test
+       * reports the same result as the following add.
        */
-      entry->history = 1;
-      entry->too_old_count = 0;
-      entry->current = seqno;
-
+      if (set) {
+        entry->history = 1;
+        entry->too_old_count = 0;
+        entry->current = seqno;
+      }
       return OONF_DUPSET_NEWEST;
     }
+    if (set) {
+      entry->too_old_count++;
+    }
     return OONF_DUPSET_TOO_OLD;
   }
 
-  /* reset counter of too old messages */
-  entry->too_old_count = 0;
+  if (set) {
+    /* reset counter of too old messages */
+    entry->too_old_count = 0;
+  }
 
   if (diff <= 0) {
-    uint32_t bitmask = 1 << ((uint32_t) (-diff));
+    uint64_t bitmask = 1ull << ((uint64_t) (-diff));
 
     if ((entry->history & bitmask) != 0) {
       return OONF_DUPSET_DUPLICATE;
@@ -346,7 +477,7 @@ _test(struct oonf_duplicate_set *dupset,
     /* new sequence number is larger than last one */
     entry->current = seqno;
 
-    if (diff >= 32) {
+    if (diff >= OONF_DUPSET_HISTORY_WINDOW) {
       entry->history = 1;
     }
     else {
@@ -368,51 +499,138 @@ oonf_duplicate_get_result_str(enum oonf_duplicate_result result) {
 }
 
 /**
- * Comparator for duplicate entry keys
- * @param p1 key1
- * @param p2 key2
- * @return <0 if p1<p2, 0 if p1==p2, >0 if p1>p2
+ * Calculate hash value for duplicate entry key (FNV-1a)
+ * @param key duplicate entry key
+ * @return hash value
  */
-static int
-_avl_cmp_dupkey(const void *p1, const void *p2) {
-  const struct oonf_duplicate_entry_key *k1, *k2;
+static uint32_t
+_hash_key(const struct oonf_duplicate_entry_key *key) {
+  const uint8_t *ptr;
+  uint32_t hash;
+  size_t i;
 
-  k1 = p1;
-  k2 = p2;
+  hash = 2166136261u;
 
-  if (k1->msg_type != k2->msg_type) {
-    return (int)(k1->msg_type) - (int)(k2->msg_type);
+  hash = (hash ^ key->msg_type) * 16777619u;
+  hash = (hash ^ key->addr._type) * 16777619u;
+  hash = (hash ^ key->addr._prefix_len) * 16777619u;
+
+  ptr = key->addr._addr;
+  for (i=0; i<sizeof(key->addr._addr); i++) {
+    hash = (hash ^ ptr[i]) * 16777619u;
   }
+  return hash;
+}
 
-  return avl_comp_netaddr(&k1->addr, &k2->addr);
+/**
+ * Lookup the slot of a key in the hash table with linear probing
+ * @param set duplicate set
+ * @param key duplicate entry key
+ * @param hash hash value of key
+ * @param insert true to return the slot where the key can be
+ *   inserted if the key is not in the table
+ * @return pointer to slot, NULL if not found and insert was false
+ */
+static struct oonf_duplicate_entry *
+_find_slot(struct oonf_duplicate_set *set,
+    const struct oonf_duplicate_entry_key *key, uint32_t hash, bool insert) {
+  struct oonf_duplicate_entry *entry, *tombstone;
+  uint32_t i, mask;
+
+  tombstone = NULL;
+  mask = set->_size - 1;
+
+  for (i = hash & mask;; i = (i+1) & mask) {
+    entry = &set->_entries[i];
+
+    switch (entry->_state) {
+      case _SLOT_EMPTY:
+        if (!insert) {
+          return NULL;
+        }
+        return tombstone != NULL ? tombstone : entry;
+      case _SLOT_DELETED:
+        if (tombstone == NULL) {
+          tombstone = entry;
+        }
+        break;
+      default:
+        if (entry->_hash == hash
+            && entry->key.msg_type == key->msg_type
+            && netaddr_cmp(&entry->key.addr, &key->addr) == 0) {
+          return entry;
+        }
+        break;
+    }
+  }
 }
 
 /**
- * Callback fired when duplicate entry times out
- * @param ptr timer instance that fired
+ * Rebuild the hash table of a duplicate set with a new size.
+ * This also removes all tombstones.
+ * @param set duplicate set
+ * @param size new number of slots, must be a power of two
+ * @return -1 if an out of memory error happened, 0 otherwise
  */
-static void
-_cb_vtime(struct oonf_timer_instance *ptr) {
-  struct oonf_duplicate_entry *entry;
-#ifdef OONF_LOG_DEBUG_INFO
-  struct netaddr_str nbuf;
-#endif
+static int
+_resize(struct oonf_duplicate_set *set, uint32_t size) {
+  struct oonf_duplicate_entry *old, *entry;
+  uint32_t i, old_size;
+
+  if (size < OONF_DUPSET_INITIAL_SIZE) {
+    size = OONF_DUPSET_INITIAL_SIZE;
+  }
+
+  old = set->_entries;
+  old_size = set->_size;
 
-  entry = container_of(ptr, struct oonf_duplicate_entry, _vtime);
-  OONF_DEBUG(LOG_DUPLICATE_SET, "Duplicate entry timed out: %s/%u",
-      netaddr_to_string(&nbuf, &entry->key.addr), entry->key.msg_type);
+  set->_entries = calloc(size, sizeof(*set->_entries));
+  if (set->_entries == NULL) {
+    OONF_WARN(LOG_DUPLICATE_SET, "Out of memory error for %u duplicate set entries", size);
+    set->_entries = old;
+    return -1;
+  }
+  set->_size = size;
+  set->_deleted = 0;
 
-  _remove_duplicate_entry(entry);
+  for (i=0; i<old_size; i++) {
+    if (old[i]._state == _SLOT_USED) {
+      entry = _find_slot(set, &old[i].key, old[i]._hash, true);
+      memcpy(entry, &old[i], sizeof(*entry));
+    }
+  }
+
+  free(old);
+  return 0;
+}
+
+/**
+ * Calculate the sweep generation at which an entry expires
+ * @param set duplicate set
+ * @param vtime validity time of the entry in milliseconds
+ * @return expiry generation
+ */
+static uint32_t
+_get_expire(struct oonf_duplicate_set *set, uint64_t vtime) {
+  uint64_t ticks;
+
+  /* the current generation is already partly over, so add one */
+  ticks = (vtime + OONF_DUPSET_SWEEP_INTERVAL - 1) / OONF_DUPSET_SWEEP_INTERVAL + 1;
+  if (ticks > INT32_MAX) {
+    ticks = INT32_MAX;
+  }
+  return set->_generation + (uint32_t)ticks;
 }
 
 /**
- * Remove a duplicate entry
- * @param entry duplicate entry
+ * Callback fired to advance all duplicate sets by one generation
+ * @param ptr timer instance that fired
  */
 static void
-_remove_duplicate_entry(struct oonf_duplicate_entry *entry) {
-  oonf_timer_stop(&entry->_vtime);
-  avl_remove(&entry->set->_tree, &entry->_node);
+_cb_sweep(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct oonf_duplicate_set *set;
 
-  oonf_class_free(&_dupset_class, entry);
+  list_for_each_element(&_set_list, set, _node) {
+    oonf_duplicate_set_sweep(set);
+  }
 }
@@ -46,10 +46,9 @@
 #ifndef OONF_DUPLICATE_SET_H_
 #define OONF_DUPLICATE_SET_H_
 
-#include "common/avl.h"
 #include "common/common_types.h"
+#include "common/list.h"
 #include "common/netaddr.h"
-#include "subsystems/oonf_timer.h"
 
 /*! subsystem identifier */
 #define OONF_DUPSET_SUBSYSTEM "duplicate_set"
@@ -62,7 +61,16 @@ enum {
    * number of consecutive 'too old' sequence numbers before
    * algorithm resets
    */
-  OONF_DUPSET_MAXIMUM_TOO_OLD = 8
+  OONF_DUPSET_MAXIMUM_TOO_OLD = 8,
+
+  /*! number of sequence numbers tracked by the sliding history */
+  OONF_DUPSET_HISTORY_WINDOW = 64,
+
+  /*! initial number of slots of the hash table, must be a power of two */
+  OONF_DUPSET_INITIAL_SIZE = 16,
+
+  /*! interval between two expiry sweeps (one generation) in milliseconds */
+  OONF_DUPSET_SWEEP_INTERVAL = 1000,
 };
 
 /**
@@ -88,23 +96,6 @@ enum oonf_duplicate_result {
   OONF_DUPSET_FIRST,
 };
 
-/**
- * session data for detecting duplicate sequence numbers for addresses
- */
-struct oonf_duplicate_set {
-  /*! tree of duplicate entries */
-  struct avl_tree _tree;
-
-  /*! mask for detecting overflow */
-  int64_t _mask;
-
-  /*! comparison limit to detect overflow */
-  int64_t _limit;
-
-  /*! offset to fix overflow */
-  int64_t _offset;
-};
-
 /**
  * Unique key for duplicate entry
  */
@@ -117,29 +108,63 @@ struct oonf_duplicate_entry_key {
 };
 
 /**
- * State of duplicate detection for one unique key
+ * State of duplicate detection for one unique key.
+ * Entries are stored packed inside the hash table of the duplicate set,
+ * pointers to them are only valid until the next modification of the set.
  */
 struct oonf_duplicate_entry {
   /*! unique key for duplicate detection */
   struct oonf_duplicate_entry_key key;
 
+  /*! slot state of the entry inside the hash table */
+  uint8_t _state;
+
+  /*! number of too old consecutive sequence numbers without a newer one */
+  uint16_t too_old_count;
+
+  /*! cached hash value of the key */
+  uint32_t _hash;
+
+  /*! sweep generation at which the entry will be removed */
+  uint32_t _expire;
+
   /*! bit buffer for duplicate detection */
   uint64_t history;
 
   /*! newest received sequence number */
   uint64_t current;
+};
 
-  /*! number of too old consecutive sequence numbers without a newer one */
-  uint16_t too_old_count;
+/**
+ * session data for detecting duplicate sequence numbers for addresses
+ */
+struct oonf_duplicate_set {
+  /*! open addressing hash table of duplicate entries */
+  struct oonf_duplicate_entry *_entries;
+
+  /*! number of slots in hash table, always a power of two */
+  uint32_t _size;
+
+  /*! number of used slots in hash table */
+  uint32_t _used;
 
-  /*! back pointer to duplicate set */
-  struct oonf_duplicate_set *set;
+  /*! number of deleted slots (tombstones) in hash table */
+  uint32_t _deleted;
 
-  /*! node for tree of duplicate set */
-  struct avl_node _node;
+  /*! current sweep generation of the set */
+  uint32_t _generation;
 
-  /*! timer for removing outdated duplicate set data */
-  struct oonf_timer_instance _vtime;
+  /*! mask for detecting overflow */
+  int64_t _mask;
+
+  /*! comparison limit to detect overflow */
+  int64_t _limit;
+
+  /*! offset to fix overflow */
+  int64_t _offset;
+
+  /*! node for global list of duplicate sets */
+  struct list_entity _node;
 };
 
 /**
@@ -166,12 +191,38 @@ EXPORT enum oonf_duplicate_result oonf_duplicate_entry_add(
     struct oonf_duplicate_set *, uint8_t msg_type,
     struct netaddr *, uint64_t seqno, uint64_t vtime);
 
+EXPORT enum oonf_duplicate_result oonf_duplicate_entry_restore(
+    struct oonf_duplicate_set *, uint8_t msg_type,
+    struct netaddr *, uint64_t seqno, uint64_t history, uint64_t vtime);
+
 EXPORT enum oonf_duplicate_result oonf_duplicate_test(
     struct oonf_duplicate_set *, uint8_t msg_type,
     struct netaddr *, uint64_t seqno);
 
+EXPORT void oonf_duplicate_set_sweep(struct oonf_duplicate_set *);
+
+EXPORT struct oonf_duplicate_entry *oonf_duplicate_entry_next(
+    struct oonf_duplicate_set *, struct oonf_duplicate_entry *);
+
 EXPORT const char *oonf_duplicate_get_result_str(enum oonf_duplicate_result);
 
+/**
+ * Iterate over all entries of a duplicate set. The set must not be
+ * modified during the iteration.
+ * @param set duplicate set
+ * @param entry pointer to duplicate entry, used as iterator variable
+ */
+#define oonf_duplicate_for_each_entry(set, entry) for (entry = oonf_duplicate_entry_next(set, NULL); entry != NULL; entry = oonf_duplicate_entry_next(set, entry))
+
+/**
+ * @param set duplicate set
+ * @return number of entries stored in duplicate set
+ */
+static INLINE uint32_t
+oonf_duplicate_set_get_count(const struct oonf_duplicate_set *set) {
+  return set->_used;
+}
+
 /**
  * returns if a sequence number result means it is new
  * @param result sequence number processing result
@@ -184,4 +235,17 @@ oonf_duplicate_is_new(enum oonf_duplicate_result result) {
       || result == OONF_DUPSET_FIRST;
 }
 
+/**
+ * Too old sequence numbers are not reported as duplicates, because
+ * they must still be added to the set to detect a sequence number
+ * reset of the originator.
+ * @param result duplicate check result
+ * @return true if the sequence number has already been seen
+ */
+static INLINE bool
+oonf_duplicate_is_duplicate(enum oonf_duplicate_result result) {
+  return result == OONF_DUPSET_DUPLICATE
+      || result == OONF_DUPSET_CURRENT;
+}
+
 #endif /* OONF_DUPLICATE_SET_H_ */
@@ -0,0 +1,281 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "config/cfg_schema.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/os_clock.h"
+
+#include "subsystems/oonf_histogram.h"
+
+/* Definitions */
+#define LOG_HISTOGRAM _oonf_histogram_subsystem.logging
+
+/**
+ * Configuration of histogram subsystem
+ */
+struct _histogram_config {
+  /*! true if latency probes should measure */
+  bool enabled;
+};
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static void _cb_config_changed(void);
+
+/* configuration */
+static struct cfg_schema_entry _histogram_entries[] = {
+  CFG_MAP_BOOL(_histogram_config, enabled, "enabled", "false",
+      "Enables the latency probes. Each measured call reads the clock twice,"
+      " so probes should only be enabled while the histograms are in use."),
+};
+
+static struct cfg_schema_section _histogram_section = {
+  .type = OONF_HISTOGRAM_SUBSYSTEM,
+  .mode = CFG_SSMODE_UNNAMED,
+  .help = "Settings for the histogram instrumentation probes",
+  .cb_delta_handler = _cb_config_changed,
+  .entries = _histogram_entries,
+  .entry_count = ARRAYSIZE(_histogram_entries),
+};
+
+/* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_OS_CLOCK_SUBSYSTEM,
+};
+
+static struct oonf_subsystem _oonf_histogram_subsystem = {
+  .name = OONF_HISTOGRAM_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .init = _init,
+  .cleanup = _cleanup,
+  .cfg_section = &_histogram_section,
+};
+DECLARE_OONF_PLUGIN(_oonf_histogram_subsystem);
+
+/* tree of all registered histograms */
+static struct avl_tree _histogram_tree;
+
+/* true if latency measurements are enabled */
+static bool _enabled = false;
+
+/**
+ * Initialize histogram subsystem
+ * @return always returns 0
+ */
+static int
+_init(void) {
+  avl_init(&_histogram_tree, avl_comp_strcasecmp, false);
+  return 0;
+}
+
+/**
+ * Cleanup histogram subsystem
+ */
+static void
+_cleanup(void) {
+  struct oonf_histogram *h, *h_it;
+
+  avl_for_each_element_safe(&_histogram_tree, h, _node, h_it) {
+    oonf_histogram_remove(h);
+  }
+}
+
+/**
+ * Register a histogram so it is visible to the viewer plugins.
+ * Values can be recorded independent of the registration.
+ * @param h initialized histogram (name and unit must be set)
+ */
+void
+oonf_histogram_add(struct oonf_histogram *h) {
+  oonf_histogram_reset(h);
+  h->_enabled = _enabled;
+
+  h->_node.key = h->name;
+  if (avl_insert(&_histogram_tree, &h->_node)) {
+    OONF_WARN(LOG_HISTOGRAM, "Histogram '%s' registered twice", h->name);
+  }
+}
+
+/**
+ * Unregister a histogram
+ * @param h histogram
+ */
+void
+oonf_histogram_remove(struct oonf_histogram *h) {
+  if (avl_is_node_added(&h->_node)) {
+    avl_remove(&_histogram_tree, &h->_node);
+  }
+  h->_enabled = false;
+}
+
+/**
+ * Enable or disable the latency measurements of all registered
+ * histograms and all histograms registered later.
+ * Values recorded with oonf_histogram_record() are not affected.
+ * @param enabled true to enable measurements
+ */
+void
+oonf_histogram_set_enabled(bool enabled) {
+  struct oonf_histogram *h;
+
+  _enabled = enabled;
+  avl_for_each_element(&_histogram_tree, h, _node) {
+    h->_enabled = enabled;
+  }
+}
+
+/**
+ * Drop all recorded values of a histogram
+ * @param h histogram
+ */
+void
+oonf_histogram_reset(struct oonf_histogram *h) {
+  h->count = 0;
+  h->sum = 0;
+  h->min = 0;
+  h->max = 0;
+  memset(h->_buckets, 0, sizeof(h->_buckets));
+}
+
+/**
+ * Estimate a percentile of the recorded values
+ * @param h histogram
+ * @param percentile percentile (0-100)
+ * @return upper bound of the bucket containing the percentile,
+ *   clamped to the recorded minimum/maximum. 0 if histogram is empty.
+ */
+uint64_t
+oonf_histogram_get_percentile(struct oonf_histogram *h, unsigned percentile) {
+  uint64_t rank, sum, value;
+  unsigned i;
+
+  if (h->count == 0) {
+    return 0;
+  }
+  if (percentile >= 100) {
+    return h->max;
+  }
+
+  /* rank of the percentile value, rounded up */
+  rank = (h->count * percentile + 99) / 100;
+  if (rank == 0) {
+    return h->min;
+  }
+
+  sum = 0;
+  for (i=0; i<OONF_HISTOGRAM_BUCKETS; i++) {
+    sum += h->_buckets[i];
+    if (sum >= rank) {
+      value = oonf_histogram_get_bucket_max(i);
+      if (value > h->max) {
+        return h->max;
+      }
+      if (value < h->min) {
+        return h->min;
+      }
+      return value;
+    }
+  }
+  return h->max;
+}
+
+/**
+ * @param idx bucket index
+ * @return smallest value sorted into the bucket
+ */
+uint64_t
+oonf_histogram_get_bucket_min(unsigned idx) {
+  if (idx < OONF_HISTOGRAM_SUB_BUCKETS) {
+    return idx;
+  }
+  return (uint64_t)(OONF_HISTOGRAM_SUB_BUCKETS
+      + (idx & (OONF_HISTOGRAM_SUB_BUCKETS - 1)))
+      << (idx / OONF_HISTOGRAM_SUB_BUCKETS - 1);
+}
+
+/**
+ * @param idx bucket index
+ * @return largest value sorted into the bucket
+ */
+uint64_t
+oonf_histogram_get_bucket_max(unsigned idx) {
+  if (idx + 1 >= OONF_HISTOGRAM_BUCKETS) {
+    return UINT64_MAX;
+  }
+  return oonf_histogram_get_bucket_min(idx + 1) - 1;
+}
+
+/**
+ * @return tree of all registered histograms
+ */
+struct avl_tree *
+oonf_histogram_get_tree(void) {
+  return &_histogram_tree;
+}
+
+/**
+ * Callback for configuration changes
+ */
+static void
+_cb_config_changed(void) {
+  struct _histogram_config config;
+
+  if (cfg_schema_tobin(&config, _histogram_section.post,
+      _histogram_entries, ARRAYSIZE(_histogram_entries))) {
+    OONF_WARN(LOG_HISTOGRAM, "Cannot convert histogram configuration.");
+    return;
+  }
+
+  oonf_histogram_set_enabled(config.enabled);
+}
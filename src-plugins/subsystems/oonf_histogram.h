@@ -0,0 +1,186 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef OONF_HISTOGRAM_H_
+#define OONF_HISTOGRAM_H_
+
+#include "common/common_types.h"
+#include "common/avl.h"
+#include "subsystems/os_clock.h"
+
+/*! subsystem identifier */
+#define OONF_HISTOGRAM_SUBSYSTEM "histogram"
+
+/**
+ * histogram constants
+ */
+enum {
+  /*! number of linear sub-buckets per power of two (must be a power of two) */
+  OONF_HISTOGRAM_SUB_BUCKETS = 4,
+
+  /*! bit shift equivalent of OONF_HISTOGRAM_SUB_BUCKETS */
+  OONF_HISTOGRAM_SUB_BITS = 2,
+
+  /*! number of buckets necessary to cover the full 64 bit range */
+  OONF_HISTOGRAM_BUCKETS =
+      (64 - OONF_HISTOGRAM_SUB_BITS + 1) * OONF_HISTOGRAM_SUB_BUCKETS,
+};
+
+/**
+ * A single instrumentation probe. Values are sorted into logarithmic
+ * buckets with OONF_HISTOGRAM_SUB_BUCKETS linear steps per power of two,
+ * so every recorded value has a relative error of less than 25 percent
+ * while the memory footprint stays constant.
+ */
+struct oonf_histogram {
+  /*! name of the probe, used as key for the histogram tree */
+  const char *name;
+
+  /*! unit of the recorded values, "ns" for latency probes */
+  const char *unit;
+
+  /*! number of recorded values */
+  uint64_t count;
+
+  /*! sum of all recorded values */
+  uint64_t sum;
+
+  /*! smallest recorded value */
+  uint64_t min;
+
+  /*! largest recorded value */
+  uint64_t max;
+
+  /*! number of recorded values per bucket */
+  uint64_t _buckets[OONF_HISTOGRAM_BUCKETS];
+
+  /*! true if latency measurements are enabled, set by the subsystem */
+  bool _enabled;
+
+  /*! hook into global tree of histograms */
+  struct avl_node _node;
+};
+
+EXPORT void oonf_histogram_add(struct oonf_histogram *);
+EXPORT void oonf_histogram_remove(struct oonf_histogram *);
+EXPORT void oonf_histogram_reset(struct oonf_histogram *);
+EXPORT void oonf_histogram_set_enabled(bool enabled);
+EXPORT uint64_t oonf_histogram_get_percentile(
+    struct oonf_histogram *, unsigned percentile);
+EXPORT uint64_t oonf_histogram_get_bucket_min(unsigned idx);
+EXPORT uint64_t oonf_histogram_get_bucket_max(unsigned idx);
+
+EXPORT struct avl_tree *oonf_histogram_get_tree(void);
+
+/**
+ * Calculate the bucket index for a value
+ * @param value recorded value
+ * @return bucket index
+ */
+static INLINE unsigned
+oonf_histogram_get_bucket(uint64_t value) {
+  unsigned msb;
+
+  if (value < OONF_HISTOGRAM_SUB_BUCKETS) {
+    return value;
+  }
+
+  msb = 63 - __builtin_clzll(value);
+  return OONF_HISTOGRAM_SUB_BUCKETS * (msb - OONF_HISTOGRAM_SUB_BITS + 1)
+      + ((value >> (msb - OONF_HISTOGRAM_SUB_BITS))
+          & (OONF_HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * Record a value in a histogram
+ * @param h histogram
+ * @param value recorded value
+ */
+static INLINE void
+oonf_histogram_record(struct oonf_histogram *h, uint64_t value) {
+  if (h->count == 0 || value < h->min) {
+    h->min = value;
+  }
+  if (value > h->max) {
+    h->max = value;
+  }
+  h->count++;
+  h->sum += value;
+  h->_buckets[oonf_histogram_get_bucket(value)]++;
+}
+
+/**
+ * Get a monotonic nanosecond timestamp to start a latency measurement.
+ * The clock is only read if latency measurements are enabled.
+ * @param h latency histogram
+ * @return timestamp in nanoseconds, 0 if measurements are disabled
+ *   or clock could not be read
+ */
+static INLINE uint64_t
+oonf_histogram_start(const struct oonf_histogram *h) {
+  uint64_t now;
+
+  if (!h->_enabled || os_clock_gettime64_ns(&now)) {
+    return 0;
+  }
+  return now;
+}
+
+/**
+ * Record the time elapsed since a call to oonf_histogram_start()
+ * @param h latency histogram
+ * @param start timestamp of oonf_histogram_start()
+ */
+static INLINE void
+oonf_histogram_stop(struct oonf_histogram *h, uint64_t start) {
+  uint64_t now;
+
+  if (start == 0 || os_clock_gettime64_ns(&now) || now < start) {
+    return;
+  }
+  oonf_histogram_record(h, now - start);
+}
+
+#endif /* OONF_HISTOGRAM_H_ */
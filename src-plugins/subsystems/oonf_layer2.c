@@ -46,6 +46,8 @@
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "common/common_types.h"
+#include "common/hash.h"
+#include "common/hash_func.h"
 #include "common/netaddr.h"
 #include "config/cfg_schema.h"
 #include "core/oonf_subsystem.h"
@@ -219,12 +221,16 @@ oonf_layer2_net_add(const char *ifname) {
   l2net->_node.key = l2net->name;
   avl_insert(&_oonf_layer2_net_tree, &l2net->_node);
 
-  /* initialize tree of neighbors and proxies */
+  /* initialize tree and hash index of neighbors */
   avl_init(&l2net->neighbors, avl_comp_netaddr, false);
+  hash_init(&l2net->_neigh_index, hash_func_netaddr, avl_comp_netaddr);
 
   /* initialize interface listener */
   l2net->if_listener.name = l2net->name;
-  os_interface_add(&l2net->if_listener);
+  if (os_interface_add(&l2net->if_listener)) {
+    /* remember layer2 network in interface */
+    l2net->if_listener.data->l2net = l2net;
+  }
 
   oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_ADDED);
 
@@ -350,13 +356,38 @@ oonf_layer2_neigh_add(struct oonf_layer2_net *l2net,
 
   avl_insert(&l2net->neighbors, &l2neigh->_node);
 
+  /* if the index has no memory the neighbor is still found by the tree */
+  l2neigh->_index_node.key = &l2neigh->addr;
+  hash_insert(&l2net->_neigh_index, &l2neigh->_index_node);
+
   avl_init(&l2neigh->destinations, avl_comp_netaddr, false);
+  hash_init(&l2neigh->_dst_index, hash_func_netaddr, avl_comp_netaddr);
 
   oonf_class_event(&_l2neighbor_class, l2neigh, OONF_OBJECT_ADDED);
 
   return l2neigh;
 }
 
+/**
+ * Get a layer-2 neighbor object from the database
+ * @param l2net layer-2 addr object
+ * @param addr remote mac address of neighbor
+ * @return layer-2 neighbor object, NULL if not found
+ */
+struct oonf_layer2_neigh *
+oonf_layer2_neigh_get(const struct oonf_layer2_net *l2net,
+    const struct netaddr *addr) {
+  struct oonf_layer2_neigh *l2neigh;
+
+  l2neigh = hash_find_element(&l2net->_neigh_index, addr, l2neigh, _index_node);
+  if (l2neigh || l2net->_neigh_index.count == l2net->neighbors.count) {
+    return l2neigh;
+  }
+
+  /* some neighbors are not indexed because the index ran out of memory */
+  return avl_find_element(&l2net->neighbors, addr, l2neigh, _node);
+}
+
 /**
  * Remove all data objects of a certain originator from a layer-2 neighbor
  * object.
@@ -435,6 +466,26 @@ oonf_layer2_neigh_commit(struct oonf_layer2_neigh *l2neigh) {
   return true;
 }
 
+/**
+ * Get a layer-2 destination object of a neighbor from the database
+ * @param l2neigh layer-2 neighbor
+ * @param destination mac address of destination
+ * @return layer-2 destination object, NULL if not found
+ */
+struct oonf_layer2_destination *
+oonf_layer2_destination_get(const struct oonf_layer2_neigh *l2neigh,
+    const struct netaddr *destination) {
+  struct oonf_layer2_destination *l2dst;
+
+  l2dst = hash_find_element(&l2neigh->_dst_index, destination, l2dst, _index_node);
+  if (l2dst || l2neigh->_dst_index.count == l2neigh->destinations.count) {
+    return l2dst;
+  }
+
+  /* some destinations are not indexed because the index ran out of memory */
+  return avl_find_element(&l2neigh->destinations, destination, l2dst, _node);
+}
+
 /**
  * add a layer2 destination (a MAC address behind a neighbor) to
  * the layer2 database
@@ -469,6 +520,10 @@ oonf_layer2_destination_add(struct oonf_layer2_neigh *l2neigh,
   l2dst->_node.key = &l2dst->destination;
   avl_insert(&l2neigh->destinations, &l2dst->_node);
 
+  /* if the index has no memory the destination is still found by the tree */
+  l2dst->_index_node.key = &l2dst->destination;
+  hash_insert(&l2neigh->_dst_index, &l2dst->_index_node);
+
   oonf_class_event(&_l2dst_class, l2dst, OONF_OBJECT_ADDED);
   return l2dst;
 }
@@ -485,6 +540,7 @@ oonf_layer2_destination_remove(struct oonf_layer2_destination *l2dst) {
   oonf_class_event(&_l2dst_class, l2dst, OONF_OBJECT_REMOVED);
 
   avl_remove(&l2dst->neighbor->destinations, &l2dst->_node);
+  hash_remove(&l2dst->neighbor->_dst_index, &l2dst->_index_node);
   oonf_class_free(&_l2dst_class, l2dst);
 }
 
@@ -525,6 +581,44 @@ oonf_layer2_neigh_query(const char *ifname,
   return NULL;
 }
 
+/**
+ * Get neighbor specific data, either from neighbor or from the networks default.
+ * Uses the cached layer2 network pointer of the interface.
+ * @param os_if operation system interface
+ * @param l2neigh_addr neighbor mac address
+ * @param idx data index
+ * @return pointer to linklayer data, NULL if no value available
+ */
+const struct oonf_layer2_data *
+oonf_layer2_neigh_query_if(const struct os_interface *os_if,
+    const struct netaddr *l2neigh_addr, enum oonf_layer2_neighbor_index idx) {
+  struct oonf_layer2_net *l2net;
+  struct oonf_layer2_neigh *l2neigh;
+  struct oonf_layer2_data *data;
+
+  /* query layer2 database about neighbor */
+  l2net = oonf_layer2_net_get_by_interface(os_if);
+  if (l2net == NULL) {
+    return NULL;
+  }
+
+  /* look for neighbor specific data */
+  l2neigh = oonf_layer2_neigh_get(l2net, l2neigh_addr);
+  if (l2neigh != NULL) {
+    data = &l2neigh->data[idx];
+    if (oonf_layer2_has_value(data)) {
+      return data;
+    }
+  }
+
+  /* look for network specific default */
+  data = &l2net->neighdata[idx];
+  if (oonf_layer2_has_value(data)) {
+    return data;
+  }
+  return NULL;
+}
+
 /**
  * Get neighbor specific data, either from neighbor or from the networks default
  * @param l2neigh pointer to layer2 neighbor
@@ -628,10 +722,14 @@ _net_remove(struct oonf_layer2_net *l2net) {
   oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_REMOVED);
 
   /* remove interface listener */
+  if (l2net->if_listener.data) {
+    l2net->if_listener.data->l2net = NULL;
+  }
   os_interface_remove(&l2net->if_listener);
 
   /* free addr */
   avl_remove(&_oonf_layer2_net_tree, &l2net->_node);
+  hash_free(&l2net->_neigh_index);
   oonf_class_free(&_l2network_class, l2net);
 }
 
@@ -653,5 +751,7 @@ _neigh_remove(struct oonf_layer2_neigh *l2neigh) {
 
   /* free resources for mac entry */
   avl_remove(&l2neigh->network->neighbors, &l2neigh->_node);
+  hash_remove(&l2neigh->network->_neigh_index, &l2neigh->_index_node);
+  hash_free(&l2neigh->_dst_index);
   oonf_class_free(&_l2neighbor_class, l2neigh);
 }
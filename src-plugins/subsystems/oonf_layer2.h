@@ -48,6 +48,7 @@
 
 #include "common/avl.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/os_interface.h"
 
@@ -217,6 +218,9 @@ struct oonf_layer2_net {
 
   /*! node to hook into global l2network tree */
   struct avl_node _node;
+
+  /*! hash index of remote neighbors by MAC address */
+  struct hash_table _neigh_index;
 };
 
 /**
@@ -240,6 +244,12 @@ struct oonf_layer2_neigh {
 
   /*! node to hook into tree of layer2 network */
   struct avl_node _node;
+
+  /*! hash index of proxied destinations by MAC address */
+  struct hash_table _dst_index;
+
+  /*! node to hook into neighbor hash index of layer2 network */
+  struct hash_node _index_node;
 };
 
 /**
@@ -257,6 +267,9 @@ struct oonf_layer2_destination {
 
   /*! node to hook into tree of layer2 neighbor */
   struct avl_node _node;
+
+  /*! node to hook into destination hash index of layer2 neighbor */
+  struct hash_node _index_node;
 };
 
 /**
@@ -285,6 +298,8 @@ EXPORT bool oonf_layer2_net_remove(
 EXPORT bool oonf_layer2_net_cleanup(struct oonf_layer2_net *l2net, uint32_t origin);
 EXPORT bool oonf_layer2_net_commit(struct oonf_layer2_net *);
 
+EXPORT struct oonf_layer2_neigh *oonf_layer2_neigh_get(
+    const struct oonf_layer2_net *l2net, const struct netaddr *addr);
 EXPORT struct oonf_layer2_neigh *oonf_layer2_neigh_add(
     struct oonf_layer2_net *, struct netaddr *l2neigh);
 EXPORT bool oonf_layer2_neigh_cleanup(struct oonf_layer2_neigh *l2neigh, uint32_t origin);
@@ -293,6 +308,8 @@ EXPORT bool oonf_layer2_neigh_remove(
 
 EXPORT bool oonf_layer2_neigh_commit(struct oonf_layer2_neigh *l2neigh);
 
+EXPORT struct oonf_layer2_destination *oonf_layer2_destination_get(
+    const struct oonf_layer2_neigh *l2neigh, const struct netaddr *destination);
 EXPORT struct oonf_layer2_destination *oonf_layer2_destination_add(
     struct oonf_layer2_neigh *l2neigh, const struct netaddr *destination,
     uint32_t origin);
@@ -301,6 +318,9 @@ EXPORT void oonf_layer2_destination_remove(struct oonf_layer2_destination *);
 EXPORT const struct oonf_layer2_data *oonf_layer2_neigh_query(
     const char *ifname, const struct netaddr *l2neigh,
     enum oonf_layer2_neighbor_index idx);
+EXPORT const struct oonf_layer2_data *oonf_layer2_neigh_query_if(
+    const struct os_interface *os_if, const struct netaddr *l2neigh,
+    enum oonf_layer2_neighbor_index idx);
 EXPORT const struct oonf_layer2_data *oonf_layer2_neigh_get_value(
     const struct oonf_layer2_neigh *l2neigh, enum oonf_layer2_neighbor_index idx);
 
@@ -326,23 +346,17 @@ oonf_layer2_net_get(const char *ifname) {
 }
 
 /**
- * Get a layer-2 neighbor object from the database
- * @param l2net layer-2 addr object
- * @param addr remote mac address of neighbor
- * @return layer-2 neighbor object, NULL if not found
+ * Get the layer-2 interface object of an operation system interface.
+ * Uses the cached pointer of the interface if available.
+ * @param os_if operation system interface
+ * @return layer-2 addr object, NULL if not found
  */
-static INLINE struct oonf_layer2_neigh *
-oonf_layer2_neigh_get(const struct oonf_layer2_net *l2net,
-    const struct netaddr *addr) {
-  struct oonf_layer2_neigh *l2neigh;
-  return avl_find_element(&l2net->neighbors, addr, l2neigh, _node);
-}
-
-static INLINE struct oonf_layer2_destination *
-oonf_layer2_destination_get(const struct oonf_layer2_neigh *l2neigh,
-    const struct netaddr *destination) {
-  struct oonf_layer2_destination *l2dst;
-  return avl_find_element(&l2neigh->destinations, destination, l2dst, _node);
+static INLINE struct oonf_layer2_net *
+oonf_layer2_net_get_by_interface(const struct os_interface *os_if) {
+  if (os_if->l2net) {
+    return os_if->l2net;
+  }
+  return oonf_layer2_net_get(os_if->name);
 }
 
 /**
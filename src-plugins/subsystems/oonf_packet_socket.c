@@ -52,6 +52,7 @@
 #include "common/netaddr_acl.h"
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/os_interface.h"
 #include "subsystems/oonf_socket.h"
 #include "subsystems/os_fd.h"
@@ -82,6 +83,7 @@ static int _cb_interface_listener(struct os_interface_listener *l);
 
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
   OONF_SOCKET_SUBSYSTEM,
   OONF_OS_FD_SUBSYSTEM,
@@ -100,6 +102,18 @@ DECLARE_OONF_PLUGIN(_oonf_packet_socket_subsystem);
 static struct list_entity _packet_sockets = { NULL, NULL };
 static char _input_buffer[65536];
 
+/* processing time of an incoming packet by the socket user */
+static struct oonf_histogram _histogram_rx = {
+  .name = "packet_rx",
+  .unit = "ns",
+};
+
+/* time necessary to hand an outgoing packet to the kernel */
+static struct oonf_histogram _histogram_tx = {
+  .name = "packet_tx",
+  .unit = "ns",
+};
+
 /**
  * Initialize packet socket handler
  * @return always returns 0
@@ -107,6 +121,9 @@ static char _input_buffer[65536];
 static int
 _init(void) {
   list_init_head(&_packet_sockets);
+
+  oonf_histogram_add(&_histogram_rx);
+  oonf_histogram_add(&_histogram_tx);
   return 0;
 }
 
@@ -122,6 +139,9 @@ _cleanup(void) {
 
     oonf_packet_remove(skt, true);
   }
+
+  oonf_histogram_remove(&_histogram_tx);
+  oonf_histogram_remove(&_histogram_rx);
 }
 
 /**
@@ -173,6 +193,7 @@ static void
 _packet_add(struct oonf_packet_socket *pktsocket,
     union netaddr_socket *local, struct os_interface *interf) {
   pktsocket->os_if = interf;
+  pktsocket->scheduler_entry.name = interf != NULL ? interf->name : "packet";
   pktsocket->scheduler_entry.process = _cb_packet_event_unicast;
 
   oonf_socket_add(&pktsocket->scheduler_entry);
@@ -220,12 +241,15 @@ int
 oonf_packet_send(struct oonf_packet_socket *pktsocket, union netaddr_socket *remote,
     const void *data, size_t length) {
   int result;
+  uint64_t start;
   struct netaddr_str buf;
 
   if (abuf_getlen(&pktsocket->out) == 0) {
     /* no backlog of outgoing packets, try to send directly */
+    start = oonf_histogram_start(&_histogram_tx);
     result = os_fd_sendto(&pktsocket->scheduler_entry.fd, data, length, remote,
         pktsocket->config.dont_route);
+    oonf_histogram_stop(&_histogram_tx, start);
     if (result > 0) {
       /* successful */
       OONF_DEBUG(LOG_PACKET, "Sent %d bytes to %s %s",
@@ -717,6 +741,7 @@ _cb_packet_event(struct oonf_socket_entry *entry,
   uint16_t length;
   char *pkt;
   ssize_t result;
+  uint64_t start;
   struct netaddr_str netbuf;
 
 #ifdef OONF_LOG_DEBUG_INFO
@@ -760,7 +785,9 @@ _cb_packet_event(struct oonf_socket_entry *entry,
       OONF_DEBUG(LOG_PACKET, "Received %"PRINTF_SSIZE_T_SPECIFIER" bytes from %s %s (%s)",
           result, netaddr_socket_to_string(&netbuf, &sock),
           interf, multicast ? "multicast" : "unicast");
+      start = oonf_histogram_start(&_histogram_rx);
       pktsocket->config.receive_data(pktsocket, &sock, buf, result);
+      oonf_histogram_stop(&_histogram_rx, start);
     }
     else if (result < 0 && (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
       OONF_WARN(LOG_PACKET, "Cannot read packet from socket %s: %s (%d)",
@@ -781,7 +808,9 @@ _cb_packet_event(struct oonf_socket_entry *entry,
     pkt += 2;
 
     /* try to send packet */
+    start = oonf_histogram_start(&_histogram_tx);
     result = os_fd_sendto(&entry->fd, pkt, length, &sock, pktsocket->config.dont_route);
+    oonf_histogram_stop(&_histogram_tx, start);
     if (result < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
       /* try again later */
       OONF_DEBUG(LOG_PACKET, "Sending to %s %s could block, try again later",
@@ -57,6 +57,7 @@
 #include "core/os_core.h"
 #include "subsystems/oonf_class.h"
 #include "subsystems/oonf_duplicate_set.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/oonf_packet_socket.h"
 #include "subsystems/oonf_timer.h"
 
@@ -80,6 +81,9 @@ struct _rfc5444_config {
    * RFC5444 messages on the same target
    */
   uint64_t aggregation_interval;
+
+  /*! algorithm used to split addresses into address blocks */
+  int addr_compression;
 };
 
 /* prototypes */
@@ -98,6 +102,7 @@ static void _cb_send_multicast_packet(
     struct rfc5444_writer *, struct rfc5444_writer_target *, void *, size_t);
 static void _cb_forward_message(struct rfc5444_reader_tlvblock_context *context,
     uint8_t *buffer, size_t length);
+static bool _cb_drop_duplicate_message(struct rfc5444_reader_tlvblock_context *context);
 static void _cb_forwarding_notifier(struct rfc5444_writer_target *);
 
 static bool _cb_single_target_selector(struct rfc5444_writer *, struct rfc5444_writer_target *, void *);
@@ -166,6 +171,12 @@ static struct oonf_timer_class _aggregation_timer = {
   .callback = _cb_aggregation_event,
 };
 
+/* names of address compression algorithms */
+static const char *_ADDR_COMPRESSION[] = {
+  [RFC5444_ADDR_COMPRESSION_SESSION]      = "session",
+  [RFC5444_ADDR_COMPRESSION_SORTED_RUNS]  = "sorted_runs",
+};
+
 /* configuration settings for handler */
 static struct cfg_schema_entry _rfc5444_entries[] = {
   CFG_MAP_INT32_MINMAX(_rfc5444_config, port, "port", RFC5444_MANET_UDP_PORT_TXT,
@@ -174,6 +185,9 @@ static struct cfg_schema_entry _rfc5444_entries[] = {
     "IP protocol for RFC5444 interface", 0, false, 1, 255),
   CFG_MAP_CLOCK(_rfc5444_config, aggregation_interval, "agregation_interval", "0.100",
     "Interval in seconds for message aggregation"),
+  CFG_MAP_CHOICE(_rfc5444_config, addr_compression, "addr_compression", "session",
+    "Algorithm to split addresses into address blocks, 'sorted_runs' sorts the"
+    " addresses and calculates the smallest encoding", _ADDR_COMPRESSION),
 };
 
 static struct cfg_schema_section _rfc5444_section = {
@@ -210,10 +224,12 @@ static struct cfg_schema_section _interface_section = {
 };
 
 static uint64_t _aggregation_interval;
+static enum rfc5444_addr_compression _addr_compression;
 
 /* rfc5444 handling */
 static const struct rfc5444_reader _reader_template = {
   .forward_message = _cb_forward_message,
+  .drop_message = _cb_drop_duplicate_message,
   .malloc_addrblock_entry = _alloc_addrblock_entry,
   .malloc_tlvblock_entry = _alloc_tlvblock_entry,
   .free_addrblock_entry = _free_addrblock_entry,
@@ -262,6 +278,7 @@ static const struct const_strarray _unicast_bindto_acl_value =
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
   OONF_DUPSET_SUBSYSTEM,
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_PACKET_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
 };
@@ -279,6 +296,24 @@ DECLARE_OONF_PLUGIN(_oonf_rfc5444_subsystem);
 /* static blocking of RFC5444 output */
 static bool _block_output = false;
 
+/* parsing time of an incoming packet */
+static struct oonf_histogram _histogram_parse = {
+  .name = "rfc5444_parse",
+  .unit = "ns",
+};
+
+/* generation time of an outgoing message */
+static struct oonf_histogram _histogram_generate = {
+  .name = "rfc5444_generate",
+  .unit = "ns",
+};
+
+/* time to assemble and send the aggregated packet of a target */
+static struct oonf_histogram _histogram_flush = {
+  .name = "rfc5444_flush",
+  .unit = "ns",
+};
+
 /* additional logging targets */
 enum oonf_log_source LOG_RFC5444_R, LOG_RFC5444_W;
 
@@ -326,6 +361,10 @@ _init(void) {
 
   LOG_RFC5444_R = oonf_log_register_source(OONF_RFC5444_SUBSYSTEM "_r");
   LOG_RFC5444_W = oonf_log_register_source(OONF_RFC5444_SUBSYSTEM "_w");
+
+  oonf_histogram_add(&_histogram_parse);
+  oonf_histogram_add(&_histogram_generate);
+  oonf_histogram_add(&_histogram_flush);
   return 0;
 }
 
@@ -372,6 +411,10 @@ _cleanup(void) {
   oonf_class_remove(&_addrblock_memcookie);
   oonf_class_remove(&_address_memcookie);
   oonf_class_remove(&_addrtlv_memcookie);
+
+  oonf_histogram_remove(&_histogram_flush);
+  oonf_histogram_remove(&_histogram_generate);
+  oonf_histogram_remove(&_histogram_parse);
   return;
 }
 
@@ -383,6 +426,8 @@ _cleanup(void) {
  */
 enum rfc5444_result oonf_rfc5444_send_if(
     struct oonf_rfc5444_target *target, uint8_t msgid) {
+  enum rfc5444_result result;
+  uint64_t start;
   uint8_t addr_len;
 
   #ifdef OONF_LOG_INFO
@@ -405,8 +450,52 @@ enum rfc5444_result oonf_rfc5444_send_if(
       target->interface->name);
 
   addr_len = netaddr_get_address_family(&target->dst) == AF_INET ? 4 : 16;
-  return rfc5444_writer_create_message(&target->interface->protocol->writer,
+
+  start = oonf_histogram_start(&_histogram_generate);
+  result = rfc5444_writer_create_message(&target->interface->protocol->writer,
       msgid, addr_len, _cb_single_target_selector, target);
+  oonf_histogram_stop(&_histogram_generate, start);
+  return result;
+}
+
+/**
+ * Add a message that has been generated before (and stored by the
+ * cacheMessage callback of the message creator) to a specific interface
+ * @param target interface for outgoing message
+ * @param msgid id of message
+ * @param data pointer to binary message
+ * @param len length of binary message
+ * @return return code of rfc5444 writer
+ */
+enum rfc5444_result
+oonf_rfc5444_send_if_cached(struct oonf_rfc5444_target *target, uint8_t msgid,
+    const uint8_t *data, size_t len) {
+  enum rfc5444_result result;
+  uint64_t start;
+
+#ifdef OONF_LOG_INFO
+  struct netaddr_str buf;
+#endif
+
+  /* check if socket can send data */
+  if (!oonf_rfc5444_is_target_active(target)) {
+    return RFC5444_OKAY;
+  }
+
+  if (!oonf_timer_is_active(&target->_aggregation)) {
+    /* activate aggregation timer */
+    oonf_timer_start(&target->_aggregation, _aggregation_interval);
+  }
+
+  OONF_INFO(LOG_RFC5444, "Add cached message id %d for protocol %s/target %s on interface %s",
+      msgid, target->interface->protocol->name, netaddr_to_string(&buf, &target->dst),
+      target->interface->name);
+
+  start = oonf_histogram_start(&_histogram_generate);
+  result = rfc5444_writer_add_cached_message(&target->interface->protocol->writer,
+      msgid, _cb_single_target_selector, target, data, len);
+  oonf_histogram_stop(&_histogram_generate, start);
+  return result;
 }
 
 /**
@@ -420,11 +509,17 @@ enum rfc5444_result oonf_rfc5444_send_if(
 enum rfc5444_result
 oonf_rfc5444_send_all(struct oonf_rfc5444_protocol *protocol,
     uint8_t msgid, uint8_t addr_len, rfc5444_writer_targetselector useIf) {
+  enum rfc5444_result result;
+  uint64_t start;
+
   /* create message */
   OONF_INFO(LOG_RFC5444, "Create message id %d", msgid);
 
-  return rfc5444_writer_create_message(&protocol->writer,
+  start = oonf_histogram_start(&_histogram_generate);
+  result = rfc5444_writer_create_message(&protocol->writer,
       msgid, addr_len, _cb_filtered_targets_selector, useIf);
+  oonf_histogram_stop(&_histogram_generate, start);
+  return result;
 }
 
 /**
@@ -458,6 +553,7 @@ oonf_rfc5444_add_protocol(const char *name, bool fixed_local_port) {
     memcpy(&protocol->writer, &_writer_template, sizeof(_writer_template));
     protocol->writer.msg_buffer = protocol->_msg_buffer;
     protocol->writer.addrtlv_buffer = protocol->_addrtlv_buffer;
+    protocol->writer.addr_compression = _addr_compression;
     rfc5444_reader_init(&protocol->reader);
     rfc5444_writer_init(&protocol->writer);
 
@@ -770,6 +866,10 @@ oonf_rfc5444_reconfigure_interface(struct oonf_rfc5444_interface *interf,
       old = NULL;
     }
     else {
+      if (old) {
+        /* keep the packet sequence number running */
+        target->_pktseqno = old->_pktseqno;
+      }
       interf->multicast4 = target;
     }
   }
@@ -794,6 +894,10 @@ oonf_rfc5444_reconfigure_interface(struct oonf_rfc5444_interface *interf,
       old = NULL;
     }
     else {
+      if (old) {
+        /* keep the packet sequence number running */
+        target->_pktseqno = old->_pktseqno;
+      }
       interf->multicast6 = target;
     }
   }
@@ -1027,6 +1131,7 @@ _cb_receive_data(struct oonf_packet_socket *sock,
   enum rfc5444_result result;
   struct netaddr source_ip;
   struct netaddr_str buf;
+  uint64_t start;
 
   interf = sock->config.user;
   protocol = interf->protocol;
@@ -1056,8 +1161,10 @@ _cb_receive_data(struct oonf_packet_socket *sock,
       "Incoming RFC5444 packet from",
       "Error while parsing incoming RFC5444 packet from");
 
+  start = oonf_histogram_start(&_histogram_parse);
   result = rfc5444_reader_handle_packet(
       &protocol->reader, ptr, length);
+  oonf_histogram_stop(&_histogram_parse, start);
   if (result < 0) {
     OONF_WARN(LOG_RFC5444, "Error while parsing incoming packet from %s: %s (%d)",
         netaddr_socket_to_string(&buf, from), rfc5444_strerror(result), result);
@@ -1159,6 +1266,47 @@ _cb_forward_message(
   }
 }
 
+/**
+ * Drop messages early that have already been processed and forwarded.
+ * Copies of flooded messages arriving through multiple interfaces
+ * do not need to be parsed (or have their signatures checked) again,
+ * the processed/forwarded sets would drop them anyway.
+ * @param context RFC5444 message context, only header is valid
+ * @return true if message is a known duplicate
+ */
+static bool
+_cb_drop_duplicate_message(struct rfc5444_reader_tlvblock_context *context) {
+  struct oonf_rfc5444_protocol *protocol;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  if (!context->has_origaddr || !context->has_seqno) {
+    return false;
+  }
+
+  protocol = container_of(context->reader, struct oonf_rfc5444_protocol, reader);
+
+  /*
+   * only test, the sets are only updated by the protocol after full validation.
+   * Too old messages are passed on, the protocol has to add them to the
+   * sets to detect a sequence number reset of the originator.
+   */
+  if (!oonf_duplicate_is_duplicate(oonf_duplicate_test(&protocol->processed_set,
+      context->msg_type, &context->orig_addr, context->seqno))) {
+    return false;
+  }
+  if (!oonf_duplicate_is_duplicate(oonf_duplicate_test(&protocol->forwarded_set,
+      context->msg_type, &context->orig_addr, context->seqno))) {
+    return false;
+  }
+
+  OONF_DEBUG(LOG_RFC5444_R, "Drop duplicate message type %u from %s with seqno %u",
+      context->msg_type, netaddr_to_string(&nbuf, &context->orig_addr),
+      context->seqno);
+  return true;
+}
+
 static void
 _cb_forwarding_notifier(struct rfc5444_writer_target *rfc5444target) {
   struct oonf_rfc5444_target *target;
@@ -1329,10 +1477,14 @@ static void
 _cb_aggregation_event (struct oonf_timer_instance *ptr) {
   struct oonf_rfc5444_target *target;
 
+  uint64_t start;
+
   target = container_of(ptr, struct oonf_rfc5444_target, _aggregation);
 
+  start = oonf_histogram_start(&_histogram_flush);
   rfc5444_writer_flush(
       &target->interface->protocol->writer, &target->rfc5444_target, false);
+  oonf_histogram_stop(&_histogram_flush, start);
 }
 
 /**
@@ -1341,6 +1493,7 @@ _cb_aggregation_event (struct oonf_timer_instance *ptr) {
 static void
 _cb_cfg_rfc5444_changed(void) {
   struct _rfc5444_config config;
+  struct oonf_rfc5444_protocol *protocol;
   int result;
 
   memset(&config, 0, sizeof(config));
@@ -1357,6 +1510,11 @@ _cb_cfg_rfc5444_changed(void) {
   oonf_rfc5444_reconfigure_protocol(_rfc5444_protocol,
       config.port, config.ip_proto);
   _aggregation_interval = config.aggregation_interval;
+
+  _addr_compression = config.addr_compression;
+  avl_for_each_element(&_protocol_tree, protocol, _node) {
+    protocol->writer.addr_compression = _addr_compression;
+  }
 }
 
 /**
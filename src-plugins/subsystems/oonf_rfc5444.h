@@ -278,6 +278,9 @@ EXPORT const union netaddr_socket *oonf_rfc5444_target_get_local_socket(
 
 EXPORT enum rfc5444_result oonf_rfc5444_send_if(
     struct oonf_rfc5444_target *, uint8_t msgid);
+EXPORT enum rfc5444_result oonf_rfc5444_send_if_cached(
+    struct oonf_rfc5444_target *, uint8_t msgid,
+    const uint8_t *data, size_t len);
 EXPORT enum rfc5444_result oonf_rfc5444_send_all(
     struct oonf_rfc5444_protocol *protocol,
     uint8_t msgid, uint8_t addr_len, rfc5444_writer_targetselector useIf);
@@ -407,6 +410,37 @@ oonf_rfc5444_get_last_packet_seqno(struct oonf_rfc5444_target *target) {
   return target->_pktseqno;
 }
 
+/**
+ * Overwrite the last used packet sequence number of a target,
+ * used to continue the sequence of an earlier run of the router.
+ * @param target pointer to rfc5444 target instance
+ * @param seqno packet sequence number
+ */
+static INLINE void
+oonf_rfc5444_set_last_packet_seqno(struct oonf_rfc5444_target *target, uint16_t seqno) {
+  target->_pktseqno = seqno;
+}
+
+/**
+ * @param protocol pointer to rfc5444 protocol instance
+ * @return last used message sequence number of a protocol
+ */
+static INLINE uint16_t
+oonf_rfc5444_get_last_message_seqno(struct oonf_rfc5444_protocol *protocol) {
+  return protocol->_msg_seqno;
+}
+
+/**
+ * Overwrite the last used message sequence number of a protocol,
+ * used to continue the sequence of an earlier run of the router.
+ * @param protocol pointer to rfc5444 protocol instance
+ * @param seqno message sequence number
+ */
+static INLINE void
+oonf_rfc5444_set_last_message_seqno(struct oonf_rfc5444_protocol *protocol, uint16_t seqno) {
+  protocol->_msg_seqno = seqno;
+}
+
 /**
  * Generates a new message sequence number for a protocol.
  * @param protocol pointer to rfc5444 protocol instance
@@ -55,6 +55,7 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_main.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/oonf_timer.h"
 #include "subsystems/os_fd.h"
 #include "subsystems/os_clock.h"
@@ -77,11 +78,27 @@ static uint64_t _scheduler_time_limit;
 /* List of all active sockets in scheduler */
 static struct list_entity _socket_head;
 
+/* socket whose callback is currently running, NULL if it has been removed */
+static struct oonf_socket_entry *_socket_in_callback;
+
 /* socket event scheduler */
 struct os_fd_select _socket_events;
 
+/* number of socket events returned by a single wait call */
+static struct oonf_histogram _histogram_batch = {
+  .name = "scheduler_batch",
+  .unit = "events",
+};
+
+/* processing time of a single socket event */
+static struct oonf_histogram _histogram_event = {
+  .name = "scheduler_event",
+  .unit = "ns",
+};
+
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_OS_FD_SUBSYSTEM,
 };
@@ -109,6 +126,9 @@ _init(void) {
   list_init_head(&_socket_head);
   os_fd_event_add(&_socket_events);
 
+  oonf_histogram_add(&_histogram_batch);
+  oonf_histogram_add(&_histogram_event);
+
   _scheduler_time_limit = ~0ull;
   return 0;
 }
@@ -128,6 +148,9 @@ _cleanup(void)
   }
 
   os_fd_event_remove(&_socket_events);
+
+  oonf_histogram_remove(&_histogram_event);
+  oonf_histogram_remove(&_histogram_batch);
 }
 
 static void
@@ -149,6 +172,8 @@ oonf_socket_add(struct oonf_socket_entry *entry)
   OONF_DEBUG(LOG_SOCKET, "Adding socket entry %d to scheduler\n",
       os_fd_get_fd(&entry->fd));
 
+  memset(&entry->profile, 0, sizeof(entry->profile));
+
   list_add_before(&_socket_head, &entry->_node);
   os_fd_event_socket_add(&_socket_events, &entry->fd);
 }
@@ -167,6 +192,10 @@ oonf_socket_remove(struct oonf_socket_entry *entry)
     list_remove(&entry->_node);
     os_fd_event_socket_remove(&_socket_events, &entry->fd);
   }
+  if (entry == _socket_in_callback) {
+    /* do not touch the entry after the callback returns */
+    _socket_in_callback = NULL;
+  }
 }
 
 void
@@ -179,6 +208,14 @@ oonf_socket_set_write(struct oonf_socket_entry *entry, bool event_write) {
   os_fd_event_socket_write(&_socket_events, &entry->fd, event_write);
 }
 
+/**
+ * @return list of all sockets in the scheduler
+ */
+struct list_entity *
+oonf_socket_get_list(void) {
+  return &_socket_head;
+}
+
 static bool
 _shall_end_scheduler(void) {
   return _scheduler_time_limit == ~0ull && oonf_main_shall_stop_scheduler();
@@ -193,8 +230,9 @@ _handle_scheduling(void)
 {
   struct oonf_socket_entry *sock_entry = NULL;
   struct os_fd *sock;
+  struct oonf_timer_profile_sample sample;
+  struct oonf_timer_profile dummy;
   uint64_t next_event;
-  uint64_t start_time, end_time;
   int i, n;
 
   while (true) {
@@ -244,6 +282,7 @@ _handle_scheduling(void)
     }
 
     OONF_DEBUG(LOG_SOCKET, "Got %d events", n);
+    oonf_histogram_record(&_histogram_batch, n);
 
     for (i=0; i<n; i++) {
       sock = os_fd_event_get(&_socket_events, i);
@@ -260,14 +299,24 @@ _handle_scheduling(void)
             os_fd_event_is_read(sock) ? "true" : "false",
             os_fd_event_is_write(sock) ? "true" : "false");
 
-        os_clock_gettime64(&start_time);
+        _socket_in_callback = sock_entry;
+        oonf_timer_profile_start(&sample);
         sock_entry->process(sock_entry);
-        os_clock_gettime64(&end_time);
 
-        if (end_time - start_time > OONF_TIMER_SLICE) {
-          OONF_WARN(LOG_SOCKET, "Socket %d scheduling took %"PRIu64" ms",
-              os_fd_get_fd(&sock_entry->fd), end_time - start_time);
+        if (_socket_in_callback == NULL) {
+          /* socket has been removed during its callback */
+          memset(&dummy, 0, sizeof(dummy));
+          oonf_timer_profile_stop(&dummy, &sample);
+        }
+        else if (oonf_timer_profile_stop(&sock_entry->profile, &sample)) {
+          OONF_WARN(LOG_SOCKET, "Socket %d (%s) scheduling took %"PRIu64" ms"
+              " (cpu: %"PRIu64" ms)", os_fd_get_fd(&sock_entry->fd),
+              sock_entry->name ? sock_entry->name : "-",
+              sample.wall / 1000000, sample.cpu / 1000000);
         }
+        _socket_in_callback = NULL;
+
+        oonf_histogram_record(&_histogram_event, sample.wall);
       }
     }
   }
@@ -50,6 +50,7 @@
 #include "common/list.h"
 #include "common/avl.h"
 #include "common/netaddr_acl.h"
+#include "subsystems/oonf_timer.h"
 #include "subsystems/os_fd.h"
 
 /*! subsystem identifier */
@@ -59,6 +60,9 @@
  * registered socket handler
  */
 struct oonf_socket_entry {
+  /*! name of the socket user, used for resource accounting */
+  const char *name;
+
   /*! file descriptor of the socket */
   struct os_fd fd;
 
@@ -68,6 +72,9 @@ struct oonf_socket_entry {
    */
   void (*process) (struct oonf_socket_entry *entry);
 
+  /*! Stats, time spent in process callback */
+  struct oonf_timer_profile profile;
+
   /*! list of socket handlers */
   struct list_entity _node;
 };
@@ -78,6 +85,7 @@ EXPORT void oonf_socket_set_read(
     struct oonf_socket_entry *entry, bool event_read);
 EXPORT void oonf_socket_set_write(
     struct oonf_socket_entry *entry, bool event_write);
+EXPORT struct list_entity *oonf_socket_get_list(void);
 
 static INLINE bool
 oonf_socket_is_read(struct oonf_socket_entry *entry) {
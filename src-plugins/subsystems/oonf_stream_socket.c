@@ -179,6 +179,7 @@ oonf_stream_add(struct oonf_stream_socket *stream_socket,
       goto add_stream_error;
     }
 
+    stream_socket->scheduler_entry.name = "stream listener";
     stream_socket->scheduler_entry.process = _cb_parse_request;
 
     oonf_socket_add(&stream_socket->scheduler_entry);
@@ -637,6 +638,7 @@ _create_session(struct oonf_stream_socket *stream_socket,
   }
 
   os_fd_copy(&session->scheduler_entry.fd, sock);
+  session->scheduler_entry.name = "stream session";
   session->scheduler_entry.process = _cb_parse_connection;
   oonf_socket_add(&session->scheduler_entry);
   oonf_socket_set_read(&session->scheduler_entry, true);
@@ -77,6 +77,12 @@ static bool _scheduling_now;
 /* List of timer classes */
 static struct list_entity _timer_info_list;
 
+/* true if callbacks should be charged with their CPU time */
+static bool _profile_cpu_time = false;
+
+/* callbacks running longer than this (in nanoseconds) trigger a warning */
+static uint64_t _profile_slow_threshold = OONF_TIMER_SLICE * 1000000ull;
+
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_CLOCK_SUBSYSTEM,
@@ -260,7 +266,7 @@ oonf_timer_walk(void)
 {
   struct oonf_timer_instance *timer;
   struct oonf_timer_class *info;
-  uint64_t start_time, end_time;
+  struct oonf_timer_profile_sample sample;
 
   _scheduling_now = true;
 
@@ -290,13 +296,13 @@ oonf_timer_walk(void)
     }
 
     /* This timer is expired, call into the provided callback function */
-    os_clock_gettime64(&start_time);
+    oonf_timer_profile_start(&sample);
     timer->class->callback(timer);
-    os_clock_gettime64(&end_time);
 
-    if (end_time - start_time > OONF_TIMER_SLICE) {
-      OONF_WARN(LOG_TIMER, "Timer %s scheduling took %"PRIu64" ms",
-          timer->class->name, end_time - start_time);
+    if (oonf_timer_profile_stop(&info->profile, &sample)) {
+      OONF_WARN(LOG_TIMER, "Timer %s scheduling took %"PRIu64" ms"
+          " (cpu: %"PRIu64" ms)", info->name,
+          sample.wall / 1000000, sample.cpu / 1000000);
     }
 
     /*
@@ -343,6 +349,90 @@ oonf_timer_get_list(void) {
   return &_timer_info_list;
 }
 
+/**
+ * Configure the resource accounting of scheduler callbacks
+ * @param cpu_time true if callbacks should also be charged
+ *   with their CPU time, this costs an additional system call
+ *   per callback
+ * @param slow_threshold callbacks with a longer wall time
+ *   (in milliseconds) trigger a warning
+ */
+void
+oonf_timer_set_profiling(bool cpu_time, uint64_t slow_threshold) {
+  _profile_cpu_time = cpu_time;
+  _profile_slow_threshold = slow_threshold * 1000000ull;
+}
+
+/**
+ * @return true if callbacks are charged with their CPU time
+ */
+bool
+oonf_timer_is_cpu_profiling(void) {
+  return _profile_cpu_time;
+}
+
+/**
+ * Start the measurement of a scheduler callback
+ * @param sample measurement to be initialized
+ */
+void
+oonf_timer_profile_start(struct oonf_timer_profile_sample *sample) {
+  /* take wall time first, so it always contains the CPU time */
+  if (os_clock_gettime64_ns(&sample->wall)) {
+    sample->wall = 0;
+  }
+  sample->cpu = 0;
+  if (_profile_cpu_time && os_clock_gettime_cpu_ns(&sample->cpu)) {
+    sample->cpu = 0;
+  }
+}
+
+/**
+ * Finish the measurement of a scheduler callback and charge
+ * the elapsed time to a profile
+ * @param profile resource accounting of callback
+ * @param sample measurement started by oonf_timer_profile_start(),
+ *   will contain the elapsed wall and CPU time afterwards
+ * @return true if the callback was slower than the warning threshold
+ */
+bool
+oonf_timer_profile_stop(struct oonf_timer_profile *profile,
+    struct oonf_timer_profile_sample *sample) {
+  uint64_t now;
+
+  if (sample->cpu != 0 && os_clock_gettime_cpu_ns(&now) == 0
+      && now >= sample->cpu) {
+    sample->cpu = now - sample->cpu;
+  }
+  else {
+    sample->cpu = 0;
+  }
+
+  if (sample->wall != 0 && os_clock_gettime64_ns(&now) == 0
+      && now >= sample->wall) {
+    sample->wall = now - sample->wall;
+  }
+  else {
+    sample->wall = 0;
+  }
+
+  profile->calls++;
+  profile->wall_total += sample->wall;
+  if (sample->wall > profile->wall_max) {
+    profile->wall_max = sample->wall;
+  }
+  profile->cpu_total += sample->cpu;
+  if (sample->cpu > profile->cpu_max) {
+    profile->cpu_max = sample->cpu;
+  }
+
+  if (sample->wall > _profile_slow_threshold) {
+    profile->slow++;
+    return true;
+  }
+  return false;
+}
+
 /**
  * Decrement a relative timer by a random number range.
  * @param the relative timer expressed in units of milliseconds.
@@ -60,6 +60,40 @@ struct oonf_timer_instance;
 /*! timeslice of the scheduler */
 #define OONF_TIMER_SLICE 100ull
 
+/**
+ * Resource accounting of a scheduler callback (timer class or socket)
+ */
+struct oonf_timer_profile {
+  /*! number of callback invocations */
+  uint64_t calls;
+
+  /*! wall time spent in the callback in nanoseconds */
+  uint64_t wall_total;
+
+  /*! longest wall time of a single callback in nanoseconds */
+  uint64_t wall_max;
+
+  /*! CPU time spent in the callback in nanoseconds (CPU profiling only) */
+  uint64_t cpu_total;
+
+  /*! longest CPU time of a single callback in nanoseconds */
+  uint64_t cpu_max;
+
+  /*! number of callbacks slower than the warning threshold */
+  uint32_t slow;
+};
+
+/**
+ * Timestamps of a running callback measurement
+ */
+struct oonf_timer_profile_sample {
+  /*! wall time at start, elapsed wall time after stop (nanoseconds) */
+  uint64_t wall;
+
+  /*! CPU time at start, elapsed CPU time after stop (nanoseconds) */
+  uint64_t cpu;
+};
+
 /**
  * This struct defines a class of timers which have the same
  * type (periodic/non-periodic) and callback.
@@ -86,6 +120,9 @@ struct oonf_timer_class {
   /*! Stats, resource churn */
   uint32_t changes;
 
+  /*! Stats, time spent in callback */
+  struct oonf_timer_profile profile;
+
   /*! pointer to timer currently in callback */
   struct oonf_timer_instance *_timer_in_callback;
 
@@ -130,6 +167,12 @@ EXPORT uint64_t oonf_timer_getNextEvent(void);
 
 EXPORT struct list_entity *oonf_timer_get_list(void);
 
+EXPORT void oonf_timer_set_profiling(bool cpu_time, uint64_t slow_threshold);
+EXPORT bool oonf_timer_is_cpu_profiling(void);
+EXPORT void oonf_timer_profile_start(struct oonf_timer_profile_sample *sample);
+EXPORT bool oonf_timer_profile_stop(struct oonf_timer_profile *profile,
+    struct oonf_timer_profile_sample *sample);
+
 /**
  * @param timer pointer to timer
  * @return true if the timer is running, false otherwise
@@ -68,5 +68,6 @@
 /* prototypes for all os_system functions */
 static INLINE int os_clock_gettime64_ns(uint64_t *t64);
 static INLINE int os_clock_gettime64(uint64_t *t64);
+static INLINE int os_clock_gettime_cpu_ns(uint64_t *t64);
 
 #endif /* OS_CLOCK_H_ */
@@ -115,6 +115,9 @@ struct os_interface_flags {
   bool any;
 };
 
+/* forward declaration, used for cached layer2 network pointer */
+struct oonf_layer2_net;
+
 /**
  * Representation of an operation system interface
  */
@@ -170,6 +173,12 @@ struct os_interface {
   /*! listeners to be informed when an interface changes */
   struct list_entity _listeners;
 
+  /**
+   * pointer to layer2 network of this interface, maintained by the
+   * layer2 subsystem (NULL if no layer2 data is available)
+   */
+  struct oonf_layer2_net *l2net;
+
   /**
    * When an interface change handler triggers a 'interface not ready'
    * error the interface should be triggered again. The variable stores
@@ -150,3 +150,25 @@ os_clock_linux_gettime64(uint64_t *t64) {
   *t64 = 1000ull * tv.tv_sec + tv.tv_usec / 1000ull;
   return 0;
 }
+
+/**
+ * Reads the CPU time consumed by the calling thread in nanoseconds
+ * @param t64 pointer to timestamp
+ * @return 0 if valid timestamp was read, negative otherwise
+ */
+int
+os_clock_linux_gettime_cpu_ns(uint64_t *t64) {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+  int error;
+
+  if ((error = clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) != 0) {
+    return error;
+  }
+
+  *t64 = 1000000000ull * ts.tv_sec + ts.tv_nsec;
+  return 0;
+#else
+  return -1;
+#endif
+}
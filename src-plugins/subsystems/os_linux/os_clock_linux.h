@@ -50,6 +50,7 @@
 
 EXPORT int os_clock_linux_gettime64_ns(uint64_t *t64);
 EXPORT int os_clock_linux_gettime64(uint64_t *t64);
+EXPORT int os_clock_linux_gettime_cpu_ns(uint64_t *t64);
 
 /**
  * Reads the current time in nanoseconds as a monotonic timestamp
@@ -71,4 +72,14 @@ os_clock_gettime64(uint64_t *t64) {
   return os_clock_linux_gettime64(t64);
 }
 
+/**
+ * Reads the CPU time consumed by the calling thread in nanoseconds
+ * @param t64 pointer to timestamp
+ * @return 0 if valid timestamp was read, negative otherwise
+ */
+static INLINE int
+os_clock_gettime_cpu_ns(uint64_t *t64) {
+  return os_clock_linux_gettime_cpu_ns(t64);
+}
+
 #endif /* OS_CLOCK_LINUX_H_ */
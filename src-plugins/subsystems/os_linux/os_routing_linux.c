@@ -55,6 +55,7 @@
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_histogram.h"
 #include "subsystems/os_system.h"
 
 #include "subsystems/os_routing.h"
@@ -90,6 +91,7 @@ static void _cb_rtnetlink_timeout(void);
 
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_HISTOGRAM_SUBSYSTEM,
   OONF_OS_SYSTEM_SUBSYSTEM,
 };
 
@@ -136,6 +138,12 @@ static struct os_system_netlink _rtnetlink_event_socket = {
 };
 
 static struct avl_tree _rtnetlink_feedback;
+
+/* time between sending a routing command and the kernel answer */
+static struct oonf_histogram _rtnetlink_histogram = {
+  .name = "netlink_route",
+  .unit = "ns",
+};
 static struct list_entity _rtnetlink_listener;
 
 /* default wildcard route */
@@ -179,6 +187,7 @@ _init(void) {
   }
   avl_init(&_rtnetlink_feedback, avl_comp_uint32, false);
   list_init_head(&_rtnetlink_listener);
+  oonf_histogram_add(&_rtnetlink_histogram);
 
   _is_kernel_3_11_0_or_better = os_system_linux_is_minimal_kernel(3,11,0);
   return 0;
@@ -197,6 +206,8 @@ _cleanup(void) {
 
   os_system_linux_netlink_remove(&_rtnetlink_socket);
   os_system_linux_netlink_remove(&_rtnetlink_event_socket);
+
+  oonf_histogram_remove(&_rtnetlink_histogram);
 }
 
 /**
@@ -289,6 +300,7 @@ os_routing_linux_set(struct os_route *route, bool set, bool del_similar) {
 
   if (route->cb_finished) {
     route->_internal.nl_seq = seq;
+    route->_internal.nl_start = oonf_histogram_start(&_rtnetlink_histogram);
     route->_internal._node.key = &route->_internal.nl_seq;
 
     assert (!avl_is_node_added(&route->_internal._node));
@@ -330,6 +342,7 @@ os_routing_linux_query(struct os_route *route) {
   }
 
   route->_internal.nl_seq = seq;
+  route->_internal.nl_start = oonf_histogram_start(&_rtnetlink_histogram);
   route->_internal._node.key = &route->_internal.nl_seq;
   avl_insert(&_rtnetlink_feedback, &route->_internal._node);
   return 0;
@@ -396,6 +409,9 @@ _routing_finished(struct os_route *route, int error) {
   /* remove first to prevent any kind of recursive cleanup */
   avl_remove(&_rtnetlink_feedback, &route->_internal._node);
 
+  oonf_histogram_stop(&_rtnetlink_histogram, route->_internal.nl_start);
+  route->_internal.nl_start = 0;
+
   if (route->cb_finished) {
     route->cb_finished(route, error);
   }
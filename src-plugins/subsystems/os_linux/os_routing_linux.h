@@ -62,6 +62,9 @@ struct os_route_internal {
 
   /*! netlink sequence number of command sent to the kernel */
   uint32_t nl_seq;
+
+  /*! nanosecond timestamp when command was sent to the kernel */
+  uint64_t nl_start;
 };
 
 /**
@@ -50,6 +50,7 @@
 #include <sys/time.h>
 
 #include "common/common_types.h"
+#include "common/avl_typed.h"
 #include "common/list.h"
 #include "common/netaddr.h"
 #include "subsystems/os_interface.h"
@@ -231,4 +232,25 @@ static INLINE void os_routing_init_sourcespec_src_prefix(
 /* AVL comparators are a special case so we don't do the INLINE trick here */
 EXPORT int os_routing_avl_cmp_route_key(const void *, const void *);
 
+/**
+ * Inline comparator for routing keys, same order as
+ * os_routing_avl_cmp_route_key()
+ * @param k1 routing key 1
+ * @param k2 routing key 2
+ * @return <0 if k1<k2, >0 if k1>k2, 0 otherwise
+ */
+static INLINE int
+os_routing_cmp_route_key(const struct os_route_key *k1, const struct os_route_key *k2) {
+  int result;
+
+  result = netaddr_cmp(&k1->dst, &k2->dst);
+  if (result) {
+    return result;
+  }
+  return netaddr_cmp(&k1->src, &k2->src);
+}
+
+/* avl_route_key_find() and avl_route_key_insert() */
+AVL_DEFINE_TYPED(route_key, struct os_route_key, os_routing_cmp_route_key)
+
 #endif /* OS_ROUTING_H_ */
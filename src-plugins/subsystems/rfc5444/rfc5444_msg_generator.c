@@ -80,13 +80,73 @@ struct _rfc5444_internal_addr_compress_session {
   bool closed;
 };
 
+/*! number of addresses which can be part of a single address block */
+#define RFC5444_MAX_BLOCK_ADDRESSES 255
+
+/**
+ * range of addresses which can start an address block ending
+ * with the current address, all with the same head and tail
+ */
+struct _rfc5444_internal_addr_run {
+  /*! index of first address of range */
+  uint32_t start;
+
+  /*! index of last address of range */
+  uint32_t end;
+
+  /*! length of common head of the block */
+  uint8_t head;
+
+  /*! length of common tail of the block */
+  uint8_t tail;
+
+  /*! true if block has multiple prefix lengths */
+  bool multiplen;
+
+  /*! index of the cheapest block start within the range */
+  uint32_t min_idx;
+
+  /*! cost of the cheapest block start, normalized to address index 0 */
+  int min;
+};
+
+/**
+ * data necessary for sorted-run address compression
+ */
+struct _rfc5444_internal_addr_runs {
+  /*! ranges of block starts, ordered by address index */
+  struct _rfc5444_internal_addr_run run[RFC5444_MAX_BLOCK_ADDRESSES + 1];
+
+  /*! number of ranges */
+  int run_count;
+
+  /*! cost of a block start for the last addresses, indexed by address index */
+  int base[RFC5444_MAX_BLOCK_ADDRESSES + 1];
+
+  /*! last addresses, indexed by address index */
+  struct rfc5444_writer_address *addr[RFC5444_MAX_BLOCK_ADDRESSES + 1];
+
+  /*! sum of tlv costs of all addresses if no block is started */
+  int tlv_sum;
+
+  /*! total number of bytes of the best compression for the last address */
+  int best;
+};
+
 static void _close_addrblock(struct _rfc5444_internal_addr_compress_session *acs,
     struct rfc5444_writer *writer, struct rfc5444_writer_address *last_addr, int);
 static void _finalize_message_fragment(struct rfc5444_writer *writer,
     struct rfc5444_writer_message *msg, struct list_entity *fragment_addrs, bool not_fragmented,
     rfc5444_writer_targetselector useIf, void *param);
+static void _add_message_to_targets(struct rfc5444_writer *writer,
+    struct rfc5444_writer_message *msg,
+    const uint8_t *head, size_t head_len, const uint8_t *tail, size_t tail_len,
+    bool cache, rfc5444_writer_targetselector useIf, void *param);
 static int _compress_address(struct _rfc5444_internal_addr_compress_session *acs,
     struct rfc5444_writer *writer, struct list_entity *addr_list, int same_prefixlen);
+static void _sort_addresses(struct rfc5444_writer_message *msg);
+static int _compress_address_runs(struct _rfc5444_internal_addr_runs *runs,
+    struct rfc5444_writer *writer, struct list_entity *addr_list);
 static void _write_addresses(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
     struct list_entity *fragment_addrs);
 static void _write_msgheader(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg);
@@ -122,6 +182,7 @@ rfc5444_writer_create_message(struct rfc5444_writer *writer, uint8_t msgid,
   size_t processor_preallocation;
 
   struct _rfc5444_internal_addr_compress_session acs[RFC5444_MAX_ADDRLEN];
+  struct _rfc5444_internal_addr_runs runs;
   int best_size, best_head, same_prefixlen;
   int i, idx, non_mandatory;
   bool first;
@@ -250,6 +311,11 @@ rfc5444_writer_create_message(struct rfc5444_writer *writer, uint8_t msgid,
     }
   }
 
+  if (writer->addr_compression == RFC5444_ADDR_COMPRESSION_SORTED_RUNS) {
+    /* process addresses in the order of the address tree */
+    _sort_addresses(msg);
+  }
+
   /* join mandatory and normal address list */
   list_merge(&msg->_addr_head, &msg->_non_mandatory_addr_head);
 
@@ -306,29 +372,41 @@ rfc5444_writer_create_message(struct rfc5444_writer *writer, uint8_t msgid,
 
       /* clear address compression session */
       memset(acs, 0, sizeof(acs));
+      runs.run_count = 0;
+      runs.tlv_sum = 0;
+      runs.best = 0;
       same_prefixlen = 1;
 
       first_processed = addr;
     }
 
     addr->index = idx++;
+    addr->_block_start = NULL;
     list_add_tail(&current_list, &addr->_addr_fragment_node);
 
-    /* update session with address */
-    same_prefixlen = _compress_address(acs, writer, &current_list, same_prefixlen);
-    first = false;
-
-    /* look for best current compression */
-    best_head = -1;
-    best_size = max_msg_size + 1;
-    for (i = 0; i < writer->msg_addr_len; i++) {
-      int size = acs[i].total + acs[i].current;
-      int count = addr->index - acs[i].ptr->index;
-
-      /* a block of 255 addresses have an index difference of 254 */
-      if (size < best_size && count <= 254) {
-        best_head = i;
-        best_size = size;
+    if (writer->addr_compression == RFC5444_ADDR_COMPRESSION_SORTED_RUNS) {
+      /* update partition into address blocks */
+      best_size = _compress_address_runs(&runs, writer, &current_list);
+      best_head = best_size > (int)max_msg_size ? -1 : addr->_block_headlen;
+      first = false;
+    }
+    else {
+      /* update session with address */
+      same_prefixlen = _compress_address(acs, writer, &current_list, same_prefixlen);
+      first = false;
+
+      /* look for best current compression */
+      best_head = -1;
+      best_size = max_msg_size + 1;
+      for (i = 0; i < writer->msg_addr_len; i++) {
+        int size = acs[i].total + acs[i].current;
+        int count = addr->index - acs[i].ptr->index;
+
+        /* a block of 255 addresses have an index difference of 254 */
+        if (size < best_size && count <= 254) {
+          best_head = i;
+          best_size = size;
+        }
       }
     }
 
@@ -347,7 +425,9 @@ rfc5444_writer_create_message(struct rfc5444_writer *writer, uint8_t msgid,
       /* one address too many */
       list_remove(&addr->_addr_fragment_node);
 
-      _close_addrblock(acs, writer, last_processed, 0);
+      if (writer->addr_compression == RFC5444_ADDR_COMPRESSION_SESSION) {
+        _close_addrblock(acs, writer, last_processed, 0);
+      }
 #ifdef DEBUG_OUTPUT
       printf("Finalize with head length: %d\n", last_processed->_block_headlen);
 #endif
@@ -385,7 +465,9 @@ rfc5444_writer_create_message(struct rfc5444_writer *writer, uint8_t msgid,
   }
 
   if (last_processed) {
-    _close_addrblock(acs, writer, last_processed, 0);
+    if (writer->addr_compression == RFC5444_ADDR_COMPRESSION_SESSION) {
+      _close_addrblock(acs, writer, last_processed, 0);
+    }
 
     /* write message fragment */
     _finalize_message_fragment(writer, msg, &current_list, not_fragmented, useIf, param);
@@ -428,6 +510,83 @@ bool rfc5444_writer_alltargets_selector(struct rfc5444_writer *writer __attribut
   return true;
 }
 
+/**
+ * Add a binary message previously reported by the cacheMessage
+ * callback of a message creator to the writers buffer.
+ * The message is not modified except by the registered
+ * postprocessors, so it must not contain fields that change
+ * between two transmissions (e.g. a message sequence number).
+ * This function must NOT be called from the rfc5444 writer callbacks.
+ *
+ * @param writer pointer to writer context
+ * @param msgid type of message
+ * @param useIf pointer to interface selector
+ * @param param last parameter of interface selector
+ * @param data pointer to binary message
+ * @param len length of binary message
+ * @return RFC5444_OKAY if message was added to packet buffer,
+ *   RFC5444_MTU_TOO_SMALL if the message does not fit into a packet
+ *   anymore (it has to be generated again), RFC5444_... otherwise
+ */
+enum rfc5444_result
+rfc5444_writer_add_cached_message(struct rfc5444_writer *writer, uint8_t msgid,
+    rfc5444_writer_targetselector useIf, void *param,
+    const uint8_t *data, size_t len) {
+  struct rfc5444_writer_message *msg;
+  struct rfc5444_writer_postprocessor *processor;
+  struct rfc5444_writer_target *target;
+  size_t processor_preallocation;
+
+#if WRITER_STATE_MACHINE == true
+  assert(writer->_state == RFC5444_WRITER_NONE);
+#endif
+
+  /* do nothing if no target is defined */
+  if (list_is_empty(&writer->_targets)) {
+    return RFC5444_OKAY;
+  }
+
+  /* find message create instance for the requested message */
+  msg = avl_find_element(&writer->_msgcreators, &msgid, msg, _msgcreator_node);
+  if (msg == NULL) {
+    /* error, no msgcreator found */
+    return RFC5444_NO_MSGCREATOR;
+  }
+
+  if (len > writer->msg_size) {
+    return RFC5444_MTU_TOO_SMALL;
+  }
+
+  /* calculate space necessary for post-processors */
+  processor_preallocation = 0;
+  avl_for_each_element(&writer->_processors, processor, _node) {
+    if (processor->is_matching_signature(processor, msg->type)) {
+      processor_preallocation += processor->allocate_space;
+    }
+  }
+
+  /* check if message still fits into all selected targets */
+  list_for_each_element(&writer->_targets, target, _target_node) {
+    /* check if we should send over this target */
+    if (!useIf(writer, target, param)) {
+      continue;
+    }
+
+    /* start packet if necessary */
+    if (target->_is_flushed) {
+      _rfc5444_writer_begin_packet(writer, target);
+    }
+
+    if (len + processor_preallocation + target->_pkt.header
+        + target->_pkt.added + target->_pkt.allocated > target->packet_size) {
+      return RFC5444_MTU_TOO_SMALL;
+    }
+  }
+
+  _add_message_to_targets(writer, msg, data, len, NULL, 0, false, useIf, param);
+  return RFC5444_OKAY;
+}
+
 /**
  * Write a binary rfc5444 message into the writers buffer to
  * forward it. This function handles the modification of hopcount
@@ -959,13 +1118,12 @@ _compress_address(struct _rfc5444_internal_addr_compress_session *acs,
     printf(" %2d/%2d", continue_cost, closed ? -1 : new_cost);
 #endif
     if (closed || acs[i].total + continue_cost > acs[addrlen-1].total + new_cost) {
-      /* forget the last addresses, longer prefix is better. */
-      /* store address block for later binary generation */
-      if (last_addr) {
-        last_addr->_block_start = acs[addrlen-1].ptr;
-        last_addr->_block_multiple_prefixlen = acs[addrlen-1].multiplen;
-        last_addr->_block_headlen = addrlen-1;
-      }
+      /*
+       * forget the last addresses, longer prefix is better.
+       * The block ending with the last address has already been
+       * stored by _close_addrblock(), the new block starts with
+       * its total.
+       */
 
       /* Create a new address block */
       acs[i].ptr = addr;
@@ -1005,6 +1163,291 @@ _compress_address(struct _rfc5444_internal_addr_compress_session *acs,
   return same_prefixlen;
 }
 
+/**
+ * Rebuild the address lists of a message in the order of the
+ * address tree, so that similar addresses become neighbors.
+ * @param msg pointer to message object
+ */
+static void
+_sort_addresses(struct rfc5444_writer_message *msg) {
+  struct rfc5444_writer_address *addr;
+
+  list_init_head(&msg->_addr_head);
+  list_init_head(&msg->_non_mandatory_addr_head);
+
+  avl_for_each_element(&msg->_addr_tree, addr, _addr_tree_node) {
+    list_add_tail(&msg->_addr_head, &addr->_addr_list_node);
+  }
+}
+
+/**
+ * Calculate the number of bytes used for each address of a block
+ * @param run pointer to range of block starts
+ * @param addrlen address length of message
+ * @return number of bytes per address
+ */
+static int
+_get_run_slope(struct _rfc5444_internal_addr_run *run, int addrlen) {
+  return addrlen - run->head - run->tail + (run->multiplen ? 1 : 0);
+}
+
+/**
+ * Search the cheapest block start of a range
+ * @param runs pointer to sorted-run compression data
+ * @param run pointer to range of block starts
+ * @param addrlen address length of message
+ */
+static void
+_update_run_min(struct _rfc5444_internal_addr_runs *runs,
+    struct _rfc5444_internal_addr_run *run, int addrlen) {
+  uint32_t idx;
+  int slope, cost;
+
+  slope = _get_run_slope(run, addrlen);
+
+  run->min_idx = run->start;
+  run->min = runs->base[run->start % ARRAYSIZE(runs->base)] - slope * (int)run->start;
+  for (idx = run->start + 1; idx <= run->end; idx++) {
+    cost = runs->base[idx % ARRAYSIZE(runs->base)] - slope * (int)idx;
+    if (cost <= run->min) {
+      run->min = cost;
+      run->min_idx = idx;
+    }
+  }
+}
+
+/**
+ * Update the sorted-run address compression with a new address.
+ *
+ * The addresses of the fragment are split into address blocks by
+ * dynamic programming. All possible block starts for a block ending
+ * with the new address are grouped into ranges with the same common
+ * head, common tail and prefix length handling. The ranges only change
+ * at the end when a new address is added, so the cheapest block start
+ * of most ranges can be reused. TLV costs are calculated once
+ * per address.
+ *
+ * The best block for the new address is stored in the address object
+ * (like _close_addrblock() does for the session based compression).
+ *
+ * @param runs pointer to sorted-run compression data
+ * @param writer pointer to rfc5444 writer
+ * @param addr_list list of addresses of the current fragment
+ * @return total number of bytes necessary to encode the address blocks
+ *   up to the new address
+ */
+static int
+_compress_address_runs(struct _rfc5444_internal_addr_runs *runs,
+    struct rfc5444_writer *writer, struct list_entity *addr_list) {
+  struct rfc5444_writer_address *addr, *last_addr;
+  struct rfc5444_writer_addrtlv *tlv, *last_tlv;
+  struct rfc5444_writer_tlvtype *tlvtype;
+  struct _rfc5444_internal_addr_run *run, *best_run;
+  const uint8_t *addrptr, *last_addrptr;
+  int cost, new_cost, continue_cost, best;
+  int addrlen, common_head, common_tail, zero_tail, head, tail;
+  int i, changed;
+  uint32_t idx;
+  bool new_prefixlen, has_prefixlen;
+
+  addr = list_last_element(addr_list, addr, _addr_fragment_node);
+  if (!list_is_first(addr_list, &addr->_addr_fragment_node)) {
+    last_addr = list_prev_element(addr, _addr_fragment_node);
+  }
+  else {
+    last_addr = NULL;
+  }
+
+  addrlen = writer->msg_addr_len;
+  idx = addr->index;
+  addrptr = netaddr_get_binptr(&addr->address);
+  has_prefixlen = netaddr_get_prefix_length(&addr->address) != addrlen * 8;
+
+  /* calculate common head and tail with last address */
+  common_head = 0;
+  common_tail = 0;
+  new_prefixlen = false;
+  if (last_addr) {
+    last_addrptr = netaddr_get_binptr(&last_addr->address);
+    while (common_head < addrlen && last_addrptr[common_head] == addrptr[common_head]) {
+      common_head++;
+    }
+    while (common_tail < addrlen
+        && last_addrptr[addrlen - common_tail - 1] == addrptr[addrlen - common_tail - 1]) {
+      common_tail++;
+    }
+    new_prefixlen = netaddr_get_prefix_length(&last_addr->address)
+        != netaddr_get_prefix_length(&addr->address);
+  }
+
+  zero_tail = 0;
+  while (zero_tail < addrlen && addrptr[addrlen - zero_tail - 1] == 0) {
+    zero_tail++;
+  }
+
+  /* calculate costs for starting and continuing tlv sequences */
+  new_cost = 0;
+  continue_cost = 0;
+  avl_for_each_element(&addr->_addrtlv_tree, tlv, addrtlv_node) {
+    tlvtype = tlv->tlvtype;
+
+    tlv->_same_length = false;
+    tlv->_same_value = false;
+
+    if (last_addr) {
+      last_tlv = avl_find_element(&last_addr->_addrtlv_tree,
+          &tlvtype->_full_type, last_tlv, addrtlv_node);
+      if (last_tlv && last_tlv->length == tlv->length) {
+        tlv->_same_length = true;
+        tlv->_same_value = memcmp(tlv->value, last_tlv->value, tlv->length) == 0;
+      }
+    }
+
+    /* type, flags, index fields, length field and value */
+    cost = 2 + 2 + tlv->length;
+    if (tlvtype->exttype > 0) {
+      cost++;
+    }
+    if (tlv->length > 255) {
+      cost++;
+    }
+    if (tlv->length > 0) {
+      cost++;
+    }
+    new_cost += cost;
+
+    /*
+     * the tlv sequence might have started before the address block,
+     * so these costs are an upper bound for all blocks
+     */
+    if (!tlv->_same_length) {
+      continue_cost += cost;
+      tlvtype->_tlvblock_count[0] = 1;
+      tlvtype->_tlvblock_multi[0] = false;
+      continue;
+    }
+
+    if (tlvtype->_tlvblock_multi[0]) {
+      continue_cost += tlv->length;
+    }
+    else if (!tlv->_same_value) {
+      continue_cost += tlv->length * tlvtype->_tlvblock_count[0];
+      tlvtype->_tlvblock_multi[0] = true;
+    }
+    tlvtype->_tlvblock_count[0]++;
+  }
+
+  /* remember cost of starting a block with this address */
+  runs->tlv_sum += continue_cost;
+  runs->base[idx % ARRAYSIZE(runs->base)] = runs->best + new_cost - runs->tlv_sum;
+  runs->addr[idx % ARRAYSIZE(runs->addr)] = addr;
+
+  /* shrink ranges of block starts, the newest range changes first */
+  changed = runs->run_count;
+  for (i = runs->run_count - 1; i >= 0; i--) {
+    run = &runs->run[i];
+    if (run->head <= common_head && run->tail <= common_tail
+        && (run->multiplen || !new_prefixlen)) {
+      /* all older ranges have shorter heads and tails */
+      break;
+    }
+
+    if (run->head > common_head) {
+      run->head = common_head;
+    }
+    if (run->tail > common_tail) {
+      run->tail = common_tail;
+    }
+    run->multiplen |= new_prefixlen;
+    _update_run_min(runs, run, addrlen);
+    changed = i;
+  }
+
+  /* join ranges that have become equal */
+  for (i = changed; i < runs->run_count; i++) {
+    run = &runs->run[i];
+    if (i > 0 && run[-1].head == run->head && run[-1].tail == run->tail
+        && run[-1].multiplen == run->multiplen) {
+      run[-1].end = run->end;
+      if (run->min <= run[-1].min) {
+        run[-1].min = run->min;
+        run[-1].min_idx = run->min_idx;
+      }
+      memmove(run, run + 1, sizeof(*run) * (runs->run_count - i - 1));
+      runs->run_count--;
+      i--;
+    }
+  }
+
+  /* remove block starts that would create too large blocks */
+  if (runs->run_count > 0 && idx - runs->run[0].start >= RFC5444_MAX_BLOCK_ADDRESSES) {
+    run = &runs->run[0];
+    run->start = idx - RFC5444_MAX_BLOCK_ADDRESSES + 1;
+    if (run->start > run->end) {
+      memmove(run, run + 1, sizeof(*run) * (runs->run_count - 1));
+      runs->run_count--;
+    }
+    else if (run->min_idx < run->start) {
+      _update_run_min(runs, run, addrlen);
+    }
+  }
+
+  /* a block with a single address has no head and tail */
+  best = runs->best + new_cost + 4 + addrlen + (has_prefixlen ? 1 : 0);
+  best_run = NULL;
+
+  /* look for cheaper blocks including older addresses */
+  for (i = 0; i < runs->run_count; i++) {
+    run = &runs->run[i];
+
+    head = run->head < addrlen - 1 ? run->head : addrlen - 1;
+    tail = run->tail < addrlen - 1 - head ? run->tail : addrlen - 1 - head;
+
+    /* number of bytes per address, block header and tlvblock length */
+    cost = run->min + (addrlen - head - tail + (run->multiplen ? 1 : 0)) * (int)(idx + 1)
+        + runs->tlv_sum + 4;
+    if (head > 0) {
+      cost += 1 + head;
+    }
+    if (tail > 0) {
+      cost += 1 + (zero_tail >= tail ? 0 : tail);
+    }
+    if (!run->multiplen && has_prefixlen) {
+      cost++;
+    }
+
+    if (cost < best) {
+      best = cost;
+      best_run = run;
+    }
+  }
+
+  /* store address block for later binary generation */
+  if (best_run) {
+    addr->_block_start = runs->addr[best_run->min_idx % ARRAYSIZE(runs->addr)];
+    addr->_block_headlen = best_run->head < addrlen - 1 ? best_run->head : addrlen - 1;
+    addr->_block_multiple_prefixlen = best_run->multiplen;
+  }
+  else {
+    addr->_block_start = addr;
+    addr->_block_headlen = 0;
+    addr->_block_multiple_prefixlen = false;
+  }
+  runs->best = best;
+
+  /* new address can start a block for the next addresses */
+  run = &runs->run[runs->run_count++];
+  run->start = idx;
+  run->end = idx;
+  run->head = addrlen;
+  run->tail = addrlen;
+  run->multiplen = false;
+  run->min_idx = idx;
+  run->min = 0;
+
+  return best;
+}
+
 static uint8_t *
 _write_addresstlv(struct rfc5444_writer_tlvtype *tlvtype,
     struct rfc5444_writer_address *addr_first,
@@ -1364,13 +1807,9 @@ static void
 _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
     struct list_entity *fragment_addrs, bool not_fragmented,
     rfc5444_writer_targetselector useIf, void *param) {
-  struct rfc5444_writer_postprocessor *processor;
   struct rfc5444_writer_content_provider *prv;
-  struct rfc5444_writer_target *target;
   struct rfc5444_writer_address *addr, *first, *last;
-  uint8_t *ptr, *firstcopy;
-  size_t msg_minsize, firstcopy_size, msg_size;
-  bool error;
+  size_t msg_minsize;
 
   /* reset optional tlv length */
   writer->_msg.set = 0;
@@ -1433,9 +1872,52 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
 
   /* precalculate number of fixed bytes of message header */
   msg_minsize = writer->_msg.header + writer->_msg.added;
+
+  /* copy message header, message tlvs and address blocks into the targets */
+  _add_message_to_targets(writer, msg,
+      writer->_msg.buffer, msg_minsize + writer->_msg.set,
+      &writer->_msg.buffer[msg_minsize + writer->_msg.allocated], msg->_bin_addr_size,
+      not_fragmented, useIf, param);
+
+  /* clear length value of message address size */
+  msg->_bin_addr_size = 0;
+
+  /* reset message tlv variables */
+  writer->_msg.set = 0;
+
+  /* clear message buffer */
+#if DEBUG_CLEANUP == true
+  memset(&writer->_msg.buffer[msg_minsize], 253, writer->_msg.max - msg_minsize);
+#endif
+}
+
+/**
+ * Copy a binary message into the packet buffers of all selected targets
+ * and run the postprocessors on it. The message is given as two segments
+ * (typically header/message-tlvs and address blocks), which are
+ * concatenated in the packet buffer.
+ * @param writer pointer to writer context
+ * @param msg pointer to message object
+ * @param head pointer to first segment of binary message
+ * @param head_len length of first segment
+ * @param tail pointer to second segment of binary message, might be NULL
+ * @param tail_len length of second segment
+ * @param cache true if message should be reported to the cacheMessage callback
+ * @param useIf pointer to callback for selecting outgoing _targets
+ * @param param custom parameter of target selector
+ */
+static void
+_add_message_to_targets(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+    const uint8_t *head, size_t head_len, const uint8_t *tail, size_t tail_len,
+    bool cache, rfc5444_writer_targetselector useIf, void *param) {
+  struct rfc5444_writer_postprocessor *processor;
+  struct rfc5444_writer_target *target;
+  uint8_t *ptr, *firstcopy;
+  size_t firstcopy_size, msg_size;
+  bool error;
+
   firstcopy = NULL;
   firstcopy_size = 0;
-  ptr = NULL;
 
   /* 1.) first flush all interfaces that have full buffers */
   list_for_each_element(&writer->_targets, target, _target_node) {
@@ -1446,8 +1928,7 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
 
     /* calculate total size of packet and message, see if it fits into the current packet */
     if (target->_pkt.header + target->_pkt.added + target->_pkt.set + target->_bin_msgs_size
-        + writer->_msg.header + writer->_msg.added + writer->_msg.set + msg->_bin_addr_size
-        > target->_pkt.max) {
+        + head_len + tail_len > target->_pkt.max) {
 
       /* flush the old packet */
       rfc5444_writer_flush(writer, target, false);
@@ -1471,15 +1952,19 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
       /* first target. Assemble message and run interface-unspecific transformers */
       firstcopy = ptr;
 
-      /* copy message header and message tlvs into packet buffer */
-      memcpy(ptr, writer->_msg.buffer, msg_minsize + writer->_msg.set);
-
-      /* copy address blocks and address tlvs into packet buffer */
-      ptr += msg_minsize + writer->_msg.set;
-      memcpy(ptr, &writer->_msg.buffer[msg_minsize + writer->_msg.allocated], msg->_bin_addr_size);
+      /* copy both segments of the message into packet buffer */
+      memcpy(ptr, head, head_len);
+      if (tail_len > 0) {
+        memcpy(ptr + head_len, tail, tail_len);
+      }
 
       /* remember position of first copy */
-      firstcopy_size = msg_minsize + writer->_msg.set + msg->_bin_addr_size;
+      firstcopy_size = head_len + tail_len;
+
+      /* give user the chance to store the unprocessed message */
+      if (cache && msg->cacheMessage) {
+        msg->cacheMessage(writer, msg, firstcopy, firstcopy_size);
+      }
 
       /* run processors */
       avl_for_each_element(&writer->_processors, processor, _node) {
@@ -1507,6 +1992,8 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
       continue;
     }
 
+    ptr = &target->_pkt.buffer[target->_pkt.header + target->_pkt.added
+                                 + target->_pkt.allocated + target->_bin_msgs_size];
     msg_size = firstcopy_size;
     avl_for_each_element(&writer->_processors, processor, _node) {
       if (processor->is_matching_signature(processor, msg->type)
@@ -1522,15 +2009,4 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
       target->_bin_msgs_size += msg_size;
     }
   }
-
-  /* clear length value of message address size */
-  msg->_bin_addr_size = 0;
-
-  /* reset message tlv variables */
-  writer->_msg.set = 0;
-
-  /* clear message buffer */
-#if DEBUG_CLEANUP == true
-  memset(&writer->_msg.buffer[msg_minsize], 253, writer->_msg.max - msg_minsize);
-#endif
 }
@@ -1132,6 +1132,15 @@ _handle_message(struct rfc5444_reader *parser,
     goto cleanup_parse_message;
   }
 
+  /* check if message can be dropped before parsing the rest of it */
+  if (parser->drop_message != NULL) {
+    tlv_context->type = RFC5444_CONTEXT_MESSAGE;
+    if (parser->drop_message(tlv_context)) {
+      tlv_context->_do_not_forward = true;
+      goto cleanup_parse_message;
+    }
+  }
+
   /* parse message TLV block */
   result = _parse_tlvblock(parser, &tlv_entries, ptr, end, 0);
   if (result != RFC5444_OKAY) {
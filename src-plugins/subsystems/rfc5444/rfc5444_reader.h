@@ -388,6 +388,16 @@ struct rfc5444_reader {
   void (*forward_message)(struct rfc5444_reader_tlvblock_context *context,
       uint8_t *buffer, size_t length);
 
+  /**
+   * Callback triggered after the header of a message has been parsed,
+   * before its TLV blocks and address blocks are parsed. Allows to
+   * drop (known duplicate) messages early without parsing them.
+   * Dropped messages are neither processed nor forwarded.
+   * @param context message context, only header fields are valid
+   * @return true if message should be dropped
+   */
+  bool (*drop_message)(struct rfc5444_reader_tlvblock_context *context);
+
   /**
    * Callback to allocate a tlvblock entry
    * @return tlvblock entry, NULL if out of memory
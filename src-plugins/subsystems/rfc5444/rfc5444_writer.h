@@ -75,6 +75,20 @@ enum rfc5444_internal_state {
   RFC5444_WRITER_FINISH_PKTHEADER
 };
 
+/**
+ * Algorithms for splitting the addresses of a message into address blocks
+ */
+enum rfc5444_addr_compression {
+  /*! incremental compression with one session per head length */
+  RFC5444_ADDR_COMPRESSION_SESSION,
+
+  /**
+   * sort addresses and calculate the cheapest partition
+   * into address blocks based on common prefix lengths
+   */
+  RFC5444_ADDR_COMPRESSION_SORTED_RUNS,
+};
+
 /* msg_type id for packet post-processor */
 enum {
   RFC5444_WRITER_PKT_POSTPROCESSOR = -1,
@@ -381,6 +395,19 @@ struct rfc5444_writer_message {
       struct rfc5444_writer_address *first,
       struct rfc5444_writer_address *last, bool complete);
 
+  /**
+   * Callback to hand the binary form of a message that fit into
+   * a single fragment to the user before any postprocessor has
+   * modified it. The data can be stored and sent again later
+   * with rfc5444_writer_add_cached_message().
+   * @param writer rfc5444 writer
+   * @param msg rfc5444 message
+   * @param data pointer to binary message
+   * @param len length of binary message
+   */
+  void (*cacheMessage)(struct rfc5444_writer *writer,
+      struct rfc5444_writer_message *msg, const uint8_t *data, size_t len);
+
   /**
    * callback to determine if a message shall be forwarded
    * @param target rfc5444 target
@@ -488,6 +515,9 @@ struct rfc5444_writer {
   /*! length of addrtlv buffer */
   size_t addrtlv_size;
 
+  /*! algorithm used to split addresses into address blocks */
+  enum rfc5444_addr_compression addr_compression;
+
   /**
    * Callback to notify an instance that a message was forwarded
    * @param target pointer to rfc5444 target where
@@ -646,6 +676,11 @@ EXPORT enum rfc5444_result rfc5444_writer_create_message(
     struct rfc5444_writer *writer, uint8_t msgid, uint8_t addr_len,
     rfc5444_writer_targetselector useIf, void *param);
 
+EXPORT enum rfc5444_result rfc5444_writer_add_cached_message(
+    struct rfc5444_writer *writer, uint8_t msgid,
+    rfc5444_writer_targetselector useIf, void *param,
+    const uint8_t *data, size_t len);
+
 EXPORT enum rfc5444_result rfc5444_writer_forward_msg(struct rfc5444_writer *writer,
     struct rfc5444_reader_tlvblock_context *context, uint8_t *msg, size_t len);
 
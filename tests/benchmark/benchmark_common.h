@@ -0,0 +1,104 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ * Helper functions shared by the benchmarks of all test directories.
+ * Each benchmark is a single compilation unit, so the helpers are
+ * defined static in this header.
+ */
+
+#ifndef BENCHMARK_COMMON_H_
+#define BENCHMARK_COMMON_H_
+
+#include <time.h>
+
+#include "common/common_types.h"
+
+/*! sink for benchmark results, prevents the compiler from removing the measured code */
+static volatile uint32_t benchmark_sink;
+
+/**
+ * @return monotonic timestamp in nanoseconds
+ */
+static INLINE uint64_t
+benchmark_get_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Deterministic pseudo random generator (64 bit LCG), so all
+ * benchmark runs use the same data sets
+ * @return pseudo random number
+ */
+static INLINE uint32_t
+benchmark_random(void) {
+  static uint64_t state = 0x853c49e6748fea9bull;
+
+  state = state * 6364136223846793005ull + 1442695040888963407ull;
+  return (uint32_t)(state >> 32);
+}
+
+/**
+ * Fill an array with a random permutation of 0 .. count-1
+ * (Fisher-Yates shuffle)
+ * @param order pointer to array
+ * @param count number of array elements
+ */
+static INLINE void
+benchmark_shuffle(uint32_t *order, uint32_t count) {
+  uint32_t i, j, tmp;
+
+  for (i = 0; i < count; i++) {
+    order[i] = i;
+  }
+  for (i = count; i > 1; i--) {
+    j = benchmark_random() % i;
+    tmp = order[i - 1];
+    order[i - 1] = order[j];
+    order[j] = tmp;
+  }
+}
+
+#endif /* BENCHMARK_COMMON_H_ */
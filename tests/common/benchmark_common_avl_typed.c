@@ -0,0 +1,249 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Benchmark comparing the generic avl functions with the specialized
+ * ones of avl_typed.h. Reports the average time per insert and
+ * per lookup for uint32 and netaddr keys, both for keys read through
+ * the key pointer and for keys read directly from the element.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/avl_typed.h"
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+#include "benchmark/benchmark_common.h"
+
+/**
+ * Element of the benchmark
+ */
+struct bench_element {
+  /*! uint32 key */
+  uint32_t value;
+
+  /*! netaddr key */
+  struct netaddr addr;
+
+  /*! node for avl tree */
+  struct avl_node node;
+};
+
+/**
+ * Variant of the avl functions used for a benchmark run
+ */
+enum bench_variant {
+  VARIANT_GENERIC,
+  VARIANT_TYPED,
+  VARIANT_MEMBER,
+};
+
+AVL_DEFINE_TYPED_MEMBER(bench_value, uint32_t, struct bench_element, node, value, avl_typed_cmp_uint32)
+AVL_DEFINE_TYPED_MEMBER(bench_addr, struct netaddr, struct bench_element, node, addr, netaddr_cmp)
+
+static const char *_variant_names[] = {
+  [VARIANT_GENERIC] = "generic",
+  [VARIANT_TYPED] = "typed",
+  [VARIANT_MEMBER] = "member",
+};
+
+static struct bench_element *_elements;
+static uint32_t *_order;
+
+static void
+_run_uint32(uint32_t count, enum bench_variant variant) {
+  struct avl_tree tree;
+  uint64_t start;
+  double insert, find;
+  uint32_t i;
+
+  avl_init(&tree, avl_comp_uint32, false);
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    _elements[i].node.key = &_elements[i].value;
+    switch (variant) {
+      case VARIANT_GENERIC:
+        avl_insert(&tree, &_elements[i].node);
+        break;
+      case VARIANT_TYPED:
+        avl_uint32_insert(&tree, &_elements[i].node);
+        break;
+      default:
+        avl_bench_value_insert(&tree, &_elements[i].node);
+        break;
+    }
+  }
+  insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  switch (variant) {
+    case VARIANT_GENERIC:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_find(&tree, &_elements[_order[i]].value) != NULL;
+      }
+      break;
+    case VARIANT_TYPED:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_uint32_find(&tree, &_elements[_order[i]].value) != NULL;
+      }
+      break;
+    default:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_bench_value_find(&tree, &_elements[_order[i]].value) != NULL;
+      }
+      break;
+  }
+  find = (double)(benchmark_get_ns() - start) / count;
+
+  for (i = 0; i < count; i++) {
+    avl_remove(&tree, &_elements[i].node);
+  }
+
+  printf("%-7s %-8s %7u %9.1f %9.1f\n", "uint32", _variant_names[variant], count, insert, find);
+}
+
+static void
+_run_netaddr(uint32_t count, enum bench_variant variant) {
+  struct avl_tree tree;
+  uint64_t start;
+  double insert, find;
+  uint32_t i;
+
+  avl_init(&tree, avl_comp_netaddr, false);
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    _elements[i].node.key = &_elements[i].addr;
+    switch (variant) {
+      case VARIANT_GENERIC:
+        avl_insert(&tree, &_elements[i].node);
+        break;
+      case VARIANT_TYPED:
+        avl_netaddr_insert(&tree, &_elements[i].node);
+        break;
+      default:
+        avl_bench_addr_insert(&tree, &_elements[i].node);
+        break;
+    }
+  }
+  insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  switch (variant) {
+    case VARIANT_GENERIC:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_find(&tree, &_elements[_order[i]].addr) != NULL;
+      }
+      break;
+    case VARIANT_TYPED:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_netaddr_find(&tree, &_elements[_order[i]].addr) != NULL;
+      }
+      break;
+    default:
+      for (i = 0; i < count; i++) {
+        benchmark_sink += avl_bench_addr_find(&tree, &_elements[_order[i]].addr) != NULL;
+      }
+      break;
+  }
+  find = (double)(benchmark_get_ns() - start) / count;
+
+  for (i = 0; i < count; i++) {
+    avl_remove(&tree, &_elements[i].node);
+  }
+
+  printf("%-7s %-8s %7u %9.1f %9.1f\n", "netaddr", _variant_names[variant], count, insert, find);
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  static const uint32_t sizes[] = { 1000, 10000, 100000, 1000000 };
+  const uint32_t max = sizes[ARRAYSIZE(sizes) - 1];
+  uint32_t i, r;
+  size_t s;
+  int v;
+
+  _elements = calloc(max, sizeof(*_elements));
+  _order = calloc(max, sizeof(*_order));
+  if (!_elements || !_order) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  for (i = 0; i < max; i++) {
+    /* bijective scramble keeps the keys unique */
+    _elements[i].value = i * 2654435761u;
+
+    /* fd00::/64 prefix, random interface identifier with unique tail */
+    _elements[i].addr._type = AF_INET6;
+    _elements[i].addr._prefix_len = 128;
+    _elements[i].addr._addr[0] = 0xfd;
+    r = benchmark_random();
+    memcpy(&_elements[i].addr._addr[8], &r, sizeof(r));
+    memcpy(&_elements[i].addr._addr[12], &i, sizeof(i));
+  }
+
+  printf("%-7s %-8s %7s %9s %9s\n", "key", "variant", "count", "insert", "find");
+
+  for (s = 0; s < ARRAYSIZE(sizes); s++) {
+    /* random lookup order */
+    benchmark_shuffle(_order, sizes[s]);
+
+    for (v = VARIANT_GENERIC; v <= VARIANT_MEMBER; v++) {
+      _run_uint32(sizes[s], v);
+    }
+    for (v = VARIANT_GENERIC; v <= VARIANT_MEMBER; v++) {
+      _run_netaddr(sizes[s], v);
+    }
+  }
+
+  free(_elements);
+  free(_order);
+  return 0;
+}
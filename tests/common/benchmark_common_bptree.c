@@ -0,0 +1,226 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Benchmark comparing the B+-tree with the avl tree for ordered
+ * containers. Reports the average time per insert, lookup, remove and
+ * per element of a full forward iteration that reads a field of each
+ * element.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/bptree.h"
+#include "common/common_types.h"
+
+#include "benchmark/benchmark_common.h"
+
+/**
+ * Element of the benchmark, can be stored in both containers
+ */
+struct bench_element {
+  /*! key of element */
+  uint32_t value;
+
+  /*! payload read during iteration */
+  uint32_t payload;
+
+  /*! node for avl tree */
+  struct avl_node avl;
+
+  /*! node for B+-tree */
+  struct bptree_node bptree;
+};
+
+/**
+ * Results of a benchmark run, all times in nanoseconds
+ */
+struct bench_result {
+  /*! average time per insert */
+  double insert;
+
+  /*! average time per lookup */
+  double find;
+
+  /*! average time per element of a full iteration */
+  double iterate;
+
+  /*! average time per remove */
+  double remove;
+};
+
+/*! number of full iterations per run */
+#define ITERATIONS 10
+
+static struct bench_element *_elements;
+static uint32_t *_order;
+
+static void
+_run_avl(uint32_t count, struct bench_result *result) {
+  struct avl_tree tree;
+  struct bench_element *el;
+  uint64_t start;
+  uint32_t i, sum;
+
+  avl_init(&tree, avl_comp_uint32, false);
+
+  /* insert in random order, so the nodes are spread over the heap */
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    avl_insert(&tree, &_elements[_order[i]].avl);
+  }
+  result->insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += avl_find(&tree, &_elements[i].value) != NULL;
+  }
+  result->find = (double)(benchmark_get_ns() - start) / count;
+
+  sum = 0;
+  start = benchmark_get_ns();
+  for (i = 0; i < ITERATIONS; i++) {
+    avl_for_each_element(&tree, el, avl) {
+      sum += el->payload;
+    }
+  }
+  result->iterate = (double)(benchmark_get_ns() - start) / count / ITERATIONS;
+  benchmark_sink += sum;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    avl_remove(&tree, &_elements[i].avl);
+  }
+  result->remove = (double)(benchmark_get_ns() - start) / count;
+}
+
+static void
+_run_bptree(uint32_t count, struct bench_result *result) {
+  struct bptree tree;
+  struct bench_element *el;
+  uint64_t start;
+  uint32_t i, sum;
+
+  bptree_init(&tree, avl_comp_uint32, false);
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    bptree_insert(&tree, &_elements[_order[i]].bptree);
+  }
+  result->insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += bptree_find(&tree, &_elements[i].value) != NULL;
+  }
+  result->find = (double)(benchmark_get_ns() - start) / count;
+
+  sum = 0;
+  start = benchmark_get_ns();
+  for (i = 0; i < ITERATIONS; i++) {
+    bptree_for_each_element(&tree, el, bptree) {
+      sum += el->payload;
+    }
+  }
+  result->iterate = (double)(benchmark_get_ns() - start) / count / ITERATIONS;
+  benchmark_sink += sum;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    bptree_remove(&tree, &_elements[i].bptree);
+  }
+  result->remove = (double)(benchmark_get_ns() - start) / count;
+}
+
+static void
+_print(const char *container, uint32_t count, struct bench_result *result) {
+  printf("%-6s %7u %9.1f %9.1f %9.1f %9.1f\n",
+      container, count, result->insert, result->find, result->iterate, result->remove);
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  static const uint32_t sizes[] = { 10000, 100000, 1000000 };
+  const uint32_t max = sizes[ARRAYSIZE(sizes) - 1];
+  struct bench_result result;
+  uint32_t i;
+  size_t s;
+
+  _elements = calloc(max, sizeof(*_elements));
+  _order = calloc(max, sizeof(*_order));
+  if (!_elements || !_order) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  /* shuffled keys, so key order does not match memory order */
+  benchmark_shuffle(_order, max);
+
+  for (i = 0; i < max; i++) {
+    _elements[i].value = _order[i];
+    _elements[i].payload = i;
+    _elements[i].avl.key = &_elements[i].value;
+    _elements[i].bptree.key = &_elements[i].value;
+  }
+
+  printf("%-6s %7s %9s %9s %9s %9s\n",
+      "type", "count", "insert", "find", "iterate", "remove");
+
+  for (s = 0; s < ARRAYSIZE(sizes); s++) {
+    benchmark_shuffle(_order, sizes[s]);
+
+    _run_avl(sizes[s], &result);
+    _print("avl", sizes[s], &result);
+
+    _run_bptree(sizes[s], &result);
+    _print("bptree", sizes[s], &result);
+  }
+
+  free(_elements);
+  free(_order);
+  return 0;
+}
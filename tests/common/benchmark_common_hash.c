@@ -0,0 +1,286 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Benchmark comparing the hash table with the avl tree for exact-match
+ * lookups. Reports the average time per insert, successful lookup,
+ * failed lookup and remove for uint32 and netaddr keys, and the
+ * longest single insert (which shows the effect of incremental
+ * resizing).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "common/hash_func.h"
+#include "common/netaddr.h"
+
+#include "benchmark/benchmark_common.h"
+
+/**
+ * Element of the benchmark, can be stored in both containers
+ */
+struct bench_element {
+  /*! uint32 key */
+  uint32_t value;
+
+  /*! netaddr key */
+  struct netaddr addr;
+
+  /*! node for avl tree */
+  struct avl_node avl;
+
+  /*! node for hash table */
+  struct hash_node hash;
+};
+
+/**
+ * Key type of a benchmark run
+ */
+enum bench_key {
+  KEY_UINT32,
+  KEY_NETADDR,
+};
+
+/**
+ * Results of a benchmark run, all times in nanoseconds
+ */
+struct bench_result {
+  /*! average time per insert */
+  double insert;
+
+  /*! average time per successful lookup */
+  double find_hit;
+
+  /*! average time per failed lookup */
+  double find_miss;
+
+  /*! average time per remove */
+  double remove;
+
+  /*! longest single insert */
+  uint64_t max_insert;
+};
+
+static struct bench_element *_elements;
+static struct bench_element *_missing;
+static uint32_t *_order;
+
+/**
+ * Initialize the elements with unique keys
+ * @param el pointer to element
+ * @param idx index of element
+ */
+static void
+_init_element(struct bench_element *el, uint32_t idx) {
+  uint32_t r;
+
+  memset(el, 0, sizeof(*el));
+
+  /* bijective scramble keeps the keys unique */
+  el->value = idx * 2654435761u;
+
+  /* fd00::/64 prefix, random interface identifier with unique tail */
+  el->addr._type = AF_INET6;
+  el->addr._prefix_len = 128;
+  el->addr._addr[0] = 0xfd;
+  r = benchmark_random();
+  memcpy(&el->addr._addr[8], &r, sizeof(r));
+  memcpy(&el->addr._addr[12], &idx, sizeof(idx));
+}
+
+static void
+_set_keys(struct bench_element *el, enum bench_key key_type) {
+  const void *key = key_type == KEY_UINT32 ? (const void *)&el->value : (const void *)&el->addr;
+
+  el->avl.key = key;
+  el->hash.key = key;
+}
+
+static void
+_run_avl(uint32_t count, enum bench_key key_type, struct bench_result *result) {
+  struct avl_tree tree;
+  uint64_t start, t1, t2;
+  uint32_t i;
+
+  avl_init(&tree, key_type == KEY_UINT32 ? avl_comp_uint32 : avl_comp_netaddr, false);
+
+  result->max_insert = 0;
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    t1 = benchmark_get_ns();
+    avl_insert(&tree, &_elements[i].avl);
+    t2 = benchmark_get_ns();
+    if (t2 - t1 > result->max_insert) {
+      result->max_insert = t2 - t1;
+    }
+  }
+  result->insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += avl_find(&tree, _elements[_order[i]].avl.key) != NULL;
+  }
+  result->find_hit = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += avl_find(&tree, _missing[_order[i]].avl.key) != NULL;
+  }
+  result->find_miss = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    avl_remove(&tree, &_elements[_order[i]].avl);
+  }
+  result->remove = (double)(benchmark_get_ns() - start) / count;
+}
+
+static void
+_run_hash(uint32_t count, enum bench_key key_type, struct bench_result *result) {
+  struct hash_table table;
+  uint64_t start, t1, t2;
+  uint32_t i;
+
+  if (key_type == KEY_UINT32) {
+    hash_init(&table, hash_func_uint32, avl_comp_uint32);
+  }
+  else {
+    hash_init(&table, hash_func_netaddr, avl_comp_netaddr);
+  }
+
+  result->max_insert = 0;
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    t1 = benchmark_get_ns();
+    hash_insert(&table, &_elements[i].hash);
+    t2 = benchmark_get_ns();
+    if (t2 - t1 > result->max_insert) {
+      result->max_insert = t2 - t1;
+    }
+  }
+  result->insert = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += hash_find(&table, _elements[_order[i]].hash.key) != NULL;
+  }
+  result->find_hit = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    benchmark_sink += hash_find(&table, _missing[_order[i]].hash.key) != NULL;
+  }
+  result->find_miss = (double)(benchmark_get_ns() - start) / count;
+
+  start = benchmark_get_ns();
+  for (i = 0; i < count; i++) {
+    hash_remove(&table, &_elements[_order[i]].hash);
+  }
+  result->remove = (double)(benchmark_get_ns() - start) / count;
+
+  hash_free(&table);
+}
+
+static void
+_print(const char *container, enum bench_key key_type, uint32_t count,
+    struct bench_result *result) {
+  printf("%-4s %-7s %7u %9.1f %9.1f %9.1f %9.1f %10.1f\n",
+      container, key_type == KEY_UINT32 ? "uint32" : "netaddr", count,
+      result->insert, result->find_hit, result->find_miss, result->remove,
+      (double)result->max_insert / 1000.0);
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  static const uint32_t sizes[] = { 10000, 100000, 1000000 };
+  static const enum bench_key keys[] = { KEY_UINT32, KEY_NETADDR };
+  const uint32_t max = sizes[ARRAYSIZE(sizes) - 1];
+  struct bench_result result;
+  uint32_t i;
+  size_t k, s;
+
+  _elements = calloc(max, sizeof(*_elements));
+  _missing = calloc(max, sizeof(*_missing));
+  _order = calloc(max, sizeof(*_order));
+  if (!_elements || !_missing || !_order) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  for (i = 0; i < max; i++) {
+    _init_element(&_elements[i], i);
+    _init_element(&_missing[i], i + max);
+  }
+
+  printf("%-4s %-7s %7s %9s %9s %9s %9s %10s\n",
+      "type", "key", "count", "insert", "find", "miss", "remove", "max_us");
+
+  for (k = 0; k < ARRAYSIZE(keys); k++) {
+    for (i = 0; i < max; i++) {
+      _set_keys(&_elements[i], keys[k]);
+      _set_keys(&_missing[i], keys[k]);
+    }
+
+    for (s = 0; s < ARRAYSIZE(sizes); s++) {
+      /* random lookup and remove order */
+      benchmark_shuffle(_order, sizes[s]);
+
+      _run_avl(sizes[s], keys[k], &result);
+      _print("avl", keys[k], sizes[s], &result);
+
+      _run_hash(sizes[s], keys[k], &result);
+      _print("hash", keys[k], sizes[s], &result);
+    }
+  }
+
+  free(_elements);
+  free(_missing);
+  free(_order);
+  return 0;
+}
@@ -0,0 +1,237 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark for the netaddr comparison kernels. Compares the
+ * byte-wise reference implementation, the scalar kernels and the
+ * kernels selected at compile time for address pairs which differ
+ * early and for address pairs with a long common prefix.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "common/netaddr_kernel.h"
+
+#include "benchmark/benchmark_common.h"
+
+/* number of address pairs per data set, fits into the L1 cache */
+#define PAIR_COUNT 512
+
+/* number of kernel calls per measurement */
+#define CALLS_PER_RUN 50000000ull
+
+/**
+ * Data set of address pairs
+ */
+struct bench_pairs {
+  /*! name of data set */
+  const char *name;
+
+  /*! first address of each pair */
+  struct netaddr a1[PAIR_COUNT];
+
+  /*! second address of each pair */
+  struct netaddr a2[PAIR_COUNT];
+};
+
+static struct bench_pairs _random_pairs = { .name = "random" };
+static struct bench_pairs _prefix_pairs = { .name = "prefix" };
+
+/**
+ * Runs an expression on all address pairs of a data set
+ * and prints the time per call.
+ * @param pairs pointer to data set
+ * @param op name of the measured operation
+ * @param variant name of the measured implementation
+ * @param expr expression to be measured, can use p1 and p2
+ */
+#define BENCH_RUN(pairs, op, variant, expr) do { \
+  uint64_t _start, _end, _r; \
+  const struct netaddr *p1, *p2; \
+  size_t _i; \
+  int _sum = 0; \
+  _start = benchmark_get_ns(); \
+  for (_r = 0; _r < CALLS_PER_RUN / PAIR_COUNT; _r++) { \
+    for (_i = 0; _i < PAIR_COUNT; _i++) { \
+      p1 = &(pairs)->a1[_i]; \
+      p2 = &(pairs)->a2[_i]; \
+      _sum += (expr); \
+    } \
+  } \
+  _end = benchmark_get_ns(); \
+  benchmark_sink = _sum; \
+  printf("%-13s %-7s %-9s %8.2f\n", op, (pairs)->name, variant, \
+      (double)(_end - _start) / (double)CALLS_PER_RUN); \
+} while (0)
+
+/**
+ * Byte-wise common prefix length, reference for the kernels
+ * @param a1 pointer to 16 byte address
+ * @param a2 pointer to 16 byte address
+ * @return common prefix length in bits
+ */
+static int
+_bytewise_common_prefix(const uint8_t *a1, const uint8_t *a2) {
+  int i, bit;
+
+  for (i = 0; i < NETADDR_KERNEL_LENGTH; i++) {
+    if (a1[i] != a2[i]) {
+      for (bit = 0; bit < 8; bit++) {
+        if ((a1[i] ^ a2[i]) & (0x80 >> bit)) {
+          break;
+        }
+      }
+      return i * 8 + bit;
+    }
+  }
+  return 128;
+}
+
+/**
+ * Byte-wise subnet test, this was netaddr_is_in_subnet() before
+ * the kernels were introduced.
+ * @param subnet netaddr prefix
+ * @param addr netaddr address
+ * @return true if addr is inside subnet
+ */
+static bool
+_bytewise_is_in_subnet(const struct netaddr *subnet, const struct netaddr *addr) {
+  size_t byte_length, bit_length;
+
+  if (subnet->_type != addr->_type) {
+    return false;
+  }
+
+  byte_length = subnet->_prefix_len / 8;
+  bit_length = subnet->_prefix_len % 8;
+
+  if (memcmp(subnet->_addr, addr->_addr, byte_length) != 0) {
+    return false;
+  }
+  if (bit_length != 0) {
+    return (subnet->_addr[byte_length] >> (8 - bit_length))
+        == (addr->_addr[byte_length] >> (8 - bit_length));
+  }
+  return true;
+}
+
+/**
+ * Fill a data set with IPv6 address pairs
+ * @param pairs pointer to data set
+ * @param min_prefix minimal common prefix length of each pair
+ */
+static void
+_init_pairs(struct bench_pairs *pairs, int min_prefix) {
+  size_t i, j;
+  int bit;
+
+  for (i = 0; i < PAIR_COUNT; i++) {
+    for (j = 0; j < NETADDR_KERNEL_LENGTH; j++) {
+      pairs->a1[i]._addr[j] = (uint8_t)benchmark_random();
+    }
+    pairs->a1[i]._type = AF_INET6;
+    pairs->a1[i]._prefix_len = 128;
+
+    memcpy(&pairs->a2[i], &pairs->a1[i], sizeof(pairs->a2[i]));
+
+    /* first differing bit, some pairs are equal */
+    bit = min_prefix + benchmark_random() % (129 - min_prefix);
+    if (bit < 128) {
+      pairs->a2[i]._addr[bit / 8] ^= 0x80 >> (bit % 8);
+    }
+
+    /* use the pair as subnet / address for the subnet test */
+    pairs->a1[i]._prefix_len = min_prefix + benchmark_random() % (129 - min_prefix);
+  }
+}
+
+static void
+_run(struct bench_pairs *pairs) {
+  BENCH_RUN(pairs, "isequal", "memcmp",
+      memcmp(p1->_addr, p2->_addr, 16) == 0);
+  BENCH_RUN(pairs, "isequal", "scalar",
+      netaddr_kernel_scalar_isequal(p1->_addr, p2->_addr));
+  BENCH_RUN(pairs, "isequal", NETADDR_KERNEL_NAME,
+      netaddr_kernel_isequal(p1->_addr, p2->_addr));
+
+  BENCH_RUN(pairs, "cmp", "memcmp",
+      memcmp(p1, p2, sizeof(*p1)) < 0);
+  BENCH_RUN(pairs, "cmp", "scalar",
+      netaddr_kernel_scalar_cmp(p1->_addr, p2->_addr) < 0);
+  BENCH_RUN(pairs, "cmp", NETADDR_KERNEL_NAME,
+      netaddr_cmp(p1, p2) < 0);
+
+  BENCH_RUN(pairs, "common_prefix", "bytewise",
+      _bytewise_common_prefix(p1->_addr, p2->_addr));
+  BENCH_RUN(pairs, "common_prefix", "scalar",
+      netaddr_kernel_scalar_common_prefix(p1->_addr, p2->_addr));
+  BENCH_RUN(pairs, "common_prefix", NETADDR_KERNEL_NAME,
+      netaddr_get_common_prefix(p1, p2));
+
+  BENCH_RUN(pairs, "in_subnet", "bytewise",
+      _bytewise_is_in_subnet(p1, p2));
+  BENCH_RUN(pairs, "in_subnet", "scalar",
+      p1->_type == p2->_type
+      && netaddr_kernel_scalar_common_prefix(p1->_addr, p2->_addr) >= p1->_prefix_len);
+  BENCH_RUN(pairs, "in_subnet", NETADDR_KERNEL_NAME,
+      p1->_type == p2->_type
+      && netaddr_kernel_is_in_prefix(p1->_addr, p2->_addr, p1->_prefix_len));
+  BENCH_RUN(pairs, "in_subnet", "api",
+      netaddr_is_in_subnet(p1, p2));
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  _init_pairs(&_random_pairs, 0);
+  _init_pairs(&_prefix_pairs, 64);
+
+  printf("netaddr kernels: %s\n", NETADDR_KERNEL_NAME);
+  printf("%-13s %-7s %-9s %8s\n", "operation", "pairs", "variant", "ns/call");
+  _run(&_random_pairs);
+  _run(&_prefix_pairs);
+  return 0;
+}
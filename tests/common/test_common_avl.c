@@ -49,6 +49,7 @@
 
 #include "common/avl.h"
 #include "common/avl_comp.h"
+#include "common/avl_typed.h"
 #include "cunit/cunit.h"
 
 struct tree_element {
@@ -56,6 +57,8 @@ struct tree_element {
   struct avl_node node;
 };
 
+AVL_DEFINE_TYPED_MEMBER(value, uint32_t, struct tree_element, node, value, avl_typed_cmp_uint32)
+
 #define COUNT 6
 
 static struct avl_tree head;
@@ -861,6 +864,109 @@ static void test_random_insert(void) {
   END_TEST();
 }
 
+/* insert random numbers with the specialized functions and compare with the generic ones */
+static void test_typed_functions(void) {
+  struct tree_element *elements, *e, *prev;
+  struct tree_element dup;
+  uint32_t i, count;
+
+  srand(1);
+  START_TEST();
+  avl_init(&head, avl_comp_uint32, true);
+
+  count = 2000;
+  elements = calloc(count, sizeof(*elements));
+
+  for (i=0; i<count; i++) {
+    /* small range to get duplicates */
+    elements[i].value = (uint32_t)rand() % 1000;
+    elements[i].node.key = &elements[i].value;
+    if (i & 1) {
+      CHECK_TRUE(avl_value_insert(&head, &elements[i].node) == 0, "cannot insert element %u", i);
+    }
+    else {
+      CHECK_TRUE(avl_uint32_insert(&head, &elements[i].node) == 0, "cannot insert element %u", i);
+    }
+  }
+  check_tree(__func__, __LINE__);
+
+  prev = NULL;
+  avl_for_each_element(&head, e, node) {
+    CHECK_TRUE(prev == NULL || prev->value <= e->value, "tree not sorted");
+    prev = e;
+  }
+
+  for (i=0; i<1100; i++) {
+    e = avl_find_element(&head, &i, e, node);
+    CHECK_TRUE(avl_typed_find_element(value, &head, &i, e, node) == e,
+        "typed find of member key %u differs", i);
+    CHECK_TRUE(avl_typed_find_element(uint32, &head, &i, e, node) == e,
+        "typed find of key %u differs", i);
+  }
+
+  /* duplicates are rejected if not allowed */
+  head.allow_dups = false;
+  memset(&dup, 0, sizeof(dup));
+  dup.value = elements[1].value;
+  dup.node.key = &dup.value;
+  CHECK_TRUE(avl_value_insert(&head, &dup.node) != 0, "duplicate inserted");
+  CHECK_TRUE(avl_uint32_insert(&head, &dup.node) != 0, "duplicate inserted");
+
+  for (i=0; i<count; i+=2) {
+    avl_remove(&head, &elements[i].node);
+  }
+  check_tree(__func__, __LINE__);
+  CHECK_TRUE(head.count == count / 2, "wrong number of elements: %u", head.count);
+
+  free(elements);
+  END_TEST();
+}
+
+static void test_typed_netaddr(void) {
+  struct netaddr_element {
+    struct netaddr addr;
+    struct avl_node node;
+  } elements[500], dup, *e, *prev;
+  uint32_t i, j;
+
+  srand(2);
+  START_TEST();
+  avl_init(&head, avl_comp_netaddr, false);
+
+  memset(elements, 0, sizeof(elements));
+  for (i=0; i<ARRAYSIZE(elements); i++) {
+    /* mix address families and prefix lengths with a shared prefix */
+    elements[i].addr._type = (i % 3) ? AF_INET6 : AF_INET;
+    elements[i].addr._prefix_len = (i % 3) ? 128 : 32;
+    elements[i].addr._addr[0] = 0xfd;
+    for (j=12; j<16; j++) {
+      elements[i].addr._addr[j] = (uint8_t)rand();
+    }
+    elements[i].addr._addr[11] = (uint8_t)i;
+    elements[i].addr._addr[10] = (uint8_t)(i >> 8);
+    elements[i].node.key = &elements[i].addr;
+    CHECK_TRUE(avl_netaddr_insert(&head, &elements[i].node) == 0, "cannot insert address %u", i);
+  }
+
+  prev = NULL;
+  avl_for_each_element(&head, e, node) {
+    CHECK_TRUE(prev == NULL || avl_comp_netaddr(&prev->addr, &e->addr) < 0, "tree not sorted");
+    prev = e;
+  }
+
+  for (i=0; i<ARRAYSIZE(elements); i++) {
+    CHECK_TRUE(avl_typed_find_element(netaddr, &head, &elements[i].addr, e, node) == &elements[i],
+        "cannot find address %u", i);
+
+    memcpy(&dup.addr, &elements[i].addr, sizeof(dup.addr));
+    dup.node.key = &dup.addr;
+    CHECK_TRUE(avl_netaddr_insert(&head, &dup.node) != 0, "duplicate address %u inserted", i);
+  }
+  CHECK_TRUE(head.count == ARRAYSIZE(elements), "wrong number of elements: %u", head.count);
+
+  END_TEST();
+}
+
 static void do_tests(bool do_random) {
   printf("Do %srandom tests.\n", do_random ? "" : "non ");
 
@@ -887,6 +993,8 @@ int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))
   do_tests(true);
   test_random_insert();
   test_for_each_key_macros();
+  test_typed_functions();
+  test_typed_netaddr();
 
   return FINISH_TESTING();
 }
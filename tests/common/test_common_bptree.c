@@ -0,0 +1,334 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/avl_comp.h"
+#include "common/bptree.h"
+#include "cunit/cunit.h"
+
+struct tree_element {
+  uint32_t value;
+  struct bptree_node node;
+};
+
+#define COUNT 5000
+
+static struct bptree _tree;
+static struct tree_element _elements[COUNT];
+
+static void
+clear_elements(void) {
+  uint32_t i;
+
+  bptree_init(&_tree, avl_comp_uint32, false);
+
+  memset(_elements, 0, sizeof(_elements));
+  for (i = 0; i < COUNT; i++) {
+    _elements[i].value = i;
+    _elements[i].node.key = &_elements[i].value;
+  }
+}
+
+/**
+ * Check the structure of a subtree
+ * @param block root of subtree
+ * @param parent expected parent of block
+ * @param depth depth of block
+ * @param leaf_depth pointer to depth of leaves, -1 if not known yet
+ * @param min pointer to storage for smallest key of subtree
+ * @return number of nodes in subtree
+ */
+static uint32_t
+_check_block(const struct bptree_block *block, const struct bptree_inner *parent,
+    int depth, int *leaf_depth, const void **min, uint32_t line) {
+  const struct bptree_inner *inner;
+  const struct bptree_leaf *leaf;
+  const void *child_min;
+  uint32_t i, count;
+
+  CHECK_NAMED_TRUE(block->parent == parent, "check_tree", line, "bad parent pointer at depth %d", depth);
+
+  if (block->is_leaf) {
+    leaf = (const struct bptree_leaf *)block;
+
+    if (*leaf_depth == -1) {
+      *leaf_depth = depth;
+    }
+    CHECK_NAMED_TRUE(*leaf_depth == depth, "check_tree", line, "leaf at depth %d instead of %d", depth, *leaf_depth);
+    CHECK_NAMED_TRUE(block->count > 0 && block->count <= BPTREE_LEAF_SIZE, "check_tree", line,
+        "leaf with %u elements", block->count);
+
+    for (i = 0; i < block->count; i++) {
+      CHECK_NAMED_TRUE(leaf->nodes[i]->_leaf == leaf && leaf->nodes[i]->_idx == i, "check_tree", line,
+          "bad position of node %u", i);
+      CHECK_NAMED_TRUE(leaf->keys[i] == leaf->nodes[i]->key, "check_tree", line, "bad key pointer %u", i);
+      CHECK_NAMED_TRUE(i == 0 || _tree.comp(leaf->keys[i - 1], leaf->keys[i]) < 0, "check_tree", line,
+          "keys of leaf not sorted at %u", i);
+    }
+    *min = leaf->keys[0];
+    return block->count;
+  }
+
+  inner = (const struct bptree_inner *)block;
+  CHECK_NAMED_TRUE(block->count >= 2 && block->count <= BPTREE_INNER_SIZE, "check_tree", line,
+      "inner node with %u children", block->count);
+
+  count = 0;
+  for (i = 0; i < block->count; i++) {
+    count += _check_block(inner->children[i], inner, depth + 1, leaf_depth, &child_min, line);
+    if (i == 0) {
+      *min = child_min;
+    }
+    else {
+      CHECK_NAMED_TRUE(inner->keys[i - 1] == child_min, "check_tree", line,
+          "separator %u does not point to smallest key of child", i - 1);
+    }
+  }
+  return count;
+}
+
+static void
+_check_tree(const bool *present, uint32_t line) {
+  struct tree_element *e, *prev;
+  int leaf_depth = -1;
+  const void *min;
+  uint32_t i, count;
+
+  count = 0;
+  for (i = 0; i < COUNT; i++) {
+    CHECK_NAMED_TRUE(bptree_is_node_added(&_elements[i].node) == present[i], "check_tree", line,
+        "element %u should %sbe in tree", i, present[i] ? "" : "not ");
+    e = bptree_find_element(&_tree, &_elements[i].value, e, node);
+    CHECK_NAMED_TRUE(present[i] ? e == &_elements[i] : e == NULL, "check_tree", line,
+        "find of element %u failed", i);
+    if (present[i]) {
+      count++;
+    }
+  }
+  CHECK_NAMED_TRUE(_tree.count == count, "check_tree", line, "tree count is %u instead of %u", _tree.count, count);
+
+  if (_tree.root) {
+    CHECK_NAMED_TRUE(_check_block(_tree.root, NULL, 0, &leaf_depth, &min, line) == count, "check_tree", line,
+        "wrong number of nodes in tree");
+  }
+  else {
+    CHECK_NAMED_TRUE(count == 0 && _tree.first == NULL && _tree.last == NULL, "check_tree", line,
+        "empty tree has leaves");
+  }
+
+  /* forward and backward iteration return all present elements in order */
+  i = 0;
+  prev = NULL;
+  bptree_for_each_element(&_tree, e, node) {
+    CHECK_NAMED_TRUE(prev == NULL || prev->value < e->value, "check_tree", line, "iteration not sorted");
+    prev = e;
+    i++;
+  }
+  CHECK_NAMED_TRUE(i == count, "check_tree", line, "iteration returned %u instead of %u elements", i, count);
+
+  i = 0;
+  prev = NULL;
+  bptree_for_each_element_reverse(&_tree, e, node) {
+    CHECK_NAMED_TRUE(prev == NULL || prev->value > e->value, "check_tree", line, "reverse iteration not sorted");
+    prev = e;
+    i++;
+  }
+  CHECK_NAMED_TRUE(i == count, "check_tree", line, "reverse iteration returned %u instead of %u elements", i, count);
+}
+
+static void
+test_insert_remove(void) {
+  bool present[COUNT];
+  uint32_t i;
+
+  START_TEST();
+
+  memset(present, 0, sizeof(present));
+  _check_tree(present, __LINE__);
+
+  /* ascending, descending and interleaved insert order */
+  for (i = 0; i < COUNT; i += 3) {
+    CHECK_TRUE(bptree_insert(&_tree, &_elements[i].node) == 0, "insert of %u failed", i);
+    present[i] = true;
+  }
+  _check_tree(present, __LINE__);
+
+  for (i = COUNT; i-- > 0;) {
+    if (i % 3 == 1) {
+      CHECK_TRUE(bptree_insert(&_tree, &_elements[i].node) == 0, "insert of %u failed", i);
+      present[i] = true;
+    }
+  }
+  _check_tree(present, __LINE__);
+
+  for (i = 2; i < COUNT; i += 3) {
+    CHECK_TRUE(bptree_insert(&_tree, &_elements[i].node) == 0, "insert of %u failed", i);
+    present[i] = true;
+  }
+  _check_tree(present, __LINE__);
+
+  CHECK_TRUE(bptree_is_first(&_tree, &_elements[0].node), "element 0 is not first");
+  CHECK_TRUE(bptree_is_last(&_tree, &_elements[COUNT - 1].node), "last element is not last");
+
+  for (i = 0; i < COUNT; i += 2) {
+    bptree_remove(&_tree, &_elements[i].node);
+    present[i] = false;
+  }
+  _check_tree(present, __LINE__);
+
+  for (i = COUNT; i-- > 0;) {
+    if (present[i]) {
+      bptree_remove(&_tree, &_elements[i].node);
+      present[i] = false;
+    }
+  }
+  _check_tree(present, __LINE__);
+  CHECK_TRUE(bptree_is_empty(&_tree), "tree is not empty");
+
+  END_TEST();
+}
+
+static void
+test_random_operations(void) {
+  bool present[COUNT];
+  uint32_t i, idx, round;
+
+  START_TEST();
+
+  memset(present, 0, sizeof(present));
+  srand(4711);
+
+  for (round = 0; round < 10; round++) {
+    for (i = 0; i < COUNT * 2; i++) {
+      /* bias the operations to grow or shrink the tree */
+      idx = rand() % COUNT;
+      if (present[idx] && (rand() % 4 != 0) == (round & 1)) {
+        bptree_remove(&_tree, &_elements[idx].node);
+        present[idx] = false;
+      }
+      else if (!present[idx]) {
+        CHECK_TRUE(bptree_insert(&_tree, &_elements[idx].node) == 0, "insert of %u failed", idx);
+        present[idx] = true;
+      }
+    }
+    _check_tree(present, __LINE__);
+  }
+
+  for (i = 0; i < COUNT; i++) {
+    if (present[i]) {
+      bptree_remove(&_tree, &_elements[i].node);
+      present[i] = false;
+    }
+  }
+  _check_tree(present, __LINE__);
+
+  END_TEST();
+}
+
+static void
+test_find_ge_le_dups(void) {
+  struct tree_element *e, *ptr;
+  struct tree_element dup;
+  uint32_t i, key;
+
+  START_TEST();
+
+  /* only even values */
+  for (i = 0; i < COUNT; i += 2) {
+    bptree_insert(&_tree, &_elements[i].node);
+  }
+
+  for (key = 0; key < COUNT + 2; key++) {
+    e = bptree_find_ge_element(&_tree, &key, e, node);
+    if (key <= COUNT - 2) {
+      CHECK_TRUE(e != NULL && e->value == ((key + 1) & ~1u), "find_ge(%u) returned %d", key, e ? (int)e->value : -1);
+    }
+    else {
+      CHECK_TRUE(e == NULL, "find_ge(%u) returned an element", key);
+    }
+
+    e = bptree_find_le_element(&_tree, &key, e, node);
+    CHECK_TRUE(e != NULL && e->value == (key < COUNT ? key & ~1u : COUNT - 2),
+        "find_le(%u) returned %d", key, e ? (int)e->value : -1);
+  }
+
+  /* duplicate keys are rejected unless allowed */
+  memset(&dup, 0, sizeof(dup));
+  dup.value = 100;
+  dup.node.key = &dup.value;
+  CHECK_TRUE(bptree_insert(&_tree, &dup.node) != 0, "duplicate inserted");
+  CHECK_TRUE(!bptree_is_node_added(&dup.node), "duplicate node marked as added");
+
+  _tree.allow_dups = true;
+  CHECK_TRUE(bptree_insert(&_tree, &dup.node) == 0, "duplicate not inserted");
+  e = bptree_find_element(&_tree, &dup.value, e, node);
+  CHECK_TRUE(e == &_elements[100], "find does not return first duplicate");
+  CHECK_TRUE(bptree_next_element(e, node) == &dup, "duplicate is not behind first one");
+
+  /* remove everything with the safe loop */
+  i = 0;
+  bptree_for_each_element_safe(&_tree, e, node, ptr) {
+    bptree_remove(&_tree, &e->node);
+    i++;
+  }
+  CHECK_TRUE(i == COUNT / 2 + 1, "safe loop returned %u elements", i);
+  CHECK_TRUE(bptree_is_empty(&_tree) && _tree.root == NULL, "tree is not empty");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_remove();
+  test_random_operations();
+  test_find_ge_le_dups();
+
+  return FINISH_TESTING();
+}
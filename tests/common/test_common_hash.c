@@ -0,0 +1,296 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/avl_comp.h"
+#include "common/hash.h"
+#include "common/hash_func.h"
+#include "common/netaddr.h"
+#include "cunit/cunit.h"
+
+struct hash_element {
+  uint32_t value;
+  struct hash_node node;
+};
+
+struct addr_element {
+  struct netaddr addr;
+  struct hash_node node;
+};
+
+#define COUNT 5000
+
+static struct hash_table _table;
+static struct hash_element _elements[COUNT];
+
+static void
+clear_elements(void) {
+  uint32_t i;
+
+  hash_free(&_table);
+  hash_init(&_table, hash_func_uint32, avl_comp_uint32);
+
+  memset(_elements, 0, sizeof(_elements));
+  for (i = 0; i < COUNT; i++) {
+    _elements[i].value = i * 7;
+    _elements[i].node.key = &_elements[i].value;
+  }
+}
+
+/**
+ * Check that all elements with 'present' set (and only those)
+ * can be found in the table
+ */
+static void
+_check_table(const bool *present, uint32_t line) {
+  struct hash_element *e;
+  uint32_t i, count, key;
+
+  count = 0;
+  for (i = 0; i < COUNT; i++) {
+    e = hash_find_element(&_table, &_elements[i].value, e, node);
+    CHECK_NAMED_TRUE(present[i] ? e == &_elements[i] : e == NULL, "check_table", line,
+        "element %u should %sbe in table", i, present[i] ? "" : "not ");
+
+    /* a key between two elements is never in the table */
+    key = _elements[i].value + 3;
+    CHECK_NAMED_TRUE(hash_find(&_table, &key) == NULL, "check_table", line,
+        "key %u should not be in table", key);
+
+    if (present[i]) {
+      count++;
+    }
+  }
+  CHECK_NAMED_TRUE(_table.count == count, "check_table", line,
+      "table count is %u instead of %u", _table.count, count);
+
+  i = 0;
+  hash_for_each_element(&_table, e, node) {
+    i++;
+  }
+  CHECK_NAMED_TRUE(i == count, "check_table", line,
+      "iteration returned %u instead of %u elements", i, count);
+}
+
+static void
+test_insert_find_remove(void) {
+  struct hash_element dup, *e;
+  bool present[COUNT], migrated;
+  uint32_t i;
+
+  START_TEST();
+
+  memset(present, 0, sizeof(present));
+  _check_table(present, __LINE__);
+
+  migrated = false;
+  for (i = 0; i < COUNT; i++) {
+    CHECK_TRUE(hash_insert(&_table, &_elements[i].node) == 0, "insert of %u failed", i);
+    CHECK_TRUE(hash_is_node_added(&_elements[i].node), "node %u is not marked as added", i);
+    present[i] = true;
+    migrated |= _table._old_slots != NULL;
+
+    /* check a few lookups while the table is resized */
+    CHECK_TRUE(hash_find(&_table, &_elements[i / 2].value) == &_elements[i / 2].node,
+        "element %u not found after insert of %u", i / 2, i);
+  }
+  _check_table(present, __LINE__);
+  CHECK_TRUE(migrated, "table was never resized incrementally");
+
+  /* insertion order is kept */
+  i = 0;
+  hash_for_each_element(&_table, e, node) {
+    CHECK_TRUE(e == &_elements[i], "iteration returned element %u at position %u",
+        (unsigned)(e - _elements), i);
+    i++;
+  }
+
+  /* duplicates are rejected */
+  memset(&dup, 0, sizeof(dup));
+  dup.value = _elements[17].value;
+  dup.node.key = &dup.value;
+  CHECK_TRUE(hash_insert(&_table, &dup.node) != 0, "duplicate key was inserted");
+  CHECK_TRUE(!hash_is_node_added(&dup.node), "duplicate node is marked as added");
+  CHECK_TRUE(hash_find(&_table, &dup.value) == &_elements[17].node, "duplicate replaced original");
+
+  for (i = 1; i < COUNT; i += 2) {
+    hash_remove(&_table, &_elements[i].node);
+    CHECK_TRUE(!hash_is_node_added(&_elements[i].node), "node %u is still marked as added", i);
+    present[i] = false;
+  }
+  _check_table(present, __LINE__);
+
+  for (i = 0; i < COUNT; i += 2) {
+    hash_remove(&_table, &_elements[i].node);
+    present[i] = false;
+
+    CHECK_TRUE(i + 2 >= COUNT || hash_find(&_table, &_elements[i + 2].value) == &_elements[i + 2].node,
+        "element %u not found after remove of %u", i + 2, i);
+  }
+  _check_table(present, __LINE__);
+  CHECK_TRUE(hash_is_empty(&_table), "table is not empty");
+
+  END_TEST();
+}
+
+static void
+test_random_operations(void) {
+  bool present[COUNT];
+  uint32_t i, idx, round;
+
+  START_TEST();
+
+  memset(present, 0, sizeof(present));
+  srand(42);
+
+  /* interleave inserts and removes to test incremental resizing with tombstones */
+  for (round = 0; round < 20; round++) {
+    for (i = 0; i < COUNT; i++) {
+      idx = rand() % COUNT;
+
+      if (present[idx]) {
+        hash_remove(&_table, &_elements[idx].node);
+        present[idx] = false;
+      }
+      else {
+        CHECK_TRUE(hash_insert(&_table, &_elements[idx].node) == 0, "insert of %u failed", idx);
+        present[idx] = true;
+      }
+    }
+    _check_table(present, __LINE__);
+
+    /* grow or shrink the table */
+    for (i = 0; i < COUNT; i++) {
+      if ((round & 1) == 0 && present[i]) {
+        hash_remove(&_table, &_elements[i].node);
+        present[i] = false;
+      }
+      else if ((round & 1) == 1 && !present[i] && (i & 3) == 0) {
+        CHECK_TRUE(hash_insert(&_table, &_elements[i].node) == 0, "insert of %u failed", i);
+        present[i] = true;
+      }
+    }
+    _check_table(present, __LINE__);
+  }
+
+  END_TEST();
+}
+
+static void
+test_for_each_safe(void) {
+  struct hash_element *e, *ptr;
+  uint32_t i;
+
+  START_TEST();
+
+  for (i = 0; i < COUNT; i++) {
+    hash_insert(&_table, &_elements[i].node);
+  }
+
+  i = 0;
+  hash_for_each_element_safe(&_table, e, node, ptr) {
+    hash_remove(&_table, &e->node);
+    i++;
+  }
+  CHECK_TRUE(i == COUNT, "safe iteration returned %u instead of %u elements", i, COUNT);
+  CHECK_TRUE(hash_is_empty(&_table), "table is not empty");
+  CHECK_TRUE(hash_first_element_safe(&_table, e, node) == NULL, "first element of empty table");
+
+  END_TEST();
+}
+
+static void
+test_netaddr_keys(void) {
+  static struct addr_element addrs[256];
+  struct addr_element *e;
+  struct netaddr key;
+  struct hash_table table;
+  uint32_t i;
+
+  START_TEST();
+
+  hash_init(&table, hash_func_netaddr, avl_comp_netaddr);
+
+  for (i = 0; i < 256; i++) {
+    /* same binary address with different prefix lengths and types */
+    memset(&addrs[i].addr, 0, sizeof(addrs[i].addr));
+    addrs[i].addr._addr[0] = 10;
+    addrs[i].addr._addr[3] = i & 63;
+    addrs[i].addr._type = (i & 64) ? AF_INET6 : AF_INET;
+    addrs[i].addr._prefix_len = (i & 128) ? 24 : 32;
+
+    addrs[i].node.key = &addrs[i].addr;
+    CHECK_TRUE(hash_insert(&table, &addrs[i].node) == 0, "insert of address %u failed", i);
+  }
+
+  for (i = 0; i < 256; i++) {
+    memcpy(&key, &addrs[i].addr, sizeof(key));
+    e = hash_find_element(&table, &key, e, node);
+    CHECK_TRUE(e == &addrs[i], "address %u not found", i);
+  }
+
+  hash_free(&table);
+  CHECK_TRUE(hash_is_empty(&table), "table is not empty after hash_free()");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  hash_init(&_table, hash_func_uint32, avl_comp_uint32);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_find_remove();
+  test_random_operations();
+  test_for_each_safe();
+  test_netaddr_keys();
+
+  hash_free(&_table);
+  return FINISH_TESTING();
+}
@@ -362,6 +362,89 @@ test_netaddr_is_in_subnet(void) {
   END_TEST();
 }
 
+static int
+_sign(int value) {
+  return (value > 0) - (value < 0);
+}
+
+static void
+_check_kernels(const uint8_t *a1, const uint8_t *a2, int prefix) {
+  int sign;
+
+  sign = _sign(memcmp(a1, a2, NETADDR_KERNEL_LENGTH));
+
+  CHECK_TRUE(_sign(netaddr_kernel_scalar_cmp(a1, a2)) == sign,
+      "scalar cmp (prefix %d)", prefix);
+  CHECK_TRUE(_sign(netaddr_kernel_cmp(a1, a2)) == sign,
+      "%s cmp (prefix %d)", NETADDR_KERNEL_NAME, prefix);
+
+  CHECK_TRUE(netaddr_kernel_scalar_isequal(a1, a2) == (sign == 0),
+      "scalar isequal (prefix %d)", prefix);
+  CHECK_TRUE(netaddr_kernel_isequal(a1, a2) == (sign == 0),
+      "%s isequal (prefix %d)", NETADDR_KERNEL_NAME, prefix);
+
+  CHECK_TRUE(netaddr_kernel_scalar_common_prefix(a1, a2) == prefix,
+      "scalar common prefix %d != %d",
+      netaddr_kernel_scalar_common_prefix(a1, a2), prefix);
+  CHECK_TRUE(netaddr_kernel_common_prefix(a1, a2) == prefix,
+      "%s common prefix %d != %d", NETADDR_KERNEL_NAME,
+      netaddr_kernel_common_prefix(a1, a2), prefix);
+
+  CHECK_TRUE(netaddr_kernel_is_in_prefix(a1, a2, prefix),
+      "%s is_in_prefix %d", NETADDR_KERNEL_NAME, prefix);
+  if (prefix < 128) {
+    CHECK_TRUE(!netaddr_kernel_is_in_prefix(a1, a2, prefix + 1),
+        "%s !is_in_prefix %d", NETADDR_KERNEL_NAME, prefix + 1);
+  }
+}
+
+static void
+test_netaddr_kernels(void) {
+  uint8_t a1[NETADDR_KERNEL_LENGTH], a2[NETADDR_KERNEL_LENGTH];
+  struct netaddr n1, n2;
+  uint32_t seed = 12345;
+  int bit, i, j;
+
+  START_TEST();
+
+  for (i = 0; i < 64; i++) {
+    /* pseudo random base address */
+    for (j = 0; j < NETADDR_KERNEL_LENGTH; j++) {
+      seed = seed * 1103515245 + 12345;
+      a1[j] = seed >> 16;
+    }
+
+    memcpy(a2, a1, sizeof(a2));
+    _check_kernels(a1, a2, 128);
+
+    for (bit = 0; bit < 128; bit++) {
+      /* flip one bit and randomize everything behind it */
+      memcpy(a2, a1, sizeof(a2));
+      a2[bit / 8] ^= 0x80 >> (bit % 8);
+      for (j = bit / 8 + 1; j < NETADDR_KERNEL_LENGTH; j++) {
+        seed = seed * 1103515245 + 12345;
+        a2[j] = seed >> 16;
+      }
+
+      _check_kernels(a1, a2, bit);
+      _check_kernels(a2, a1, bit);
+    }
+  }
+
+  /* netaddr_cmp() must order like a memcmp() over the whole object */
+  for (i = 0; i < (int)ARRAYSIZE(string_tests); i++) {
+    for (j = 0; j < (int)ARRAYSIZE(string_tests); j++) {
+      memcpy(&n1, &string_tests[i].bin, sizeof(n1));
+      memcpy(&n2, &string_tests[j].bin, sizeof(n2));
+
+      CHECK_TRUE(_sign(netaddr_cmp(&n1, &n2)) == _sign(memcmp(&n1, &n2, sizeof(n1))),
+          "netaddr_cmp(%d, %d)", i, j);
+    }
+  }
+
+  END_TEST();
+}
+
 int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   BEGIN_TESTING(NULL);
 
@@ -372,5 +455,7 @@ int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))
 
   test_netaddr_create_host();
 
+  test_netaddr_kernels();
+
   return FINISH_TESTING();
 }
@@ -0,0 +1,360 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/string.h"
+#include "config/cfg_db.h"
+#include "config/cfg_schema.h"
+#include "core/oonf_appdata.h"
+#include "core/oonf_cfg.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+
+#include "cunit/cunit.h"
+
+#define SECTION_TYPE_1   "type_1"
+#define SECTION_TYPE_2   "type_2"
+#define SECTION_TYPE_3   "type_3"
+
+#define NAME_1           "name_1"
+
+#define KEY_1            "key_1"
+
+static void handler_1(void);
+static void handler_2(void);
+static void handler_3(void);
+
+static const struct oonf_appdata _appdata = {
+  .app_name = "test_config_apply",
+  .default_lockfile = "/tmp/test_config_apply.lock",
+  .default_cfg_handler = "",
+};
+
+static struct cfg_schema_entry entries_1[] = {
+  CFG_VALIDATE_STRING(KEY_1, "", "help"),
+};
+static struct cfg_schema_entry entries_2[] = {
+  CFG_VALIDATE_STRING(KEY_1, "", "help"),
+};
+static struct cfg_schema_entry entries_3[] = {
+  CFG_VALIDATE_STRING(KEY_1, "", "help"),
+};
+
+static struct cfg_schema_section section_1 = {
+  .type = SECTION_TYPE_1, .mode = CFG_SSMODE_NAMED,
+  .cb_delta_handler = handler_1,
+  .entries = entries_1,
+  .entry_count = ARRAYSIZE(entries_1),
+};
+static struct cfg_schema_section section_2 = {
+  .type = SECTION_TYPE_2, .mode = CFG_SSMODE_NAMED,
+  .cb_delta_handler = handler_2,
+  .entries = entries_2,
+  .entry_count = ARRAYSIZE(entries_2),
+};
+static struct cfg_schema_section section_3 = {
+  .type = SECTION_TYPE_3, .mode = CFG_SSMODE_NAMED,
+  .cb_delta_handler = handler_3,
+  .entries = entries_3,
+  .entry_count = ARRAYSIZE(entries_3),
+};
+
+static uint32_t callback_counter[3];
+static bool removed_1;
+
+static void
+clear_elements(void) {
+  memset(callback_counter, 0, sizeof(callback_counter));
+  removed_1 = false;
+}
+
+static void
+handler_1(void) {
+  callback_counter[0]++;
+  removed_1 = section_1.pre != NULL && section_1.post == NULL;
+}
+
+static void
+handler_2(void) {
+  callback_counter[1]++;
+}
+
+static void
+handler_3(void) {
+  callback_counter[2]++;
+}
+
+/**
+ * Write the content of a configuration database into a buffer
+ * @param out output buffer
+ * @param db configuration database
+ */
+static void
+_dump_db(struct autobuf *out, struct cfg_db *db) {
+  struct cfg_section_type *s_type, *s_type_it;
+  struct cfg_named_section *s_name, *s_name_it;
+  struct cfg_entry *entry, *entry_it;
+  char *value;
+
+  CFG_FOR_ALL_SECTION_TYPES(db, s_type, s_type_it) {
+    CFG_FOR_ALL_SECTION_NAMES(s_type, s_name, s_name_it) {
+      abuf_appendf(out, "[%s=%s]\n", s_type->type,
+          s_name->name == NULL ? "" : s_name->name);
+      CFG_FOR_ALL_ENTRIES(s_name, entry, entry_it) {
+        strarray_for_each_element(&entry->val, value) {
+          abuf_appendf(out, "%s=%s\n", entry->name, value);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Compare the content of two configuration databases
+ * @param db1 first database
+ * @param db2 second database
+ * @return true if both databases contain the same sections and values
+ */
+static bool
+_is_db_equal(struct cfg_db *db1, struct cfg_db *db2) {
+  struct autobuf out1, out2;
+  bool equal;
+
+  abuf_init(&out1);
+  abuf_init(&out2);
+
+  _dump_db(&out1, db1);
+  _dump_db(&out2, db2);
+
+  equal = abuf_getlen(&out1) == abuf_getlen(&out2)
+      && memcmp(abuf_getptr(&out1), abuf_getptr(&out2), abuf_getlen(&out1)) == 0;
+
+  abuf_free(&out1);
+  abuf_free(&out2);
+  return equal;
+}
+
+/**
+ * Check that the work database (which might have been created incrementally)
+ * is identical to the raw database and to a full validated copy of it.
+ */
+static void
+_check_full_copy(const char *name, int line) {
+  struct cfg_db *full;
+
+  CHECK_NAMED_TRUE(_is_db_equal(oonf_cfg_get_rawdb(), oonf_cfg_get_db()),
+      name, line, "raw db differs from work db");
+
+  full = cfg_db_duplicate(oonf_cfg_get_rawdb());
+  CHECK_NAMED_TRUE(full != NULL, name, line, "Cannot duplicate raw db");
+  if (full) {
+    cfg_db_link_schema(full, oonf_cfg_get_schema());
+    cfg_schema_validate(full, true, false, NULL);
+
+    CHECK_NAMED_TRUE(_is_db_equal(full, oonf_cfg_get_db()),
+        name, line, "work db differs from full copy of raw db");
+    cfg_db_remove(full);
+  }
+}
+
+static const char *
+_get_value(struct cfg_db *db, const char *type) {
+  const struct const_strarray *value;
+
+  value = cfg_db_get_entry_value(db, type, NAME_1, KEY_1);
+  return value == NULL ? NULL : strarray_get_first_c(value);
+}
+
+static void
+test_apply_first(void) {
+  START_TEST();
+
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_1, NAME_1, KEY_1, "a");
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_2, NAME_1, KEY_1, "b");
+
+  CHECK_TRUE(oonf_cfg_apply() == 0, "apply failed");
+  CHECK_TRUE(callback_counter[0] == 1, "handler 1 called %u times", callback_counter[0]);
+  CHECK_TRUE(callback_counter[1] == 1, "handler 2 called %u times", callback_counter[1]);
+
+  _check_full_copy(__func__, __LINE__);
+  END_TEST();
+}
+
+static void
+test_apply_twice(void) {
+  struct cfg_named_section *named_2;
+  const char *value;
+
+  START_TEST();
+
+  named_2 = cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1);
+
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_1, NAME_1, KEY_1, "c");
+
+  CHECK_TRUE(oonf_cfg_apply() == 0, "first apply failed");
+  CHECK_TRUE(callback_counter[0] == 1, "handler 1 called %u times", callback_counter[0]);
+  CHECK_TRUE(callback_counter[1] == 0, "handler 2 called %u times", callback_counter[1]);
+
+  value = _get_value(oonf_cfg_get_db(), SECTION_TYPE_1);
+  CHECK_TRUE(value != NULL && strcmp(value, "c") == 0, "value of type 1 is %s", value);
+
+  /* unchanged section type is moved into the new work db, not copied */
+  CHECK_TRUE(named_2 == cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1),
+      "unchanged section has been copied");
+  _check_full_copy(__func__, __LINE__);
+
+  /* second apply without modifications must not change anything */
+  CHECK_TRUE(oonf_cfg_apply() == 0, "second apply failed");
+  CHECK_TRUE(callback_counter[0] == 1, "handler 1 called %u times", callback_counter[0]);
+  CHECK_TRUE(callback_counter[1] == 0, "handler 2 called %u times", callback_counter[1]);
+
+  value = _get_value(oonf_cfg_get_db(), SECTION_TYPE_1);
+  CHECK_TRUE(value != NULL && strcmp(value, "c") == 0, "value of type 1 is %s", value);
+  value = _get_value(oonf_cfg_get_rawdb(), SECTION_TYPE_1);
+  CHECK_TRUE(value != NULL && strcmp(value, "c") == 0, "raw value of type 1 is %s", value);
+
+  _check_full_copy(__func__, __LINE__);
+  END_TEST();
+}
+
+static void
+test_apply_schema_change(void) {
+  struct cfg_named_section *named_2;
+  const char *value;
+
+  START_TEST();
+
+  named_2 = cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1);
+
+  /* values of a section type without schema are removed from the work db */
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_3, NAME_1, KEY_1, "d");
+  CHECK_TRUE(oonf_cfg_apply() == 0, "apply without schema failed");
+  CHECK_TRUE(_get_value(oonf_cfg_get_db(), SECTION_TYPE_3) == NULL,
+      "section without schema is in work db");
+  CHECK_TRUE(_get_value(oonf_cfg_get_rawdb(), SECTION_TYPE_3) == NULL,
+      "section without schema is in raw db");
+  _check_full_copy(__func__, __LINE__);
+
+  /* schema changes between applies, so the full copy has to be used */
+  cfg_schema_add_section(oonf_cfg_get_schema(), &section_3);
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_3, NAME_1, KEY_1, "d");
+
+  CHECK_TRUE(oonf_cfg_apply() == 0, "apply with new schema failed");
+  CHECK_TRUE(callback_counter[0] == 0, "handler 1 called %u times", callback_counter[0]);
+  CHECK_TRUE(callback_counter[1] == 0, "handler 2 called %u times", callback_counter[1]);
+  CHECK_TRUE(callback_counter[2] == 1, "handler 3 called %u times", callback_counter[2]);
+
+  value = _get_value(oonf_cfg_get_db(), SECTION_TYPE_3);
+  CHECK_TRUE(value != NULL && strcmp(value, "d") == 0, "value of type 3 is %s", value);
+  CHECK_TRUE(named_2 != cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1),
+      "unchanged section has not been copied after schema change");
+  _check_full_copy(__func__, __LINE__);
+
+  /* next apply is incremental again */
+  named_2 = cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1);
+  cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), SECTION_TYPE_3, NAME_1, KEY_1, "e");
+
+  CHECK_TRUE(oonf_cfg_apply() == 0, "apply after schema change failed");
+  CHECK_TRUE(callback_counter[2] == 2, "handler 3 called %u times", callback_counter[2]);
+  CHECK_TRUE(named_2 == cfg_db_find_namedsection(oonf_cfg_get_db(), SECTION_TYPE_2, NAME_1),
+      "unchanged section has been copied");
+  _check_full_copy(__func__, __LINE__);
+
+  END_TEST();
+}
+
+static void
+test_apply_remove_sectiontype(void) {
+  START_TEST();
+
+  cfg_db_remove_sectiontype(oonf_cfg_get_rawdb(), SECTION_TYPE_1);
+
+  CHECK_TRUE(oonf_cfg_apply() == 0, "apply failed");
+  CHECK_TRUE(callback_counter[0] == 1, "handler 1 called %u times", callback_counter[0]);
+  CHECK_TRUE(removed_1, "handler 1 did not see the section removal");
+  CHECK_TRUE(callback_counter[1] == 0, "handler 2 called %u times", callback_counter[1]);
+  CHECK_TRUE(cfg_db_find_sectiontype(oonf_cfg_get_db(), SECTION_TYPE_1) == NULL,
+      "removed section type is still in work db");
+
+  _check_full_copy(__func__, __LINE__);
+  END_TEST();
+}
+
+int
+main(int argc, char **argv) {
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+  if (oonf_subsystem_init() || oonf_cfg_init(argc, argv, _appdata.default_cfg_handler)) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  cfg_schema_add_section(oonf_cfg_get_schema(), &section_1);
+  cfg_schema_add_section(oonf_cfg_get_schema(), &section_2);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_apply_first();
+  test_apply_twice();
+  test_apply_schema_change();
+  test_apply_remove_sectiontype();
+
+  result = FINISH_TESTING();
+
+  cfg_schema_remove_section(oonf_cfg_get_schema(), &section_3);
+  cfg_schema_remove_section(oonf_cfg_get_schema(), &section_2);
+  cfg_schema_remove_section(oonf_cfg_get_schema(), &section_1);
+
+  oonf_cfg_cleanup();
+  oonf_subsystem_cleanup();
+  oonf_log_cleanup();
+  return result;
+}
@@ -495,6 +495,107 @@ handler_modify_two_sections(void) {
   }
 }
 
+static void handler_tracked_changes(void);
+
+static void
+test_delta_tracked_unchanged(void) {
+  START_TEST();
+
+  handler_1.cb_delta_handler = handler_tracked_changes;
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_2.value);
+
+  /* modifications of other section types must not trigger the handler */
+  cfg_db_track_changes(db_post);
+  cfg_db_add_entry(db_post, SECTION_TYPE_2, NAME_1, KEY_1, value_1.value);
+
+  CHECK_TRUE(cfg_db_is_changed(db_post, SECTION_TYPE_2), "Type 2 is not marked as changed");
+  CHECK_TRUE(!cfg_db_is_changed(db_post, SECTION_TYPE_1), "Type 1 is marked as changed");
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0,
+      "delta calculation failed");
+
+  CHECK_TRUE(callback_counter == 0, "Callback counter was called %d times", callback_counter);
+  END_TEST();
+}
+
+static void
+test_delta_tracked_changed(void) {
+  START_TEST();
+
+  handler_1.cb_delta_handler = handler_tracked_changes;
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_2.value);
+
+  cfg_db_track_changes(db_post);
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+
+  CHECK_TRUE(cfg_db_is_changed(db_post, SECTION_TYPE_1), "Type 1 is not marked as changed");
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0,
+      "delta calculation failed");
+
+  CHECK_TRUE(callback_counter == 1, "Callback counter was called %d times", callback_counter);
+  END_TEST();
+}
+
+static void
+handler_tracked_changes(void) {
+  callback_counter++;
+
+  CHECK_TRUE(handler_1.pre != NULL && handler_1.post != NULL,
+      "Missing pre or post named-section");
+  CHECK_TRUE(entries_1[0].delta_changed, "Key 1 did not change!");
+}
+
+static void
+test_move_sectiontype(void) {
+  struct cfg_section_type *s_type;
+  const struct const_strarray *value;
+
+  START_TEST();
+
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_1, KEY_1, value_1.value);
+  cfg_db_add_entry(db_pre, SECTION_TYPE_1, NAME_2, KEY_2, value_2.value);
+  cfg_db_add_entry(db_pre, SECTION_TYPE_2, NAME_1, KEY_1, value_3.value);
+
+  /* existing section type in target is replaced */
+  cfg_db_add_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_3, value_3.value);
+  cfg_db_track_changes(db_post);
+
+  CHECK_TRUE(cfg_db_move_sectiontype(db_post, db_pre, SECTION_TYPE_1) == 0,
+      "Moving section type failed");
+  CHECK_TRUE(cfg_db_move_sectiontype(db_post, db_pre, SECTION_TYPE_1) != 0,
+      "Moving missing section type succeeded");
+
+  CHECK_TRUE(cfg_db_find_sectiontype(db_pre, SECTION_TYPE_1) == NULL,
+      "Section type is still in source db");
+  CHECK_TRUE(cfg_db_find_sectiontype(db_pre, SECTION_TYPE_2) != NULL,
+      "Other section type was removed from source db");
+
+  s_type = cfg_db_find_sectiontype(db_post, SECTION_TYPE_1);
+  CHECK_TRUE(s_type != NULL && s_type->db == db_post,
+      "Section type is not linked to target db");
+
+  value = cfg_db_get_entry_value(db_post, SECTION_TYPE_1, NAME_1, KEY_1);
+  CHECK_TRUE(value != NULL && strcmp(strarray_get_first_c(value), value_1.value) == 0,
+      "Moved value of %s is wrong", NAME_1);
+  value = cfg_db_get_entry_value(db_post, SECTION_TYPE_1, NAME_2, KEY_2);
+  CHECK_TRUE(value != NULL && strcmp(strarray_get_first_c(value), value_2.value) == 0,
+      "Moved value of %s is wrong", NAME_2);
+  CHECK_TRUE(cfg_db_find_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_3) == NULL,
+      "Old value of target db was not replaced");
+
+  CHECK_TRUE(!cfg_db_is_changed(db_post, SECTION_TYPE_1),
+      "Move was recorded as a change");
+
+  /* moved data must be modifiable in its new database */
+  cfg_db_overwrite_entry(db_post, SECTION_TYPE_1, NAME_1, KEY_1, value_3.value);
+  CHECK_TRUE(cfg_db_is_changed(db_post, SECTION_TYPE_1),
+      "Modification after move was not recorded");
+  END_TEST();
+}
+
 int
 main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   cfg_schema_add(&schema);
@@ -509,6 +610,9 @@ main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   test_delta_remove_two_sections();
   test_delta_modify_single_section();
   test_delta_modify_two_sections();
+  test_delta_tracked_unchanged();
+  test_delta_tracked_changed();
+  test_move_sectiontype();
 
   abuf_free(&out);
   if (db_post) {
@@ -0,0 +1,214 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include "common/common_types.h"
+#include "core/oonf_appdata.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/rfc5444/rfc5444_iana.h"
+
+#include "rfc7182_provider/rfc7182_provider.h"
+
+#include "cunit/cunit.h"
+
+/* name of the hash plugin under test, set by the build system */
+#ifndef TEST_HASH_SUBSYSTEM
+#error "TEST_HASH_SUBSYSTEM must be defined"
+#endif
+
+#define SHA256_LEN 32
+
+/* HMAC-SHA-256 test cases of RFC 4231 */
+struct _hmac_testcase {
+  const char *name;
+  uint8_t key[131];
+  size_t key_len;
+  const char *data;
+  uint8_t hmac[SHA256_LEN];
+};
+
+static const struct _hmac_testcase _testcases[] = {
+  {
+    .name = "RFC4231 test case 1",
+    .key = {
+      0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+      0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    },
+    .key_len = 20,
+    .data = "Hi There",
+    .hmac = {
+      0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53,
+      0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+      0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7,
+      0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7,
+    },
+  },
+  {
+    .name = "RFC4231 test case 2",
+    .key = "Jefe",
+    .key_len = 4,
+    .data = "what do ya want for nothing?",
+    .hmac = {
+      0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e,
+      0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+      0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83,
+      0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43,
+    },
+  },
+  {
+    /* key is filled with 0xaa in main() */
+    .name = "RFC4231 test case 6",
+    .key_len = 131,
+    .data = "Test Using Larger Than Block-Size Key - Hash Key First",
+    .hmac = {
+      0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f,
+      0x0d, 0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f,
+      0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14,
+      0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54,
+    },
+  },
+};
+
+static const struct oonf_appdata _appdata = {
+  .app_name = "test_rfc7182_hmac",
+  .default_lockfile = "/tmp/test_rfc7182_hmac.lock",
+  .default_cfg_handler = "",
+};
+
+static struct _hmac_testcase _case6;
+
+static struct rfc7182_crypt *_hmac;
+static struct rfc7182_hash *_sha256;
+
+static void
+clear_elements(void) {
+}
+
+static void
+_check_testcase(const struct _hmac_testcase *tc) {
+  struct rfc7182_iov iov[3];
+  uint8_t signature[SHA256_LEN];
+  size_t signature_len, data_len, split;
+
+  data_len = strlen(tc->data);
+
+  /* contiguous signature */
+  signature_len = sizeof(signature);
+  CHECK_NAMED_TRUE(_hmac->sign(_hmac, _sha256, signature, &signature_len,
+      tc->data, data_len, tc->key, tc->key_len) == 0, tc->name, __LINE__, "sign failed");
+  CHECK_NAMED_TRUE(signature_len == SHA256_LEN
+      && memcmp(signature, tc->hmac, SHA256_LEN) == 0, tc->name, __LINE__,
+      "sign does not match known answer");
+
+  /* scattered signature, twice to use the cached key context */
+  for (split = 0; split <= data_len; split += data_len / 2 + 1) {
+    iov[0].data = tc->data;
+    iov[0].length = split / 2;
+    iov[1].data = tc->data + split / 2;
+    iov[1].length = split - split / 2;
+    iov[2].data = tc->data + split;
+    iov[2].length = data_len - split;
+
+    signature_len = sizeof(signature);
+    CHECK_NAMED_TRUE(rfc7182_sign_iov(_hmac, _sha256, signature, &signature_len,
+        iov, 3, tc->key, tc->key_len) == 0, tc->name, __LINE__,
+        "sign_iov failed (split %"PRINTF_SIZE_T_SPECIFIER")", split);
+    CHECK_NAMED_TRUE(signature_len == SHA256_LEN
+        && memcmp(signature, tc->hmac, SHA256_LEN) == 0, tc->name, __LINE__,
+        "sign_iov does not match known answer (split %"PRINTF_SIZE_T_SPECIFIER")", split);
+    CHECK_NAMED_TRUE(rfc7182_validate_iov(_hmac, _sha256, tc->hmac, SHA256_LEN,
+        iov, 3, tc->key, tc->key_len), tc->name, __LINE__,
+        "validate_iov rejected known answer (split %"PRINTF_SIZE_T_SPECIFIER")", split);
+  }
+}
+
+static void
+test_hmac_sha256(void) {
+  START_TEST();
+
+  _check_testcase(&_testcases[0]);
+  _check_testcase(&_testcases[1]);
+  _check_testcase(&_case6);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  struct oonf_subsystem *plugin;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+  if (oonf_subsystem_init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  memcpy(&_case6, &_testcases[2], sizeof(_case6));
+  memset(_case6.key, 0xaa, sizeof(_case6.key));
+
+  result = 1;
+  plugin = oonf_subsystem_get(TEST_HASH_SUBSYSTEM);
+  if (plugin != NULL && oonf_subsystem_call_init(plugin) == 0) {
+    _hmac = rfc7182_get_crypt(RFC7182_ICV_CRYPT_HMAC);
+    _sha256 = rfc7182_get_hash(RFC7182_ICV_HASH_SHA_256);
+  }
+
+  if (_hmac != NULL && _sha256 != NULL) {
+    BEGIN_TESTING(clear_elements);
+
+    test_hmac_sha256();
+
+    result = FINISH_TESTING();
+  }
+
+  oonf_subsystem_cleanup();
+  oonf_log_cleanup();
+  return result;
+}
@@ -0,0 +1,322 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include "common/common_types.h"
+#include "core/oonf_appdata.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+
+/* test the static key context cache of the provider directly */
+#include "rfc7182_provider/rfc7182_provider.c"
+
+#include "cunit/cunit.h"
+
+/* unused crypto/hash ids, the provider registers the identity ones */
+#define TEST_CRYPT_TYPE 200
+#define TEST_HASH_TYPE  200
+
+/* length of the test signature */
+#define TEST_SIGN_LEN   4
+
+/* precalculated state of the keyed checksum */
+struct _checksum_ctx {
+  uint32_t state;
+};
+
+static int _cb_checksum_sign(struct rfc7182_crypt *crypt,
+    struct rfc7182_hash *hash,
+    void *dst, size_t *dst_len, const void *src, size_t src_len,
+    const void *key, size_t key_len);
+static int _cb_checksum_init_key(struct rfc7182_crypt *crypt,
+    struct rfc7182_hash *hash, void *ctx,
+    const void *key, size_t key_len);
+static int _cb_checksum_sign_iov(struct rfc7182_crypt *crypt,
+    struct rfc7182_hash *hash, const void *ctx,
+    void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count);
+
+static const struct oonf_appdata _appdata = {
+  .app_name = "test_rfc7182_provider",
+  .default_lockfile = "/tmp/test_rfc7182_provider.lock",
+  .default_cfg_handler = "",
+};
+
+static struct rfc7182_hash _test_hash = {
+  .type = TEST_HASH_TYPE,
+};
+
+static struct rfc7182_crypt _test_crypt = {
+  .type = TEST_CRYPT_TYPE,
+  .sign = _cb_checksum_sign,
+  .key_context_size = sizeof(struct _checksum_ctx),
+  .init_key_context = _cb_checksum_init_key,
+  .sign_iov = _cb_checksum_sign_iov,
+};
+
+/* number of key contexts initialized by the provider */
+static int _init_key_count;
+
+static uint8_t _data[200];
+
+static uint32_t
+_checksum(uint32_t state, const void *data, size_t len) {
+  const uint8_t *ptr = data;
+  size_t i;
+
+  /* FNV-1a */
+  for (i = 0; i < len; i++) {
+    state = (state ^ ptr[i]) * 16777619u;
+  }
+  return state;
+}
+
+static int
+_write_checksum(uint32_t state, void *dst, size_t *dst_len) {
+  if (*dst_len < TEST_SIGN_LEN) {
+    return -1;
+  }
+  memcpy(dst, &state, TEST_SIGN_LEN);
+  *dst_len = TEST_SIGN_LEN;
+  return 0;
+}
+
+static int
+_cb_checksum_sign(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash __attribute__((unused)),
+    void *dst, size_t *dst_len, const void *src, size_t src_len,
+    const void *key, size_t key_len) {
+  uint32_t state;
+
+  state = _checksum(2166136261u, key, key_len);
+  state = _checksum(state, src, src_len);
+  return _write_checksum(state, dst, dst_len);
+}
+
+static int
+_cb_checksum_init_key(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash __attribute__((unused)), void *ctx,
+    const void *key, size_t key_len) {
+  struct _checksum_ctx *cctx = ctx;
+
+  _init_key_count++;
+  cctx->state = _checksum(2166136261u, key, key_len);
+  return 0;
+}
+
+static int
+_cb_checksum_sign_iov(struct rfc7182_crypt *crypt __attribute__((unused)),
+    struct rfc7182_hash *hash __attribute__((unused)), const void *ctx,
+    void *dst, size_t *dst_len,
+    const struct rfc7182_iov *src, size_t src_count) {
+  const struct _checksum_ctx *cctx = ctx;
+  uint32_t state;
+  size_t i;
+
+  state = cctx->state;
+  for (i = 0; i < src_count; i++) {
+    state = _checksum(state, src[i].data, src[i].length);
+  }
+  return _write_checksum(state, dst, dst_len);
+}
+
+static void
+clear_elements(void) {
+  struct _key_context *kctx, *kctx_it;
+
+  list_for_each_element_safe(&_key_contexts, kctx, _node, kctx_it) {
+    _remove_key_context(kctx);
+  }
+  _init_key_count = 0;
+}
+
+static void
+test_sign_iov_matches_sign(void) {
+  static const size_t splits[][3] = {
+    { 200, 0, 0 },
+    { 1, 199, 0 },
+    { 64, 64, 72 },
+    { 0, 100, 100 },
+  };
+  struct rfc7182_iov iov[3];
+  uint8_t expected[TEST_SIGN_LEN], signature[TEST_SIGN_LEN];
+  size_t expected_len, signature_len, offset, i, j;
+  static const char key[] = "shared key";
+
+  START_TEST();
+
+  expected_len = sizeof(expected);
+  CHECK_TRUE(_test_crypt.sign(&_test_crypt, &_test_hash, expected, &expected_len,
+      _data, sizeof(_data), key, sizeof(key)) == 0, "contiguous signature failed");
+
+  for (i = 0; i < ARRAYSIZE(splits); i++) {
+    offset = 0;
+    for (j = 0; j < 3; j++) {
+      iov[j].data = &_data[offset];
+      iov[j].length = splits[i][j];
+      offset += splits[i][j];
+    }
+
+    signature_len = sizeof(signature);
+    CHECK_TRUE(rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+        iov, 3, key, sizeof(key)) == 0, "scattered signature %"PRINTF_SIZE_T_SPECIFIER" failed", i);
+    CHECK_TRUE(signature_len == expected_len
+        && memcmp(signature, expected, expected_len) == 0,
+        "scattered signature %"PRINTF_SIZE_T_SPECIFIER" differs from contiguous one", i);
+    CHECK_TRUE(rfc7182_validate_iov(&_test_crypt, &_test_hash, expected, expected_len,
+        iov, 3, key, sizeof(key)), "valid signature %"PRINTF_SIZE_T_SPECIFIER" rejected", i);
+  }
+
+  /* the cached context must not accept a modified signature */
+  expected[0] ^= 0xff;
+  CHECK_TRUE(!rfc7182_validate_iov(&_test_crypt, &_test_hash, expected, expected_len,
+      iov, 3, key, sizeof(key)), "invalid signature accepted");
+
+  CHECK_TRUE(_init_key_count == 1, "key context was initialized %d times", _init_key_count);
+
+  END_TEST();
+}
+
+static void
+test_key_context_cache(void) {
+  struct rfc7182_iov iov = { _data, sizeof(_data) };
+  uint8_t signature[TEST_SIGN_LEN];
+  size_t signature_len;
+  uint8_t key;
+
+  START_TEST();
+
+  /* cache miss */
+  key = 0;
+  signature_len = sizeof(signature);
+  CHECK_TRUE(rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+      &iov, 1, &key, 1) == 0, "signature failed");
+  CHECK_TRUE(_init_key_count == 1 && _key_context_count == 1,
+      "first key was not cached (init=%d, count=%"PRINTF_SIZE_T_SPECIFIER")",
+      _init_key_count, _key_context_count);
+
+  /* cache hit */
+  signature_len = sizeof(signature);
+  rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+      &iov, 1, &key, 1);
+  CHECK_TRUE(_init_key_count == 1, "cached key was initialized again");
+
+  /* fill the cache, key 0 is the least recently used one afterwards */
+  for (key = 1; key < RFC7182_KEY_CONTEXT_CACHE_SIZE; key++) {
+    signature_len = sizeof(signature);
+    rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+        &iov, 1, &key, 1);
+  }
+  CHECK_TRUE(_init_key_count == RFC7182_KEY_CONTEXT_CACHE_SIZE
+      && _key_context_count == RFC7182_KEY_CONTEXT_CACHE_SIZE,
+      "cache not filled (init=%d, count=%"PRINTF_SIZE_T_SPECIFIER")",
+      _init_key_count, _key_context_count);
+
+  /* one more key evicts key 0, but keeps key 1 */
+  key = RFC7182_KEY_CONTEXT_CACHE_SIZE;
+  signature_len = sizeof(signature);
+  rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+      &iov, 1, &key, 1);
+  CHECK_TRUE(_key_context_count == RFC7182_KEY_CONTEXT_CACHE_SIZE,
+      "cache grew beyond its size: %"PRINTF_SIZE_T_SPECIFIER, _key_context_count);
+
+  key = 1;
+  signature_len = sizeof(signature);
+  rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+      &iov, 1, &key, 1);
+  CHECK_TRUE(_init_key_count == RFC7182_KEY_CONTEXT_CACHE_SIZE + 1,
+      "recently used key was evicted");
+
+  key = 0;
+  signature_len = sizeof(signature);
+  rfc7182_sign_iov(&_test_crypt, &_test_hash, signature, &signature_len,
+      &iov, 1, &key, 1);
+  CHECK_TRUE(_init_key_count == RFC7182_KEY_CONTEXT_CACHE_SIZE + 2,
+      "least recently used key was not evicted");
+
+  /* removing the crypto function drops its contexts */
+  rfc7182_remove_crypt(&_test_crypt);
+  CHECK_TRUE(_key_context_count == 0,
+      "%"PRINTF_SIZE_T_SPECIFIER" contexts left after removing crypt", _key_context_count);
+  rfc7182_add_crypt(&_test_crypt);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  size_t i;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+  if (oonf_subsystem_init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  for (i = 0; i < sizeof(_data); i++) {
+    _data[i] = (uint8_t)(i * 7 + 3);
+  }
+
+  result = 1;
+  if (oonf_subsystem_call_init(&_rfc7182_provider_subsystem) == 0) {
+    rfc7182_add_hash(&_test_hash);
+    rfc7182_add_crypt(&_test_crypt);
+
+    BEGIN_TESTING(clear_elements);
+
+    test_sign_iov_matches_sign();
+    test_key_context_cache();
+
+    result = FINISH_TESTING();
+  }
+
+  oonf_subsystem_cleanup();
+  oonf_log_cleanup();
+  return result;
+}
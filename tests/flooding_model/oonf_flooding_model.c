@@ -0,0 +1,1755 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Synthetic flooding model for scale testing of the RFC5444 and
+ * duplicate set code. Runs many nodes in a single process on top of
+ * a virtual clock.
+ *
+ * The nodes do NOT run the NHDP and OLSRv2 plugins, which keep their
+ * state in process-wide databases. Instead each node owns its own
+ * RFC5444 reader/writer, duplicate set and timers and implements a
+ * simplified protocol: periodic HELLO messages with link status address
+ * TLVs establish symmetric links and periodic TC messages are flooded
+ * by every node (no MPR selection, no link metrics, no routing). The
+ * results show the cost of message generation, parsing and duplicate
+ * detection, not the convergence behaviour of olsrd2.
+ *
+ * All nodes share the timer scheduler, which is driven by a virtual
+ * clock that jumps from one timer event to the next, so simulated
+ * minutes run in a fraction of the time and every run with the same
+ * seed produces the same result.
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+
+#include "core/oonf_subsystem.h"
+
+#include "subsystems/rfc5444/rfc5444.h"
+#include "subsystems/rfc5444/rfc5444_iana.h"
+#include "subsystems/rfc5444/rfc5444_reader.h"
+#include "subsystems/rfc5444/rfc5444_writer.h"
+#include "subsystems/oonf_clock.h"
+#include "subsystems/oonf_duplicate_set.h"
+#include "subsystems/oonf_timer.h"
+#include "subsystems/os_clock.h"
+
+#include "benchmark/benchmark_common.h"
+
+/* simulation constants */
+enum {
+  /*! maximum size of a simulated packet */
+  SIM_MTU = 1280,
+
+  /*! size of address TLV value buffer of each writer */
+  SIM_ADDRTLV_SIZE = 2048,
+
+  /*! delay between message generation and packet transmission */
+  SIM_AGGREGATION_INTERVAL = 100,
+
+  /*! validity of a HELLO in multiples of the HELLO interval */
+  SIM_HELLO_VALIDITY_FACTOR = 3,
+
+  /*! validity of a TC in multiples of the TC interval */
+  SIM_TC_VALIDITY_FACTOR = 3,
+
+  /*! reader priority of the HELLO consumers */
+  SIM_HELLO_PRIORITY = 10,
+
+  /*! reader priority of the TC consumers */
+  SIM_TC_PRIORITY = 20,
+};
+
+/**
+ * Supported topology generators
+ */
+enum sim_topology {
+  /*! square grid, each node is connected to up to four neighbors */
+  SIM_TOPOLOGY_GRID,
+
+  /*! random geometric graph in the unit square */
+  SIM_TOPOLOGY_RANDOM,
+
+  /*! links loaded from a NetJSON NetworkGraph file */
+  SIM_TOPOLOGY_NETJSON,
+};
+
+/**
+ * Link of a node to one of its neighbors in the topology
+ */
+struct sim_link {
+  /*! index of the neighbor node */
+  uint32_t neighbor;
+
+  /*! virtual time until the neighbor is heard */
+  uint64_t heard_until;
+
+  /*! virtual time until the link is symmetric */
+  uint64_t sym_until;
+
+  /*! true if the link is currently counted as symmetric */
+  bool symmetric;
+};
+
+/**
+ * A single node of the flooding model
+ */
+struct sim_node {
+  /*! index of the node */
+  uint32_t index;
+
+  /*! originator and interface address of the node */
+  struct netaddr addr;
+
+  /*! links to topology neighbors */
+  struct sim_link *links;
+
+  /*! number of topology neighbors */
+  uint32_t link_count;
+
+  /*! bitmap of originators this node received a TC from */
+  uint8_t *known;
+
+  /*! next TC sequence number */
+  uint16_t tc_seqno;
+
+  /*! duplicate set for flooded TCs */
+  struct oonf_duplicate_set dupset;
+
+  /*! message generator of this node */
+  struct rfc5444_writer writer;
+
+  /*! the single (wireless) interface of the node */
+  struct rfc5444_writer_target target;
+
+  /*! HELLO content provider */
+  struct rfc5444_writer_content_provider hello_provider;
+
+  /*! TC content provider */
+  struct rfc5444_writer_content_provider tc_provider;
+
+  /*! HELLO address TLV types */
+  struct rfc5444_writer_tlvtype hello_addrtlvs[1];
+
+  /*! TC address TLV types */
+  struct rfc5444_writer_tlvtype tc_addrtlvs[1];
+
+  /*! timer for HELLO generation */
+  struct oonf_timer_instance hello_timer;
+
+  /*! timer for TC generation */
+  struct oonf_timer_instance tc_timer;
+
+  /*! timer for packet aggregation */
+  struct oonf_timer_instance flush_timer;
+
+  /*! processing time spent for this node in nanoseconds */
+  uint64_t cpu_ns;
+
+  /*! message buffer of the writer */
+  uint8_t msg_buffer[SIM_MTU];
+
+  /*! address TLV buffer of the writer */
+  uint8_t addrtlv_buffer[SIM_ADDRTLV_SIZE];
+
+  /*! packet buffer of the interface */
+  uint8_t packet_buffer[SIM_MTU];
+};
+
+/**
+ * Reference counted copy of a transmitted packet
+ */
+struct sim_packet {
+  /*! number of pending deliveries */
+  uint32_t refcount;
+
+  /*! length of the packet */
+  size_t length;
+
+  /*! packet data */
+  uint8_t data[];
+};
+
+/**
+ * Pending reception of a packet by a single neighbor
+ */
+struct sim_delivery {
+  /*! node of the delivery queue */
+  struct list_entity _node;
+
+  /*! packet to be received */
+  struct sim_packet *packet;
+
+  /*! receiving node */
+  struct sim_node *receiver;
+};
+
+/**
+ * Mapping of a NetJSON node id to a node index
+ */
+struct sim_node_id {
+  /*! node of id tree */
+  struct avl_node _node;
+
+  /*! index of node */
+  uint32_t index;
+
+  /*! NetJSON id */
+  char id[];
+};
+
+/**
+ * Undirected edge between two nodes
+ */
+struct sim_edge {
+  /*! smaller node index */
+  uint32_t a;
+
+  /*! larger node index */
+  uint32_t b;
+};
+
+/**
+ * Simulation statistics
+ */
+struct sim_statistics {
+  /*! HELLO messages generated */
+  uint64_t hellos;
+
+  /*! TC messages generated */
+  uint64_t tcs;
+
+  /*! TC messages forwarded */
+  uint64_t forwarded;
+
+  /*! TC messages dropped as duplicates */
+  uint64_t duplicates;
+
+  /*! messages parsed by receivers */
+  uint64_t messages;
+
+  /*! packets transmitted */
+  uint64_t packets;
+
+  /*! packets received */
+  uint64_t deliveries;
+
+  /*! packets lost on the medium */
+  uint64_t lost;
+
+  /*! maximum number of packets in flight */
+  uint64_t max_pending;
+};
+
+/**
+ * Parameters of the simulation
+ */
+struct sim_config {
+  /*! topology generator */
+  enum sim_topology topology;
+
+  /*! NetJSON file for file based topology */
+  const char *file;
+
+  /*! number of nodes for generated topologies */
+  uint32_t nodes;
+
+  /*! average number of neighbors for random topology */
+  double degree;
+
+  /*! packet loss probability per link */
+  double loss;
+
+  /*! seed of random number generator */
+  uint64_t seed;
+
+  /*! simulated time in milliseconds */
+  uint64_t duration;
+
+  /*! HELLO interval in milliseconds */
+  uint64_t hello_interval;
+
+  /*! TC interval in milliseconds */
+  uint64_t tc_interval;
+
+  /*! true if the model should fail if the network did not converge */
+  bool require_convergence;
+};
+
+static uint64_t _random(void);
+static double _random_unit(void);
+
+static int _add_edge(uint32_t a, uint32_t b);
+static int _build_grid(uint32_t count);
+static int _build_random(uint32_t count, double degree);
+static int _build_netjson(const char *file);
+static int _build_nodes(void);
+static void _calculate_components(void);
+
+static struct sim_node *_get_node(const struct netaddr *addr);
+static struct sim_link *_get_link(struct sim_node *node, uint32_t neighbor);
+static void _update_link(struct sim_link *link);
+static void _schedule_flush(struct sim_node *node);
+
+static void _cb_send_packet(struct rfc5444_writer *writer,
+    struct rfc5444_writer_target *target, void *ptr, size_t len);
+static void _cb_forwarding_notifier(struct rfc5444_writer_target *target);
+static int _cb_add_hello_header(struct rfc5444_writer *writer,
+    struct rfc5444_writer_message *msg);
+static void _cb_add_hello_msgtlvs(struct rfc5444_writer *writer);
+static void _cb_add_hello_addresses(struct rfc5444_writer *writer);
+static int _cb_add_tc_header(struct rfc5444_writer *writer,
+    struct rfc5444_writer_message *msg);
+static void _cb_add_tc_msgtlvs(struct rfc5444_writer *writer);
+static void _cb_add_tc_addresses(struct rfc5444_writer *writer);
+static bool _cb_tc_forward_target(struct rfc5444_writer_target *target,
+    struct rfc5444_reader_tlvblock_context *context,
+    const uint8_t *buffer, size_t len);
+
+static bool _cb_drop_message(struct rfc5444_reader_tlvblock_context *context);
+static void _cb_forward_message(struct rfc5444_reader_tlvblock_context *context,
+    uint8_t *buffer, size_t length);
+static enum rfc5444_result _cb_hello_msgtlvs(
+    struct rfc5444_reader_tlvblock_context *context);
+static enum rfc5444_result _cb_hello_addresstlvs(
+    struct rfc5444_reader_tlvblock_context *context);
+static enum rfc5444_result _cb_hello_end(
+    struct rfc5444_reader_tlvblock_context *context, bool dropped);
+static enum rfc5444_result _cb_tc_msgtlvs(
+    struct rfc5444_reader_tlvblock_context *context);
+
+static void _cb_hello_timer(struct oonf_timer_instance *ptr);
+static void _cb_tc_timer(struct oonf_timer_instance *ptr);
+static void _cb_flush_timer(struct oonf_timer_instance *ptr);
+
+/* simulation parameters */
+static struct sim_config _config = {
+  .topology = SIM_TOPOLOGY_GRID,
+  .nodes = 100,
+  .degree = 6.0,
+  .seed = 1,
+  .duration = 60000,
+  .hello_interval = 2000,
+  .tc_interval = 5000,
+};
+
+/* current virtual time of the simulated OS clock */
+static uint64_t _virtual_time = 0;
+
+/* state of the xorshift random number generator */
+static uint64_t _random_state;
+
+/* topology */
+static struct sim_edge *_edges = NULL;
+static size_t _edge_count = 0, _edge_size = 0;
+static uint32_t _node_count = 0;
+static uint32_t _component_count = 0;
+static struct avl_tree _node_id_tree;
+
+/* simulated nodes */
+static struct sim_node *_nodes = NULL;
+static struct sim_link *_links = NULL;
+static uint8_t *_known = NULL;
+
+/* node currently processing an incoming packet */
+static struct sim_node *_current_node = NULL;
+
+/* state of the HELLO currently parsed */
+static struct sim_link *_hello_link;
+static uint64_t _hello_vtime;
+static bool _hello_sees_receiver;
+
+/* packets in flight */
+static struct list_entity _delivery_queue;
+static uint64_t _pending = 0;
+
+/* convergence tracking */
+static uint64_t _symmetric_links = 0;
+static uint64_t _known_originators = 0;
+static uint64_t _expected_originators = 0;
+static uint64_t _converged_at = 0;
+static bool _converged = false;
+
+static struct sim_statistics _stats;
+
+/* shared message parser of all nodes */
+static struct rfc5444_reader _reader = {
+  .drop_message = _cb_drop_message,
+  .forward_message = _cb_forward_message,
+};
+
+/* HELLO message and address consumers */
+enum {
+  IDX_HELLO_VTIME,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _hello_msgtlvs[] = {
+  [IDX_HELLO_VTIME] = { .type = RFC5497_MSGTLV_VALIDITY_TIME, .mandatory = true,
+      .min_length = 1, .max_length = 1, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _hello_msg_consumer = {
+  .order = SIM_HELLO_PRIORITY,
+  .msg_id = RFC6130_MSGTYPE_HELLO,
+  .block_callback = _cb_hello_msgtlvs,
+  .end_callback = _cb_hello_end,
+};
+
+enum {
+  IDX_ADDRTLV_LINK_STATUS,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _hello_addrtlvs[] = {
+  [IDX_ADDRTLV_LINK_STATUS] = { .type = RFC6130_ADDRTLV_LINK_STATUS,
+      .min_length = 1, .max_length = 1, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _hello_addr_consumer = {
+  .order = SIM_HELLO_PRIORITY,
+  .msg_id = RFC6130_MSGTYPE_HELLO,
+  .addrblock_consumer = true,
+  .block_callback = _cb_hello_addresstlvs,
+};
+
+/* TC message consumer */
+enum {
+  IDX_TC_VTIME,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _tc_msgtlvs[] = {
+  [IDX_TC_VTIME] = { .type = RFC5497_MSGTLV_VALIDITY_TIME, .mandatory = true,
+      .min_length = 1, .max_length = 1, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _tc_msg_consumer = {
+  .order = SIM_TC_PRIORITY,
+  .msg_id = RFC7181_MSGTYPE_TC,
+  .block_callback = _cb_tc_msgtlvs,
+};
+
+/* timer classes */
+static struct oonf_timer_class _hello_timer_class = {
+  .name = "flooding model hello",
+  .callback = _cb_hello_timer,
+  .periodic = true,
+};
+static struct oonf_timer_class _tc_timer_class = {
+  .name = "flooding model tc",
+  .callback = _cb_tc_timer,
+  .periodic = true,
+};
+static struct oonf_timer_class _flush_timer_class = {
+  .name = "flooding model aggregation",
+  .callback = _cb_flush_timer,
+};
+
+/* subsystems used by the model, in initialization order */
+static const char *_subsystems[] = {
+  OONF_CLOCK_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+  OONF_DUPSET_SUBSYSTEM,
+};
+
+/**
+ * Simulated OS clock, returns the virtual time
+ * @param t64 pointer to timestamp
+ * @return always 0
+ */
+int
+os_clock_linux_gettime64(uint64_t *t64) {
+  *t64 = _virtual_time;
+  return 0;
+}
+
+/**
+ * Real monotonic clock in nanoseconds, used for profiling
+ * @param t64 pointer to timestamp
+ * @return always 0
+ */
+int
+os_clock_linux_gettime64_ns(uint64_t *t64) {
+  *t64 = benchmark_get_ns();
+  return 0;
+}
+
+/**
+ * Real CPU time of the calling thread in nanoseconds
+ * @param t64 pointer to timestamp
+ * @return 0 if valid timestamp was read, negative otherwise
+ */
+int
+os_clock_linux_gettime_cpu_ns(uint64_t *t64) {
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+    return -1;
+  }
+  *t64 = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+  return 0;
+}
+
+/**
+ * @return next value of the deterministic xorshift64* generator
+ */
+static uint64_t
+_random(void) {
+  _random_state ^= _random_state >> 12;
+  _random_state ^= _random_state << 25;
+  _random_state ^= _random_state >> 27;
+  return _random_state * 2685821657736338717ull;
+}
+
+/**
+ * @return deterministic random number in [0,1)
+ */
+static double
+_random_unit(void) {
+  return (double)(_random() >> 11) / (double)(1ull << 53);
+}
+
+/**
+ * Add an undirected edge to the topology
+ * @param a index of first node
+ * @param b index of second node
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_add_edge(uint32_t a, uint32_t b) {
+  struct sim_edge *edges;
+
+  if (a == b) {
+    return 0;
+  }
+
+  if (_edge_count == _edge_size) {
+    _edge_size = _edge_size ? _edge_size * 2 : 1024;
+    edges = realloc(_edges, _edge_size * sizeof(*_edges));
+    if (!edges) {
+      return -1;
+    }
+    _edges = edges;
+  }
+
+  _edges[_edge_count].a = a < b ? a : b;
+  _edges[_edge_count].b = a < b ? b : a;
+  _edge_count++;
+  return 0;
+}
+
+static int
+_compare_edges(const void *p1, const void *p2) {
+  const struct sim_edge *e1 = p1, *e2 = p2;
+
+  if (e1->a != e2->a) {
+    return e1->a < e2->a ? -1 : 1;
+  }
+  if (e1->b != e2->b) {
+    return e1->b < e2->b ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * Generate a square grid, each node is connected to its
+ * horizontal and vertical neighbors
+ * @param count number of nodes
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_build_grid(uint32_t count) {
+  uint32_t side, i;
+
+  side = 1;
+  while (side * side < count) {
+    side++;
+  }
+  _node_count = count;
+
+  for (i=0; i<count; i++) {
+    if ((i % side) + 1 < side && i + 1 < count) {
+      if (_add_edge(i, i + 1)) {
+        return -1;
+      }
+    }
+    if (i + side < count) {
+      if (_add_edge(i, i + side)) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Generate a random geometric graph in the unit square. The radio
+ * range is chosen to get the requested average number of neighbors.
+ * @param count number of nodes
+ * @param degree average number of neighbors
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_build_random(uint32_t count, double degree) {
+  double *x, *y, range, dx, dy;
+  uint32_t i, j;
+  int result = 0;
+
+  x = calloc(count, sizeof(*x));
+  y = calloc(count, sizeof(*y));
+  if (!x || !y) {
+    free(x);
+    free(y);
+    return -1;
+  }
+
+  _node_count = count;
+  range = sqrt(degree / (M_PI * (double)count));
+
+  for (i=0; i<count; i++) {
+    x[i] = _random_unit();
+    y[i] = _random_unit();
+  }
+
+  for (i=0; i<count && !result; i++) {
+    for (j=i+1; j<count; j++) {
+      dx = x[i] - x[j];
+      dy = y[i] - y[j];
+      if (dx*dx + dy*dy <= range*range && _add_edge(i, j)) {
+        result = -1;
+        break;
+      }
+    }
+  }
+
+  free(x);
+  free(y);
+  return result;
+}
+
+/**
+ * Get the index of a NetJSON node id, allocate a new node if
+ * the id is unknown.
+ * @param id pointer to start of id
+ * @param len length of id
+ * @return index of node, -1 if out of memory
+ */
+static int64_t
+_get_node_index(const char *id, size_t len) {
+  struct sim_node_id *node_id;
+  char buf[256];
+
+  if (len >= sizeof(buf)) {
+    len = sizeof(buf) - 1;
+  }
+  memcpy(buf, id, len);
+  buf[len] = 0;
+
+  node_id = avl_find_element(&_node_id_tree, buf, node_id, _node);
+  if (node_id) {
+    return node_id->index;
+  }
+
+  node_id = calloc(1, sizeof(*node_id) + len + 1);
+  if (!node_id) {
+    return -1;
+  }
+  memcpy(node_id->id, buf, len + 1);
+  node_id->index = _node_count++;
+  node_id->_node.key = node_id->id;
+  avl_insert(&_node_id_tree, &node_id->_node);
+  return node_id->index;
+}
+
+/**
+ * Load the topology from a NetJSON NetworkGraph file. Only the
+ * "id" of the nodes and "source" and "target" of the links are used.
+ * @param file name of NetJSON file
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_build_netjson(const char *file) {
+  struct sim_node_id *node_id, *it;
+  const char *key, *value, *ptr;
+  size_t key_len, value_len;
+  int64_t source, target, index;
+  bool in_links;
+  FILE *f;
+  char *buffer;
+  long size;
+  int result = -1;
+
+  f = fopen(file, "r");
+  if (!f) {
+    fprintf(stderr, "Cannot open NetJSON file '%s'\n", file);
+    return -1;
+  }
+
+  buffer = NULL;
+  if (fseek(f, 0, SEEK_END) || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET)) {
+    goto netjson_error;
+  }
+  buffer = calloc(1, size + 1);
+  if (!buffer || fread(buffer, 1, size, f) != (size_t)size) {
+    goto netjson_error;
+  }
+
+  avl_init(&_node_id_tree, avl_comp_strcasecmp, false);
+
+  in_links = false;
+  source = -1;
+  target = -1;
+  ptr = buffer;
+  while ((ptr = strchr(ptr, '"')) != NULL) {
+    key = ptr + 1;
+    ptr = strchr(key, '"');
+    if (!ptr) {
+      break;
+    }
+    key_len = ptr - key;
+    ptr += 1 + strspn(ptr + 1, " \t\r\n");
+    if (*ptr != ':') {
+      /* string value without key */
+      continue;
+    }
+    ptr += 1 + strspn(ptr + 1, " \t\r\n");
+
+    if (key_len == 5 && strncmp(key, "links", 5) == 0) {
+      in_links = true;
+      continue;
+    }
+    if (key_len == 5 && strncmp(key, "nodes", 5) == 0) {
+      in_links = false;
+      continue;
+    }
+    if (*ptr != '"') {
+      continue;
+    }
+
+    value = ptr + 1;
+    ptr = strchr(value, '"');
+    if (!ptr) {
+      break;
+    }
+    value_len = ptr - value;
+    ptr++;
+
+    index = -2;
+    if (!in_links && key_len == 2 && strncmp(key, "id", 2) == 0) {
+      index = _get_node_index(value, value_len);
+    }
+    else if (in_links && key_len == 6 && strncmp(key, "source", 6) == 0) {
+      index = source = _get_node_index(value, value_len);
+    }
+    else if (in_links && key_len == 6 && strncmp(key, "target", 6) == 0) {
+      index = target = _get_node_index(value, value_len);
+    }
+    if (index == -1) {
+      goto netjson_error;
+    }
+
+    if (source >= 0 && target >= 0) {
+      if (_add_edge(source, target)) {
+        goto netjson_error;
+      }
+      source = -1;
+      target = -1;
+    }
+  }
+
+  if (_node_count == 0) {
+    fprintf(stderr, "NetJSON file '%s' contains no nodes\n", file);
+  }
+  else {
+    result = 0;
+  }
+
+netjson_error:
+  if (_node_id_tree.comp) {
+    avl_for_each_element_safe(&_node_id_tree, node_id, _node, it) {
+      avl_remove(&_node_id_tree, &node_id->_node);
+      free(node_id);
+    }
+  }
+  free(buffer);
+  fclose(f);
+  return result;
+}
+
+/**
+ * Allocate and initialize all nodes and their links
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_build_nodes(void) {
+  struct rfc5444_writer_message *msg;
+  struct sim_node *node;
+  uint8_t bin[4];
+  size_t i, j, known_size;
+  uint32_t *degree;
+
+  /* remove duplicate edges */
+  if (_edge_count > 0) {
+    qsort(_edges, _edge_count, sizeof(*_edges), _compare_edges);
+    for (i=1, j=0; i<_edge_count; i++) {
+      if (_compare_edges(&_edges[i], &_edges[j]) != 0) {
+        _edges[++j] = _edges[i];
+      }
+    }
+    _edge_count = j + 1;
+  }
+
+  known_size = (_node_count + 7) / 8;
+
+  _nodes = calloc(_node_count, sizeof(*_nodes));
+  _links = calloc(_edge_count * 2 + 1, sizeof(*_links));
+  _known = calloc(_node_count, known_size);
+  degree = calloc(_node_count, sizeof(*degree));
+  if (!_nodes || !_links || !_known || !degree) {
+    free(degree);
+    return -1;
+  }
+
+  for (i=0; i<_edge_count; i++) {
+    degree[_edges[i].a]++;
+    degree[_edges[i].b]++;
+  }
+
+  for (i=0, j=0; i<_node_count; i++) {
+    node = &_nodes[i];
+    node->index = i;
+    node->links = &_links[j];
+    node->known = &_known[i * known_size];
+    j += degree[i];
+
+    bin[0] = 10;
+    bin[1] = ((i + 1) >> 16) & 255;
+    bin[2] = ((i + 1) >> 8) & 255;
+    bin[3] = (i + 1) & 255;
+    netaddr_from_binary(&node->addr, bin, sizeof(bin), AF_INET);
+  }
+  free(degree);
+
+  for (i=0; i<_edge_count; i++) {
+    node = &_nodes[_edges[i].a];
+    node->links[node->link_count++].neighbor = _edges[i].b;
+    node = &_nodes[_edges[i].b];
+    node->links[node->link_count++].neighbor = _edges[i].a;
+  }
+
+  for (i=0; i<_node_count; i++) {
+    node = &_nodes[i];
+
+    oonf_duplicate_set_add(&node->dupset, OONF_DUPSET_16BIT);
+
+    node->writer.msg_buffer = node->msg_buffer;
+    node->writer.msg_size = sizeof(node->msg_buffer);
+    node->writer.addrtlv_buffer = node->addrtlv_buffer;
+    node->writer.addrtlv_size = sizeof(node->addrtlv_buffer);
+    node->writer.forwarding_notifier = _cb_forwarding_notifier;
+    rfc5444_writer_init(&node->writer);
+
+    node->target.packet_buffer = node->packet_buffer;
+    node->target.packet_size = sizeof(node->packet_buffer);
+    node->target.sendPacket = _cb_send_packet;
+    rfc5444_writer_register_target(&node->writer, &node->target);
+
+    node->hello_provider.msg_type = RFC6130_MSGTYPE_HELLO;
+    node->hello_provider.addMessageTLVs = _cb_add_hello_msgtlvs;
+    node->hello_provider.addAddresses = _cb_add_hello_addresses;
+    node->hello_addrtlvs[0].type = RFC6130_ADDRTLV_LINK_STATUS;
+
+    node->tc_provider.msg_type = RFC7181_MSGTYPE_TC;
+    node->tc_provider.addMessageTLVs = _cb_add_tc_msgtlvs;
+    node->tc_provider.addAddresses = _cb_add_tc_addresses;
+    node->tc_addrtlvs[0].type = RFC7181_ADDRTLV_NBR_ADDR_TYPE;
+
+    msg = rfc5444_writer_register_message(&node->writer, RFC6130_MSGTYPE_HELLO, false);
+    if (!msg) {
+      return -1;
+    }
+    msg->addMessageHeader = _cb_add_hello_header;
+    rfc5444_writer_register_msgcontentprovider(&node->writer,
+        &node->hello_provider, node->hello_addrtlvs, ARRAYSIZE(node->hello_addrtlvs));
+
+    msg = rfc5444_writer_register_message(&node->writer, RFC7181_MSGTYPE_TC, false);
+    if (!msg) {
+      return -1;
+    }
+    msg->addMessageHeader = _cb_add_tc_header;
+    msg->forward_target_selector = _cb_tc_forward_target;
+    rfc5444_writer_register_msgcontentprovider(&node->writer,
+        &node->tc_provider, node->tc_addrtlvs, ARRAYSIZE(node->tc_addrtlvs));
+
+    /* spread the first messages of the nodes over one interval */
+    node->hello_timer.class = &_hello_timer_class;
+    oonf_timer_set_ext(&node->hello_timer,
+        _random() % _config.hello_interval + 1, _config.hello_interval);
+
+    node->tc_timer.class = &_tc_timer_class;
+    oonf_timer_set_ext(&node->tc_timer,
+        _random() % _config.tc_interval + 1, _config.tc_interval);
+
+    node->flush_timer.class = &_flush_timer_class;
+  }
+  return 0;
+}
+
+/**
+ * Calculate the connected components of the topology and the number
+ * of originators each node has to learn to converge.
+ */
+static void
+_calculate_components(void) {
+  uint32_t *stack, *component, count, top, i, j, n;
+  struct sim_node *node;
+
+  stack = calloc(_node_count, sizeof(*stack));
+  component = calloc(_node_count, sizeof(*component));
+  if (!stack || !component) {
+    free(stack);
+    free(component);
+    return;
+  }
+
+  /* component ids start with 1, 0 means not visited */
+  for (i=0; i<_node_count; i++) {
+    if (component[i]) {
+      continue;
+    }
+
+    _component_count++;
+    component[i] = _component_count;
+    stack[0] = i;
+    top = 1;
+    count = 0;
+
+    while (top > 0) {
+      node = &_nodes[stack[--top]];
+      count++;
+
+      for (j=0; j<node->link_count; j++) {
+        n = node->links[j].neighbor;
+        if (!component[n]) {
+          component[n] = _component_count;
+          stack[top++] = n;
+        }
+      }
+    }
+
+    /* every node of the component has to learn all other originators */
+    _expected_originators += (uint64_t)count * (count - 1);
+  }
+
+  free(stack);
+  free(component);
+}
+
+/**
+ * @param addr originator address
+ * @return simulated node with this address, NULL if none
+ */
+static struct sim_node *
+_get_node(const struct netaddr *addr) {
+  const uint8_t *bin;
+  uint32_t index;
+
+  if (netaddr_get_address_family(addr) != AF_INET) {
+    return NULL;
+  }
+
+  bin = netaddr_get_binptr(addr);
+  index = (bin[1] << 16) | (bin[2] << 8) | bin[3];
+  if (bin[0] != 10 || index == 0 || index > _node_count) {
+    return NULL;
+  }
+  return &_nodes[index - 1];
+}
+
+/**
+ * @param node simulated node
+ * @param neighbor index of neighbor node
+ * @return link to neighbor, NULL if not a topology neighbor
+ */
+static struct sim_link *
+_get_link(struct sim_node *node, uint32_t neighbor) {
+  uint32_t i;
+
+  for (i=0; i<node->link_count; i++) {
+    if (node->links[i].neighbor == neighbor) {
+      return &node->links[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Update the symmetric state of a link and the global link counter
+ * @param link simulated link
+ */
+static void
+_update_link(struct sim_link *link) {
+  bool symmetric;
+
+  symmetric = link->sym_until > oonf_clock_getNow();
+  if (symmetric != link->symmetric) {
+    link->symmetric = symmetric;
+    if (symmetric) {
+      _symmetric_links++;
+    }
+    else {
+      _symmetric_links--;
+    }
+  }
+}
+
+/**
+ * Start the aggregation timer of a node if not already running
+ * @param node simulated node
+ */
+static void
+_schedule_flush(struct sim_node *node) {
+  if (!oonf_timer_is_active(&node->flush_timer)) {
+    oonf_timer_set(&node->flush_timer, SIM_AGGREGATION_INTERVAL);
+  }
+}
+
+/**
+ * Transmit a packet to all topology neighbors of a node
+ * @param writer rfc5444 writer
+ * @param target interface of node
+ * @param ptr pointer to packet
+ * @param len length of packet
+ */
+static void
+_cb_send_packet(struct rfc5444_writer *writer __attribute__((unused)),
+    struct rfc5444_writer_target *target, void *ptr, size_t len) {
+  struct sim_delivery *delivery;
+  struct sim_packet *packet;
+  struct sim_node *node;
+  uint32_t i;
+
+  node = container_of(target, struct sim_node, target);
+
+  packet = malloc(sizeof(*packet) + len);
+  if (!packet) {
+    return;
+  }
+  packet->refcount = 0;
+  packet->length = len;
+  memcpy(packet->data, ptr, len);
+
+  _stats.packets++;
+
+  for (i=0; i<node->link_count; i++) {
+    if (_config.loss > 0 && _random_unit() < _config.loss) {
+      _stats.lost++;
+      continue;
+    }
+
+    delivery = malloc(sizeof(*delivery));
+    if (!delivery) {
+      break;
+    }
+    delivery->packet = packet;
+    delivery->receiver = &_nodes[node->links[i].neighbor];
+    packet->refcount++;
+
+    list_add_tail(&_delivery_queue, &delivery->_node);
+    _pending++;
+  }
+
+  if (_pending > _stats.max_pending) {
+    _stats.max_pending = _pending;
+  }
+  if (packet->refcount == 0) {
+    free(packet);
+  }
+}
+
+/**
+ * Process all packets in flight
+ */
+static void
+_deliver_packets(void) {
+  struct sim_delivery *delivery;
+  struct sim_packet *packet;
+  uint64_t start;
+
+  while (!list_is_empty(&_delivery_queue)) {
+    delivery = list_first_element(&_delivery_queue, delivery, _node);
+    list_remove(&delivery->_node);
+    _pending--;
+
+    packet = delivery->packet;
+    _current_node = delivery->receiver;
+
+    start = benchmark_get_ns();
+    rfc5444_reader_handle_packet(&_reader, packet->data, packet->length);
+    _current_node->cpu_ns += benchmark_get_ns() - start;
+    _current_node = NULL;
+
+    _stats.deliveries++;
+
+    if (--packet->refcount == 0) {
+      free(packet);
+    }
+    free(delivery);
+  }
+}
+
+/**
+ * Check if all links are symmetric and all nodes know all
+ * originators of their component.
+ */
+static void
+_check_convergence(void) {
+  if (_symmetric_links == 2 * _edge_count
+      && _known_originators == _expected_originators) {
+    if (!_converged) {
+      _converged = true;
+      _converged_at = oonf_clock_getNow();
+    }
+  }
+}
+
+static void
+_cb_forwarding_notifier(struct rfc5444_writer_target *target) {
+  _schedule_flush(container_of(target, struct sim_node, target));
+}
+
+static int
+_cb_add_hello_header(struct rfc5444_writer *writer,
+    struct rfc5444_writer_message *msg) {
+  struct sim_node *node = container_of(writer, struct sim_node, writer);
+
+  rfc5444_writer_set_msg_header(writer, msg, true, false, false, false);
+  rfc5444_writer_set_msg_originator(writer, msg, netaddr_get_binptr(&node->addr));
+  return RFC5444_OKAY;
+}
+
+static void
+_cb_add_hello_msgtlvs(struct rfc5444_writer *writer) {
+  uint8_t vtime, itime;
+
+  vtime = rfc5497_timetlv_encode(_config.hello_interval * SIM_HELLO_VALIDITY_FACTOR);
+  itime = rfc5497_timetlv_encode(_config.hello_interval);
+
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime, sizeof(vtime));
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, &itime, sizeof(itime));
+}
+
+static void
+_cb_add_hello_addresses(struct rfc5444_writer *writer) {
+  struct rfc5444_writer_address *address;
+  struct sim_node *node;
+  struct sim_link *link;
+  uint64_t now;
+  uint8_t status;
+  uint32_t i;
+
+  node = container_of(writer, struct sim_node, writer);
+  now = oonf_clock_getNow();
+
+  for (i=0; i<node->link_count; i++) {
+    link = &node->links[i];
+    if (link->heard_until <= now) {
+      continue;
+    }
+
+    address = rfc5444_writer_add_address(writer, node->hello_provider.creator,
+        &_nodes[link->neighbor].addr, false);
+    if (!address) {
+      continue;
+    }
+
+    status = link->sym_until > now ? RFC6130_LINKSTATUS_SYMMETRIC : RFC6130_LINKSTATUS_HEARD;
+    rfc5444_writer_add_addrtlv(writer, address, &node->hello_addrtlvs[0],
+        &status, sizeof(status), false);
+  }
+}
+
+static int
+_cb_add_tc_header(struct rfc5444_writer *writer,
+    struct rfc5444_writer_message *msg) {
+  struct sim_node *node = container_of(writer, struct sim_node, writer);
+
+  rfc5444_writer_set_msg_header(writer, msg, true, true, true, true);
+  rfc5444_writer_set_msg_originator(writer, msg, netaddr_get_binptr(&node->addr));
+  rfc5444_writer_set_msg_hopcount(writer, msg, 0);
+  rfc5444_writer_set_msg_hoplimit(writer, msg, 255);
+  rfc5444_writer_set_msg_seqno(writer, msg, node->tc_seqno++);
+  return RFC5444_OKAY;
+}
+
+static void
+_cb_add_tc_msgtlvs(struct rfc5444_writer *writer) {
+  uint8_t vtime;
+
+  vtime = rfc5497_timetlv_encode(_config.tc_interval * SIM_TC_VALIDITY_FACTOR);
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime, sizeof(vtime));
+}
+
+static void
+_cb_add_tc_addresses(struct rfc5444_writer *writer) {
+  static const uint8_t type = RFC7181_NBR_ADDR_TYPE_ORIGINATOR;
+  struct rfc5444_writer_address *address;
+  struct sim_node *node;
+  uint32_t i;
+
+  node = container_of(writer, struct sim_node, writer);
+
+  for (i=0; i<node->link_count; i++) {
+    if (!node->links[i].symmetric) {
+      continue;
+    }
+
+    address = rfc5444_writer_add_address(writer, node->tc_provider.creator,
+        &_nodes[node->links[i].neighbor].addr, false);
+    if (address) {
+      rfc5444_writer_add_addrtlv(writer, address, &node->tc_addrtlvs[0],
+          &type, sizeof(type), false);
+    }
+  }
+}
+
+static bool
+_cb_tc_forward_target(struct rfc5444_writer_target *target __attribute__((unused)),
+    struct rfc5444_reader_tlvblock_context *context __attribute__((unused)),
+    const uint8_t *buffer __attribute__((unused)), size_t len __attribute__((unused))) {
+  /* each writer has only the interface of its node */
+  return true;
+}
+
+/**
+ * Drop TCs of the receiving node itself and duplicates before
+ * they are parsed and forwarded.
+ * @param context message context
+ * @return true if message should be dropped
+ */
+static bool
+_cb_drop_message(struct rfc5444_reader_tlvblock_context *context) {
+  struct sim_node *originator;
+  enum oonf_duplicate_result result;
+
+  _stats.messages++;
+
+  if (context->msg_type != RFC7181_MSGTYPE_TC) {
+    return false;
+  }
+  if (!context->has_origaddr || !context->has_seqno) {
+    return true;
+  }
+
+  originator = _get_node(&context->orig_addr);
+  if (originator == NULL || originator == _current_node) {
+    return true;
+  }
+
+  result = oonf_duplicate_entry_add(&_current_node->dupset, RFC7181_MSGTYPE_TC,
+      &context->orig_addr, context->seqno,
+      _config.tc_interval * SIM_TC_VALIDITY_FACTOR);
+  if (!oonf_duplicate_is_new(result)) {
+    _stats.duplicates++;
+    return true;
+  }
+  return false;
+}
+
+static void
+_cb_forward_message(struct rfc5444_reader_tlvblock_context *context,
+    uint8_t *buffer, size_t length) {
+  if (rfc5444_writer_forward_msg(&_current_node->writer, context, buffer, length) == RFC5444_OKAY) {
+    _stats.forwarded++;
+  }
+}
+
+static enum rfc5444_result
+_cb_hello_msgtlvs(struct rfc5444_reader_tlvblock_context *context) {
+  struct sim_node *sender;
+
+  _hello_link = NULL;
+  if (!context->has_origaddr) {
+    return RFC5444_DROP_MESSAGE;
+  }
+
+  sender = _get_node(&context->orig_addr);
+  if (!sender) {
+    return RFC5444_DROP_MESSAGE;
+  }
+
+  _hello_link = _get_link(_current_node, sender->index);
+  if (!_hello_link) {
+    return RFC5444_DROP_MESSAGE;
+  }
+
+  _hello_vtime = rfc5497_timetlv_decode(
+      _hello_msgtlvs[IDX_HELLO_VTIME].tlv->single_value[0]);
+  _hello_sees_receiver = false;
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_hello_addresstlvs(struct rfc5444_reader_tlvblock_context *context) {
+  struct rfc5444_reader_tlvblock_entry *tlv;
+
+  if (netaddr_cmp(&context->addr, &_current_node->addr) != 0) {
+    return RFC5444_OKAY;
+  }
+
+  tlv = _hello_addrtlvs[IDX_ADDRTLV_LINK_STATUS].tlv;
+  if (tlv != NULL && (tlv->single_value[0] == RFC6130_LINKSTATUS_SYMMETRIC
+      || tlv->single_value[0] == RFC6130_LINKSTATUS_HEARD)) {
+    _hello_sees_receiver = true;
+  }
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_hello_end(struct rfc5444_reader_tlvblock_context *context __attribute__((unused)),
+    bool dropped) {
+  uint64_t now;
+
+  if (dropped || !_hello_link) {
+    return RFC5444_OKAY;
+  }
+
+  now = oonf_clock_getNow();
+  _hello_link->heard_until = now + _hello_vtime;
+  if (_hello_sees_receiver) {
+    _hello_link->sym_until = now + _hello_vtime;
+  }
+  _update_link(_hello_link);
+  _hello_link = NULL;
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_tc_msgtlvs(struct rfc5444_reader_tlvblock_context *context) {
+  struct sim_node *originator;
+
+  originator = _get_node(&context->orig_addr);
+  if (originator == NULL) {
+    return RFC5444_DROP_MESSAGE;
+  }
+
+  if ((_current_node->known[originator->index / 8] & (1 << (originator->index % 8))) == 0) {
+    _current_node->known[originator->index / 8] |= 1 << (originator->index % 8);
+    _known_originators++;
+  }
+  return RFC5444_OKAY;
+}
+
+static void
+_cb_hello_timer(struct oonf_timer_instance *ptr) {
+  struct sim_node *node;
+  uint64_t start;
+  uint32_t i;
+
+  node = container_of(ptr, struct sim_node, hello_timer);
+  start = benchmark_get_ns();
+
+  for (i=0; i<node->link_count; i++) {
+    _update_link(&node->links[i]);
+  }
+
+  if (rfc5444_writer_create_message_alltarget(
+      &node->writer, RFC6130_MSGTYPE_HELLO, 4) == RFC5444_OKAY) {
+    _stats.hellos++;
+  }
+  _schedule_flush(node);
+
+  node->cpu_ns += benchmark_get_ns() - start;
+}
+
+static void
+_cb_tc_timer(struct oonf_timer_instance *ptr) {
+  struct sim_node *node;
+  uint64_t start;
+
+  node = container_of(ptr, struct sim_node, tc_timer);
+  start = benchmark_get_ns();
+
+  if (rfc5444_writer_create_message_alltarget(
+      &node->writer, RFC7181_MSGTYPE_TC, 4) == RFC5444_OKAY) {
+    _stats.tcs++;
+  }
+  _schedule_flush(node);
+
+  node->cpu_ns += benchmark_get_ns() - start;
+}
+
+static void
+_cb_flush_timer(struct oonf_timer_instance *ptr) {
+  struct sim_node *node;
+  uint64_t start;
+
+  node = container_of(ptr, struct sim_node, flush_timer);
+  start = benchmark_get_ns();
+
+  rfc5444_writer_flush(&node->writer, &node->target, false);
+
+  node->cpu_ns += benchmark_get_ns() - start;
+}
+
+/**
+ * Initialize the clock, timer and duplicate set subsystems
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init_subsystems(void) {
+  struct oonf_subsystem *subsystem;
+  size_t i;
+
+  for (i=0; i<ARRAYSIZE(_subsystems); i++) {
+    subsystem = oonf_subsystem_get(_subsystems[i]);
+    if (!subsystem || (subsystem->init && subsystem->init())) {
+      fprintf(stderr, "Could not initialize subsystem %s\n", _subsystems[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void
+_cleanup_subsystems(void) {
+  struct oonf_subsystem *subsystem;
+  size_t i;
+
+  for (i=ARRAYSIZE(_subsystems); i>0; i--) {
+    subsystem = oonf_subsystem_get(_subsystems[i-1]);
+    if (subsystem && subsystem->cleanup) {
+      subsystem->cleanup();
+    }
+  }
+}
+
+static void
+_cleanup_nodes(void) {
+  struct sim_delivery *delivery, *it;
+  struct sim_node *node;
+  uint32_t i;
+
+  list_for_each_element_safe(&_delivery_queue, delivery, _node, it) {
+    list_remove(&delivery->_node);
+    if (--delivery->packet->refcount == 0) {
+      free(delivery->packet);
+    }
+    free(delivery);
+  }
+
+  for (i=0; _nodes && i<_node_count; i++) {
+    node = &_nodes[i];
+    oonf_timer_stop(&node->hello_timer);
+    oonf_timer_stop(&node->tc_timer);
+    oonf_timer_stop(&node->flush_timer);
+    rfc5444_writer_cleanup(&node->writer);
+    oonf_duplicate_set_remove(&node->dupset);
+  }
+
+  free(_nodes);
+  free(_links);
+  free(_known);
+  free(_edges);
+}
+
+static void
+_print_report(uint64_t real_ns) {
+  static const char *topology[] = {
+    [SIM_TOPOLOGY_GRID] = "grid",
+    [SIM_TOPOLOGY_RANDOM] = "random",
+    [SIM_TOPOLOGY_NETJSON] = "netjson",
+  };
+  uint64_t cpu_total, cpu_max, mem, mem_total, mem_max;
+  uint32_t i;
+
+  cpu_total = cpu_max = mem_total = mem_max = 0;
+  for (i=0; i<_node_count; i++) {
+    cpu_total += _nodes[i].cpu_ns;
+    if (_nodes[i].cpu_ns > cpu_max) {
+      cpu_max = _nodes[i].cpu_ns;
+    }
+
+    mem = sizeof(struct sim_node)
+        + _nodes[i].link_count * sizeof(struct sim_link)
+        + (_node_count + 7) / 8
+        + _nodes[i].dupset._size * sizeof(struct oonf_duplicate_entry);
+    mem_total += mem;
+    if (mem > mem_max) {
+      mem_max = mem;
+    }
+  }
+
+  printf("model:       synthetic HELLO/TC flooding, not an NHDP/OLSRv2 benchmark\n");
+  printf("topology:    %s, %u nodes, %zu links, %u components, %.2f neighbors per node\n",
+      topology[_config.topology], _node_count, _edge_count, _component_count,
+      _node_count ? 2.0 * _edge_count / _node_count : 0.0);
+  printf("parameters:  seed %"PRIu64", loss %.3f, hello %"PRIu64" ms, tc %"PRIu64" ms\n",
+      _config.seed, _config.loss, _config.hello_interval, _config.tc_interval);
+  if (_converged) {
+    printf("convergence: converged after %.3f s\n", (double)_converged_at / 1000.0);
+  }
+  else {
+    printf("convergence: not converged (%"PRIu64"/%zu symmetric links, %"PRIu64"/%"PRIu64" originators)\n",
+        _symmetric_links, 2 * _edge_count, _known_originators, _expected_originators);
+  }
+  printf("time:        %.3f s simulated in %.3f s (%.1fx)\n",
+      (double)_config.duration / 1000.0, (double)real_ns / 1e9,
+      real_ns ? (double)_config.duration * 1e6 / (double)real_ns : 0.0);
+  printf("messages:    %"PRIu64" HELLO, %"PRIu64" TC, %"PRIu64" forwarded, %"PRIu64" duplicates, %"PRIu64" parsed (%.0f messages/s)\n",
+      _stats.hellos, _stats.tcs, _stats.forwarded, _stats.duplicates, _stats.messages,
+      real_ns ? (double)_stats.messages * 1e9 / (double)real_ns : 0.0);
+  printf("packets:     %"PRIu64" sent, %"PRIu64" received, %"PRIu64" lost, %"PRIu64" max in flight\n",
+      _stats.packets, _stats.deliveries, _stats.lost, _stats.max_pending);
+  printf("cpu:         %.1f us per node average, %.1f us maximum\n",
+      _node_count ? (double)cpu_total / _node_count / 1000.0 : 0.0, (double)cpu_max / 1000.0);
+  printf("memory:      %.0f bytes per node average, %"PRIu64" bytes maximum\n",
+      _node_count ? (double)mem_total / _node_count : 0.0, mem_max);
+}
+
+static void
+_usage(const char *name) {
+  printf("Usage: %s [options]\n"
+      "Synthetic flooding model of RFC5444 message generation, parsing and duplicate\n"
+      "detection. The nodes run a simplified HELLO/TC protocol without the NHDP and\n"
+      "OLSRv2 plugins (no MPR selection, no link metrics, no routing), so the results\n"
+      "are NOT a benchmark of NHDP/OLSRv2 or of olsrd2 convergence.\n\n"
+      "  -t, --topology=TYPE           grid, random or netjson (default grid)\n"
+      "  -f, --file=FILE               NetJSON NetworkGraph for netjson topology\n"
+      "  -n, --nodes=N                 number of nodes (default 100)\n"
+      "  -d, --degree=D                average neighbors of random topology (default 6)\n"
+      "  -l, --loss=P                  packet loss probability per link (default 0)\n"
+      "  -s, --seed=N                  random seed (default 1)\n"
+      "  -D, --duration=MS             simulated time in milliseconds (default 60000)\n"
+      "  -H, --hello-interval=MS       HELLO interval (default 2000)\n"
+      "  -T, --tc-interval=MS          TC interval (default 5000)\n"
+      "  -c, --require-convergence     fail if the network did not converge\n"
+      "  -h, --help                    this help text\n", name);
+}
+
+static int
+_parse_options(int argc, char **argv) {
+  static const struct option options[] = {
+    { "topology",            required_argument, 0, 't' },
+    { "file",                required_argument, 0, 'f' },
+    { "nodes",               required_argument, 0, 'n' },
+    { "degree",              required_argument, 0, 'd' },
+    { "loss",                required_argument, 0, 'l' },
+    { "seed",                required_argument, 0, 's' },
+    { "duration",            required_argument, 0, 'D' },
+    { "hello-interval",      required_argument, 0, 'H' },
+    { "tc-interval",         required_argument, 0, 'T' },
+    { "require-convergence", no_argument,       0, 'c' },
+    { "help",                no_argument,       0, 'h' },
+    { NULL, 0, 0, 0 },
+  };
+  int opt;
+
+  while ((opt = getopt_long(argc, argv, "t:f:n:d:l:s:D:H:T:ch", options, NULL)) != -1) {
+    switch (opt) {
+      case 't':
+        if (strcmp(optarg, "grid") == 0) {
+          _config.topology = SIM_TOPOLOGY_GRID;
+        }
+        else if (strcmp(optarg, "random") == 0) {
+          _config.topology = SIM_TOPOLOGY_RANDOM;
+        }
+        else if (strcmp(optarg, "netjson") == 0) {
+          _config.topology = SIM_TOPOLOGY_NETJSON;
+        }
+        else {
+          fprintf(stderr, "Unknown topology: %s\n", optarg);
+          return -1;
+        }
+        break;
+      case 'f':
+        _config.file = optarg;
+        _config.topology = SIM_TOPOLOGY_NETJSON;
+        break;
+      case 'n':
+        _config.nodes = strtoul(optarg, NULL, 10);
+        break;
+      case 'd':
+        _config.degree = strtod(optarg, NULL);
+        break;
+      case 'l':
+        _config.loss = strtod(optarg, NULL);
+        break;
+      case 's':
+        _config.seed = strtoull(optarg, NULL, 10);
+        break;
+      case 'D':
+        _config.duration = strtoull(optarg, NULL, 10);
+        break;
+      case 'H':
+        _config.hello_interval = strtoull(optarg, NULL, 10);
+        break;
+      case 'T':
+        _config.tc_interval = strtoull(optarg, NULL, 10);
+        break;
+      case 'c':
+        _config.require_convergence = true;
+        break;
+      case 'h':
+        _usage(argv[0]);
+        exit(0);
+      default:
+        _usage(argv[0]);
+        return -1;
+    }
+  }
+
+  if (_config.topology == SIM_TOPOLOGY_NETJSON && _config.file == NULL) {
+    fprintf(stderr, "NetJSON topology needs a --file parameter\n");
+    return -1;
+  }
+  if (_config.topology != SIM_TOPOLOGY_NETJSON
+      && (_config.nodes == 0 || _config.nodes >= (1u << 24) - 1)) {
+    fprintf(stderr, "Number of nodes must be between 1 and %u\n", (1u << 24) - 2);
+    return -1;
+  }
+  if (_config.hello_interval == 0 || _config.tc_interval == 0) {
+    fprintf(stderr, "HELLO and TC interval must not be zero\n");
+    return -1;
+  }
+  if (_config.loss < 0 || _config.loss >= 1) {
+    fprintf(stderr, "Loss must be between 0 and 1\n");
+    return -1;
+  }
+  return 0;
+}
+
+int
+main(int argc, char **argv) {
+  uint64_t start, next;
+  int result;
+
+  if (_parse_options(argc, argv)) {
+    return 1;
+  }
+
+  /* xorshift state must not be zero */
+  _random_state = _config.seed ^ 0x9e3779b97f4a7c15ull;
+  if (_random_state == 0) {
+    _random_state = 1;
+  }
+
+  list_init_head(&_delivery_queue);
+
+  switch (_config.topology) {
+    case SIM_TOPOLOGY_GRID:
+      result = _build_grid(_config.nodes);
+      break;
+    case SIM_TOPOLOGY_RANDOM:
+      result = _build_random(_config.nodes, _config.degree);
+      break;
+    default:
+      result = _build_netjson(_config.file);
+      break;
+  }
+  if (result) {
+    fprintf(stderr, "Could not create topology\n");
+    free(_edges);
+    return 1;
+  }
+
+  if (_init_subsystems()) {
+    free(_edges);
+    return 1;
+  }
+
+  oonf_timer_add(&_hello_timer_class);
+  oonf_timer_add(&_tc_timer_class);
+  oonf_timer_add(&_flush_timer_class);
+
+  rfc5444_reader_init(&_reader);
+  rfc5444_reader_add_message_consumer(&_reader, &_hello_msg_consumer,
+      _hello_msgtlvs, ARRAYSIZE(_hello_msgtlvs));
+  rfc5444_reader_add_message_consumer(&_reader, &_hello_addr_consumer,
+      _hello_addrtlvs, ARRAYSIZE(_hello_addrtlvs));
+  rfc5444_reader_add_message_consumer(&_reader, &_tc_msg_consumer,
+      _tc_msgtlvs, ARRAYSIZE(_tc_msgtlvs));
+
+  if (_build_nodes()) {
+    fprintf(stderr, "Out of memory\n");
+    result = 1;
+  }
+  else {
+    _calculate_components();
+
+    start = benchmark_get_ns();
+    while ((next = oonf_timer_getNextEvent()) <= _config.duration) {
+      if (next > _virtual_time) {
+        _virtual_time = next;
+      }
+      if (oonf_clock_update()) {
+        break;
+      }
+
+      oonf_timer_walk();
+      _deliver_packets();
+      _check_convergence();
+    }
+    _virtual_time = _config.duration;
+
+    _print_report(benchmark_get_ns() - start);
+    result = _config.require_convergence && !_converged ? 1 : 0;
+  }
+
+  _cleanup_nodes();
+
+  rfc5444_reader_remove_message_consumer(&_reader, &_tc_msg_consumer);
+  rfc5444_reader_remove_message_consumer(&_reader, &_hello_addr_consumer);
+  rfc5444_reader_remove_message_consumer(&_reader, &_hello_msg_consumer);
+  rfc5444_reader_cleanup(&_reader);
+
+  oonf_timer_remove(&_flush_timer_class);
+  oonf_timer_remove(&_tc_timer_class);
+  oonf_timer_remove(&_hello_timer_class);
+
+  _cleanup_subsystems();
+  return result;
+}
@@ -0,0 +1,421 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "core/oonf_appdata.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_duplicate_set.h"
+#include "subsystems/oonf_rfc5444.h"
+#include "subsystems/os_routing.h"
+
+#include "nhdp/nhdp_domain.h"
+#include "olsrv2/olsrv2.h"
+#include "olsrv2/olsrv2_tc.h"
+
+/* test the static functions of the plugin directly */
+#include "state_snapshot/state_snapshot.c"
+
+#include "cunit/cunit.h"
+
+#define SNAPSHOT_FILE "/tmp/test_state_snapshot.bin"
+
+#define MSG_TYPE      1
+#define VALIDITY      60000
+#define ANSN          1234
+#define MSG_SEQNO     4321
+
+/* sequence numbers known by the duplicate sets before the snapshot */
+static const uint16_t _processed_seqno[] = { 100, 98, 97, 60, 1 };
+static const uint16_t _forwarded_seqno[] = { 65535, 3, 4 };
+
+static const struct oonf_appdata _appdata = {
+  .app_name = "test_state_snapshot",
+  .default_lockfile = "/tmp/test_state_snapshot.lock",
+  .default_cfg_handler = "",
+};
+
+static struct nhdp_domain *_domain;
+
+static void
+_make_addr(struct netaddr *addr, uint8_t idx, uint8_t prefix_len) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = prefix_len == 32 ? 0 : idx;
+  bin[2] = 0;
+  bin[3] = prefix_len == 32 ? idx : 0;
+  netaddr_from_binary_prefix(addr, bin, sizeof(bin), AF_INET, prefix_len);
+}
+
+static void
+_clear_tc(void) {
+  struct olsrv2_tc_node *node;
+  bool removed;
+
+  /* removing a node can turn other nodes into virtual ones */
+  do {
+    removed = false;
+    avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+      if (!olsrv2_tc_is_node_virtual(node)) {
+        olsrv2_tc_node_remove(node);
+        removed = true;
+        break;
+      }
+    }
+  } while (removed);
+}
+
+static void
+_clear_dupsets(void) {
+  struct oonf_rfc5444_protocol *protocol;
+
+  protocol = oonf_rfc5444_get_default_protocol();
+  oonf_duplicate_set_remove(&protocol->processed_set);
+  oonf_duplicate_set_add(&protocol->processed_set, OONF_DUPSET_16BIT);
+  oonf_duplicate_set_remove(&protocol->forwarded_set);
+  oonf_duplicate_set_add(&protocol->forwarded_set, OONF_DUPSET_16BIT);
+}
+
+static void
+clear_elements(void) {
+  _clear_tc();
+  _clear_dupsets();
+  olsrv2_set_ansn(0);
+  oonf_rfc5444_set_last_message_seqno(oonf_rfc5444_get_default_protocol(), 0);
+  remove(SNAPSHOT_FILE);
+}
+
+static void
+_add_tc_state(void) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_node *node;
+  struct os_route_key prefix;
+  struct netaddr addr;
+  uint8_t i;
+
+  for (i=1; i<=3; i++) {
+    _make_addr(&addr, i, 32);
+    node = olsrv2_tc_node_add(&addr, VALIDITY, 100 + i);
+    node->interval_time = 1000 * i;
+    node->source_specific = i == 2;
+    node->ss_attached_networks[_domain->index] = i == 2;
+  }
+
+  /* node 1 and 2 are connected in both directions, node 4 stays virtual */
+  _make_addr(&addr, 1, 32);
+  node = olsrv2_tc_node_get(&addr);
+
+  _make_addr(&addr, 2, 32);
+  edge = olsrv2_tc_edge_add(node, &addr);
+  edge->cost[_domain->index] = 10;
+  _make_addr(&addr, 4, 32);
+  edge = olsrv2_tc_edge_add(node, &addr);
+  edge->cost[_domain->index] = 40;
+
+  _make_addr(&addr, 5, 16);
+  os_routing_init_sourcespec_prefix(&prefix, &addr);
+  attached = olsrv2_tc_endpoint_add(node, &prefix, false);
+  attached->cost[_domain->index] = 5;
+  attached->distance[_domain->index] = 2;
+
+  _make_addr(&addr, 2, 32);
+  node = olsrv2_tc_node_get(&addr);
+
+  _make_addr(&addr, 1, 32);
+  edge = olsrv2_tc_edge_add(node, &addr);
+  edge->cost[_domain->index] = 20;
+
+  _make_addr(&addr, 6, 32);
+  os_routing_init_sourcespec_prefix(&prefix, &addr);
+  attached = olsrv2_tc_endpoint_add(node, &prefix, true);
+  attached->cost[_domain->index] = 7;
+  attached->distance[_domain->index] = 0;
+}
+
+static void
+_dump_tc(struct autobuf *out) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_node *node;
+  struct netaddr_str nbuf;
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    if (olsrv2_tc_is_node_virtual(node)) {
+      continue;
+    }
+
+    abuf_appendf(out, "node %s ansn=%u interval=%" PRIu64 " ss=%d/%d\n",
+        netaddr_to_string(&nbuf, &node->target.prefix.dst), node->ansn,
+        node->interval_time, node->source_specific,
+        node->ss_attached_networks[_domain->index]);
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      if (!edge->virtual) {
+        abuf_appendf(out, "  edge %s cost=%u\n",
+            netaddr_to_string(&nbuf, &edge->dst->target.prefix.dst),
+            edge->cost[_domain->index]);
+      }
+    }
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      abuf_appendf(out, "  attached %s type=%d cost=%u distance=%u\n",
+          netaddr_to_string(&nbuf, &attached->dst->target.prefix.dst),
+          attached->dst->target.type, attached->cost[_domain->index],
+          attached->distance[_domain->index]);
+    }
+  }
+}
+
+static void
+_add_dupset(struct oonf_duplicate_set *set, struct netaddr *addr,
+    const uint16_t *seqno, size_t count) {
+  size_t i;
+
+  for (i=0; i<count; i++) {
+    oonf_duplicate_entry_add(set, MSG_TYPE, addr, seqno[i], VALIDITY);
+  }
+}
+
+/*
+ * the state of a duplicate set entry is described by the result of
+ * a test of each sequence number around the newest one
+ */
+static void
+_dump_dupset(struct autobuf *out, struct oonf_duplicate_set *set,
+    struct netaddr *addr, uint16_t current) {
+  uint16_t seqno;
+  int i;
+
+  for (i=-OONF_DUPSET_HISTORY_WINDOW-1; i<=2; i++) {
+    seqno = current + i;
+    abuf_appendf(out, "%u:%s ", seqno, oonf_duplicate_get_result_str(
+        oonf_duplicate_test(set, MSG_TYPE, addr, seqno)));
+  }
+  abuf_puts(out, "\n");
+}
+
+static void
+_dump_dupsets(struct autobuf *out) {
+  struct oonf_rfc5444_protocol *protocol;
+  struct netaddr addr;
+
+  protocol = oonf_rfc5444_get_default_protocol();
+
+  _make_addr(&addr, 1, 32);
+  _dump_dupset(out, &protocol->processed_set, &addr, _processed_seqno[0]);
+  _make_addr(&addr, 2, 32);
+  _dump_dupset(out, &protocol->forwarded_set, &addr, _forwarded_seqno[2]);
+}
+
+static void
+_check_dump(struct autobuf *expected, struct autobuf *current,
+    const char *name, int line) {
+  CHECK_NAMED_TRUE(strcmp(abuf_getptr(expected), abuf_getptr(current)) == 0, name, line,
+      "state differs after restore:\nexpected:\n%scurrent:\n%s",
+      abuf_getptr(expected), abuf_getptr(current));
+}
+
+static void
+test_roundtrip(void) {
+  struct oonf_rfc5444_protocol *protocol;
+  struct autobuf tc_before, tc_after, dup_before, dup_after;
+  struct netaddr addr;
+
+  START_TEST();
+
+  protocol = oonf_rfc5444_get_default_protocol();
+
+  abuf_init(&tc_before);
+  abuf_init(&tc_after);
+  abuf_init(&dup_before);
+  abuf_init(&dup_after);
+
+  _add_tc_state();
+  olsrv2_set_ansn(ANSN);
+  oonf_rfc5444_set_last_message_seqno(protocol, MSG_SEQNO);
+
+  _make_addr(&addr, 1, 32);
+  _add_dupset(&protocol->processed_set, &addr,
+      _processed_seqno, ARRAYSIZE(_processed_seqno));
+  _make_addr(&addr, 2, 32);
+  _add_dupset(&protocol->forwarded_set, &addr,
+      _forwarded_seqno, ARRAYSIZE(_forwarded_seqno));
+
+  _dump_tc(&tc_before);
+  _dump_dupsets(&dup_before);
+
+  CHECK_TRUE(_save_snapshot(SNAPSHOT_FILE) == 0, "save snapshot");
+
+  /* simulate the restart of the daemon */
+  _clear_tc();
+  _clear_dupsets();
+  olsrv2_set_ansn(0);
+  oonf_rfc5444_set_last_message_seqno(protocol, 0);
+
+  CHECK_TRUE(olsrv2_tc_get_tree()->count == 0,
+      "%u tc nodes left after clear", olsrv2_tc_get_tree()->count);
+  CHECK_TRUE(oonf_duplicate_set_get_count(&protocol->processed_set) == 0,
+      "processed set not empty after clear");
+
+  CHECK_TRUE(_restore_snapshot(SNAPSHOT_FILE) == 0, "restore snapshot");
+
+  _dump_tc(&tc_after);
+  _dump_dupsets(&dup_after);
+
+  _check_dump(&tc_before, &tc_after, "topology", __LINE__);
+  _check_dump(&dup_before, &dup_after, "duplicate sets", __LINE__);
+
+  /* sequence numbers continue after the saved ones */
+  CHECK_TRUE(olsrv2_get_ansn() == ANSN + 1,
+      "ansn is %u", olsrv2_get_ansn());
+  CHECK_TRUE(oonf_rfc5444_get_last_message_seqno(protocol) == MSG_SEQNO,
+      "message seqno is %u", oonf_rfc5444_get_last_message_seqno(protocol));
+
+  abuf_free(&tc_before);
+  abuf_free(&tc_after);
+  abuf_free(&dup_before);
+  abuf_free(&dup_after);
+
+  END_TEST();
+}
+
+static void
+test_restore_keeps_new_state(void) {
+  struct oonf_rfc5444_protocol *protocol;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_node *node;
+  struct netaddr addr;
+  uint32_t count;
+
+  START_TEST();
+
+  protocol = oonf_rfc5444_get_default_protocol();
+
+  _add_tc_state();
+  _make_addr(&addr, 1, 32);
+  _add_dupset(&protocol->processed_set, &addr,
+      _processed_seqno, ARRAYSIZE(_processed_seqno));
+
+  CHECK_TRUE(_save_snapshot(SNAPSHOT_FILE) == 0, "save snapshot");
+
+  _clear_tc();
+  _clear_dupsets();
+
+  /* state received after the restart must not be overwritten */
+  _make_addr(&addr, 1, 32);
+  node = olsrv2_tc_node_add(&addr, VALIDITY, 500);
+  _make_addr(&addr, 3, 32);
+  edge = olsrv2_tc_edge_add(node, &addr);
+  edge->cost[_domain->index] = 99;
+
+  _make_addr(&addr, 1, 32);
+  oonf_duplicate_entry_add(&protocol->processed_set, MSG_TYPE, &addr, 200, VALIDITY);
+
+  CHECK_TRUE(_restore_snapshot(SNAPSHOT_FILE) == 0, "restore snapshot");
+
+  node = olsrv2_tc_node_get(&addr);
+  CHECK_TRUE(node != NULL && node->ansn == 500, "tc node received after restart was changed");
+
+  /* restored node 2 only adds a virtual inverse edge */
+  count = 0;
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (!edge->virtual) {
+      count++;
+    }
+  }
+  CHECK_TRUE(count == 1, "tc node received after restart has %u edges", count);
+
+  CHECK_TRUE(oonf_duplicate_test(&protocol->processed_set, MSG_TYPE, &addr, 200)
+      == OONF_DUPSET_CURRENT, "duplicate entry received after restart was changed");
+  CHECK_TRUE(oonf_duplicate_test(&protocol->processed_set, MSG_TYPE, &addr, 199)
+      == OONF_DUPSET_NEW, "history of duplicate entry was changed");
+
+  _make_addr(&addr, 2, 32);
+  node = olsrv2_tc_node_get(&addr);
+  CHECK_TRUE(node != NULL && !olsrv2_tc_is_node_virtual(node) && node->ansn == 102,
+      "tc node missing after restore");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+  if (oonf_subsystem_init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  result = 1;
+  if (oonf_subsystem_call_init(&_snapshot_subsystem) == 0
+      && (_domain = nhdp_domain_add(0)) != NULL) {
+    _config.validity = VALIDITY;
+    _config.max_age = VALIDITY;
+
+    BEGIN_TESTING(clear_elements);
+
+    test_roundtrip();
+    test_restore_keeps_new_state();
+
+    result = FINISH_TESTING();
+  }
+
+  remove(SNAPSHOT_FILE);
+
+  oonf_subsystem_cleanup();
+  oonf_log_cleanup();
+  return result;
+}
@@ -0,0 +1,1018 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Replay benchmark for the RFC5444 reader. Packets are loaded from a
+ * pcap file, from a hexdump as printed by the rfc5444 subsystem debug
+ * logging or generated synthetically, and are then fed into
+ * rfc5444_reader_handle_packet() as fast as possible.
+ */
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "rfc5444/rfc5444.h"
+#include "rfc5444/rfc5444_iana.h"
+#include "rfc5444/rfc5444_reader.h"
+#include "rfc5444/rfc5444_writer.h"
+
+#include "benchmark/benchmark_common.h"
+
+/* benchmark constants */
+enum {
+  /*! maximum size of a replayed packet */
+  MAX_PACKET_SIZE = 65535,
+
+  /*! UDP port for MANET protocols (RFC5498) */
+  MANET_PORT = 269,
+
+  /*! NHDP originator TLV, see nhdp.h */
+  NHDP_MSGTLV_IPV4ORIGINATOR = 226,
+
+  /*! NHDP MAC TLV, see nhdp.h */
+  NHDP_MSGTLV_MAC = 227,
+
+  /*! maximum number of NHDP domains, see nhdp.h */
+  NHDP_MAXIMUM_DOMAINS = 4,
+};
+
+/* pcap file constants */
+enum {
+  PCAP_MAGIC         = 0xa1b2c3d4,
+  PCAP_MAGIC_NS      = 0xa1b23c4d,
+  PCAP_HEADER_SIZE   = 24,
+  PCAP_RECORD_SIZE   = 16,
+
+  LINKTYPE_NULL      = 0,
+  LINKTYPE_ETHERNET  = 1,
+  LINKTYPE_RAW       = 101,
+  LINKTYPE_LINUX_SLL = 113,
+};
+
+/**
+ * Reference to a packet inside the trace buffer
+ */
+struct bench_packet {
+  /*! offset of the packet in the trace buffer */
+  size_t offset;
+
+  /*! length of the packet */
+  size_t length;
+};
+
+/**
+ * Collection of packets to replay
+ */
+struct bench_trace {
+  /*! buffer with the data of all packets */
+  uint8_t *data;
+
+  /*! bytes used in data buffer */
+  size_t used;
+
+  /*! allocated size of data buffer */
+  size_t size;
+
+  /*! array of packets */
+  struct bench_packet *packets;
+
+  /*! number of packets */
+  size_t count;
+
+  /*! allocated length of packet array */
+  size_t allocated;
+};
+
+static enum rfc5444_result _cb_count_message(struct rfc5444_reader_tlvblock_context *);
+static enum rfc5444_result _cb_nhdp_messagetlvs(struct rfc5444_reader_tlvblock_context *);
+static enum rfc5444_result _cb_nhdp_addresstlvs(struct rfc5444_reader_tlvblock_context *);
+static enum rfc5444_result _cb_olsrv2_messagetlvs(struct rfc5444_reader_tlvblock_context *);
+static enum rfc5444_result _cb_olsrv2_addresstlvs(struct rfc5444_reader_tlvblock_context *);
+
+static struct rfc5444_reader_tlvblock_entry *_malloc_tlvblock_entry(void);
+static struct rfc5444_reader_addrblock_entry *_malloc_addrblock_entry(void);
+
+static int _cb_add_message_header(struct rfc5444_writer *, struct rfc5444_writer_message *);
+static void _cb_add_hello_tlvs(struct rfc5444_writer *);
+static void _cb_add_hello_addresses(struct rfc5444_writer *);
+static void _cb_add_tc_tlvs(struct rfc5444_writer *);
+static void _cb_add_tc_addresses(struct rfc5444_writer *);
+static void _cb_store_packet(struct rfc5444_writer *,
+    struct rfc5444_writer_target *, void *, size_t);
+
+/* packets to replay */
+static struct bench_trace _trace;
+
+/* statistics */
+static uint64_t _messages = 0;
+static uint64_t _addresses = 0;
+static uint64_t _tlv_values = 0;
+static uint64_t _allocations = 0;
+
+/* reader with counting allocators */
+static struct rfc5444_reader _reader = {
+  .malloc_tlvblock_entry = _malloc_tlvblock_entry,
+  .malloc_addrblock_entry = _malloc_addrblock_entry,
+};
+
+/* consumer that is always attached and counts all messages */
+static struct rfc5444_reader_tlvblock_consumer _count_consumer = {
+  .order = 0,
+  .default_msg_consumer = true,
+  .block_callback = _cb_count_message,
+};
+
+/* consumers with the same constraints as the NHDP HELLO reader */
+enum {
+  IDX_HELLO_VTIME,
+  IDX_HELLO_ITIME,
+  IDX_HELLO_WILLINGNESS,
+  IDX_HELLO_MPRTYPES,
+  IDX_HELLO_IPV4ORIG,
+  IDX_HELLO_MAC,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _nhdp_message_tlvs[] = {
+  [IDX_HELLO_VTIME] = { .type = RFC5497_MSGTLV_VALIDITY_TIME, .type_ext = 0, .match_type_ext = true,
+      .mandatory = true, .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_ITIME] = { .type = RFC5497_MSGTLV_INTERVAL_TIME, .type_ext = 0, .match_type_ext = true,
+      .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_WILLINGNESS] = { .type = RFC7181_MSGTLV_MPR_WILLING, .type_ext = 0, .match_type_ext = true,
+    .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_MPRTYPES] = { .type = DRAFT_MT_MSGTLV_MPR_TYPES,
+      .type_ext = DRAFT_MT_MSGTLV_MPR_TYPES_EXT, .match_type_ext = true,
+      .min_length = 1, .max_length = NHDP_MAXIMUM_DOMAINS, .match_length = true },
+  [IDX_HELLO_IPV4ORIG] = { .type = NHDP_MSGTLV_IPV4ORIGINATOR, .type_ext = 0, .match_type_ext = true,
+      .min_length = 4, .match_length = true },
+  [IDX_HELLO_MAC] = { .type = NHDP_MSGTLV_MAC, .type_ext = 0, .match_type_ext = true,
+      .min_length = 6, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _nhdp_message_consumer = {
+  .order = 1,
+  .msg_id = RFC6130_MSGTYPE_HELLO,
+  .block_callback = _cb_nhdp_messagetlvs,
+};
+
+enum {
+  IDX_HELLO_ADDRTLV_LOCAL_IF,
+  IDX_HELLO_ADDRTLV_LINK_STATUS,
+  IDX_HELLO_ADDRTLV_OTHER_NEIGHB,
+  IDX_HELLO_ADDRTLV_MPR,
+  IDX_HELLO_ADDRTLV_LINKMETRIC,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _nhdp_address_tlvs[] = {
+  [IDX_HELLO_ADDRTLV_LOCAL_IF] = { .type = RFC6130_ADDRTLV_LOCAL_IF, .type_ext = 0, .match_type_ext = true,
+      .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_ADDRTLV_LINK_STATUS] = { .type = RFC6130_ADDRTLV_LINK_STATUS, .type_ext = 0, .match_type_ext = true,
+      .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_ADDRTLV_OTHER_NEIGHB] = { .type = RFC6130_ADDRTLV_OTHER_NEIGHB, .type_ext = 0, .match_type_ext = true,
+      .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_ADDRTLV_MPR] = { .type = RFC7181_ADDRTLV_MPR,
+      .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_HELLO_ADDRTLV_LINKMETRIC] = { .type = RFC7181_ADDRTLV_LINK_METRIC, .min_length = 2, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _nhdp_address_consumer = {
+  .order = 1,
+  .msg_id = RFC6130_MSGTYPE_HELLO,
+  .addrblock_consumer = true,
+  .block_callback = _cb_nhdp_addresstlvs,
+};
+
+/* consumers with the same constraints as the OLSRv2 TC reader */
+enum {
+  IDX_TC_ITIME,
+  IDX_TC_VTIME,
+  IDX_TC_CONT_SEQ_NUM,
+  IDX_TC_MPRTYPES,
+  IDX_TC_SSR,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _olsrv2_message_tlvs[] = {
+  [IDX_TC_ITIME] = { .type = RFC5497_MSGTLV_INTERVAL_TIME, .type_ext = 0, .match_type_ext = true,
+      .min_length = 1, .max_length = 511, .match_length = true },
+  [IDX_TC_VTIME] = { .type = RFC5497_MSGTLV_VALIDITY_TIME, .type_ext = 0, .match_type_ext = true,
+      .mandatory = true, .min_length = 1, .max_length = 511, .match_length = true },
+  [IDX_TC_CONT_SEQ_NUM] = { .type = RFC7181_MSGTLV_CONT_SEQ_NUM,
+      .mandatory = true, .min_length = 2, .max_length = 65535, .match_length = true },
+  [IDX_TC_MPRTYPES] = { .type = DRAFT_MT_MSGTLV_MPR_TYPES,
+      .type_ext = DRAFT_MT_MSGTLV_MPR_TYPES_EXT, .match_type_ext = true,
+      .min_length = 1, .max_length = NHDP_MAXIMUM_DOMAINS, .match_length = true },
+  [IDX_TC_SSR] = { .type = DRAFT_SSR_MSGTLV_CAPABILITY,
+      .type_ext = DRAFT_SSR_MSGTLV_CAPABILITY_EXT, .match_type_ext = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _olsrv2_message_consumer = {
+  .order = 2,
+  .msg_id = RFC7181_MSGTYPE_TC,
+  .block_callback = _cb_olsrv2_messagetlvs,
+};
+
+enum {
+  IDX_TC_ADDRTLV_LINK_METRIC,
+  IDX_TC_ADDRTLV_NBR_ADDR_TYPE,
+  IDX_TC_ADDRTLV_GATEWAY,
+  IDX_TC_ADDRTLV_SRC_PREFIX,
+};
+static struct rfc5444_reader_tlvblock_consumer_entry _olsrv2_address_tlvs[] = {
+  [IDX_TC_ADDRTLV_LINK_METRIC] = { .type = RFC7181_ADDRTLV_LINK_METRIC,
+    .min_length = 2, .max_length = 65535, .match_length = true },
+  [IDX_TC_ADDRTLV_NBR_ADDR_TYPE] = { .type = RFC7181_ADDRTLV_NBR_ADDR_TYPE,
+    .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_TC_ADDRTLV_GATEWAY] = { .type = RFC7181_ADDRTLV_GATEWAY,
+    .min_length = 1, .max_length = 65535, .match_length = true },
+  [IDX_TC_ADDRTLV_SRC_PREFIX] = { .type = SRCSPEC_GW_ADDRTLV_SRC_PREFIX,
+    .min_length = 1, .max_length = 17, .match_length = true },
+};
+static struct rfc5444_reader_tlvblock_consumer _olsrv2_address_consumer = {
+  .order = 2,
+  .msg_id = RFC7181_MSGTYPE_TC,
+  .addrblock_consumer = true,
+  .block_callback = _cb_olsrv2_addresstlvs,
+};
+
+/* writer for synthetic traces */
+static uint8_t _msg_buffer[1280];
+static uint8_t _msg_addrtlvs[5000];
+static uint8_t _packet_buffer[1280];
+
+static struct rfc5444_writer _writer = {
+  .msg_buffer = _msg_buffer,
+  .msg_size = sizeof(_msg_buffer),
+  .addrtlv_buffer = _msg_addrtlvs,
+  .addrtlv_size = sizeof(_msg_addrtlvs),
+};
+
+static struct rfc5444_writer_target _target = {
+  .packet_buffer = _packet_buffer,
+  .packet_size = sizeof(_packet_buffer),
+  .sendPacket = _cb_store_packet,
+};
+
+static struct rfc5444_writer_content_provider _hello_provider = {
+  .msg_type = RFC6130_MSGTYPE_HELLO,
+  .addMessageTLVs = _cb_add_hello_tlvs,
+  .addAddresses = _cb_add_hello_addresses,
+};
+
+static struct rfc5444_writer_tlvtype _hello_addrtlvs[] = {
+  { .type = RFC6130_ADDRTLV_LINK_STATUS },
+  { .type = RFC7181_ADDRTLV_LINK_METRIC, .exttype = 0 },
+};
+
+static struct rfc5444_writer_content_provider _tc_provider = {
+  .msg_type = RFC7181_MSGTYPE_TC,
+  .addMessageTLVs = _cb_add_tc_tlvs,
+  .addAddresses = _cb_add_tc_addresses,
+};
+
+static struct rfc5444_writer_tlvtype _tc_addrtlvs[] = {
+  { .type = RFC7181_ADDRTLV_NBR_ADDR_TYPE },
+  { .type = RFC7181_ADDRTLV_LINK_METRIC, .exttype = 0 },
+};
+
+/* state of synthetic trace generator */
+static uint32_t _gen_originator;
+static uint32_t _gen_hello_addresses = 16;
+static uint32_t _gen_tc_addresses = 48;
+
+static int
+_compare_u64(const void *p1, const void *p2) {
+  const uint64_t *u1 = p1, *u2 = p2;
+
+  return *u1 < *u2 ? -1 : (*u1 > *u2 ? 1 : 0);
+}
+
+/**
+ * Append a packet to the trace
+ * @param data pointer to packet
+ * @param length length of packet
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_add_packet(const void *data, size_t length) {
+  struct bench_packet *packets;
+  uint8_t *buffer;
+  size_t size;
+
+  if (length == 0) {
+    return 0;
+  }
+
+  if (_trace.used + length > _trace.size) {
+    size = _trace.size ? _trace.size * 2 : 65536;
+    while (size < _trace.used + length) {
+      size *= 2;
+    }
+    buffer = realloc(_trace.data, size);
+    if (!buffer) {
+      return -1;
+    }
+    _trace.data = buffer;
+    _trace.size = size;
+  }
+
+  if (_trace.count == _trace.allocated) {
+    size = _trace.allocated ? _trace.allocated * 2 : 1024;
+    packets = realloc(_trace.packets, size * sizeof(*packets));
+    if (!packets) {
+      return -1;
+    }
+    _trace.packets = packets;
+    _trace.allocated = size;
+  }
+
+  memcpy(&_trace.data[_trace.used], data, length);
+  _trace.packets[_trace.count].offset = _trace.used;
+  _trace.packets[_trace.count].length = length;
+  _trace.used += length;
+  _trace.count++;
+  return 0;
+}
+
+static uint32_t
+_read_u32(const uint8_t *ptr, bool swap) {
+  if (swap) {
+    return (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+  }
+  return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+/**
+ * Extract the UDP payload of a captured frame and add it to the trace
+ * @param frame pointer to captured frame
+ * @param length captured length
+ * @param linktype pcap link type
+ * @param port UDP port to filter for, 0 for all
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_add_frame(const uint8_t *frame, size_t length, uint32_t linktype, uint16_t port) {
+  const uint8_t *ip, *udp;
+  size_t offset, udp_len;
+  uint16_t ethertype;
+
+  switch (linktype) {
+    case LINKTYPE_NULL:
+      offset = 4;
+      break;
+    case LINKTYPE_ETHERNET:
+      offset = 14;
+      if (length >= 18 && frame[12] == 0x81 && frame[13] == 0x00) {
+        /* 802.1Q VLAN tag */
+        offset += 4;
+      }
+      ethertype = (frame[offset-2] << 8) | frame[offset-1];
+      if (ethertype != 0x0800 && ethertype != 0x86dd) {
+        return 0;
+      }
+      break;
+    case LINKTYPE_RAW:
+      offset = 0;
+      break;
+    case LINKTYPE_LINUX_SLL:
+      offset = 16;
+      break;
+    default:
+      return 0;
+  }
+  if (length <= offset) {
+    return 0;
+  }
+
+  ip = frame + offset;
+  length -= offset;
+
+  if ((ip[0] >> 4) == 4) {
+    if (length < 20 || ip[9] != IPPROTO_UDP || (ip[6] & 0x3f) != 0 || ip[7] != 0) {
+      /* not UDP or fragmented */
+      return 0;
+    }
+    offset = (ip[0] & 0x0f) * 4;
+  }
+  else if ((ip[0] >> 4) == 6) {
+    if (length < 40 || ip[6] != IPPROTO_UDP) {
+      return 0;
+    }
+    offset = 40;
+  }
+  else {
+    return 0;
+  }
+
+  if (length < offset + 8) {
+    return 0;
+  }
+  udp = ip + offset;
+  length -= offset;
+
+  if (port != 0 && ((udp[2] << 8) | udp[3]) != port) {
+    return 0;
+  }
+
+  udp_len = (udp[4] << 8) | udp[5];
+  if (udp_len < 8) {
+    return 0;
+  }
+  if (udp_len > length) {
+    /* truncated capture */
+    udp_len = length;
+  }
+  return _add_packet(udp + 8, udp_len - 8);
+}
+
+/**
+ * Load packets from a pcap file
+ * @param f file handle positioned at the start of the file
+ * @param port UDP port to filter for, 0 for all
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_load_pcap(FILE *f, uint16_t port) {
+  uint8_t header[PCAP_HEADER_SIZE], record[PCAP_RECORD_SIZE];
+  uint8_t *frame;
+  uint32_t magic, linktype, caplen;
+  bool swap;
+  int result = 0;
+
+  if (fread(header, sizeof(header), 1, f) != 1) {
+    return -1;
+  }
+
+  magic = _read_u32(header, false);
+  swap = magic != PCAP_MAGIC && magic != PCAP_MAGIC_NS;
+  linktype = _read_u32(&header[20], swap);
+
+  frame = malloc(MAX_PACKET_SIZE);
+  if (!frame) {
+    return -1;
+  }
+
+  while (result == 0 && fread(record, sizeof(record), 1, f) == 1) {
+    caplen = _read_u32(&record[8], swap);
+    if (caplen > MAX_PACKET_SIZE) {
+      fprintf(stderr, "Captured frame too large: %u bytes\n", caplen);
+      result = -1;
+    }
+    else if (fread(frame, 1, caplen, f) != caplen) {
+      /* truncated file */
+      break;
+    }
+    else {
+      result = _add_frame(frame, caplen, linktype, port);
+    }
+  }
+
+  free(frame);
+  return result;
+}
+
+static int
+_hexval(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/**
+ * Find the start of a hexdump line generated by abuf_hexdump()
+ * @param line text line
+ * @return pointer to the offset of the hexdump line, NULL if none
+ */
+static const char *
+_find_hexdump(const char *line) {
+  const char *ptr;
+  int i;
+
+  for (ptr = line; (ptr = strchr(ptr, ':')) != NULL; ptr++) {
+    if (ptr - line < 4 || ptr[1] != ' ') {
+      continue;
+    }
+    for (i=1; i<=4; i++) {
+      if (_hexval(ptr[-i]) < 0) {
+        break;
+      }
+    }
+    if (i <= 4) {
+      continue;
+    }
+    if (ptr - line > 4 && ptr[-5] != ' ' && ptr[-5] != '\t') {
+      continue;
+    }
+    for (i=2; i<10; i++) {
+      if (_hexval(ptr[i]) < 0) {
+        break;
+      }
+    }
+    if (i == 10) {
+      return ptr - 4;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Load packets from the hexdumps of the rfc5444 debug logging.
+ * Each packet starts with a line with offset 0000.
+ * @param f file handle
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_load_hexdump(FILE *f) {
+  uint8_t *packet;
+  char line[512];
+  const char *ptr;
+  size_t length, offset;
+  bool valid;
+  int i, hi, lo;
+
+  packet = malloc(MAX_PACKET_SIZE);
+  if (!packet) {
+    return -1;
+  }
+
+  length = 0;
+  valid = false;
+  while (fgets(line, sizeof(line), f)) {
+    ptr = _find_hexdump(line);
+    if (!ptr) {
+      continue;
+    }
+
+    offset = strtoul(ptr, NULL, 16);
+    if (offset == 0) {
+      if (valid && _add_packet(packet, length)) {
+        free(packet);
+        return -1;
+      }
+      length = 0;
+      valid = true;
+    }
+    else if (offset != length || offset + 32 > MAX_PACKET_SIZE) {
+      /* lost a line of this dump */
+      valid = false;
+    }
+    if (!valid) {
+      continue;
+    }
+
+    /* 32 bytes per line in groups of four, separated by a space */
+    ptr += 5;
+    for (i=0; i<32; i++) {
+      if ((i & 3) == 0) {
+        ptr++;
+      }
+      hi = _hexval(ptr[0]);
+      lo = hi < 0 ? -1 : _hexval(ptr[1]);
+      if (lo < 0) {
+        break;
+      }
+      packet[length++] = (hi << 4) | lo;
+      ptr += 2;
+    }
+  }
+
+  if (valid && _add_packet(packet, length)) {
+    free(packet);
+    return -1;
+  }
+  free(packet);
+  return 0;
+}
+
+/**
+ * Load a pcap file or hexdump
+ * @param file name of file
+ * @param port UDP port to filter pcap files for
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_load_file(const char *file, uint16_t port) {
+  uint8_t magic[4];
+  uint32_t value;
+  FILE *f;
+  int result;
+
+  f = fopen(file, "rb");
+  if (!f) {
+    fprintf(stderr, "Cannot open file '%s'\n", file);
+    return -1;
+  }
+
+  value = 0;
+  if (fread(magic, sizeof(magic), 1, f) == 1) {
+    value = _read_u32(magic, false);
+  }
+  rewind(f);
+
+  if (value == PCAP_MAGIC || value == PCAP_MAGIC_NS
+      || _read_u32(magic, true) == PCAP_MAGIC || _read_u32(magic, true) == PCAP_MAGIC_NS) {
+    result = _load_pcap(f, port);
+  }
+  else {
+    result = _load_hexdump(f);
+  }
+  fclose(f);
+  return result;
+}
+
+static int
+_cb_add_message_header(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg) {
+  uint8_t originator[4];
+
+  originator[0] = 10;
+  originator[1] = (_gen_originator >> 16) & 255;
+  originator[2] = (_gen_originator >> 8) & 255;
+  originator[3] = _gen_originator & 255;
+
+  if (msg->type == RFC7181_MSGTYPE_TC) {
+    rfc5444_writer_set_msg_header(writer, msg, true, true, true, true);
+    rfc5444_writer_set_msg_hopcount(writer, msg, 1);
+    rfc5444_writer_set_msg_hoplimit(writer, msg, 254);
+    rfc5444_writer_set_msg_seqno(writer, msg, _gen_originator & 0xffff);
+  }
+  else {
+    rfc5444_writer_set_msg_header(writer, msg, true, false, false, false);
+  }
+  rfc5444_writer_set_msg_originator(writer, msg, originator);
+  return RFC5444_OKAY;
+}
+
+static void
+_add_addresses(struct rfc5444_writer *writer, struct rfc5444_writer_content_provider *provider,
+    struct rfc5444_writer_tlvtype *tlvs, uint32_t count, uint8_t value) {
+  struct rfc5444_writer_address *address;
+  struct netaddr addr;
+  uint8_t bin[4], metric[2];
+  uint32_t i, neigh;
+
+  for (i=0; i<count; i++) {
+    neigh = _gen_originator * 7 + i;
+    bin[0] = 10;
+    bin[1] = (neigh >> 16) & 255;
+    bin[2] = (neigh >> 8) & 255;
+    bin[3] = neigh & 255;
+    netaddr_from_binary(&addr, bin, sizeof(bin), AF_INET);
+
+    address = rfc5444_writer_add_address(writer, provider->creator, &addr, false);
+    if (!address) {
+      continue;
+    }
+
+    metric[0] = 0x10 + (i & 15);
+    metric[1] = i & 255;
+    rfc5444_writer_add_addrtlv(writer, address, &tlvs[0], &value, sizeof(value), false);
+    rfc5444_writer_add_addrtlv(writer, address, &tlvs[1], metric, sizeof(metric), false);
+  }
+}
+
+static void
+_cb_add_hello_tlvs(struct rfc5444_writer *writer) {
+  uint8_t vtime = 0x62, itime = 0x42, willingness = 0x77;
+
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime, sizeof(vtime));
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_INTERVAL_TIME, 0, &itime, sizeof(itime));
+  rfc5444_writer_add_messagetlv(writer, RFC7181_MSGTLV_MPR_WILLING, 0, &willingness, sizeof(willingness));
+}
+
+static void
+_cb_add_hello_addresses(struct rfc5444_writer *writer) {
+  _add_addresses(writer, &_hello_provider, _hello_addrtlvs,
+      _gen_hello_addresses, RFC6130_LINKSTATUS_SYMMETRIC);
+}
+
+static void
+_cb_add_tc_tlvs(struct rfc5444_writer *writer) {
+  uint8_t vtime = 0x82, ansn[2];
+
+  ansn[0] = (_gen_originator >> 8) & 255;
+  ansn[1] = _gen_originator & 255;
+
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime, sizeof(vtime));
+  rfc5444_writer_add_messagetlv(writer, RFC7181_MSGTLV_CONT_SEQ_NUM,
+      RFC7181_CONT_SEQ_NUM_COMPLETE, ansn, sizeof(ansn));
+}
+
+static void
+_cb_add_tc_addresses(struct rfc5444_writer *writer) {
+  _add_addresses(writer, &_tc_provider, _tc_addrtlvs,
+      _gen_tc_addresses, RFC7181_NBR_ADDR_TYPE_ORIGINATOR);
+}
+
+static void
+_cb_store_packet(struct rfc5444_writer *writer __attribute__((unused)),
+    struct rfc5444_writer_target *target __attribute__((unused)),
+    void *ptr, size_t len) {
+  if (_add_packet(ptr, len)) {
+    fprintf(stderr, "Out of memory\n");
+  }
+}
+
+/**
+ * Generate a synthetic trace with one HELLO and one TC per originator
+ * @param originators number of originators
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_generate_trace(uint32_t originators) {
+  struct rfc5444_writer_message *msg;
+
+  rfc5444_writer_init(&_writer);
+  rfc5444_writer_register_target(&_writer, &_target);
+
+  msg = rfc5444_writer_register_message(&_writer, RFC6130_MSGTYPE_HELLO, false);
+  msg->addMessageHeader = _cb_add_message_header;
+  rfc5444_writer_register_msgcontentprovider(&_writer, &_hello_provider,
+      _hello_addrtlvs, ARRAYSIZE(_hello_addrtlvs));
+
+  msg = rfc5444_writer_register_message(&_writer, RFC7181_MSGTYPE_TC, false);
+  msg->addMessageHeader = _cb_add_message_header;
+  rfc5444_writer_register_msgcontentprovider(&_writer, &_tc_provider,
+      _tc_addrtlvs, ARRAYSIZE(_tc_addrtlvs));
+
+  for (_gen_originator = 1; _gen_originator <= originators; _gen_originator++) {
+    if (rfc5444_writer_create_message_alltarget(&_writer, RFC6130_MSGTYPE_HELLO, 4)
+        || rfc5444_writer_create_message_alltarget(&_writer, RFC7181_MSGTYPE_TC, 4)) {
+      rfc5444_writer_cleanup(&_writer);
+      return -1;
+    }
+    rfc5444_writer_flush(&_writer, &_target, false);
+  }
+
+  rfc5444_writer_cleanup(&_writer);
+  return 0;
+}
+
+static enum rfc5444_result
+_cb_count_message(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _messages++;
+  return RFC5444_OKAY;
+}
+
+static void
+_count_tlvs(struct rfc5444_reader_tlvblock_consumer_entry *entries, size_t count) {
+  size_t i;
+
+  for (i=0; i<count; i++) {
+    if (entries[i].tlv && entries[i].tlv->length > 0) {
+      _tlv_values += entries[i].tlv->single_value[0];
+    }
+  }
+}
+
+static enum rfc5444_result
+_cb_nhdp_messagetlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _count_tlvs(_nhdp_message_tlvs, ARRAYSIZE(_nhdp_message_tlvs));
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_nhdp_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _addresses++;
+  _count_tlvs(_nhdp_address_tlvs, ARRAYSIZE(_nhdp_address_tlvs));
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_olsrv2_messagetlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _count_tlvs(_olsrv2_message_tlvs, ARRAYSIZE(_olsrv2_message_tlvs));
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_olsrv2_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _addresses++;
+  _count_tlvs(_olsrv2_address_tlvs, ARRAYSIZE(_olsrv2_address_tlvs));
+  return RFC5444_OKAY;
+}
+
+static struct rfc5444_reader_tlvblock_entry *
+_malloc_tlvblock_entry(void) {
+  _allocations++;
+  return calloc(1, sizeof(struct rfc5444_reader_tlvblock_entry));
+}
+
+static struct rfc5444_reader_addrblock_entry *
+_malloc_addrblock_entry(void) {
+  _allocations++;
+  return calloc(1, sizeof(struct rfc5444_reader_addrblock_entry));
+}
+
+/**
+ * Replay the trace and print the results
+ * @param rounds number of times the trace is replayed
+ * @param consumers true if NHDP/OLSRv2 consumers are attached
+ */
+static void
+_run(uint32_t rounds, bool consumers) {
+  uint64_t *samples, start, end, total, errors, bytes;
+  struct bench_packet *packet;
+  size_t count, i;
+  uint32_t round;
+
+  count = _trace.count * rounds;
+  samples = calloc(count, sizeof(*samples));
+  if (!samples) {
+    fprintf(stderr, "Out of memory\n");
+    return;
+  }
+
+  _messages = 0;
+  _addresses = 0;
+  _allocations = 0;
+  errors = 0;
+  bytes = 0;
+  total = 0;
+
+  for (round = 0; round < rounds; round++) {
+    for (i=0; i<_trace.count; i++) {
+      packet = &_trace.packets[i];
+
+      start = benchmark_get_ns();
+      if (rfc5444_reader_handle_packet(&_reader,
+          &_trace.data[packet->offset], packet->length) < 0) {
+        errors++;
+      }
+      end = benchmark_get_ns();
+
+      samples[round * _trace.count + i] = end - start;
+      total += end - start;
+      bytes += packet->length;
+    }
+  }
+
+  qsort(samples, count, sizeof(*samples), _compare_u64);
+
+  printf("consumers:   %s\n", consumers ? "nhdp, olsrv2" : "none");
+  printf("throughput:  %.0f packets/s, %.0f messages/s, %.1f MByte/s\n",
+      (double)count * 1e9 / (double)total, (double)_messages * 1e9 / (double)total,
+      (double)bytes * 1e3 / (double)total);
+  printf("ns/packet:   avg %.0f, p50 %"PRIu64", p90 %"PRIu64", p99 %"PRIu64", max %"PRIu64"\n",
+      (double)total / (double)count, samples[count / 2],
+      samples[count * 9 / 10], samples[count * 99 / 100], samples[count - 1]);
+  printf("allocations: %.1f per packet, %.1f per message\n",
+      (double)_allocations / (double)count,
+      _messages ? (double)_allocations / (double)_messages : 0.0);
+  if (consumers) {
+    printf("addresses:   %.1f per message\n",
+        _messages ? (double)_addresses / (double)_messages : 0.0);
+  }
+  printf("errors:      %"PRIu64" packets\n", errors);
+
+  free(samples);
+}
+
+static void
+_usage(const char *name) {
+  printf("Usage: %s [options] [pcap or hexdump file]\n"
+      "  -c, --consumers       attach NHDP and OLSRv2 shaped consumers\n"
+      "  -r, --rounds=N        number of times the trace is replayed (default 100)\n"
+      "  -p, --port=N          UDP port of pcap packets, 0 for all (default 269)\n"
+      "  -o, --originators=N   originators of the synthetic trace (default 500)\n"
+      "  -H, --hello=N         addresses per synthetic HELLO (default 16)\n"
+      "  -T, --tc=N            addresses per synthetic TC (default 48)\n"
+      "  -h, --help            this help text\n"
+      "Without a file a synthetic trace with one HELLO and one TC per\n"
+      "originator is generated.\n", name);
+}
+
+int
+main(int argc, char **argv) {
+  static const struct option options[] = {
+    { "consumers",   no_argument,       0, 'c' },
+    { "rounds",      required_argument, 0, 'r' },
+    { "port",        required_argument, 0, 'p' },
+    { "originators", required_argument, 0, 'o' },
+    { "hello",       required_argument, 0, 'H' },
+    { "tc",          required_argument, 0, 'T' },
+    { "help",        no_argument,       0, 'h' },
+    { NULL, 0, 0, 0 },
+  };
+  uint32_t rounds = 100, originators = 500;
+  uint16_t port = MANET_PORT;
+  bool consumers = false;
+  int opt, result;
+
+  while ((opt = getopt_long(argc, argv, "cr:p:o:H:T:h", options, NULL)) != -1) {
+    switch (opt) {
+      case 'c':
+        consumers = true;
+        break;
+      case 'r':
+        rounds = strtoul(optarg, NULL, 10);
+        break;
+      case 'p':
+        port = strtoul(optarg, NULL, 10);
+        break;
+      case 'o':
+        originators = strtoul(optarg, NULL, 10);
+        break;
+      case 'H':
+        _gen_hello_addresses = strtoul(optarg, NULL, 10);
+        break;
+      case 'T':
+        _gen_tc_addresses = strtoul(optarg, NULL, 10);
+        break;
+      case 'h':
+        _usage(argv[0]);
+        return 0;
+      default:
+        _usage(argv[0]);
+        return 1;
+    }
+  }
+  if (rounds == 0) {
+    rounds = 1;
+  }
+
+  if (optind < argc) {
+    result = _load_file(argv[optind], port);
+  }
+  else {
+    result = _generate_trace(originators);
+  }
+  if (result || _trace.count == 0) {
+    fprintf(stderr, "No packets to replay\n");
+    free(_trace.data);
+    free(_trace.packets);
+    return 1;
+  }
+
+  printf("trace:       %zu packets, %zu bytes, %s, %u rounds\n",
+      _trace.count, _trace.used, optind < argc ? argv[optind] : "synthetic", rounds);
+
+  rfc5444_reader_init(&_reader);
+  rfc5444_reader_add_message_consumer(&_reader, &_count_consumer, NULL, 0);
+  if (consumers) {
+    rfc5444_reader_add_message_consumer(&_reader, &_nhdp_message_consumer,
+        _nhdp_message_tlvs, ARRAYSIZE(_nhdp_message_tlvs));
+    rfc5444_reader_add_message_consumer(&_reader, &_nhdp_address_consumer,
+        _nhdp_address_tlvs, ARRAYSIZE(_nhdp_address_tlvs));
+    rfc5444_reader_add_message_consumer(&_reader, &_olsrv2_message_consumer,
+        _olsrv2_message_tlvs, ARRAYSIZE(_olsrv2_message_tlvs));
+    rfc5444_reader_add_message_consumer(&_reader, &_olsrv2_address_consumer,
+        _olsrv2_address_tlvs, ARRAYSIZE(_olsrv2_address_tlvs));
+  }
+
+  _run(rounds, consumers);
+
+  if (consumers) {
+    rfc5444_reader_remove_message_consumer(&_reader, &_olsrv2_address_consumer);
+    rfc5444_reader_remove_message_consumer(&_reader, &_olsrv2_message_consumer);
+    rfc5444_reader_remove_message_consumer(&_reader, &_nhdp_address_consumer);
+    rfc5444_reader_remove_message_consumer(&_reader, &_nhdp_message_consumer);
+  }
+  rfc5444_reader_remove_message_consumer(&_reader, &_count_consumer);
+  rfc5444_reader_cleanup(&_reader);
+
+  free(_trace.data);
+  free(_trace.packets);
+  return 0;
+}
@@ -0,0 +1,359 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Benchmark for the RFC5444 message generator. Creates HELLO and TC
+ * shaped messages with a growing number of addresses and different
+ * address TLV densities and reports the generation time per address,
+ * the generated bytes and the number of message fragments.
+ *
+ * Use --sorted-runs to benchmark the sorted-run address compression
+ * instead of the session based one.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "rfc5444/rfc5444_iana.h"
+#include "rfc5444/rfc5444_writer.h"
+
+#include "benchmark/benchmark_common.h"
+
+/* minimum number of addresses generated per test case */
+#define MIN_ADDRESSES_PER_CASE 500000
+
+/**
+ * Address TLV densities
+ */
+enum bench_density {
+  /*! no address TLVs */
+  DENSITY_NONE,
+
+  /*! one TLV on every fourth address */
+  DENSITY_SPARSE,
+
+  /*! one TLV with the same value on every address */
+  DENSITY_DENSE,
+
+  /*! two TLVs with varying values on every address */
+  DENSITY_FULL,
+};
+
+static const char *_density_names[] = {
+  [DENSITY_NONE]   = "none",
+  [DENSITY_SPARSE] = "sparse",
+  [DENSITY_DENSE]  = "dense",
+  [DENSITY_FULL]   = "full",
+};
+
+static int _cb_add_message_header(struct rfc5444_writer *, struct rfc5444_writer_message *);
+static void _cb_finish_message_header(struct rfc5444_writer *, struct rfc5444_writer_message *,
+    struct rfc5444_writer_address *, struct rfc5444_writer_address *, bool);
+static void _cb_add_message_tlvs(struct rfc5444_writer *);
+static void _cb_add_addresses(struct rfc5444_writer *);
+static void _cb_send_packet(struct rfc5444_writer *,
+    struct rfc5444_writer_target *, void *, size_t);
+
+static uint8_t _msg_buffer[1280];
+static uint8_t _msg_addrtlvs[65536];
+static uint8_t _packet_buffer[1280];
+
+static struct rfc5444_writer _writer = {
+  .msg_buffer = _msg_buffer,
+  .msg_size = sizeof(_msg_buffer),
+  .addrtlv_buffer = _msg_addrtlvs,
+  .addrtlv_size = sizeof(_msg_addrtlvs),
+};
+
+static struct rfc5444_writer_target _target = {
+  .packet_buffer = _packet_buffer,
+  .packet_size = sizeof(_packet_buffer),
+  .sendPacket = _cb_send_packet,
+};
+
+static struct rfc5444_writer_content_provider _hello_provider = {
+  .msg_type = RFC6130_MSGTYPE_HELLO,
+  .addMessageTLVs = _cb_add_message_tlvs,
+  .addAddresses = _cb_add_addresses,
+};
+
+static struct rfc5444_writer_tlvtype _hello_addrtlvs[] = {
+  { .type = RFC6130_ADDRTLV_LINK_STATUS },
+  { .type = RFC7181_ADDRTLV_LINK_METRIC },
+};
+
+static struct rfc5444_writer_content_provider _tc_provider = {
+  .msg_type = RFC7181_MSGTYPE_TC,
+  .addMessageTLVs = _cb_add_message_tlvs,
+  .addAddresses = _cb_add_addresses,
+};
+
+static struct rfc5444_writer_tlvtype _tc_addrtlvs[] = {
+  { .type = RFC7181_ADDRTLV_NBR_ADDR_TYPE },
+  { .type = RFC7181_ADDRTLV_LINK_METRIC },
+};
+
+/* parameters of the current test case */
+static uint8_t _msg_type;
+static struct netaddr *_addresses;
+static uint32_t _address_count;
+static enum bench_density _density;
+
+/* results of the current test case */
+static uint64_t _fragments;
+static uint64_t _packets;
+static uint64_t _bytes;
+
+static int
+_cb_add_message_header(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg) {
+  static const uint8_t originator[4] = { 10, 0, 0, 1 };
+
+  if (msg->type == RFC7181_MSGTYPE_TC) {
+    rfc5444_writer_set_msg_header(writer, msg, true, true, true, true);
+    rfc5444_writer_set_msg_hopcount(writer, msg, 0);
+    rfc5444_writer_set_msg_hoplimit(writer, msg, 255);
+    rfc5444_writer_set_msg_seqno(writer, msg, 1);
+  }
+  else {
+    rfc5444_writer_set_msg_header(writer, msg, true, false, false, false);
+  }
+  rfc5444_writer_set_msg_originator(writer, msg, originator);
+  return RFC5444_OKAY;
+}
+
+static void
+_cb_finish_message_header(struct rfc5444_writer *writer __attribute__((unused)),
+    struct rfc5444_writer_message *msg __attribute__((unused)),
+    struct rfc5444_writer_address *first __attribute__((unused)),
+    struct rfc5444_writer_address *last __attribute__((unused)),
+    bool complete __attribute__((unused))) {
+  _fragments++;
+}
+
+static void
+_cb_add_message_tlvs(struct rfc5444_writer *writer) {
+  uint8_t vtime = 0x62;
+
+  rfc5444_writer_add_messagetlv(writer, RFC5497_MSGTLV_VALIDITY_TIME, 0, &vtime, sizeof(vtime));
+}
+
+static void
+_cb_add_addresses(struct rfc5444_writer *writer) {
+  struct rfc5444_writer_content_provider *provider;
+  struct rfc5444_writer_tlvtype *tlvs;
+  struct rfc5444_writer_address *address;
+  uint8_t value, metric[2];
+  uint32_t i;
+
+  if (_msg_type == RFC7181_MSGTYPE_TC) {
+    provider = &_tc_provider;
+    tlvs = _tc_addrtlvs;
+    value = RFC7181_NBR_ADDR_TYPE_ORIGINATOR;
+  }
+  else {
+    provider = &_hello_provider;
+    tlvs = _hello_addrtlvs;
+    value = RFC6130_LINKSTATUS_SYMMETRIC;
+  }
+
+  for (i=0; i<_address_count; i++) {
+    address = rfc5444_writer_add_address(writer, provider->creator, &_addresses[i], false);
+    if (!address) {
+      continue;
+    }
+
+    switch (_density) {
+      case DENSITY_SPARSE:
+        if ((i & 3) == 0) {
+          rfc5444_writer_add_addrtlv(writer, address, &tlvs[0], &value, sizeof(value), false);
+        }
+        break;
+      case DENSITY_DENSE:
+        rfc5444_writer_add_addrtlv(writer, address, &tlvs[0], &value, sizeof(value), false);
+        break;
+      case DENSITY_FULL:
+        metric[0] = 0x10 + (i & 15);
+        metric[1] = (i * 37) & 255;
+        rfc5444_writer_add_addrtlv(writer, address, &tlvs[0], &value, sizeof(value), false);
+        rfc5444_writer_add_addrtlv(writer, address, &tlvs[1], metric, sizeof(metric), false);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static void
+_cb_send_packet(struct rfc5444_writer *writer __attribute__((unused)),
+    struct rfc5444_writer_target *target __attribute__((unused)),
+    void *ptr __attribute__((unused)), size_t len) {
+  _packets++;
+  _bytes += len;
+}
+
+/**
+ * Fill the address array. HELLO neighbors share a common prefix and
+ * are mostly consecutive, TC addresses are spread over a larger network.
+ * @param msg_type message type
+ * @param count number of addresses
+ */
+static void
+_generate_addresses(uint8_t msg_type, uint32_t count) {
+  uint32_t i, value, random;
+  uint8_t bin[4];
+
+  random = 1;
+  for (i=0; i<count; i++) {
+    if (msg_type == RFC7181_MSGTYPE_TC) {
+      /* deterministic pseudo random, unique lower 16 bit */
+      random = random * 1103515245 + 12345;
+      value = (((random >> 16) & 0x0f) << 16) | ((i * 40503) & 0xffff);
+    }
+    else {
+      value = i + 2;
+    }
+    bin[0] = 10;
+    bin[1] = (value >> 16) & 255;
+    bin[2] = (value >> 8) & 255;
+    bin[3] = value & 255;
+    netaddr_from_binary(&_addresses[i], bin, sizeof(bin), AF_INET);
+  }
+}
+
+/**
+ * Run a single test case and print one line of results
+ * @param msg_type message type
+ * @param count number of addresses
+ * @param density address TLV density
+ */
+static void
+_run(uint8_t msg_type, uint32_t count, enum bench_density density) {
+  uint64_t start, end;
+  uint32_t rounds, i;
+
+  _generate_addresses(msg_type, count);
+  _msg_type = msg_type;
+  _address_count = count;
+  _density = density;
+
+  rounds = MIN_ADDRESSES_PER_CASE / count;
+  if (rounds == 0) {
+    rounds = 1;
+  }
+
+  _fragments = 0;
+  _packets = 0;
+  _bytes = 0;
+
+  start = benchmark_get_ns();
+  for (i=0; i<rounds; i++) {
+    rfc5444_writer_create_message_alltarget(&_writer, msg_type, 4);
+    rfc5444_writer_flush(&_writer, &_target, false);
+  }
+  end = benchmark_get_ns();
+
+  printf("%-5s %-6s %5u %10.1f %10.1f %10"PRIu64" %9.1f %8.1f\n",
+      msg_type == RFC7181_MSGTYPE_TC ? "TC" : "HELLO", _density_names[density], count,
+      (double)(end - start) / ((double)rounds * count),
+      (double)(end - start) / ((double)rounds * 1000.0),
+      _bytes / rounds,
+      (double)_bytes / ((double)rounds * count),
+      (double)_fragments / (double)rounds);
+}
+
+int
+main(int argc, char **argv) {
+  static const uint32_t sizes[] = { 10, 50, 100, 500, 1000, 5000 };
+  static const uint8_t types[] = { RFC6130_MSGTYPE_HELLO, RFC7181_MSGTYPE_TC };
+  struct rfc5444_writer_message *msg;
+  size_t t, d, s;
+  int i;
+
+  for (i=1; i<argc; i++) {
+    if (strcmp(argv[i], "--sorted-runs") == 0) {
+      _writer.addr_compression = RFC5444_ADDR_COMPRESSION_SORTED_RUNS;
+    }
+    else {
+      fprintf(stderr, "Usage: %s [--sorted-runs]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  _addresses = calloc(sizes[ARRAYSIZE(sizes) - 1], sizeof(*_addresses));
+  if (!_addresses) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  rfc5444_writer_init(&_writer);
+  rfc5444_writer_register_target(&_writer, &_target);
+
+  msg = rfc5444_writer_register_message(&_writer, RFC6130_MSGTYPE_HELLO, false);
+  msg->addMessageHeader = _cb_add_message_header;
+  msg->finishMessageHeader = _cb_finish_message_header;
+  rfc5444_writer_register_msgcontentprovider(&_writer, &_hello_provider,
+      _hello_addrtlvs, ARRAYSIZE(_hello_addrtlvs));
+
+  msg = rfc5444_writer_register_message(&_writer, RFC7181_MSGTYPE_TC, false);
+  msg->addMessageHeader = _cb_add_message_header;
+  msg->finishMessageHeader = _cb_finish_message_header;
+  rfc5444_writer_register_msgcontentprovider(&_writer, &_tc_provider,
+      _tc_addrtlvs, ARRAYSIZE(_tc_addrtlvs));
+
+  printf("%-5s %-6s %5s %10s %10s %10s %9s %8s\n",
+      "type", "tlvs", "addrs", "ns/addr", "us/msg", "bytes", "byte/addr", "frags");
+  for (t=0; t<ARRAYSIZE(types); t++) {
+    for (d=0; d<ARRAYSIZE(_density_names); d++) {
+      for (s=0; s<ARRAYSIZE(sizes); s++) {
+        _run(types[t], sizes[s], d);
+      }
+    }
+  }
+
+  rfc5444_writer_cleanup(&_writer);
+  free(_addresses);
+  return 0;
+}
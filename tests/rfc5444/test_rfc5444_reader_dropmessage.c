@@ -0,0 +1,163 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "rfc5444/rfc5444_reader.h"
+
+#include "cunit/cunit.h"
+
+/* rfc5444 test packet */
+static uint8_t testpacket[] = {
+/* packet without tlvblock and sequence number */
+    0x00,
+/* message type 1, originator, hoplimit and seqno, addrlen 4 */
+    1, 0xd3, 0, 13,
+/* originator 10.0.0.1, hoplimit 2, seqno 1 */
+    10, 0, 0, 1, 2, 0, 1,
+/* empty tlvblock */
+    0, 0,
+/* message type 2, originator, hoplimit and seqno, addrlen 4 */
+    2, 0xd3, 0, 13,
+/* originator 10.0.0.1, hoplimit 2, seqno 2 */
+    10, 0, 0, 1, 2, 0, 2,
+/* empty tlvblock */
+    0, 0,
+};
+
+static struct rfc5444_reader reader;
+static struct rfc5444_reader_tlvblock_consumer consumer[2];
+
+static int drop_type;
+static int filtered[3], processed[3], forwarded[3];
+
+static bool
+cb_drop_message(struct rfc5444_reader_tlvblock_context *context) {
+  filtered[context->msg_type]++;
+  return context->msg_type == drop_type;
+}
+
+static void
+cb_forward_message(struct rfc5444_reader_tlvblock_context *context,
+    uint8_t *buffer __attribute__((unused)), size_t length __attribute__((unused))) {
+  forwarded[context->msg_type]++;
+}
+
+static enum rfc5444_result
+cb_start_message(struct rfc5444_reader_tlvblock_context *context) {
+  processed[context->msg_type]++;
+  return RFC5444_OKAY;
+}
+
+static void
+clear_elements(void) {
+  memset(filtered, 0, sizeof(filtered));
+  memset(processed, 0, sizeof(processed));
+  memset(forwarded, 0, sizeof(forwarded));
+}
+
+static void
+test_no_drop(void) {
+  START_TEST();
+
+  drop_type = 0;
+  CHECK_TRUE(rfc5444_reader_handle_packet(&reader, testpacket, sizeof(testpacket)) == RFC5444_OKAY,
+      "parsing of packet failed");
+
+  CHECK_TRUE(filtered[1] == 1 && filtered[2] == 1, "filter was called %d/%d times",
+      filtered[1], filtered[2]);
+  CHECK_TRUE(processed[1] == 1 && processed[2] == 1, "messages were processed %d/%d times",
+      processed[1], processed[2]);
+  CHECK_TRUE(forwarded[1] == 1 && forwarded[2] == 1, "messages were forwarded %d/%d times",
+      forwarded[1], forwarded[2]);
+
+  END_TEST();
+}
+
+static void
+test_drop_first(void) {
+  START_TEST();
+
+  drop_type = 1;
+  CHECK_TRUE(rfc5444_reader_handle_packet(&reader, testpacket, sizeof(testpacket)) == RFC5444_OKAY,
+      "parsing of packet failed");
+
+  CHECK_TRUE(filtered[1] == 1 && filtered[2] == 1, "filter was called %d/%d times",
+      filtered[1], filtered[2]);
+  CHECK_TRUE(processed[1] == 0, "dropped message was processed");
+  CHECK_TRUE(forwarded[1] == 0, "dropped message was forwarded");
+  CHECK_TRUE(processed[2] == 1, "second message was processed %d times", processed[2]);
+  CHECK_TRUE(forwarded[2] == 1, "second message was forwarded %d times", forwarded[2]);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  rfc5444_reader_init(&reader);
+  reader.drop_message = cb_drop_message;
+  reader.forward_message = cb_forward_message;
+
+  consumer[0].msg_id = 1;
+  consumer[0].start_callback = cb_start_message;
+  rfc5444_reader_add_message_consumer(&reader, &consumer[0], NULL, 0);
+
+  consumer[1].msg_id = 2;
+  consumer[1].start_callback = cb_start_message;
+  rfc5444_reader_add_message_consumer(&reader, &consumer[1], NULL, 0);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_no_drop();
+  test_drop_first();
+
+  rfc5444_reader_remove_message_consumer(&reader, &consumer[0]);
+  rfc5444_reader_remove_message_consumer(&reader, &consumer[1]);
+  rfc5444_reader_cleanup(&reader);
+
+  return FINISH_TESTING();
+}
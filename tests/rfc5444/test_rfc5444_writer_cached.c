@@ -0,0 +1,214 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/netaddr.h"
+#include "rfc5444/rfc5444_context.h"
+#include "rfc5444/rfc5444_writer.h"
+#include "cunit/cunit.h"
+
+static void write_packet(struct rfc5444_writer *,
+    struct rfc5444_writer_target *,void *, size_t);
+static int addMessageHeader(struct rfc5444_writer *,
+    struct rfc5444_writer_message *);
+static void addMessageTLVs(struct rfc5444_writer *);
+static void addAddresses(struct rfc5444_writer *);
+static void cacheMessage(struct rfc5444_writer *,
+    struct rfc5444_writer_message *, const uint8_t *, size_t);
+
+static uint8_t msg_buffer[128];
+static uint8_t msg_addrtlvs[1000];
+
+static struct rfc5444_writer writer = {
+  .msg_buffer = msg_buffer,
+  .msg_size = sizeof(msg_buffer),
+  .addrtlv_buffer = msg_addrtlvs,
+  .addrtlv_size = sizeof(msg_addrtlvs),
+};
+
+static uint8_t packet_buffer_if[128];
+static struct rfc5444_writer_target out_if = {
+  .packet_buffer = packet_buffer_if,
+  .packet_size = sizeof(packet_buffer_if),
+  .sendPacket = write_packet,
+};
+
+static struct rfc5444_writer_content_provider cpr = {
+  .msg_type = 1,
+  .addMessageTLVs = addMessageTLVs,
+  .addAddresses = addAddresses,
+};
+
+static int generated_messages;
+
+static uint8_t cache[128];
+static size_t cache_len;
+static int cached_messages;
+
+static uint8_t packet[128];
+static size_t packet_len;
+
+static int addMessageHeader(struct rfc5444_writer *wr, struct rfc5444_writer_message *msg) {
+  static const uint8_t originator[4] = { 10, 0, 0, 1 };
+
+  rfc5444_writer_set_msg_header(wr, msg, true, false, false, false);
+  rfc5444_writer_set_msg_originator(wr, msg, originator);
+  generated_messages++;
+  return RFC5444_OKAY;
+}
+
+static void addMessageTLVs(struct rfc5444_writer *wr) {
+  uint8_t value = 42;
+
+  rfc5444_writer_add_messagetlv(wr, 1, 0, &value, sizeof(value));
+}
+
+static void addAddresses(struct rfc5444_writer *wr) {
+  static const uint8_t addrs[3][4] = {
+    { 10, 0, 0, 2 }, { 10, 0, 0, 3 }, { 10, 0, 1, 4 },
+  };
+  struct netaddr addr;
+  size_t i;
+
+  for (i=0; i<ARRAYSIZE(addrs); i++) {
+    netaddr_from_binary(&addr, addrs[i], sizeof(addrs[i]), AF_INET);
+    rfc5444_writer_add_address(wr, cpr.creator, &addr, false);
+  }
+}
+
+static void cacheMessage(struct rfc5444_writer *wr __attribute__ ((unused)),
+    struct rfc5444_writer_message *msg __attribute__ ((unused)),
+    const uint8_t *data, size_t len) {
+  assert(len <= sizeof(cache));
+  memcpy(cache, data, len);
+  cache_len = len;
+  cached_messages++;
+}
+
+static void write_packet(struct rfc5444_writer *wr __attribute__ ((unused)),
+    struct rfc5444_writer_target *iface __attribute__ ((unused)),
+    void *buffer, size_t length) {
+  assert(length <= sizeof(packet));
+  memcpy(packet, buffer, length);
+  packet_len = length;
+}
+
+static void clear_elements(void) {
+  generated_messages = 0;
+  cached_messages = 0;
+  cache_len = 0;
+  packet_len = 0;
+}
+
+static void test_cached_message(void) {
+  uint8_t generated[128];
+  size_t generated_len;
+
+  START_TEST();
+
+  CHECK_TRUE(0 == rfc5444_writer_create_message_alltarget(&writer, 1, 4),
+      "Generator should return 0");
+  rfc5444_writer_flush(&writer, &out_if, false);
+
+  CHECK_TRUE(generated_messages == 1, "bad number of generated messages: %d", generated_messages);
+  CHECK_TRUE(cached_messages == 1, "bad number of cached messages: %d", cached_messages);
+  CHECK_TRUE(cache_len > 0 && packet_len > cache_len, "bad cache length: %zu", cache_len);
+
+  memcpy(generated, packet, packet_len);
+  generated_len = packet_len;
+  packet_len = 0;
+
+  CHECK_TRUE(0 == rfc5444_writer_add_cached_message(&writer, 1,
+      rfc5444_writer_alltargets_selector, NULL, cache, cache_len),
+      "Adding cached message should return 0");
+  rfc5444_writer_flush(&writer, &out_if, false);
+
+  CHECK_TRUE(generated_messages == 1, "message was generated again");
+  CHECK_TRUE(cached_messages == 1, "cached message was reported again");
+  CHECK_TRUE(packet_len == generated_len, "bad packet length: %zu != %zu", packet_len, generated_len);
+  CHECK_TRUE(memcmp(packet, generated, generated_len) == 0, "cached packet differs from generated one");
+
+  END_TEST();
+}
+
+static void test_cached_message_too_long(void) {
+  START_TEST();
+
+  CHECK_TRUE(RFC5444_MTU_TOO_SMALL == rfc5444_writer_add_cached_message(&writer, 1,
+      rfc5444_writer_alltargets_selector, NULL, cache, sizeof(msg_buffer) + 1),
+      "Oversized cached message should be rejected");
+  CHECK_TRUE(RFC5444_NO_MSGCREATOR == rfc5444_writer_add_cached_message(&writer, 2,
+      rfc5444_writer_alltargets_selector, NULL, cache, 4),
+      "Cached message without message creator should be rejected");
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  struct rfc5444_writer_message *msg;
+
+  rfc5444_writer_init(&writer);
+
+  rfc5444_writer_register_target(&writer, &out_if);
+
+  msg = rfc5444_writer_register_message(&writer, 1, false);
+  msg->addMessageHeader = addMessageHeader;
+  msg->cacheMessage = cacheMessage;
+
+  rfc5444_writer_register_msgcontentprovider(&writer, &cpr, NULL, 0);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_cached_message();
+  test_cached_message_too_long();
+
+  rfc5444_writer_unregister_content_provider(&writer, &cpr, NULL, 0);
+  rfc5444_writer_cleanup(&writer);
+
+  return FINISH_TESTING();
+}
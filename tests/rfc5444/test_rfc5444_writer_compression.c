@@ -0,0 +1,376 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "rfc5444/rfc5444_context.h"
+#include "rfc5444/rfc5444_reader.h"
+#include "rfc5444/rfc5444_writer.h"
+#include "cunit/cunit.h"
+
+#define MSG_TYPE 1
+#define MAX_ADDRESSES 600
+
+static void write_packet(struct rfc5444_writer *,
+    struct rfc5444_writer_target *, void *, size_t);
+static void addAddresses(struct rfc5444_writer *wr);
+static enum rfc5444_result cb_addr_start(struct rfc5444_reader_tlvblock_context *context);
+static enum rfc5444_result cb_addr_tlv(struct rfc5444_reader_tlvblock_entry *entry,
+    struct rfc5444_reader_tlvblock_context *context);
+
+/* guard bytes behind the message and packet buffer detect writes past their end */
+#define GUARD_VALUE 0xa5
+
+struct guarded_buffer {
+  uint8_t buffer[256];
+  uint8_t guard[64];
+};
+
+static struct guarded_buffer msg_buffer;
+static uint8_t msg_addrtlvs[8192];
+
+static struct rfc5444_writer writer = {
+  .msg_buffer = msg_buffer.buffer,
+  .msg_size = sizeof(msg_buffer.buffer),
+  .addrtlv_buffer = msg_addrtlvs,
+  .addrtlv_size = sizeof(msg_addrtlvs),
+};
+
+static struct rfc5444_writer_content_provider cpr = {
+  .msg_type = MSG_TYPE,
+  .addAddresses = addAddresses,
+};
+
+static struct rfc5444_writer_tlvtype addrtlvs[] = {
+  { .type = 2 },
+  { .type = 3 },
+};
+
+static struct guarded_buffer packet_buffer;
+static struct rfc5444_writer_target interface = {
+  .packet_buffer = packet_buffer.buffer,
+  .packet_size = sizeof(packet_buffer.buffer),
+  .sendPacket = write_packet,
+};
+
+static struct rfc5444_reader reader;
+
+static struct rfc5444_reader_tlvblock_consumer addr_consumer = {
+  .msg_id = MSG_TYPE,
+  .addrblock_consumer = true,
+  .start_callback = cb_addr_start,
+  .tlv_callback = cb_addr_tlv,
+};
+
+/* addresses and tlv values of the test case, 0 for no tlv */
+static struct netaddr addresses[MAX_ADDRESSES];
+static uint8_t tlv2_values[MAX_ADDRESSES];
+static uint8_t tlv3_values[MAX_ADDRESSES];
+static size_t address_count;
+
+/* results of the parsed packets */
+static int addr_seen[MAX_ADDRESSES];
+static int tlv_seen[MAX_ADDRESSES];
+static int current_addr;
+static int fragments;
+static size_t bytes;
+
+static int addMessageHeader(struct rfc5444_writer *wr, struct rfc5444_writer_message *msg) {
+  rfc5444_writer_set_msg_header(wr, msg, false, false, false, false);
+  return RFC5444_OKAY;
+}
+
+static void finishMessageHeader(struct rfc5444_writer *wr  __attribute__ ((unused)),
+    struct rfc5444_writer_message *msg __attribute__ ((unused)),
+    struct rfc5444_writer_address *first_addr __attribute__ ((unused)),
+    struct rfc5444_writer_address *last_addr __attribute__ ((unused)),
+    bool not_fragmented __attribute__ ((unused))) {
+  fragments++;
+}
+
+static void addAddresses(struct rfc5444_writer *wr) {
+  struct rfc5444_writer_address *addr;
+  size_t i;
+
+  for (i=0; i<address_count; i++) {
+    addr = rfc5444_writer_add_address(wr, cpr.creator, &addresses[i], false);
+    if (tlv2_values[i]) {
+      rfc5444_writer_add_addrtlv(wr, addr, &addrtlvs[0], &tlv2_values[i], 1, false);
+    }
+    if (tlv3_values[i]) {
+      rfc5444_writer_add_addrtlv(wr, addr, &addrtlvs[1], &tlv3_values[i], 1, false);
+    }
+  }
+}
+
+static void write_packet(struct rfc5444_writer *w __attribute__ ((unused)),
+    struct rfc5444_writer_target *iface __attribute__ ((unused)),
+    void *buffer, size_t length) {
+  bytes += length;
+  CHECK_TRUE(rfc5444_reader_handle_packet(&reader, buffer, length) == RFC5444_OKAY,
+      "Could not parse generated packet");
+}
+
+static enum rfc5444_result
+cb_addr_start(struct rfc5444_reader_tlvblock_context *context) {
+  size_t i;
+
+  for (i=0; i<address_count; i++) {
+    if (netaddr_cmp(&context->addr, &addresses[i]) == 0) {
+      current_addr = i;
+      addr_seen[i]++;
+      return RFC5444_OKAY;
+    }
+  }
+
+  current_addr = -1;
+  CHECK_TRUE(false, "Unknown address in generated packet");
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+cb_addr_tlv(struct rfc5444_reader_tlvblock_entry *entry,
+    struct rfc5444_reader_tlvblock_context *context __attribute__ ((unused))) {
+  uint8_t expected;
+
+  if (current_addr == -1) {
+    return RFC5444_OKAY;
+  }
+
+  expected = entry->type == 2 ? tlv2_values[current_addr] : tlv3_values[current_addr];
+  CHECK_TRUE(entry->length == 1 && expected != 0 && entry->single_value[0] == expected,
+      "Bad tlv %u for address %d", entry->type, current_addr);
+  tlv_seen[current_addr]++;
+  return RFC5444_OKAY;
+}
+
+static void clear_elements(void) {
+  address_count = 0;
+  memset(addresses, 0, sizeof(addresses));
+  memset(tlv2_values, 0, sizeof(tlv2_values));
+  memset(tlv3_values, 0, sizeof(tlv3_values));
+}
+
+static bool
+is_guard_intact(struct guarded_buffer *buf) {
+  size_t i;
+
+  for (i=0; i<sizeof(buf->guard); i++) {
+    if (buf->guard[i] != GUARD_VALUE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Generate the message with the selected compression and check if
+ * all addresses and tlvs have been parsed correctly.
+ * @param compression address compression algorithm
+ * @return number of generated bytes
+ */
+static size_t
+generate(enum rfc5444_addr_compression compression) {
+  size_t i;
+  int tlvs;
+
+  memset(addr_seen, 0, sizeof(addr_seen));
+  memset(tlv_seen, 0, sizeof(tlv_seen));
+  memset(msg_buffer.guard, GUARD_VALUE, sizeof(msg_buffer.guard));
+  memset(packet_buffer.guard, GUARD_VALUE, sizeof(packet_buffer.guard));
+  fragments = 0;
+  bytes = 0;
+
+  writer.addr_compression = compression;
+  CHECK_TRUE(0 == rfc5444_writer_create_message_alltarget(&writer, MSG_TYPE, 4),
+      "Could not create message");
+  rfc5444_writer_flush(&writer, &interface, false);
+
+  CHECK_TRUE(is_guard_intact(&msg_buffer),
+      "Message generator wrote behind the end of the message buffer");
+  CHECK_TRUE(is_guard_intact(&packet_buffer),
+      "Message generator wrote behind the end of the packet buffer");
+
+  for (i=0; i<address_count; i++) {
+    CHECK_TRUE(addr_seen[i] == 1,
+        "Address %zu was parsed %d times", i, addr_seen[i]);
+
+    tlvs = (tlv2_values[i] ? 1 : 0) + (tlv3_values[i] ? 1 : 0);
+    CHECK_TRUE(tlv_seen[i] == tlvs,
+        "Address %zu has %d tlvs instead of %d", i, tlv_seen[i], tlvs);
+  }
+  return bytes;
+}
+
+static void
+compare(void) {
+  size_t session, runs;
+
+  session = generate(RFC5444_ADDR_COMPRESSION_SESSION);
+  runs = generate(RFC5444_ADDR_COMPRESSION_SORTED_RUNS);
+
+  CHECK_TRUE(runs <= session, "sorted runs generated %zu bytes, session %zu bytes",
+      runs, session);
+}
+
+static void test_sequential(void) {
+  uint8_t bin[4] = { 10, 0, 0, 0 };
+  size_t i;
+
+  START_TEST();
+
+  address_count = 300;
+  for (i=0; i<address_count; i++) {
+    bin[2] = (i+1) >> 8;
+    bin[3] = (i+1) & 255;
+    netaddr_from_binary(&addresses[i], bin, sizeof(bin), AF_INET);
+    tlv2_values[i] = 1;
+  }
+
+  compare();
+  END_TEST();
+}
+
+static void test_scattered(void) {
+  uint8_t bin[4] = { 10, 0, 0, 0 };
+  uint32_t random = 1;
+  size_t i;
+
+  START_TEST();
+
+  address_count = 500;
+  for (i=0; i<address_count; i++) {
+    random = random * 1103515245 + 12345;
+    bin[1] = (random >> 16) & 0x0f;
+    bin[2] = ((i * 40503) >> 8) & 255;
+    bin[3] = (i * 40503) & 255;
+    netaddr_from_binary(&addresses[i], bin, sizeof(bin), AF_INET);
+
+    if (i % 4 == 0) {
+      tlv2_values[i] = 1 + (i & 3);
+    }
+    tlv3_values[i] = 1 + ((random >> 20) & 7);
+  }
+
+  compare();
+  END_TEST();
+}
+
+static void test_prefixlen(void) {
+  uint8_t bin[4] = { 10, 0, 0, 0 };
+  size_t i;
+
+  START_TEST();
+
+  address_count = 200;
+  for (i=0; i<address_count; i++) {
+    bin[1] = i / 64;
+    bin[2] = i & 255;
+    netaddr_from_binary_prefix(&addresses[i], bin, sizeof(bin), AF_INET,
+        (i % 7) < 5 ? 24 : 32);
+    if (i % 3) {
+      tlv3_values[i] = 5;
+    }
+  }
+
+  compare();
+  END_TEST();
+}
+
+/*
+ * Groups of addresses with a two byte head, the next group shares only
+ * one byte with the previous one. Restarting the address block for the
+ * short head overwrote the block already stored for the previous
+ * address, so the generated message did not match its size estimate
+ * and overflowed the packet buffer.
+ */
+static void test_short_head(void) {
+  uint8_t bin[4] = { 10, 0, 0, 1 };
+  size_t i;
+
+  START_TEST();
+
+  address_count = 31;
+  for (i=0; i<address_count; i++) {
+    bin[1] = i / 10;
+    bin[2] = i % 10;
+    netaddr_from_binary(&addresses[i], bin, sizeof(bin), AF_INET);
+  }
+
+  compare();
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  struct rfc5444_writer_message *msg;
+
+  rfc5444_reader_init(&reader);
+  rfc5444_reader_add_message_consumer(&reader, &addr_consumer, NULL, 0);
+
+  rfc5444_writer_init(&writer);
+  rfc5444_writer_register_target(&writer, &interface);
+
+  msg = rfc5444_writer_register_message(&writer, MSG_TYPE, false);
+  msg->addMessageHeader = addMessageHeader;
+  msg->finishMessageHeader = finishMessageHeader;
+
+  rfc5444_writer_register_msgcontentprovider(&writer, &cpr, addrtlvs, ARRAYSIZE(addrtlvs));
+
+  BEGIN_TESTING(clear_elements);
+
+  test_sequential();
+  test_scattered();
+  test_prefixlen();
+  test_short_head();
+
+  rfc5444_writer_cleanup(&writer);
+  rfc5444_reader_cleanup(&reader);
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,121 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "subsystems/oonf_duplicate_set.h"
+
+#include "benchmark/benchmark_common.h"
+
+/* number of copies of each message (one original, rest duplicates) */
+#define COPIES 4
+
+/* number of rounds of sequence numbers per originator */
+#define ROUNDS 64
+
+static void
+_run(uint32_t originators) {
+  struct oonf_duplicate_set set;
+  struct netaddr *addr;
+  uint8_t bin[4];
+  uint64_t start, end, tests, duplicates;
+  uint32_t i, round, copy;
+
+  addr = calloc(originators, sizeof(*addr));
+  if (!addr) {
+    fprintf(stderr, "Out of memory\n");
+    return;
+  }
+
+  for (i=0; i<originators; i++) {
+    bin[0] = 10;
+    bin[1] = (i >> 16) & 255;
+    bin[2] = (i >> 8) & 255;
+    bin[3] = i & 255;
+    netaddr_from_binary(&addr[i], bin, sizeof(bin), AF_INET);
+  }
+
+  oonf_duplicate_set_add(&set, OONF_DUPSET_16BIT);
+
+  tests = 0;
+  duplicates = 0;
+  start = benchmark_get_ns();
+  for (round=0; round<ROUNDS; round++) {
+    for (copy=0; copy<COPIES; copy++) {
+      for (i=0; i<originators; i++) {
+        if (!oonf_duplicate_is_new(oonf_duplicate_entry_add(
+            &set, 1, &addr[i], round, 30000))) {
+          duplicates++;
+        }
+        tests++;
+      }
+    }
+    oonf_duplicate_set_sweep(&set);
+  }
+  end = benchmark_get_ns();
+
+  printf("%8u originators: %10"PRIu64" tests, %10"PRIu64" duplicates, %8.1f ns/test, %12.0f tests/s\n",
+      originators, tests, duplicates,
+      (double)(end - start) / (double)tests,
+      (double)tests * 1e9 / (double)(end - start));
+
+  oonf_duplicate_set_remove(&set);
+  free(addr);
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  static const uint32_t sizes[] = { 100, 1000, 10000, 100000 };
+  size_t i;
+
+  for (i=0; i<ARRAYSIZE(sizes); i++) {
+    _run(sizes[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,312 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "subsystems/oonf_duplicate_set.h"
+
+#include "cunit/cunit.h"
+
+#define MSG_TYPE 1
+#define VTIME    (3 * OONF_DUPSET_SWEEP_INTERVAL)
+
+static struct oonf_duplicate_set _set;
+
+static void
+_make_addr(struct netaddr *addr, uint32_t idx) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = (idx >> 16) & 255;
+  bin[2] = (idx >> 8) & 255;
+  bin[3] = idx & 255;
+  netaddr_from_binary(addr, bin, sizeof(bin), AF_INET);
+}
+
+static void
+clear_elements(void) {
+  oonf_duplicate_set_remove(&_set);
+  oonf_duplicate_set_add(&_set, OONF_DUPSET_16BIT);
+}
+
+static void
+test_sequence(void) {
+  struct netaddr addr;
+
+  START_TEST();
+
+  _make_addr(&addr, 1);
+
+  CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr, 100) == OONF_DUPSET_FIRST,
+      "test of unknown originator");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 100, VTIME) == OONF_DUPSET_FIRST,
+      "first seqno");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 100, VTIME) == OONF_DUPSET_CURRENT,
+      "repeated seqno");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 102, VTIME) == OONF_DUPSET_NEWEST,
+      "newer seqno");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 101, VTIME) == OONF_DUPSET_NEW,
+      "seqno inside window");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 101, VTIME) == OONF_DUPSET_DUPLICATE,
+      "duplicate seqno inside window");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 102 - OONF_DUPSET_HISTORY_WINDOW + 1, VTIME)
+      == OONF_DUPSET_NEW, "oldest seqno of window");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 102 - OONF_DUPSET_HISTORY_WINDOW, VTIME)
+      == OONF_DUPSET_TOO_OLD, "seqno outside of window");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE + 1, &addr, 5, VTIME) == OONF_DUPSET_FIRST,
+      "different message type");
+
+  END_TEST();
+}
+
+static void
+test_rollover(void) {
+  struct netaddr addr;
+
+  START_TEST();
+
+  _make_addr(&addr, 1);
+
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 65534, VTIME) == OONF_DUPSET_FIRST,
+      "first seqno");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 1, VTIME) == OONF_DUPSET_NEWEST,
+      "seqno after rollover");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 65535, VTIME) == OONF_DUPSET_NEW,
+      "seqno before rollover");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 65534, VTIME) == OONF_DUPSET_DUPLICATE,
+      "duplicate before rollover");
+
+  END_TEST();
+}
+
+/*
+ * emulates the early drop of the rfc5444 subsystem (test first, add
+ * only if not a duplicate) for an originator that reset its sequence
+ * number
+ */
+static void
+test_seqno_reset(void) {
+  enum oonf_duplicate_result test_result, add_result;
+  struct netaddr addr;
+  uint64_t seqno;
+  int i;
+
+  START_TEST();
+
+  _make_addr(&addr, 1);
+
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 1000, VTIME) == OONF_DUPSET_FIRST,
+      "first seqno");
+
+  /* testing alone must not count too old messages */
+  for (i = 0; i < 2 * OONF_DUPSET_MAXIMUM_TOO_OLD; i++) {
+    CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr, 1) == OONF_DUPSET_TOO_OLD,
+        "test %d of too old seqno changed the set", i);
+  }
+
+  for (seqno = 1; seqno <= OONF_DUPSET_MAXIMUM_TOO_OLD + 4; seqno++) {
+    test_result = oonf_duplicate_test(&_set, MSG_TYPE, &addr, seqno);
+    CHECK_TRUE(!oonf_duplicate_is_duplicate(test_result),
+        "seqno %"PRIu64" after reset dropped early as %s", seqno,
+        oonf_duplicate_get_result_str(test_result));
+
+    add_result = oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, seqno, VTIME);
+    CHECK_TRUE(test_result == add_result, "test (%s) and add (%s) of seqno %"PRIu64" differ",
+        oonf_duplicate_get_result_str(test_result),
+        oonf_duplicate_get_result_str(add_result), seqno);
+
+    if (seqno <= OONF_DUPSET_MAXIMUM_TOO_OLD) {
+      CHECK_TRUE(add_result == OONF_DUPSET_TOO_OLD, "seqno %"PRIu64" before reset detection: %s",
+          seqno, oonf_duplicate_get_result_str(add_result));
+    }
+    else {
+      /* the message that triggered the reset is accepted too */
+      CHECK_TRUE(add_result == OONF_DUPSET_NEWEST, "seqno %"PRIu64" after reset detection: %s",
+          seqno, oonf_duplicate_get_result_str(add_result));
+    }
+  }
+
+  END_TEST();
+}
+
+static void
+test_many_entries(void) {
+  struct netaddr addr;
+  uint32_t i;
+  bool ok;
+
+  START_TEST();
+
+  for (i=0; i<5000; i++) {
+    _make_addr(&addr, i);
+    oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, i, VTIME);
+  }
+  CHECK_TRUE(oonf_duplicate_set_get_count(&_set) == 5000,
+      "set contains %u entries", oonf_duplicate_set_get_count(&_set));
+
+  ok = true;
+  for (i=0; i<5000; i++) {
+    _make_addr(&addr, i);
+    ok &= oonf_duplicate_test(&_set, MSG_TYPE, &addr, i) == OONF_DUPSET_CURRENT;
+  }
+  CHECK_TRUE(ok, "all entries found again");
+
+  END_TEST();
+}
+
+static void
+test_sweep(void) {
+  struct netaddr addr1, addr2;
+  int i;
+
+  START_TEST();
+
+  _make_addr(&addr1, 1);
+  _make_addr(&addr2, 2);
+
+  oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr1, 1, VTIME);
+  oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr2, 1, 2 * VTIME);
+
+  for (i=0; i<3; i++) {
+    oonf_duplicate_set_sweep(&_set);
+  }
+  CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr1, 1) == OONF_DUPSET_CURRENT,
+      "entry still valid before vtime");
+
+  oonf_duplicate_set_sweep(&_set);
+  CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr1, 1) == OONF_DUPSET_FIRST,
+      "entry removed after vtime");
+  CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr2, 1) == OONF_DUPSET_CURRENT,
+      "entry with longer vtime still valid");
+
+  /* refreshing an entry extends its validity */
+  oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr2, 2, VTIME);
+  for (i=0; i<3; i++) {
+    oonf_duplicate_set_sweep(&_set);
+  }
+  CHECK_TRUE(oonf_duplicate_test(&_set, MSG_TYPE, &addr2, 2) == OONF_DUPSET_CURRENT,
+      "refreshed entry still valid");
+
+  oonf_duplicate_set_sweep(&_set);
+  CHECK_TRUE(oonf_duplicate_set_get_count(&_set) == 0, "set is empty");
+
+  END_TEST();
+}
+
+static void
+test_iteration(void) {
+  struct oonf_duplicate_entry *entry;
+  struct netaddr addr;
+  uint32_t i, count, sum;
+
+  START_TEST();
+
+  for (i=0; i<100; i++) {
+    _make_addr(&addr, i);
+    oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, i, VTIME);
+  }
+
+  count = 0;
+  sum = 0;
+  oonf_duplicate_for_each_entry(&_set, entry) {
+    count++;
+    sum += entry->current;
+  }
+  CHECK_TRUE(count == 100, "iteration found %u entries", count);
+  CHECK_TRUE(sum == 99*100/2, "sum of sequence numbers is %u", sum);
+
+  END_TEST();
+}
+
+static void
+test_restore(void) {
+  struct netaddr addr;
+
+  START_TEST();
+
+  _make_addr(&addr, 1);
+
+  /* seqno 100, 98 and 97 have been seen before the restart */
+  CHECK_TRUE(oonf_duplicate_entry_restore(&_set, MSG_TYPE, &addr, 100, 0x0d, VTIME)
+      == OONF_DUPSET_FIRST, "restored entry");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 100, VTIME) == OONF_DUPSET_CURRENT,
+      "restored current seqno");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 98, VTIME) == OONF_DUPSET_DUPLICATE,
+      "restored seqno in history");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 97, VTIME) == OONF_DUPSET_DUPLICATE,
+      "restored seqno in history");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 99, VTIME) == OONF_DUPSET_NEW,
+      "seqno missing in history");
+
+  /* a restored entry must not override the current state */
+  CHECK_TRUE(oonf_duplicate_entry_restore(&_set, MSG_TYPE, &addr, 20, 0xff, VTIME)
+      == OONF_DUPSET_TOO_OLD, "restore of known entry");
+  CHECK_TRUE(oonf_duplicate_entry_add(&_set, MSG_TYPE, &addr, 96, VTIME) == OONF_DUPSET_NEW,
+      "history unchanged by second restore");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  oonf_duplicate_set_add(&_set, OONF_DUPSET_16BIT);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_sequence();
+  test_rollover();
+  test_seqno_reset();
+  test_many_entries();
+  test_sweep();
+  test_iteration();
+  test_restore();
+
+  oonf_duplicate_set_remove(&_set);
+  return FINISH_TESTING();
+}
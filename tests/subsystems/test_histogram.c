@@ -0,0 +1,182 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_histogram.h"
+#include "subsystems/os_clock.h"
+
+#include "cunit/cunit.h"
+
+static struct oonf_histogram _histogram = {
+  .name = "test",
+  .unit = "ns",
+};
+
+static void
+clear_elements(void) {
+  oonf_histogram_reset(&_histogram);
+}
+
+static void
+test_bucket_bounds(void) {
+  uint64_t value;
+  unsigned idx, last_idx, shift;
+
+  START_TEST();
+
+  last_idx = 0;
+  for (shift = 0; shift < 64; shift++) {
+    for (value = 1ull << shift; value < (2ull << shift) && value != 0;
+        value += (shift < 4 ? 1 : (1ull << (shift - 4)))) {
+      idx = oonf_histogram_get_bucket(value);
+
+      CHECK_TRUE(idx < OONF_HISTOGRAM_BUCKETS,
+          "value %"PRIu64" has bucket %u", value, idx);
+      CHECK_TRUE(idx >= last_idx,
+          "bucket index of %"PRIu64" not monotonic", value);
+      CHECK_TRUE(oonf_histogram_get_bucket_min(idx) <= value
+          && value <= oonf_histogram_get_bucket_max(idx),
+          "value %"PRIu64" outside of bucket %u (%"PRIu64"-%"PRIu64")",
+          value, idx, oonf_histogram_get_bucket_min(idx),
+          oonf_histogram_get_bucket_max(idx));
+      last_idx = idx;
+    }
+  }
+
+  CHECK_TRUE(oonf_histogram_get_bucket(0) == 0, "zero is not in bucket 0");
+  CHECK_TRUE(oonf_histogram_get_bucket(UINT64_MAX) == OONF_HISTOGRAM_BUCKETS - 1,
+      "maximum value is not in last bucket");
+
+  for (idx = 1; idx < OONF_HISTOGRAM_BUCKETS; idx++) {
+    CHECK_TRUE(oonf_histogram_get_bucket_min(idx)
+        == oonf_histogram_get_bucket_max(idx - 1) + 1,
+        "gap between bucket %u and %u", idx - 1, idx);
+  }
+
+  END_TEST();
+}
+
+static void
+test_statistics(void) {
+  uint64_t value;
+
+  START_TEST();
+
+  for (value = 1; value <= 1000; value++) {
+    oonf_histogram_record(&_histogram, value);
+  }
+
+  CHECK_TRUE(_histogram.count == 1000, "count is %"PRIu64, _histogram.count);
+  CHECK_TRUE(_histogram.sum == 500500, "sum is %"PRIu64, _histogram.sum);
+  CHECK_TRUE(_histogram.min == 1, "min is %"PRIu64, _histogram.min);
+  CHECK_TRUE(_histogram.max == 1000, "max is %"PRIu64, _histogram.max);
+
+  value = oonf_histogram_get_percentile(&_histogram, 50);
+  CHECK_TRUE(value >= 500 && value < 625, "p50 is %"PRIu64, value);
+
+  value = oonf_histogram_get_percentile(&_histogram, 99);
+  CHECK_TRUE(value >= 990 && value <= 1000, "p99 is %"PRIu64, value);
+
+  value = oonf_histogram_get_percentile(&_histogram, 0);
+  CHECK_TRUE(value == 1, "p0 is %"PRIu64, value);
+
+  value = oonf_histogram_get_percentile(&_histogram, 100);
+  CHECK_TRUE(value == 1000, "p100 is %"PRIu64, value);
+
+  oonf_histogram_reset(&_histogram);
+  CHECK_TRUE(_histogram.count == 0, "count after reset is %"PRIu64, _histogram.count);
+  CHECK_TRUE(oonf_histogram_get_percentile(&_histogram, 50) == 0,
+      "percentile of empty histogram is not zero");
+
+  END_TEST();
+}
+
+static void
+test_probe_enabled(void) {
+  struct oonf_subsystem *os_clock;
+  uint64_t start;
+
+  START_TEST();
+
+  /* the clock source is selected by the os_clock subsystem */
+  os_clock = oonf_subsystem_get(OONF_OS_CLOCK_SUBSYSTEM);
+  CHECK_TRUE(os_clock != NULL, "os_clock subsystem not found");
+  if (os_clock && os_clock->init) {
+    os_clock->init();
+  }
+
+  /* latency probes are disabled by default */
+  start = oonf_histogram_start(&_histogram);
+  CHECK_TRUE(start == 0, "disabled probe returned timestamp %"PRIu64, start);
+  oonf_histogram_stop(&_histogram, start);
+  CHECK_TRUE(_histogram.count == 0, "disabled probe recorded %"PRIu64" values",
+      _histogram.count);
+
+  _histogram._enabled = true;
+  start = oonf_histogram_start(&_histogram);
+  CHECK_TRUE(start != 0, "enabled probe returned no timestamp");
+  oonf_histogram_stop(&_histogram, start);
+  CHECK_TRUE(_histogram.count == 1, "enabled probe recorded %"PRIu64" values",
+      _histogram.count);
+  _histogram._enabled = false;
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_bucket_bounds();
+  test_statistics();
+  test_probe_enabled();
+
+  return FINISH_TESTING();
+}